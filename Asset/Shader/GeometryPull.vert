@@ -0,0 +1,24 @@
+#version 460
+#extension GL_GOOGLE_include_directive : require
+
+#define AD_GEOMETRY_SET 0
+#define AD_SCENE_SET 1
+#include "Include/AdGpuScene.glsl"
+
+// 每个绘制命令的 firstInstance 指向自己的实例数据
+
+layout(push_constant) uniform AdGeometryPushConstants {
+    mat4 viewProj;
+} pc;
+
+layout(location = 0) out vec3 vNormal;
+layout(location = 1) out vec2 vUV;
+
+void main() {
+    AdGeometryInstance instance = instances[gl_InstanceIndex];
+    AdGeometryVertex vertex = AdPullVertex(gl_VertexIndex, instance.meshId);
+    gl_Position = pc.viewProj * instance.model * vec4(vertex.position, 1.0);
+    // 假设实例只有均匀缩放
+    vNormal = mat3(instance.model) * vertex.normal;
+    vUV = vertex.uv;
+}
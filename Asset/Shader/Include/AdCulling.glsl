@@ -0,0 +1,51 @@
+#ifndef AD_CULLING_GLSL
+#define AD_CULLING_GLSL
+
+// 包围球对从 viewProj 提取的 6 个裁剪面做测试(Vulkan 深度 0..1), 球心与 viewProj 在同一空间
+bool AdIsSphereInFrustum(mat4 viewProj, vec3 center, float radius) {
+    mat4 m = transpose(viewProj);
+    vec4 planes[6] = vec4[6](m[3] + m[0], m[3] - m[0], m[3] + m[1], m[3] - m[1], m[2], m[3] - m[2]);
+    for (int i = 0; i < 6; i++) {
+        if (dot(planes[i].xyz, center) + planes[i].w < -radius * length(planes[i].xyz)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * 包围球与深度金字塔(Platform/Public/Graphic/AdVKDepthPyramid.h)比较, 被完全遮挡时返回 false
+ * 投影包围盒的 8 个角得到屏幕矩形和最近深度, 选矩形在其中最多跨 2x2 个 texel 的层级, 取 4 个角的最远深度
+ * 与近平面相交时保守地认为可见
+ */
+bool AdIsSphereVisibleInPyramid(mat4 viewProj, vec3 center, float radius, sampler2D depthPyramid) {
+    vec2 minUV = vec2(1.0);
+    vec2 maxUV = vec2(0.0);
+    float minDepth = 1.0;
+    for (int i = 0; i < 8; i++) {
+        vec3 corner = center + radius * vec3((i & 1) != 0 ? 1.0 : -1.0, (i & 2) != 0 ? 1.0 : -1.0,
+                                             (i & 4) != 0 ? 1.0 : -1.0);
+        vec4 clip = viewProj * vec4(corner, 1.0);
+        if (clip.w <= 1e-5) {
+            return true;
+        }
+        vec3 ndc = clip.xyz / clip.w;
+        minUV = min(minUV, ndc.xy * 0.5 + 0.5);
+        maxUV = max(maxUV, ndc.xy * 0.5 + 0.5);
+        minDepth = min(minDepth, ndc.z);
+    }
+    if (minDepth <= 0.0) {
+        return true;
+    }
+    minUV = clamp(minUV, vec2(0.0), vec2(1.0));
+    maxUV = clamp(maxUV, vec2(0.0), vec2(1.0));
+    vec2 size = (maxUV - minUV) * vec2(textureSize(depthPyramid, 0));
+    float level = ceil(log2(max(max(size.x, size.y), 1.0)));
+    float pyramidDepth = max(max(textureLod(depthPyramid, minUV, level).r,
+                                 textureLod(depthPyramid, vec2(maxUV.x, minUV.y), level).r),
+                             max(textureLod(depthPyramid, vec2(minUV.x, maxUV.y), level).r,
+                                 textureLod(depthPyramid, maxUV, level).r));
+    return minDepth <= pyramidDepth;
+}
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef AD_GEOMETRY_GLSL
+#define AD_GEOMETRY_GLSL
+
+#include "AdMesh.glsl"
+
+// 几何大缓冲的描述符集, 对应 Platform/Public/Graphic/AdVKGeometryBuffer.h
+#ifndef AD_GEOMETRY_SET
+#define AD_GEOMETRY_SET 0
+#endif
+
+#define AD_GEOMETRY_MAX_LOD_COUNT 8
+#define AD_GEOMETRY_INVALID_MESH_ID 0xffffffffu
+
+struct AdGeometryLod {
+    uint firstIndex;
+    uint indexCount;
+    float error;
+    uint reserved;
+};
+
+struct AdGeometryMesh {
+    AdMeshDequantize dq;
+    vec4 boundingSphere;    // 物体空间, xyz 球心, w 半径
+    uint firstVertex;
+    uint lodCount;
+    uint reserved0;
+    uint reserved1;
+    AdGeometryLod lods[AD_GEOMETRY_MAX_LOD_COUNT];
+};
+
+struct AdGeometryInstance {
+    mat4 model;
+    uint meshId;
+    uint materialId;
+    uint bucket;
+    uint reserved;
+};
+
+layout(std430, set = AD_GEOMETRY_SET, binding = 0) readonly buffer AdGeometryMeshes {
+    AdGeometryMesh geometryMeshes[];
+};
+layout(std430, set = AD_GEOMETRY_SET, binding = 1) readonly buffer AdGeometryPositions {
+    uvec2 geometryPositions[];      // unorm16x4
+};
+layout(std430, set = AD_GEOMETRY_SET, binding = 2) readonly buffer AdGeometryAttributes {
+    uvec2 geometryAttributes[];     // x: 八面体法线 snorm16x2, y: uv unorm16x2
+};
+
+struct AdGeometryVertex {
+    vec3 position;
+    vec3 normal;
+    vec2 uv;
+};
+
+// vertexIndex 是 gl_VertexIndex, 已经包含了绘制命令中的 vertexOffset
+AdGeometryVertex AdPullVertex(uint vertexIndex, uint meshId) {
+    AdMeshDequantize dq = geometryMeshes[meshId].dq;
+    uvec2 position = geometryPositions[vertexIndex];
+    uvec2 attribute = geometryAttributes[vertexIndex];
+    AdGeometryVertex vertex;
+    vertex.position = AdDecodePosition(vec4(unpackUnorm2x16(position.x), unpackUnorm2x16(position.y)), dq);
+    vertex.normal = AdDecodeNormal(unpackSnorm2x16(attribute.x));
+    vertex.uv = AdDecodeUV(unpackUnorm2x16(attribute.y), dq);
+    return vertex;
+}
+
+#endif
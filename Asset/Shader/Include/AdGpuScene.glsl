@@ -0,0 +1,35 @@
+#ifndef AD_GPU_SCENE_GLSL
+#define AD_GPU_SCENE_GLSL
+
+#include "AdGeometry.glsl"
+
+// 常驻 GPU 场景的描述符集, 对应 Platform/Public/Graphic/AdVKGpuScene.h
+#ifndef AD_SCENE_SET
+#define AD_SCENE_SET 1
+#endif
+
+struct AdDrawIndexedCommand {
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+};
+
+layout(std430, set = AD_SCENE_SET, binding = 0) readonly buffer AdSceneInstances {
+    AdGeometryInstance instances[];
+};
+layout(std430, set = AD_SCENE_SET, binding = 1) writeonly buffer AdSceneDrawCommands {
+    AdDrawIndexedCommand drawCommands[];
+};
+layout(std430, set = AD_SCENE_SET, binding = 2) buffer AdSceneDrawCounts {
+    uint drawCounts[];          // 每个桶一个
+};
+layout(std430, set = AD_SCENE_SET, binding = 3) readonly buffer AdSceneBucketOffsets {
+    uint bucketOffsets[];       // 每个桶在 drawCommands 中的起始位置
+};
+layout(std430, set = AD_SCENE_SET, binding = 4) buffer AdSceneInstanceVisibility {
+    uint instanceVisibility[];  // 上一帧遮挡剔除的结果, 1 为可见
+};
+
+#endif
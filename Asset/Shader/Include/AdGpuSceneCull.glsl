@@ -0,0 +1,87 @@
+#ifndef AD_GPU_SCENE_CULL_GLSL
+#define AD_GPU_SCENE_CULL_GLSL
+
+// GpuSceneCull.comp 和 GpuSceneOcclusionCull.comp 共用, 对应 AdVKGpuScene::CmdCull
+// 每个线程处理一个实例: 剔除, 按投影误差选 LOD, 把绘制命令追加到实例所在的桶
+#define AD_GEOMETRY_SET 0
+#define AD_SCENE_SET 1
+#include "AdGpuScene.glsl"
+#include "AdCulling.glsl"
+
+#ifndef AD_GPU_CULL_OCCLUSION
+#define AD_GPU_CULL_OCCLUSION 0
+#endif
+
+// 只绘制上一帧可见的实例(两阶段遮挡剔除的第一阶段)
+#define AD_GPU_CULL_FLAG_EARLY 1u
+
+layout(local_size_x = 64) in;
+
+layout(push_constant) uniform AdGpuCullPushConstants {
+    mat4 viewProj;
+    vec3 cameraPosition;
+    float projectionScale;      // 0 表示总是使用 LOD0
+    uint instanceCount;
+    float maxPixelError;
+    uint bucketCount;
+    uint flags;
+} pc;
+
+#if AD_GPU_CULL_OCCLUSION
+// 本帧第一阶段深度生成的金字塔
+layout(set = 2, binding = 0) uniform sampler2D depthPyramid;
+#endif
+
+void main() {
+    uint instanceId = gl_GlobalInvocationID.x;
+    if (instanceId >= pc.instanceCount) {
+        return;
+    }
+    AdGeometryInstance instance = instances[instanceId];
+    if (instance.meshId == AD_GEOMETRY_INVALID_MESH_ID || instance.bucket >= pc.bucketCount) {
+        return;
+    }
+    uint lodCount = geometryMeshes[instance.meshId].lodCount;
+    if (lodCount == 0) {
+        return;
+    }
+
+    vec4 sphere = geometryMeshes[instance.meshId].boundingSphere;
+    vec3 center = (instance.model * vec4(sphere.xyz, 1.0)).xyz;
+    float scale = max(length(instance.model[0].xyz), max(length(instance.model[1].xyz), length(instance.model[2].xyz)));
+    float radius = sphere.w * scale;
+    bool visible = AdIsSphereInFrustum(pc.viewProj, center, radius);
+#if AD_GPU_CULL_OCCLUSION
+    // 第二阶段: 记录本帧的可见性, 第一阶段已经画过的不再重复绘制
+    if (visible) {
+        visible = AdIsSphereVisibleInPyramid(pc.viewProj, center, radius, depthPyramid);
+    }
+    bool wasVisible = instanceVisibility[instanceId] != 0;
+    instanceVisibility[instanceId] = visible ? 1 : 0;
+    if (!visible || wasVisible) {
+        return;
+    }
+#else
+    if (!visible || ((pc.flags & AD_GPU_CULL_FLAG_EARLY) != 0 && instanceVisibility[instanceId] == 0)) {
+        return;
+    }
+#endif
+
+    // 与 SelectMeshLod 相同: 选误差投影到屏幕上不超过 maxPixelError 的最粗一级
+    uint lod = 0;
+    if (pc.projectionScale > 0.0) {
+        float distance = max(length(center - pc.cameraPosition) - radius, 1e-4);
+        float pixelsPerUnit = pc.projectionScale * scale / distance;
+        while (lod + 1 < lodCount
+               && geometryMeshes[instance.meshId].lods[lod + 1].error * pixelsPerUnit <= pc.maxPixelError) {
+            lod++;
+        }
+    }
+
+    AdGeometryLod meshLod = geometryMeshes[instance.meshId].lods[lod];
+    uint slot = atomicAdd(drawCounts[instance.bucket], 1);
+    drawCommands[bucketOffsets[instance.bucket] + slot] = AdDrawIndexedCommand(
+            meshLod.indexCount, 1, meshLod.firstIndex, int(geometryMeshes[instance.meshId].firstVertex), instanceId);
+}
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef AD_MESH_GLSL
+#define AD_MESH_GLSL
+
+// 量化网格顶点的反量化, 对应 Platform/Public/Asset/AdMeshFormat.h
+struct AdMeshDequantize {
+    vec4 positionScale;     // xyz
+    vec4 positionOffset;    // xyz
+    vec4 uvScaleOffset;     // xy scale, zw offset
+};
+
+vec3 AdDecodePosition(vec4 quantized, AdMeshDequantize dq) {
+    return quantized.xyz * dq.positionScale.xyz + dq.positionOffset.xyz;
+}
+
+vec3 AdDecodeNormal(vec2 encoded) {
+    vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float t = max(-n.z, 0.0);
+    n.xy += mix(vec2(t), vec2(-t), greaterThanEqual(n.xy, vec2(0.0)));
+    return normalize(n);
+}
+
+vec2 AdDecodeUV(vec2 quantized, AdMeshDequantize dq) {
+    return quantized * dq.uvScaleOffset.xy + dq.uvScaleOffset.zw;
+}
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef AD_MESHLET_GLSL
+#define AD_MESHLET_GLSL
+
+#include "AdMesh.glsl"
+#include "AdCulling.glsl"
+
+// 对应 Platform/Public/Asset/AdMeshFormat.h 中的 AdMeshlet, std430 下 64 字节
+struct AdMeshlet {
+    vec3 center;
+    float radius;
+    vec3 coneApex;
+    uint vertexOffset;
+    vec3 coneAxis;
+    float coneCutoff;
+    uint triangleOffset;
+    uint vertexCount;
+    uint triangleCount;
+    uint reserved;
+};
+
+// 对应 AdVKMeshletPass 的描述符布局
+layout(set = 0, binding = 0) uniform AdMeshletMeshInfo {
+    AdMeshDequantize dq;
+};
+layout(std430, set = 0, binding = 1) readonly buffer AdMeshletPositions {
+    uvec2 positions[];      // unorm16x4
+};
+layout(std430, set = 0, binding = 2) readonly buffer AdMeshletAttributes {
+    uvec2 attributes[];     // x: 八面体法线 snorm16x2, y: uv unorm16x2
+};
+layout(std430, set = 0, binding = 3) readonly buffer AdMeshletBuffer {
+    AdMeshlet meshlets[];
+};
+layout(std430, set = 0, binding = 4) readonly buffer AdMeshletVertices {
+    uint meshletVertices[];
+};
+layout(std430, set = 0, binding = 5) readonly buffer AdMeshletTriangles {
+    uint meshletTriangles[];    // 每个三角形 3 个 8 位局部索引
+};
+
+layout(push_constant) uniform AdMeshletPushConstants {
+    mat4 modelViewProj;
+    vec4 cameraPosition;    // 物体空间
+    uint meshletOffset;
+    uint meshletCount;
+} pc;
+
+uvec3 AdUnpackMeshletTriangle(uint packed) {
+    return uvec3(packed & 0xff, (packed >> 8) & 0xff, (packed >> 16) & 0xff);
+}
+
+vec3 AdLoadMeshletPosition(uint vertexIndex) {
+    uvec2 packed = positions[vertexIndex];
+    return AdDecodePosition(vec4(unpackUnorm2x16(packed.x), unpackUnorm2x16(packed.y)), dq);
+}
+
+/**
+ * 包围球在物体空间对 MVP 提取的裁剪面做测试
+ * 法线锥: 相机位于锥的背面时整簇不可见
+ */
+bool AdIsMeshletVisible(AdMeshlet meshlet) {
+    if (dot(normalize(meshlet.coneApex - pc.cameraPosition.xyz), meshlet.coneAxis) >= meshlet.coneCutoff) {
+        return false;
+    }
+    return AdIsSphereInFrustum(pc.modelViewProj, meshlet.center, meshlet.radius);
+}
+
+#endif
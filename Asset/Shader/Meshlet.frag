@@ -0,0 +1,12 @@
+#version 460
+
+layout(location = 0) in vec3 vNormal;
+layout(location = 1) in vec2 vUV;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    // 物体空间的简单方向光, 用于检查 meshlet 输出
+    float lambert = max(dot(normalize(vNormal), normalize(vec3(0.3, 0.8, 0.5))), 0.0);
+    outColor = vec4(vec3(0.1 + 0.9 * lambert), 1.0);
+}
@@ -0,0 +1,18 @@
+#version 460
+#extension GL_GOOGLE_include_directive : require
+
+#include "Include/AdMeshlet.glsl"
+
+// 量化顶点输入, 见 AdMesh::GetVertexInputDescription
+layout(location = 0) in vec4 inPosition;
+layout(location = 1) in vec2 inNormal;
+layout(location = 2) in vec2 inUV;
+
+layout(location = 0) out vec3 vNormal;
+layout(location = 1) out vec2 vUV;
+
+void main() {
+    gl_Position = pc.modelViewProj * vec4(AdDecodePosition(inPosition, dq), 1.0);
+    vNormal = AdDecodeNormal(inNormal);
+    vUV = AdDecodeUV(inUV, dq);
+}
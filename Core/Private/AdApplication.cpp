@@ -1,5 +1,145 @@
 #include "AdApplication.h"
+#include "AdLog.h"
+#include "Memory/AdMemoryTracker.h"
 
 namespace ade {
+    static const char *const STAGE_NAMES[] = {"Simulation", "Extract", "Culling", "Record", "Submit"};
 
-}
\ No newline at end of file
+    AdApplication::AdApplication(const AdApplicationSettings &settings) : mJobSystem(settings.jobSettings),
+                                                                          bRenderThread(settings.bRenderThread) {
+        for (uint32_t stage = 0; stage < static_cast<uint32_t>(AdFrameStage::Count); stage++) {
+            AdTaskGraph &graph = IsRenderStage(stage) ? mRenderGraph : mGameGraph;
+            mStageEndTasks[stage] = graph.AddTask(STAGE_NAMES[stage], nullptr);
+            // 只在同一线程的阶段之间串联
+            if (stage > 0 && IsRenderStage(stage) == IsRenderStage(stage - 1)) {
+                graph.AddDependency(mStageEndTasks[stage - 1], mStageEndTasks[stage]);
+            }
+        }
+
+        mRenderFrameCount = std::min(std::max(settings.renderFrameCount, 1u), MAX_RENDER_FRAMES);
+        if (!bRenderThread) {
+            mRenderFrameCount = 1;
+        }
+        for (uint32_t i = 0; i < mRenderFrameCount; i++) {
+            mRenderFrames[i] = std::make_unique<AdRenderFrame>();
+            mFreeFrames.TryPush(mRenderFrames[i].get());
+        }
+        if (bRenderThread) {
+            mRenderThread = std::thread(&AdApplication::RenderThreadMain, this);
+        }
+    }
+
+    AdApplication::~AdApplication() {
+        if (!bRenderThread) {
+            return;
+        }
+        Flush();
+        {
+            std::lock_guard<std::mutex> lock(mFrameMutex);
+            bStopRender = true;
+        }
+        mFrameCondition.notify_all();
+        mRenderThread.join();
+    }
+
+    uint32_t AdApplication::AddFrameTask(AdFrameStage stage, const std::string &name, AdTaskGraph::TaskFunc func) {
+        uint32_t stageIndex = static_cast<uint32_t>(stage);
+        bool bRenderStage = IsRenderStage(stageIndex);
+        AdTaskGraph &graph = bRenderStage ? mRenderGraph : mGameGraph;
+        // 任务在任意工作线程执行, 按阶段设置分配归属
+        if (func) {
+            AdMemoryTag tag = bRenderStage ? AdMemoryTag::Renderer : AdMemoryTag::Scene;
+            func = [tag, func = std::move(func)]() {
+                AdMemoryTagScope memoryTag(tag);
+                func();
+            };
+        }
+        uint32_t task = graph.AddTask(name, std::move(func));
+        if (stageIndex > 0 && IsRenderStage(stageIndex - 1) == bRenderStage) {
+            graph.AddDependency(mStageEndTasks[stageIndex - 1], task);
+        }
+        graph.AddDependency(task, mStageEndTasks[stageIndex]);
+        mFrameTasks.push_back({bRenderStage, task});
+        return static_cast<uint32_t>(mFrameTasks.size()) - 1;
+    }
+
+    void AdApplication::AddFrameDependency(uint32_t before, uint32_t after) {
+        if (before >= mFrameTasks.size() || after >= mFrameTasks.size()) {
+            LOG_E("Invalid frame task dependency {0} -> {1}", before, after);
+            return;
+        }
+        if (mFrameTasks[before].bRenderThread != mFrameTasks[after].bRenderThread) {
+            LOG_E("Frame task {0} and {1} run on different threads, pass data through AdRenderFrame.", before, after);
+            return;
+        }
+        AdTaskGraph &graph = mFrameTasks[before].bRenderThread ? mRenderGraph : mGameGraph;
+        graph.AddDependency(mFrameTasks[before].graphTask, mFrameTasks[after].graphTask);
+    }
+
+    AdRenderFrame *AdApplication::AcquireFrame() {
+        AdRenderFrame *frame = nullptr;
+        while (!mFreeFrames.TryPop(frame)) {
+            std::unique_lock<std::mutex> lock(mFrameMutex);
+            mFrameCondition.wait(lock, [this]() { return !mFreeFrames.IsEmpty(); });
+        }
+        return frame;
+    }
+
+    void AdApplication::RunFrame() {
+        AdRenderFrame *frame = AcquireFrame();
+        frame->Reset(mFrameIndex);
+        mGameFrame = frame;
+        mGameGraph.Run(mJobSystem);
+        mGameFrame = nullptr;
+        // 开启渲染线程时统计的是这段时间内两个线程的分配, 与帧边界大致对齐
+        AdMemoryTracker::EndFrame(mFrameIndex);
+        mFrameIndex++;
+
+        if (!bRenderThread) {
+            RenderFrame(frame);
+            mFreeFrames.TryPush(frame);
+            return;
+        }
+        // 帧数不超过队列容量, 不会失败; 在锁内放入, 等待方检查条件后不会错过通知
+        {
+            std::lock_guard<std::mutex> lock(mFrameMutex);
+            mReadyFrames.TryPush(frame);
+        }
+        mFrameCondition.notify_all();
+    }
+
+    void AdApplication::Flush() {
+        if (!bRenderThread) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mFrameMutex);
+        mFrameCondition.wait(lock, [this]() { return mFreeFrames.GetSize() == mRenderFrameCount; });
+    }
+
+    void AdApplication::RenderFrame(AdRenderFrame *frame) {
+        mRenderFrame = frame;
+        mRenderGraph.Run(mJobSystem);
+        mRenderFrame = nullptr;
+    }
+
+    void AdApplication::RenderThreadMain() {
+        AdMemoryTagScope memoryTag(AdMemoryTag::Renderer);
+        while (true) {
+            AdRenderFrame *frame = nullptr;
+            if (!mReadyFrames.TryPop(frame)) {
+                std::unique_lock<std::mutex> lock(mFrameMutex);
+                mFrameCondition.wait(lock, [this]() { return bStopRender || !mReadyFrames.IsEmpty(); });
+                if (mReadyFrames.IsEmpty()) {
+                    return;
+                }
+                continue;
+            }
+            RenderFrame(frame);
+            {
+                std::lock_guard<std::mutex> lock(mFrameMutex);
+                mFreeFrames.TryPush(frame);
+            }
+            mFrameCondition.notify_all();
+        }
+    }
+}
@@ -0,0 +1,91 @@
+#include "ECS/AdArchetype.h"
+#include "Memory/AdAlign.h"
+#include <new>
+
+namespace ade {
+
+    AdArchetype::AdArchetype(std::vector<uint32_t> componentTypes) : mComponentTypes(std::move(componentTypes)) {
+        uint32_t rowSize = sizeof(AdEntity);
+        for (uint32_t typeId: mComponentTypes) {
+            mMask.set(typeId);
+            rowSize += AdComponentRegistry::GetInfo(typeId).size;
+        }
+        mColumnOffsets.resize(mComponentTypes.size());
+        mColumnSizes.resize(mComponentTypes.size());
+
+        // 按每行大小估算容量, 加上每列的对齐后放不下时逐个减少; 单行超过块大小时块随之变大
+        uint32_t capacity = std::max(1u, CHUNK_SIZE / rowSize);
+        uint32_t usedSize;
+        while (true) {
+            usedSize = capacity * static_cast<uint32_t>(sizeof(AdEntity));
+            for (size_t column = 0; column < mComponentTypes.size(); column++) {
+                const AdComponentInfo &info = AdComponentRegistry::GetInfo(mComponentTypes[column]);
+                usedSize = static_cast<uint32_t>(AlignUp(usedSize, std::max(info.alignment, COLUMN_ALIGNMENT)));
+                mColumnOffsets[column] = usedSize;
+                mColumnSizes[column] = info.size;
+                usedSize += capacity * info.size;
+            }
+            if (usedSize <= CHUNK_SIZE || capacity == 1) {
+                break;
+            }
+            capacity--;
+        }
+        mChunkCapacity = capacity;
+        mChunkSize = std::max(CHUNK_SIZE, static_cast<uint32_t>(AlignUp(usedSize, COLUMN_ALIGNMENT)));
+    }
+
+    AdArchetype::~AdArchetype() {
+        for (Chunk &chunk: mChunks) {
+            for (size_t column = 0; column < mComponentTypes.size(); column++) {
+                const AdComponentInfo &info = AdComponentRegistry::GetInfo(mComponentTypes[column]);
+                for (uint32_t row = 0; row < chunk.count; row++) {
+                    info.destruct(chunk.data + mColumnOffsets[column] + size_t(row) * info.size);
+                }
+            }
+            ::operator delete(chunk.data, std::align_val_t(COLUMN_ALIGNMENT));
+        }
+    }
+
+    int32_t AdArchetype::GetColumn(uint32_t typeId) const {
+        if (typeId >= AD_MAX_COMPONENT_TYPES || !mMask.test(typeId)) {
+            return -1;
+        }
+        auto it = std::lower_bound(mComponentTypes.begin(), mComponentTypes.end(), typeId);
+        return static_cast<int32_t>(it - mComponentTypes.begin());
+    }
+
+    void AdArchetype::AllocateRow(AdEntity entity, uint32_t &outChunk, uint32_t &outRow) {
+        if (mChunks.empty() || mChunks.back().count == mChunkCapacity) {
+            Chunk chunk{};
+            chunk.data = static_cast<uint8_t *>(::operator new(mChunkSize, std::align_val_t(COLUMN_ALIGNMENT)));
+            mChunks.push_back(chunk);
+        }
+        outChunk = static_cast<uint32_t>(mChunks.size() - 1);
+        Chunk &chunk = mChunks.back();
+        outRow = chunk.count++;
+        GetEntities(outChunk)[outRow] = entity;
+        mEntityCount++;
+    }
+
+    AdEntity AdArchetype::RemoveRow(uint32_t chunk, uint32_t row) {
+        uint32_t lastChunk = static_cast<uint32_t>(mChunks.size() - 1);
+        uint32_t lastRow = mChunks[lastChunk].count - 1;
+        AdEntity moved;
+        if (chunk != lastChunk || row != lastRow) {
+            for (size_t column = 0; column < mComponentTypes.size(); column++) {
+                const AdComponentInfo &info = AdComponentRegistry::GetInfo(mComponentTypes[column]);
+                void *src = GetComponent(lastChunk, lastRow, static_cast<uint32_t>(column));
+                info.moveConstruct(GetComponent(chunk, row, static_cast<uint32_t>(column)), src);
+                info.destruct(src);
+            }
+            moved = GetEntities(lastChunk)[lastRow];
+            GetEntities(chunk)[row] = moved;
+        }
+        mEntityCount--;
+        if (--mChunks[lastChunk].count == 0) {
+            ::operator delete(mChunks[lastChunk].data, std::align_val_t(COLUMN_ALIGNMENT));
+            mChunks.pop_back();
+        }
+        return moved;
+    }
+}
@@ -0,0 +1,29 @@
+#include "ECS/AdComponent.h"
+#include "AdLog.h"
+#include <mutex>
+
+namespace ade {
+    // 固定大小, 注册新类型时已有的引用不会失效
+    static AdComponentInfo sComponentInfos[AD_MAX_COMPONENT_TYPES];
+    static uint32_t sComponentTypeCount = 0;
+    static std::mutex sRegistryMutex;
+
+    uint32_t AdComponentRegistry::Register(const AdComponentInfo &info) {
+        std::lock_guard<std::mutex> lock(sRegistryMutex);
+        if (sComponentTypeCount >= AD_MAX_COMPONENT_TYPES) {
+            LOG_E("Too many component types, max is {0}", AD_MAX_COMPONENT_TYPES);
+            return UINT32_MAX;
+        }
+        sComponentInfos[sComponentTypeCount] = info;
+        return sComponentTypeCount++;
+    }
+
+    const AdComponentInfo &AdComponentRegistry::GetInfo(uint32_t typeId) {
+        return sComponentInfos[typeId];
+    }
+
+    uint32_t AdComponentRegistry::GetTypeCount() {
+        std::lock_guard<std::mutex> lock(sRegistryMutex);
+        return sComponentTypeCount;
+    }
+}
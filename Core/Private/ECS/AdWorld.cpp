@@ -0,0 +1,194 @@
+#include "ECS/AdWorld.h"
+#include "AdLog.h"
+
+namespace ade {
+
+    AdWorld::AdWorld() {
+        // 原型 0 为没有组件的实体
+        GetOrCreateArchetype({});
+    }
+
+    const AdWorld::EntityRecord *AdWorld::FindRecord(AdEntity entity) const {
+        if (entity.index >= mRecords.size()) {
+            return nullptr;
+        }
+        const EntityRecord &record = mRecords[entity.index];
+        if (record.archetype == UINT32_MAX || record.generation != entity.generation) {
+            return nullptr;
+        }
+        return &record;
+    }
+
+    bool AdWorld::IsAlive(AdEntity entity) const {
+        return FindRecord(entity) != nullptr;
+    }
+
+    uint32_t AdWorld::GetOrCreateArchetype(std::vector<uint32_t> componentTypes) {
+        auto it = mArchetypeLookup.find(componentTypes);
+        if (it != mArchetypeLookup.end()) {
+            return it->second;
+        }
+        uint32_t index = static_cast<uint32_t>(mArchetypes.size());
+        mArchetypes.push_back(std::make_unique<AdArchetype>(componentTypes));
+        mArchetypeLookup.emplace(std::move(componentTypes), index);
+        return index;
+    }
+
+    AdEntity AdWorld::CreateEntity() {
+        return CreateEntityRaw({});
+    }
+
+    AdEntity AdWorld::CreateEntityRaw(std::vector<uint32_t> componentTypes) {
+        for (uint32_t typeId: componentTypes) {
+            if (typeId >= AD_MAX_COMPONENT_TYPES) {
+                LOG_E("Create entity with invalid component type {0}", typeId);
+                return {};
+            }
+        }
+        std::sort(componentTypes.begin(), componentTypes.end());
+        componentTypes.erase(std::unique(componentTypes.begin(), componentTypes.end()), componentTypes.end());
+
+        AdEntity entity;
+        if (!mFreeIndices.empty()) {
+            entity.index = mFreeIndices.back();
+            mFreeIndices.pop_back();
+        } else {
+            entity.index = static_cast<uint32_t>(mRecords.size());
+            mRecords.emplace_back();
+        }
+        EntityRecord &record = mRecords[entity.index];
+        entity.generation = record.generation;
+        record.archetype = GetOrCreateArchetype(std::move(componentTypes));
+
+        AdArchetype *archetype = mArchetypes[record.archetype].get();
+        archetype->AllocateRow(entity, record.chunk, record.row);
+        for (uint32_t column = 0; column < archetype->GetComponentTypes().size(); column++) {
+            AdComponentRegistry::GetInfo(archetype->GetComponentTypes()[column]).construct(
+                    archetype->GetComponent(record.chunk, record.row, column));
+        }
+        mAliveCount++;
+        mStructureVersion++;
+        return entity;
+    }
+
+    void AdWorld::DestroyEntity(AdEntity entity) {
+        const EntityRecord *found = FindRecord(entity);
+        if (!found) {
+            return;
+        }
+        EntityRecord &record = mRecords[entity.index];
+        AdArchetype *archetype = mArchetypes[record.archetype].get();
+        for (uint32_t column = 0; column < archetype->GetComponentTypes().size(); column++) {
+            AdComponentRegistry::GetInfo(archetype->GetComponentTypes()[column]).destruct(
+                    archetype->GetComponent(record.chunk, record.row, column));
+        }
+        RemoveRow(record);
+        record.archetype = UINT32_MAX;
+        record.generation++;
+        mFreeIndices.push_back(entity.index);
+        mAliveCount--;
+        mStructureVersion++;
+    }
+
+    void AdWorld::RemoveRow(const EntityRecord &record) {
+        AdEntity moved = mArchetypes[record.archetype]->RemoveRow(record.chunk, record.row);
+        if (moved.IsValid()) {
+            mRecords[moved.index].chunk = record.chunk;
+            mRecords[moved.index].row = record.row;
+        }
+    }
+
+    void AdWorld::MoveEntity(AdEntity entity, uint32_t targetArchetype) {
+        EntityRecord &record = mRecords[entity.index];
+        AdArchetype *source = mArchetypes[record.archetype].get();
+        AdArchetype *target = mArchetypes[targetArchetype].get();
+        uint32_t chunk, row;
+        target->AllocateRow(entity, chunk, row);
+        for (uint32_t column = 0; column < target->GetComponentTypes().size(); column++) {
+            uint32_t typeId = target->GetComponentTypes()[column];
+            const AdComponentInfo &info = AdComponentRegistry::GetInfo(typeId);
+            int32_t sourceColumn = source->GetColumn(typeId);
+            if (sourceColumn >= 0) {
+                info.moveConstruct(target->GetComponent(chunk, row, column),
+                                   source->GetComponent(record.chunk, record.row, sourceColumn));
+            } else {
+                info.construct(target->GetComponent(chunk, row, column));
+            }
+        }
+        for (uint32_t column = 0; column < source->GetComponentTypes().size(); column++) {
+            AdComponentRegistry::GetInfo(source->GetComponentTypes()[column]).destruct(
+                    source->GetComponent(record.chunk, record.row, column));
+        }
+        RemoveRow(record);
+        record.archetype = targetArchetype;
+        record.chunk = chunk;
+        record.row = row;
+        mStructureVersion++;
+    }
+
+    void *AdWorld::AddComponentRaw(AdEntity entity, uint32_t typeId) {
+        const EntityRecord *record = FindRecord(entity);
+        if (!record || typeId >= AD_MAX_COMPONENT_TYPES) {
+            LOG_E("Add component {0} to invalid entity {1}", typeId, entity.index);
+            return nullptr;
+        }
+        AdArchetype *source = mArchetypes[record->archetype].get();
+        int32_t column = source->GetColumn(typeId);
+        if (column >= 0) {
+            return source->GetComponent(record->chunk, record->row, column);
+        }
+
+        uint32_t target;
+        auto edge = source->addEdges.find(typeId);
+        if (edge != source->addEdges.end()) {
+            target = edge->second;
+        } else {
+            std::vector<uint32_t> types = source->GetComponentTypes();
+            types.insert(std::lower_bound(types.begin(), types.end(), typeId), typeId);
+            target = GetOrCreateArchetype(std::move(types));
+            // 创建原型可能使 source 所在的数组扩容, 但原型本身在堆上, 指针不变
+            source->addEdges[typeId] = target;
+            mArchetypes[target]->removeEdges[typeId] = record->archetype;
+        }
+        MoveEntity(entity, target);
+        AdArchetype *archetype = mArchetypes[target].get();
+        return archetype->GetComponent(record->chunk, record->row, archetype->GetColumn(typeId));
+    }
+
+    void AdWorld::RemoveComponentRaw(AdEntity entity, uint32_t typeId) {
+        const EntityRecord *record = FindRecord(entity);
+        if (!record) {
+            return;
+        }
+        AdArchetype *source = mArchetypes[record->archetype].get();
+        if (source->GetColumn(typeId) < 0) {
+            return;
+        }
+
+        uint32_t target;
+        auto edge = source->removeEdges.find(typeId);
+        if (edge != source->removeEdges.end()) {
+            target = edge->second;
+        } else {
+            std::vector<uint32_t> types = source->GetComponentTypes();
+            types.erase(std::lower_bound(types.begin(), types.end(), typeId));
+            target = GetOrCreateArchetype(std::move(types));
+            source->removeEdges[typeId] = target;
+            mArchetypes[target]->addEdges[typeId] = record->archetype;
+        }
+        MoveEntity(entity, target);
+    }
+
+    void *AdWorld::GetComponentRaw(AdEntity entity, uint32_t typeId) const {
+        const EntityRecord *record = FindRecord(entity);
+        if (!record) {
+            return nullptr;
+        }
+        const AdArchetype *archetype = mArchetypes[record->archetype].get();
+        int32_t column = archetype->GetColumn(typeId);
+        if (column < 0) {
+            return nullptr;
+        }
+        return archetype->GetComponent(record->chunk, record->row, column);
+    }
+}
@@ -0,0 +1,231 @@
+#include "Job/AdJobSystem.h"
+#include "AdLog.h"
+#include "Memory/AdLinearAllocator.h"
+
+#ifdef AD_ENGINE_PLATFORM_WIN32
+#include <windows.h>
+#elif AD_ENGINE_PLATFORM_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ade {
+    static thread_local const AdJobSystem *tJobSystem = nullptr;
+    static thread_local uint32_t tQueueIndex = UINT32_MAX;
+    static thread_local uint32_t tStealSeed = 0;
+
+    // 空闲时放弃时间片重试的次数, 之后才睡眠
+    static constexpr uint32_t IDLE_SPIN_COUNT = 64;
+
+    static void PinThread(std::thread &thread, uint32_t core) {
+#ifdef AD_ENGINE_PLATFORM_WIN32
+        SetThreadAffinityMask(static_cast<HANDLE>(thread.native_handle()), DWORD_PTR(1) << (core % 64));
+#elif AD_ENGINE_PLATFORM_LINUX
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(core % CPU_SETSIZE, &cpuSet);
+        if (pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuSet) != 0) {
+            LOG_W("Failed to pin job worker to core {0}", core);
+        }
+#else
+        // macOS 没有绑定核心的接口
+        (void) thread;
+        (void) core;
+#endif
+    }
+
+    AdJobSystem::AdJobSystem(const AdJobSystemSettings &settings) {
+        uint32_t workerCount = settings.workerCount;
+        if (workerCount == 0) {
+            workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+        }
+        // 创建线程 + 工作线程 + 外部线程
+        for (uint32_t i = 0; i < workerCount + 2; i++) {
+            mQueues.push_back(std::make_unique<WorkerQueue>());
+        }
+        tJobSystem = this;
+        tQueueIndex = 0;
+        for (uint32_t i = 1; i <= workerCount; i++) {
+            mThreads.emplace_back(&AdJobSystem::WorkerMain, this, i);
+            if (settings.bPinWorkers) {
+                PinThread(mThreads.back(), i);
+            }
+        }
+    }
+
+    AdJobSystem::~AdJobSystem() {
+        bStop.store(true, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(mSleepMutex);
+            mSleepCondition.notify_all();
+        }
+        for (auto &thread: mThreads) {
+            thread.join();
+        }
+        // 执行剩下的任务, 保证闭包被析构、计数归零
+        while (AdJob *job = FindJob(0)) {
+            Execute(job);
+        }
+        if (tJobSystem == this) {
+            tJobSystem = nullptr;
+            tQueueIndex = UINT32_MAX;
+        }
+    }
+
+    uint32_t AdJobSystem::GetQueueIndex() const {
+        return tJobSystem == this ? tQueueIndex : UINT32_MAX;
+    }
+
+    AdJob *AdJobSystem::AllocateJob() {
+        uint32_t queueIndex = GetQueueIndex();
+        WorkerQueue *queue = queueIndex == UINT32_MAX ? mQueues.back().get() : mQueues[queueIndex].get();
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock;
+                if (queueIndex == UINT32_MAX) {
+                    lock = std::unique_lock<std::mutex>(mExternalMutex);
+                }
+                // 槽位只由所属线程占用, 执行完的任务在任意线程释放
+                for (uint32_t i = 0; i < MAX_JOBS_PER_THREAD; i++) {
+                    AdJob *job = &queue->jobs[queue->nextJob++ & (MAX_JOBS_PER_THREAD - 1)];
+                    if (!job->bInUse.load(std::memory_order_acquire)) {
+                        job->bInUse.store(true, std::memory_order_relaxed);
+                        return job;
+                    }
+                }
+            }
+            // 槽位全部在用: 先执行排队的任务腾出槽位
+            if (AdJob *job = FindJob(queueIndex)) {
+                Execute(job);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void AdJobSystem::Schedule(AdJob *job) {
+        uint32_t queueIndex = GetQueueIndex();
+        if (queueIndex == UINT32_MAX || !mQueues[queueIndex]->deque.Push(job)) {
+            std::lock_guard<std::mutex> lock(mExternalMutex);
+            mExternalJobs.push_back(job);
+            mExternalJobCount.fetch_add(1, std::memory_order_release);
+        }
+        mWakeEpoch.fetch_add(1, std::memory_order_seq_cst);
+        if (mSleepingCount.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lock(mSleepMutex);
+            mSleepCondition.notify_one();
+        }
+    }
+
+    void AdJobSystem::AddContinuation(AdJobCounter *dependency, AdJob *job) {
+        {
+            std::lock_guard<std::mutex> lock(dependency->mMutex);
+            // 只剩最低位时依赖的任务都已完成, 正在被取出的列表不会再包含新加入的任务
+            if (dependency->mState.load(std::memory_order_acquire) >= 2) {
+                dependency->mContinuations.push_back(job);
+                return;
+            }
+        }
+        Schedule(job);
+    }
+
+    AdJob *AdJobSystem::FindJob(uint32_t queueIndex) {
+        AdJob *job = nullptr;
+        if (queueIndex != UINT32_MAX && mQueues[queueIndex]->deque.Pop(job)) {
+            return job;
+        }
+        if (mExternalJobCount.load(std::memory_order_acquire) > 0) {
+            std::lock_guard<std::mutex> lock(mExternalMutex);
+            if (!mExternalJobs.empty()) {
+                job = mExternalJobs.front();
+                mExternalJobs.pop_front();
+                mExternalJobCount.fetch_sub(1, std::memory_order_relaxed);
+                return job;
+            }
+        }
+        // 从随机位置开始窃取, 避免所有线程挤在同一个队列上
+        uint32_t stealCount = static_cast<uint32_t>(mQueues.size()) - 1;
+        if (tStealSeed == 0) {
+            tStealSeed = static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1u;
+        }
+        tStealSeed ^= tStealSeed << 13;
+        tStealSeed ^= tStealSeed >> 17;
+        tStealSeed ^= tStealSeed << 5;
+        for (uint32_t i = 0; i < stealCount; i++) {
+            uint32_t victim = (tStealSeed + i) % stealCount;
+            if (victim != queueIndex && mQueues[victim]->deque.Steal(job)) {
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    void AdJobSystem::Execute(AdJob *job) {
+        AdJobCounter *counter = job->counter;
+        job->invoke(job);
+        job->bInUse.store(false, std::memory_order_release);
+        if (!counter) {
+            return;
+        }
+        // 不是最后一个任务时减一后就不再访问 counter; 最后一个任务先置上最低位, 取出后续任务后再清零
+        uint32_t state = counter->mState.load(std::memory_order_relaxed);
+        while (!counter->mState.compare_exchange_weak(state, state == 2 ? 1 : state - 2, std::memory_order_acq_rel,
+                                                      std::memory_order_relaxed)) {
+        }
+        if (state != 2) {
+            return;
+        }
+        // 复制到线程临时内存后清空, 计数的列表保留容量, 复用时不再分配
+        AdScratchScope scratch;
+        AdJob **continuations;
+        size_t continuationCount;
+        {
+            std::lock_guard<std::mutex> lock(counter->mMutex);
+            continuationCount = counter->mContinuations.size();
+            continuations = scratch.AllocateArray<AdJob *>(continuationCount);
+            std::copy(counter->mContinuations.begin(), counter->mContinuations.end(), continuations);
+            counter->mContinuations.clear();
+        }
+        counter->mState.fetch_sub(1, std::memory_order_release);
+        for (size_t i = 0; i < continuationCount; i++) {
+            Schedule(continuations[i]);
+        }
+    }
+
+    void AdJobSystem::Wait(AdJobCounter *counter) {
+        uint32_t queueIndex = GetQueueIndex();
+        while (!counter->IsDone()) {
+            if (AdJob *job = FindJob(queueIndex)) {
+                Execute(job);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void AdJobSystem::WorkerMain(uint32_t queueIndex) {
+        tJobSystem = this;
+        tQueueIndex = queueIndex;
+        uint32_t idleCount = 0;
+        while (!bStop.load(std::memory_order_acquire)) {
+            uint64_t epoch = mWakeEpoch.load(std::memory_order_seq_cst);
+            if (AdJob *job = FindJob(queueIndex)) {
+                Execute(job);
+                idleCount = 0;
+                continue;
+            }
+            if (++idleCount < IDLE_SPIN_COUNT) {
+                std::this_thread::yield();
+                continue;
+            }
+            // 睡眠前登记, 提交者看到登记才通知; 期间有新任务提交时 epoch 已变化, 不会睡眠
+            std::unique_lock<std::mutex> lock(mSleepMutex);
+            mSleepingCount.fetch_add(1, std::memory_order_seq_cst);
+            mSleepCondition.wait(lock, [this, epoch]() {
+                return bStop.load(std::memory_order_acquire) || mWakeEpoch.load(std::memory_order_seq_cst) != epoch;
+            });
+            mSleepingCount.fetch_sub(1, std::memory_order_relaxed);
+            idleCount = 0;
+        }
+    }
+}
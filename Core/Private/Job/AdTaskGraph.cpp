@@ -0,0 +1,90 @@
+#include "Job/AdTaskGraph.h"
+#include "AdLog.h"
+
+namespace ade {
+
+    uint32_t AdTaskGraph::AddTask(const std::string &name, TaskFunc func) {
+        mTasks.push_back({name, std::move(func), {}, 0});
+        bValidated = false;
+        return static_cast<uint32_t>(mTasks.size()) - 1;
+    }
+
+    void AdTaskGraph::AddDependency(uint32_t before, uint32_t after) {
+        if (before >= mTasks.size() || after >= mTasks.size() || before == after) {
+            LOG_E("Invalid task dependency {0} -> {1}", before, after);
+            return;
+        }
+        mTasks[before].successors.push_back(after);
+        mTasks[after].dependencyCount++;
+        bValidated = false;
+    }
+
+    void AdTaskGraph::Clear() {
+        mTasks.clear();
+        mPendingCounts.reset();
+        bValidated = false;
+    }
+
+    bool AdTaskGraph::Validate() {
+        if (bValidated) {
+            return bValid;
+        }
+        // 拓扑排序能取出全部任务即无环
+        std::vector<uint32_t> counts(mTasks.size());
+        std::vector<uint32_t> ready;
+        for (uint32_t i = 0; i < mTasks.size(); i++) {
+            counts[i] = mTasks[i].dependencyCount;
+            if (counts[i] == 0) {
+                ready.push_back(i);
+            }
+        }
+        uint32_t visited = 0;
+        while (!ready.empty()) {
+            uint32_t task = ready.back();
+            ready.pop_back();
+            visited++;
+            for (uint32_t successor: mTasks[task].successors) {
+                if (--counts[successor] == 0) {
+                    ready.push_back(successor);
+                }
+            }
+        }
+        bValid = visited == mTasks.size();
+        if (!bValid) {
+            LOG_E("Task graph has a dependency cycle.");
+        }
+        mPendingCounts = std::make_unique<std::atomic<uint32_t>[]>(mTasks.size());
+        bValidated = true;
+        return bValid;
+    }
+
+    void AdTaskGraph::RunTask(AdJobSystem &jobSystem, AdJobCounter &counter, uint32_t task) {
+        jobSystem.Run([this, &jobSystem, &counter, task]() {
+            if (mTasks[task].func) {
+                mTasks[task].func();
+            }
+            // 后继在本任务的计数减一之前调度, counter 不会提前归零
+            for (uint32_t successor: mTasks[task].successors) {
+                if (mPendingCounts[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    RunTask(jobSystem, counter, successor);
+                }
+            }
+        }, &counter);
+    }
+
+    void AdTaskGraph::Run(AdJobSystem &jobSystem) {
+        if (!Validate()) {
+            return;
+        }
+        for (uint32_t i = 0; i < mTasks.size(); i++) {
+            mPendingCounts[i].store(mTasks[i].dependencyCount, std::memory_order_relaxed);
+        }
+        AdJobCounter counter;
+        for (uint32_t i = 0; i < mTasks.size(); i++) {
+            if (mTasks[i].dependencyCount == 0) {
+                RunTask(jobSystem, counter, i);
+            }
+        }
+        jobSystem.Wait(&counter);
+    }
+}
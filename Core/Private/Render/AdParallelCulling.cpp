@@ -0,0 +1,86 @@
+#include "Render/AdParallelCulling.h"
+#include "Culling/AdCullingSimd.h"
+
+namespace ade {
+
+    // 分段边界对齐到 SIMD 宽度, 每段整组读取
+    static uint32_t AlignBatchSize(uint32_t batchSize) {
+        batchSize = std::max(batchSize, AD_LANE_COUNT);
+        return (batchSize + AD_LANE_COUNT - 1) / AD_LANE_COUNT * AD_LANE_COUNT;
+    }
+
+    // 第 i 段的结果在 indices + i * batchSize, 数量为 counts[i * stride], 依次前移拼接
+    static uint32_t CompactBatches(uint32_t *indices, const uint32_t *counts, uint32_t stride, uint32_t batchCount,
+                                   uint32_t batchSize) {
+        uint32_t total = 0;
+        for (uint32_t batch = 0; batch < batchCount; batch++) {
+            uint32_t count = counts[size_t(batch) * stride];
+            const uint32_t *source = indices + size_t(batch) * batchSize;
+            if (source != indices + total) {
+                std::copy(source, source + count, indices + total);
+            }
+            total += count;
+        }
+        return total;
+    }
+
+    uint32_t ParallelCull(AdJobSystem &jobSystem, const AdFrustumCuller &culler, const AdFrustum &frustum,
+                          uint32_t *outIndices, uint32_t batchSize) {
+        uint32_t count = 0;
+        ParallelCullViews(jobSystem, culler, &frustum, 1, &outIndices, &count, batchSize);
+        return count;
+    }
+
+    void ParallelCullViews(AdJobSystem &jobSystem, const AdFrustumCuller &culler, const AdFrustum *frustums,
+                           uint32_t viewCount, uint32_t *const *outIndices, uint32_t *outCounts,
+                           uint32_t batchSize) {
+        uint32_t count = culler.GetCount();
+        batchSize = AlignBatchSize(batchSize);
+        if (count <= batchSize) {
+            culler.CullViews(frustums, viewCount, 0, count, outIndices, outCounts);
+            return;
+        }
+
+        uint32_t batchCount = (count + batchSize - 1) / batchSize;
+        std::vector<uint32_t> batchCounts(size_t(batchCount) * viewCount);
+        jobSystem.ParallelFor(count, batchSize, [&](uint32_t begin, uint32_t end) {
+            uint32_t batch = begin / batchSize;
+            // CullViews 的输出指针和数量都是按视图的数组
+            uint32_t *batchIndices[AdFrustumCuller::MAX_VIEW_COUNT];
+            for (uint32_t view = 0; view < viewCount; view += AdFrustumCuller::MAX_VIEW_COUNT) {
+                uint32_t groupCount = std::min(AdFrustumCuller::MAX_VIEW_COUNT, viewCount - view);
+                for (uint32_t i = 0; i < groupCount; i++) {
+                    batchIndices[i] = outIndices[view + i] + begin;
+                }
+                culler.CullViews(frustums + view, groupCount, begin, end, batchIndices,
+                                 &batchCounts[size_t(batch) * viewCount + view]);
+            }
+        });
+        for (uint32_t view = 0; view < viewCount; view++) {
+            outCounts[view] = CompactBatches(outIndices[view], &batchCounts[view], viewCount, batchCount, batchSize);
+        }
+    }
+
+    void ParallelRasterize(AdJobSystem &jobSystem, AdSoftwareOcclusion &occlusion, uint32_t batchSize) {
+        jobSystem.ParallelFor(occlusion.GetTileCount(), batchSize, [&occlusion](uint32_t begin, uint32_t end) {
+            occlusion.RasterizeTiles(begin, end);
+        });
+    }
+
+    uint32_t ParallelCullBoxes(AdJobSystem &jobSystem, const AdSoftwareOcclusion &occlusion,
+                               const AdBoundingBox *boxes, uint32_t count, uint32_t *outVisibleIndices,
+                               uint32_t baseIndex, uint32_t batchSize) {
+        batchSize = AlignBatchSize(batchSize);
+        if (count <= batchSize) {
+            return occlusion.CullBoxes(boxes, count, outVisibleIndices, baseIndex);
+        }
+
+        uint32_t batchCount = (count + batchSize - 1) / batchSize;
+        std::vector<uint32_t> batchCounts(batchCount);
+        jobSystem.ParallelFor(count, batchSize, [&](uint32_t begin, uint32_t end) {
+            batchCounts[begin / batchSize] = occlusion.CullBoxes(boxes + begin, end - begin,
+                                                                 outVisibleIndices + begin, baseIndex + begin);
+        });
+        return CompactBatches(outVisibleIndices, batchCounts.data(), 1, batchCount, batchSize);
+    }
+}
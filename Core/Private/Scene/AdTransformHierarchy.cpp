@@ -0,0 +1,236 @@
+#include "Scene/AdTransformHierarchy.h"
+#include "AdLog.h"
+
+namespace ade {
+
+    static AdMat4 ComposeMatrix(const AdLocalTransform &local) {
+        return AdMat4::TRS(AdVec3(local.position), AdQuat(local.rotation), AdVec3(local.scale));
+    }
+
+    void AdTransformHierarchy::LinkChild(uint32_t parent, uint32_t node) {
+        mNodeParents[node] = parent;
+        mPrevSiblings[node] = INVALID;
+        mNextSiblings[node] = INVALID;
+        if (parent == INVALID) {
+            return;
+        }
+        uint32_t first = mFirstChildren[parent];
+        mNextSiblings[node] = first;
+        if (first != INVALID) {
+            mPrevSiblings[first] = node;
+        }
+        mFirstChildren[parent] = node;
+    }
+
+    void AdTransformHierarchy::UnlinkChild(uint32_t node) {
+        uint32_t parent = mNodeParents[node];
+        if (parent == INVALID) {
+            return;
+        }
+        uint32_t prev = mPrevSiblings[node];
+        uint32_t next = mNextSiblings[node];
+        if (prev != INVALID) {
+            mNextSiblings[prev] = next;
+        } else {
+            mFirstChildren[parent] = next;
+        }
+        if (next != INVALID) {
+            mPrevSiblings[next] = prev;
+        }
+        mNodeParents[node] = INVALID;
+        mPrevSiblings[node] = INVALID;
+        mNextSiblings[node] = INVALID;
+    }
+
+    uint32_t AdTransformHierarchy::CreateNode(uint32_t parent, const AdLocalTransform &local) {
+        if (parent != INVALID && !IsValid(parent)) {
+            LOG_E("Create transform node with invalid parent {0}", parent);
+            return INVALID;
+        }
+        uint32_t node;
+        if (!mFreeNodes.empty()) {
+            node = mFreeNodes.back();
+            mFreeNodes.pop_back();
+        } else {
+            node = static_cast<uint32_t>(mNodeToIndex.size());
+            mNodeToIndex.push_back(INVALID);
+            mNodeParents.push_back(INVALID);
+            mFirstChildren.push_back(INVALID);
+            mNextSiblings.push_back(INVALID);
+            mPrevSiblings.push_back(INVALID);
+        }
+        mFirstChildren[node] = INVALID;
+        LinkChild(parent, node);
+
+        uint32_t index = static_cast<uint32_t>(mIndexToNode.size());
+        uint32_t parentIndex = parent == INVALID ? INVALID : mNodeToIndex[parent];
+        uint32_t depth = parent == INVALID ? 0 : mDepths[parentIndex] + 1;
+        mNodeToIndex[node] = index;
+        mIndexToNode.push_back(node);
+        mParentIndices.push_back(parentIndex);
+        mLocals.push_back(local);
+        mWorlds.emplace_back();
+        mLocalDirty.push_back(1);
+        mWorldChanged.push_back(0);
+        mDepths.push_back(depth);
+        mNodeCount++;
+
+        // 按深度顺序追加时(例如逐层加载场景)不需要重新排序
+        uint32_t levelCount = GetLevelCount();
+        if (!bOrderDirty && levelCount > 0 && depth == levelCount - 1) {
+            mLevelOffsets.back()++;
+        } else if (!bOrderDirty && depth == levelCount) {
+            mLevelOffsets.push_back(index + 1);
+        } else {
+            bOrderDirty = true;
+        }
+        return node;
+    }
+
+    void AdTransformHierarchy::DestroyNode(uint32_t node) {
+        if (!IsValid(node)) {
+            return;
+        }
+        UnlinkChild(node);
+        // 子树中的句柄全部释放, 存储数组中的位置留到下一次排序时回收
+        std::vector<uint32_t> stack = {node};
+        while (!stack.empty()) {
+            uint32_t current = stack.back();
+            stack.pop_back();
+            for (uint32_t child = mFirstChildren[current]; child != INVALID; child = mNextSiblings[child]) {
+                stack.push_back(child);
+            }
+            mNodeToIndex[current] = INVALID;
+            mNodeParents[current] = INVALID;
+            mFirstChildren[current] = INVALID;
+            mNextSiblings[current] = INVALID;
+            mPrevSiblings[current] = INVALID;
+            mFreeNodes.push_back(current);
+            mNodeCount--;
+        }
+        bOrderDirty = true;
+    }
+
+    void AdTransformHierarchy::SetParent(uint32_t node, uint32_t parent) {
+        if (!IsValid(node) || (parent != INVALID && !IsValid(parent))) {
+            LOG_E("Set parent of transform node {0} to invalid node {1}", node, parent);
+            return;
+        }
+        if (mNodeParents[node] == parent) {
+            return;
+        }
+        for (uint32_t ancestor = parent; ancestor != INVALID; ancestor = mNodeParents[ancestor]) {
+            if (ancestor == node) {
+                LOG_E("Transform node {0} can not be parented to its descendant {1}", node, parent);
+                return;
+            }
+        }
+        UnlinkChild(node);
+        LinkChild(parent, node);
+        mLocalDirty[mNodeToIndex[node]] = 1;
+        bOrderDirty = true;
+    }
+
+    void AdTransformHierarchy::SetLocalTransform(uint32_t node, const AdLocalTransform &local) {
+        uint32_t index = mNodeToIndex[node];
+        mLocals[index] = local;
+        mLocalDirty[index] = 1;
+    }
+
+    void AdTransformHierarchy::GetChangedNodes(std::vector<uint32_t> &outNodes) const {
+        for (uint32_t i = 0; i < mIndexToNode.size(); i++) {
+            if (mWorldChanged[i] && mNodeToIndex[mIndexToNode[i]] == i) {
+                outNodes.push_back(mIndexToNode[i]);
+            }
+        }
+    }
+
+    void AdTransformHierarchy::RebuildOrder() {
+        // 按层遍历: 先放所有根节点(保持原来的顺序), 之后依次放入每个节点的子节点
+        std::vector<uint32_t> order;
+        order.reserve(mNodeCount);
+        for (uint32_t i = 0; i < mIndexToNode.size(); i++) {
+            uint32_t node = mIndexToNode[i];
+            if (mNodeToIndex[node] == i && mNodeParents[node] == INVALID) {
+                order.push_back(node);
+            }
+        }
+        for (size_t i = 0; i < order.size(); i++) {
+            for (uint32_t child = mFirstChildren[order[i]]; child != INVALID; child = mNextSiblings[child]) {
+                order.push_back(child);
+            }
+        }
+
+        std::vector<uint32_t> parentIndices(order.size());
+        std::vector<AdLocalTransform> locals(order.size());
+        std::vector<AdMat4> worlds(order.size());
+        std::vector<uint8_t> localDirty(order.size());
+        std::vector<uint8_t> worldChanged(order.size());
+        std::vector<uint32_t> depths(order.size());
+        mLevelOffsets = {0};
+        for (uint32_t i = 0; i < order.size(); i++) {
+            uint32_t node = order[i];
+            uint32_t oldIndex = mNodeToIndex[node];
+            uint32_t parent = mNodeParents[node];
+            // 父节点在更早的位置, 已经更新为新下标
+            parentIndices[i] = parent == INVALID ? INVALID : mNodeToIndex[parent];
+            depths[i] = parent == INVALID ? 0 : depths[parentIndices[i]] + 1;
+            locals[i] = mLocals[oldIndex];
+            worlds[i] = mWorlds[oldIndex];
+            localDirty[i] = mLocalDirty[oldIndex];
+            worldChanged[i] = mWorldChanged[oldIndex];
+            mNodeToIndex[node] = i;
+            if (depths[i] == GetLevelCount()) {
+                mLevelOffsets.push_back(i);
+            }
+            mLevelOffsets.back() = i + 1;
+        }
+
+        mIndexToNode = std::move(order);
+        mParentIndices = std::move(parentIndices);
+        mLocals = std::move(locals);
+        mWorlds = std::move(worlds);
+        mLocalDirty = std::move(localDirty);
+        mWorldChanged = std::move(worldChanged);
+        mDepths = std::move(depths);
+        bOrderDirty = false;
+    }
+
+    void AdTransformHierarchy::BeginUpdate() {
+        if (bOrderDirty) {
+            RebuildOrder();
+        }
+    }
+
+    void AdTransformHierarchy::UpdateRange(uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+            uint32_t parent = mParentIndices[i];
+            // 父节点在上一层, 它的标记已经是这一次更新的结果
+            bool bChanged = mLocalDirty[i] || (parent != INVALID && mWorldChanged[parent]);
+            mWorldChanged[i] = bChanged;
+            if (!bChanged) {
+                continue;
+            }
+            mLocalDirty[i] = 0;
+            mWorlds[i] = parent == INVALID ? ComposeMatrix(mLocals[i]) : mWorlds[parent] * ComposeMatrix(mLocals[i]);
+        }
+    }
+
+    void AdTransformHierarchy::Update() {
+        BeginUpdate();
+        for (uint32_t level = 0; level < GetLevelCount(); level++) {
+            UpdateRange(mLevelOffsets[level], mLevelOffsets[level + 1]);
+        }
+    }
+
+    void AdTransformHierarchy::Update(AdJobSystem &jobSystem, uint32_t batchSize) {
+        BeginUpdate();
+        for (uint32_t level = 0; level < GetLevelCount(); level++) {
+            uint32_t begin = mLevelOffsets[level];
+            uint32_t count = mLevelOffsets[level + 1] - begin;
+            jobSystem.ParallelFor(count, batchSize, [this, begin](uint32_t first, uint32_t last) {
+                UpdateRange(begin + first, begin + last);
+            });
+        }
+    }
+}
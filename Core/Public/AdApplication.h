@@ -1,11 +1,110 @@
 #ifndef AD_APPLICATION_H
 #define AD_APPLICATION_H
 
+#include "Job/AdTaskGraph.h"
+#include "Render/AdRenderProxy.h"
+#include "Concurrency/AdSpscQueue.h"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 namespace ade {
+    // 每帧按顺序执行的阶段, 阶段内的任务并行
+    enum class AdFrameStage : uint32_t {
+        Simulation,     // 逻辑、动画、变换层级                    (游戏线程)
+        Extract,        // 把可绘制对象写入 AdRenderFrame           (游戏线程)
+        Culling,        // 视锥 / 遮挡剔除, 生成可见列表            (渲染线程)
+        Record,         // 录制命令缓冲                            (渲染线程)
+        Submit,         // 提交队列、呈现                          (渲染线程)
+        Count,
+    };
+
+    struct AdApplicationSettings {
+        AdJobSystemSettings jobSettings;
+        bool bRenderThread = true;          // false 时所有阶段都在调用 RunFrame 的线程上串行执行
+        uint32_t renderFrameCount = 2;      // 帧数据个数, 2 时游戏线程最多领先渲染线程一帧
+    };
+
+    /**
+     * 应用持有全引擎共用的任务系统和每帧的任务图
+     * 子系统用 AddFrameTask 把工作注册到某个阶段, 上一阶段全部完成后才开始下一阶段
+     *
+     * 开启渲染线程时, RunFrame 在调用线程(游戏线程)执行 Simulation / Extract, 把写好的 AdRenderFrame
+     * 放入队列后返回; 渲染线程取出后执行 Culling / Record / Submit, 用完归还.
+     * 这样第 N + 1 帧模拟时第 N 帧在录制, 两边的任务都在同一个任务系统上并行
+     */
     class AdApplication {
     public:
+        static constexpr uint32_t MAX_RENDER_FRAMES = 4;
+
+        explicit AdApplication(const AdApplicationSettings &settings = {});
+
+        // 派生类持有渲染任务用到的资源时, 应在自己的析构函数中先调用 Flush
+        virtual ~AdApplication();
+
+        AdApplication(const AdApplication &) = delete;
+
+        AdApplication &operator=(const AdApplication &) = delete;
+
+        AdJobSystem &GetJobSystem() { return mJobSystem; }
+
+        // 返回任务 id, 可用于 AddFrameDependency
+        uint32_t AddFrameTask(AdFrameStage stage, const std::string &name, AdTaskGraph::TaskFunc func);
+
+        // 同一阶段内任务之间的额外依赖, 不能跨游戏线程和渲染线程
+        void AddFrameDependency(uint32_t before, uint32_t after);
+
+        // 执行一帧的游戏线程部分, 渲染线程落后 renderFrameCount 帧时先等待
+        void RunFrame();
+
+        // 等待渲染线程处理完所有已提交的帧, 修改渲染资源或任务前调用
+        void Flush();
+
+        // 仅在 Simulation / Extract 阶段的任务中有效
+        AdRenderFrame &GetGameFrame() { return *mGameFrame; }
+
+        // 仅在 Culling / Record / Submit 阶段的任务中有效
+        const AdRenderFrame &GetRenderFrame() const { return *mRenderFrame; }
+
+        uint64_t GetFrameIndex() const { return mFrameIndex; }
+
+    private:
+        struct FrameTask {
+            bool bRenderThread;
+            uint32_t graphTask;
+        };
+
+        static bool IsRenderStage(uint32_t stage) { return stage >= static_cast<uint32_t>(AdFrameStage::Culling); }
+
+        AdRenderFrame *AcquireFrame();
+
+        void RenderFrame(AdRenderFrame *frame);
+
+        void RenderThreadMain();
+
+        AdJobSystem mJobSystem;
+        AdTaskGraph mGameGraph;
+        AdTaskGraph mRenderGraph;
+        // 每个阶段的结束节点, 依赖阶段内所有任务
+        uint32_t mStageEndTasks[static_cast<uint32_t>(AdFrameStage::Count)];
+        std::vector<FrameTask> mFrameTasks;
+        uint64_t mFrameIndex = 0;
+
+        std::unique_ptr<AdRenderFrame> mRenderFrames[MAX_RENDER_FRAMES];
+        uint32_t mRenderFrameCount;
+        AdRenderFrame *mGameFrame = nullptr;
+        const AdRenderFrame *mRenderFrame = nullptr;
 
+        // 游戏线程 -> 渲染线程传递写好的帧, 反方向归还用完的帧
+        bool bRenderThread;
+        AdSpscQueue<AdRenderFrame *, MAX_RENDER_FRAMES> mReadyFrames;
+        AdSpscQueue<AdRenderFrame *, MAX_RENDER_FRAMES> mFreeFrames;
+        std::mutex mFrameMutex;
+        std::condition_variable mFrameCondition;
+        bool bStopRender = false;
+        std::thread mRenderThread;
     };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,142 @@
+#ifndef AD_CONCURRENT_HANDLE_POOL_H
+#define AD_CONCURRENT_HANDLE_POOL_H
+
+#include "AdEngine.h"
+#include <atomic>
+
+namespace ade {
+
+    // 槽位下标 + 代数, 槽位被重用后旧句柄失效
+    struct AdPoolHandle {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+
+        bool IsValid() const { return index != UINT32_MAX; }
+
+        bool operator==(const AdPoolHandle &other) const {
+            return index == other.index && generation == other.generation;
+        }
+
+        bool operator!=(const AdPoolHandle &other) const { return !(*this == other); }
+    };
+
+    /**
+     * 固定容量的对象池, 任意线程可以同时 Create / Destroy / Get:
+     * 空闲槽位组成无锁栈, 栈顶带版本号避免 ABA; 每个槽位的代数为奇数时存活, Destroy 用 CAS 保证只释放一次
+     * Get 只保证句柄有效时返回对象, 与同一对象的 Destroy 并发时, 对象生命周期需要调用方保证
+     */
+    template<typename T>
+    class AdConcurrentHandlePool {
+    public:
+        explicit AdConcurrentHandlePool(uint32_t capacity) : mCapacity(capacity) {
+            mSlots = std::make_unique<Slot[]>(capacity);
+            for (uint32_t i = 0; i < capacity; i++) {
+                mSlots[i].next.store(i + 1 < capacity ? i + 1 : UINT32_MAX, std::memory_order_relaxed);
+            }
+            mFreeHead.store(capacity > 0 ? 0 : UINT32_MAX, std::memory_order_relaxed);
+        }
+
+        // 析构时不能再有其他线程访问
+        ~AdConcurrentHandlePool() {
+            for (uint32_t i = 0; i < mCapacity; i++) {
+                if (mSlots[i].generation.load(std::memory_order_relaxed) & 1) {
+                    reinterpret_cast<T *>(mSlots[i].data)->~T();
+                }
+            }
+        }
+
+        AdConcurrentHandlePool(const AdConcurrentHandlePool &) = delete;
+
+        AdConcurrentHandlePool &operator=(const AdConcurrentHandlePool &) = delete;
+
+        // 池满时返回无效句柄
+        template<typename... Args>
+        AdPoolHandle Create(Args &&... args) {
+            uint32_t index = PopFree();
+            if (index == UINT32_MAX) {
+                return {};
+            }
+            Slot &slot = mSlots[index];
+            new(slot.data) T(std::forward<Args>(args)...);
+            uint32_t generation = slot.generation.load(std::memory_order_relaxed) + 1;
+            slot.generation.store(generation, std::memory_order_release);
+            mCount.fetch_add(1, std::memory_order_relaxed);
+            return {index, generation};
+        }
+
+        // 句柄已失效时返回 false
+        bool Destroy(AdPoolHandle handle) {
+            if (handle.index >= mCapacity) {
+                return false;
+            }
+            Slot &slot = mSlots[handle.index];
+            uint32_t generation = handle.generation;
+            if ((generation & 1) == 0 || !slot.generation.compare_exchange_strong(
+                    generation, generation + 1, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                return false;
+            }
+            reinterpret_cast<T *>(slot.data)->~T();
+            mCount.fetch_sub(1, std::memory_order_relaxed);
+            PushFree(handle.index);
+            return true;
+        }
+
+        // 句柄失效时返回空
+        T *Get(AdPoolHandle handle) const {
+            if (handle.index >= mCapacity ||
+                mSlots[handle.index].generation.load(std::memory_order_acquire) != handle.generation) {
+                return nullptr;
+            }
+            return reinterpret_cast<T *>(mSlots[handle.index].data);
+        }
+
+        bool IsValid(AdPoolHandle handle) const { return Get(handle) != nullptr; }
+
+        uint32_t GetCount() const { return mCount.load(std::memory_order_relaxed); }
+
+        uint32_t GetCapacity() const { return mCapacity; }
+
+    private:
+        struct Slot {
+            std::atomic<uint32_t> generation{0};
+            std::atomic<uint32_t> next{UINT32_MAX};
+            alignas(T) uint8_t data[sizeof(T)];
+        };
+
+        // 栈顶低 32 位为槽位下标, 高 32 位为每次修改递增的版本号
+        uint32_t PopFree() {
+            uint64_t head = mFreeHead.load(std::memory_order_acquire);
+            while (true) {
+                uint32_t index = static_cast<uint32_t>(head);
+                if (index == UINT32_MAX) {
+                    return UINT32_MAX;
+                }
+                uint64_t next = mSlots[index].next.load(std::memory_order_relaxed);
+                uint64_t newHead = ((head >> 32) + 1) << 32 | next;
+                if (mFreeHead.compare_exchange_weak(head, newHead, std::memory_order_acq_rel,
+                                                    std::memory_order_acquire)) {
+                    return index;
+                }
+            }
+        }
+
+        void PushFree(uint32_t index) {
+            uint64_t head = mFreeHead.load(std::memory_order_relaxed);
+            while (true) {
+                mSlots[index].next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+                uint64_t newHead = ((head >> 32) + 1) << 32 | index;
+                if (mFreeHead.compare_exchange_weak(head, newHead, std::memory_order_release,
+                                                    std::memory_order_relaxed)) {
+                    return;
+                }
+            }
+        }
+
+        uint32_t mCapacity;
+        std::unique_ptr<Slot[]> mSlots;
+        alignas(64) std::atomic<uint64_t> mFreeHead{UINT32_MAX};
+        std::atomic<uint32_t> mCount{0};
+    };
+}
+
+#endif
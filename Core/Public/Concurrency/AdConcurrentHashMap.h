@@ -0,0 +1,126 @@
+#ifndef AD_CONCURRENT_HASH_MAP_H
+#define AD_CONCURRENT_HASH_MAP_H
+
+#include "AdEngine.h"
+#include <atomic>
+#include <limits>
+
+namespace ade {
+
+    /**
+     * 有界无锁哈希表, 开放寻址 + 线性探测, 任意线程可以同时 Insert / Find / Erase
+     * 键为整数(资源 id、哈希值等), 最大值保留为空槽标记; 值需要能无锁原子读写(整数、指针、句柄)
+     * 键第一次插入时用 CAS 占据槽位, 之后一直保留(Erase 只清除存在标记), 所以探测链不会断开;
+     * 容量按"运行期间出现的不同键的数量"估计, Clear 才回收槽位
+     */
+    template<typename K, typename V>
+    class AdConcurrentHashMap {
+        static_assert(std::is_integral<K>::value, "Key must be an integer");
+        static_assert(std::atomic<V>::is_always_lock_free, "Value must be lock free, store a pointer or handle");
+
+    public:
+        static constexpr K EMPTY_KEY = std::numeric_limits<K>::max();
+
+        // 槽位数为 capacity 的两倍以上(2 的幂), 负载不超过一半
+        explicit AdConcurrentHashMap(uint32_t capacity) {
+            uint32_t size = 2;
+            while (size < capacity * 2) {
+                size <<= 1;
+            }
+            mMask = size - 1;
+            mSlots = std::make_unique<Slot[]>(size);
+            Clear();
+        }
+
+        AdConcurrentHashMap(const AdConcurrentHashMap &) = delete;
+
+        AdConcurrentHashMap &operator=(const AdConcurrentHashMap &) = delete;
+
+        // 插入或覆盖, 表满时返回 false
+        bool Insert(K key, V value) {
+            Slot *slot = FindSlot(key, true);
+            if (!slot) {
+                return false;
+            }
+            slot->value.store(value, std::memory_order_relaxed);
+            slot->bPresent.store(true, std::memory_order_release);
+            return true;
+        }
+
+        bool Find(K key, V &outValue) const {
+            const Slot *slot = FindSlot(key, false);
+            if (!slot || !slot->bPresent.load(std::memory_order_acquire)) {
+                return false;
+            }
+            outValue = slot->value.load(std::memory_order_relaxed);
+            return true;
+        }
+
+        bool Contains(K key) const {
+            V value;
+            return Find(key, value);
+        }
+
+        // 不存在时返回 false
+        bool Erase(K key) {
+            Slot *slot = FindSlot(key, false);
+            return slot && slot->bPresent.exchange(false, std::memory_order_acq_rel);
+        }
+
+        // 不能与其他操作并发
+        void Clear() {
+            for (uint32_t i = 0; i <= mMask; i++) {
+                mSlots[i].key.store(EMPTY_KEY, std::memory_order_relaxed);
+                mSlots[i].bPresent.store(false, std::memory_order_relaxed);
+            }
+        }
+
+        uint32_t GetSlotCount() const { return mMask + 1; }
+
+    private:
+        struct Slot {
+            std::atomic<K> key{EMPTY_KEY};
+            std::atomic<bool> bPresent{false};
+            std::atomic<V> value{};
+        };
+
+        static uint32_t Hash(K key) {
+            // murmur3 的 64 位收尾混合
+            uint64_t hash = static_cast<uint64_t>(key);
+            hash ^= hash >> 33;
+            hash *= 0xff51afd7ed558ccdull;
+            hash ^= hash >> 33;
+            hash *= 0xc4ceb9fe1a85ec53ull;
+            hash ^= hash >> 33;
+            return static_cast<uint32_t>(hash);
+        }
+
+        // bInsert 时遇到空槽用 CAS 占据; 找不到时返回空
+        Slot *FindSlot(K key, bool bInsert) const {
+            assert(key != EMPTY_KEY);
+            uint32_t index = Hash(key);
+            for (uint32_t probe = 0; probe <= mMask; probe++, index++) {
+                Slot &slot = mSlots[index & mMask];
+                K current = slot.key.load(std::memory_order_acquire);
+                if (current == key) {
+                    return &slot;
+                }
+                if (current == EMPTY_KEY) {
+                    if (!bInsert) {
+                        return nullptr;
+                    }
+                    if (slot.key.compare_exchange_strong(current, key, std::memory_order_acq_rel,
+                                                         std::memory_order_acquire) || current == key) {
+                        return &slot;
+                    }
+                }
+            }
+            return nullptr;
+        }
+
+        uint32_t mMask;
+        std::unique_ptr<Slot[]> mSlots;
+    };
+}
+
+#endif
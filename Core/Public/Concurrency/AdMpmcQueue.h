@@ -0,0 +1,113 @@
+#ifndef AD_MPMC_QUEUE_H
+#define AD_MPMC_QUEUE_H
+
+#include "AdEngine.h"
+#include <atomic>
+
+namespace ade {
+
+    /**
+     * 多生产者多消费者的有界无锁队列(Vyukov): 每个槽位带序号, 生产者和消费者各自用一次 CAS 抢占下标,
+     * 之后只写自己的槽位; 序号表示槽位是否可写 / 可读, 不需要锁也没有 ABA 问题
+     * 适合上传请求、日志记录、输入事件等多个线程汇集到一处的场景
+     */
+    template<typename T>
+    class AdMpmcQueue {
+    public:
+        // capacity 向上取整到 2 的幂
+        explicit AdMpmcQueue(uint32_t capacity) {
+            uint32_t size = 2;
+            while (size < capacity) {
+                size <<= 1;
+            }
+            mMask = size - 1;
+            mSlots = std::make_unique<Slot[]>(size);
+            for (uint32_t i = 0; i < size; i++) {
+                mSlots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        // 析构时不能再有其他线程访问
+        ~AdMpmcQueue() {
+            uint32_t tail = mTail.load(std::memory_order_acquire);
+            for (uint32_t i = mHead.load(std::memory_order_relaxed); i != tail; i++) {
+                reinterpret_cast<T *>(mSlots[i & mMask].data)->~T();
+            }
+        }
+
+        AdMpmcQueue(const AdMpmcQueue &) = delete;
+
+        AdMpmcQueue &operator=(const AdMpmcQueue &) = delete;
+
+        // 满时返回 false
+        template<typename U>
+        bool TryPush(U &&item) {
+            uint32_t position = mTail.load(std::memory_order_relaxed);
+            Slot *slot;
+            while (true) {
+                slot = &mSlots[position & mMask];
+                uint32_t sequence = slot->sequence.load(std::memory_order_acquire);
+                int32_t diff = static_cast<int32_t>(sequence - position);
+                if (diff == 0) {
+                    if (mTail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    // 槽位还没被上一轮的消费者取走
+                    return false;
+                } else {
+                    position = mTail.load(std::memory_order_relaxed);
+                }
+            }
+            new(slot->data) T(std::forward<U>(item));
+            slot->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 空时返回 false
+        bool TryPop(T &outItem) {
+            uint32_t position = mHead.load(std::memory_order_relaxed);
+            Slot *slot;
+            while (true) {
+                slot = &mSlots[position & mMask];
+                uint32_t sequence = slot->sequence.load(std::memory_order_acquire);
+                int32_t diff = static_cast<int32_t>(sequence - (position + 1));
+                if (diff == 0) {
+                    if (mHead.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    position = mHead.load(std::memory_order_relaxed);
+                }
+            }
+            T *value = reinterpret_cast<T *>(slot->data);
+            outItem = std::move(*value);
+            value->~T();
+            // 下一轮的生产者在 position + 容量 时写入
+            slot->sequence.store(position + mMask + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 近似值
+        uint32_t GetSize() const {
+            return mTail.load(std::memory_order_relaxed) - mHead.load(std::memory_order_relaxed);
+        }
+
+        uint32_t GetCapacity() const { return mMask + 1; }
+
+    private:
+        struct Slot {
+            std::atomic<uint32_t> sequence;
+            alignas(T) uint8_t data[sizeof(T)];
+        };
+
+        uint32_t mMask;
+        std::unique_ptr<Slot[]> mSlots;
+        alignas(64) std::atomic<uint32_t> mTail{0};
+        alignas(64) std::atomic<uint32_t> mHead{0};
+    };
+}
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef AD_SPSC_QUEUE_H
+#define AD_SPSC_QUEUE_H
+
+#include "AdEngine.h"
+#include <atomic>
+
+namespace ade {
+
+    /**
+     * 单生产者单消费者的有界无锁环形队列, 用于两个固定线程之间传递命令(例如游戏线程 -> 渲染线程)
+     * 读写下标放在不同缓存行, 各自缓存对方的下标, 只有看起来满/空时才重新读取, 减少缓存行来回同步
+     * 元素在 TryPop 中移出并析构, 队列析构时析构剩余元素; 元素内嵌在对象中, 容量较大时应放在堆上
+     */
+    template<typename T, uint32_t Capacity>
+    class AdSpscQueue {
+        static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        AdSpscQueue() = default;
+
+        ~AdSpscQueue() {
+            uint32_t tail = mTail.load(std::memory_order_acquire);
+            for (uint32_t i = mHead.load(std::memory_order_relaxed); i != tail; i++) {
+                reinterpret_cast<T *>(&mSlots[i & MASK])->~T();
+            }
+        }
+
+        AdSpscQueue(const AdSpscQueue &) = delete;
+
+        AdSpscQueue &operator=(const AdSpscQueue &) = delete;
+
+        // 仅生产者调用, 满时返回 false
+        template<typename U>
+        bool TryPush(U &&item) {
+            uint32_t tail = mTail.load(std::memory_order_relaxed);
+            if (tail - mCachedHead == Capacity) {
+                mCachedHead = mHead.load(std::memory_order_acquire);
+                if (tail - mCachedHead == Capacity) {
+                    return false;
+                }
+            }
+            new(&mSlots[tail & MASK]) T(std::forward<U>(item));
+            mTail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 仅消费者调用, 空时返回 false
+        bool TryPop(T &outItem) {
+            uint32_t head = mHead.load(std::memory_order_relaxed);
+            if (head == mCachedTail) {
+                mCachedTail = mTail.load(std::memory_order_acquire);
+                if (head == mCachedTail) {
+                    return false;
+                }
+            }
+            T *slot = reinterpret_cast<T *>(&mSlots[head & MASK]);
+            outItem = std::move(*slot);
+            slot->~T();
+            mHead.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 近似值
+        uint32_t GetSize() const {
+            return mTail.load(std::memory_order_relaxed) - mHead.load(std::memory_order_relaxed);
+        }
+
+        bool IsEmpty() const { return GetSize() == 0; }
+
+        static constexpr uint32_t GetCapacity() { return Capacity; }
+
+    private:
+        static constexpr uint32_t MASK = Capacity - 1;
+
+        struct Slot {
+            alignas(T) uint8_t data[sizeof(T)];
+        };
+
+        // 消费者写 mHead, 读 mCachedTail
+        alignas(64) std::atomic<uint32_t> mHead{0};
+        uint32_t mCachedTail = 0;
+        // 生产者写 mTail, 读 mCachedHead
+        alignas(64) std::atomic<uint32_t> mTail{0};
+        uint32_t mCachedHead = 0;
+        alignas(64) Slot mSlots[Capacity];
+    };
+}
+
+#endif
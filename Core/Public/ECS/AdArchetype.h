@@ -0,0 +1,96 @@
+#ifndef AD_ARCHETYPE_H
+#define AD_ARCHETYPE_H
+
+#include "ECS/AdComponent.h"
+#include <unordered_map>
+
+namespace ade {
+
+    // index 为实体表中的位置, generation 在实体销毁后递增, 旧句柄随之失效
+    struct AdEntity {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+
+        bool IsValid() const { return index != UINT32_MAX; }
+
+        bool operator==(const AdEntity &other) const { return index == other.index && generation == other.generation; }
+
+        bool operator!=(const AdEntity &other) const { return !(*this == other); }
+    };
+
+    /**
+     * 组件集合相同的实体放在同一个原型中, 按固定大小的块存储
+     * 块内先是实体数组, 之后每种组件一列连续存放(SoA), 遍历时每列都是紧凑数组
+     * 除最后一块外所有块都是满的, 删除时用最后一行填补
+     */
+    class AdArchetype {
+    public:
+        static constexpr uint32_t CHUNK_SIZE = 16 * 1024;
+        // 每列起始地址的最小对齐, 方便 SIMD 读取
+        static constexpr uint32_t COLUMN_ALIGNMENT = 64;
+
+        // componentTypes 升序
+        explicit AdArchetype(std::vector<uint32_t> componentTypes);
+
+        ~AdArchetype();
+
+        AdArchetype(const AdArchetype &) = delete;
+
+        AdArchetype &operator=(const AdArchetype &) = delete;
+
+        const std::vector<uint32_t> &GetComponentTypes() const { return mComponentTypes; }
+
+        const AdComponentMask &GetMask() const { return mMask; }
+
+        // 组件在这个原型中的列号, 不包含时返回 -1
+        int32_t GetColumn(uint32_t typeId) const;
+
+        uint32_t GetChunkCapacity() const { return mChunkCapacity; }
+
+        uint32_t GetChunkCount() const { return static_cast<uint32_t>(mChunks.size()); }
+
+        uint32_t GetEntityCount() const { return mEntityCount; }
+
+        uint32_t GetEntityCount(uint32_t chunk) const { return mChunks[chunk].count; }
+
+        AdEntity *GetEntities(uint32_t chunk) const { return reinterpret_cast<AdEntity *>(mChunks[chunk].data); }
+
+        void *GetColumnData(uint32_t chunk, uint32_t column) const {
+            return mChunks[chunk].data + mColumnOffsets[column];
+        }
+
+        void *GetComponent(uint32_t chunk, uint32_t row, uint32_t column) const {
+            return mChunks[chunk].data + mColumnOffsets[column] + size_t(row) * mColumnSizes[column];
+        }
+
+        // 在末尾追加一行, 组件内存未构造
+        void AllocateRow(AdEntity entity, uint32_t &outChunk, uint32_t &outRow);
+
+        /**
+         * 删除一行, 这一行的组件必须已经析构; 最后一行会移动过来填补
+         * @return 被移动的实体, 没有移动时无效
+         */
+        AdEntity RemoveRow(uint32_t chunk, uint32_t row);
+
+        // 增加 / 删除一种组件后到达的原型, 由 AdWorld 维护
+        std::unordered_map<uint32_t, uint32_t> addEdges;
+        std::unordered_map<uint32_t, uint32_t> removeEdges;
+
+    private:
+        struct Chunk {
+            uint8_t *data;
+            uint32_t count;
+        };
+
+        std::vector<uint32_t> mComponentTypes;
+        AdComponentMask mMask;
+        std::vector<uint32_t> mColumnOffsets;
+        std::vector<uint32_t> mColumnSizes;
+        uint32_t mChunkCapacity = 0;
+        uint32_t mChunkSize = CHUNK_SIZE;
+        uint32_t mEntityCount = 0;
+        std::vector<Chunk> mChunks;
+    };
+}
+
+#endif
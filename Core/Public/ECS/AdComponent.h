@@ -0,0 +1,55 @@
+#ifndef AD_COMPONENT_H
+#define AD_COMPONENT_H
+
+#include "AdEngine.h"
+#include <bitset>
+
+namespace ade {
+    static constexpr uint32_t AD_MAX_COMPONENT_TYPES = 128;
+
+    using AdComponentMask = std::bitset<AD_MAX_COMPONENT_TYPES>;
+
+    // 组件类型的大小和构造/移动/析构函数, 块内的组件按类型擦除后的字节处理
+    struct AdComponentInfo {
+        uint32_t size;
+        uint32_t alignment;
+        void (*construct)(void *dst);
+        // 移动构造到 dst, src 之后仍需析构
+        void (*moveConstruct)(void *dst, void *src);
+        void (*destruct)(void *ptr);
+    };
+
+    class AdComponentRegistry {
+    public:
+        // 线程安全, 超出 AD_MAX_COMPONENT_TYPES 时返回 UINT32_MAX
+        static uint32_t Register(const AdComponentInfo &info);
+
+        static const AdComponentInfo &GetInfo(uint32_t typeId);
+
+        static uint32_t GetTypeCount();
+    };
+
+    template<typename T>
+    AdComponentInfo MakeComponentInfo() {
+        return {
+            static_cast<uint32_t>(sizeof(T)),
+            static_cast<uint32_t>(alignof(T)),
+            [](void *dst) { new(dst) T(); },
+            [](void *dst, void *src) { new(dst) T(std::move(*static_cast<T *>(src))); },
+            [](void *ptr) { static_cast<T *>(ptr)->~T(); }
+        };
+    }
+
+    // 组件类型 id 在第一次使用时分配, 同一次运行内不变; const T 与 T 相同, 查询中用 const 表示只读
+    template<typename T>
+    uint32_t GetComponentTypeId() {
+        if constexpr (!std::is_same_v<T, std::remove_cv_t<T>>) {
+            return GetComponentTypeId<std::remove_cv_t<T>>();
+        } else {
+            static const uint32_t sTypeId = AdComponentRegistry::Register(MakeComponentInfo<T>());
+            return sTypeId;
+        }
+    }
+}
+
+#endif
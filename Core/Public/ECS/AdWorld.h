@@ -0,0 +1,207 @@
+#ifndef AD_WORLD_H
+#define AD_WORLD_H
+
+#include "ECS/AdArchetype.h"
+#include "Job/AdJobSystem.h"
+#include <array>
+#include <map>
+
+namespace ade {
+
+    /**
+     * 实体和组件的容器, 组件按原型分块存储, 见 AdArchetype
+     * 组件需要可默认构造、可移动; 增删实体或组件(结构改变)会移动组件, 之前取得的组件指针失效
+     * 结构改变只能在单线程进行, 遍历时不能改变结构
+     */
+    class AdWorld {
+    public:
+        AdWorld();
+
+        AdWorld(const AdWorld &) = delete;
+
+        AdWorld &operator=(const AdWorld &) = delete;
+
+        AdEntity CreateEntity();
+
+        // 直接放入目标原型, 不经过中间原型; 组件类型超出上限时返回无效实体
+        template<typename... Ts>
+        AdEntity CreateEntity(Ts &&... components) {
+            std::vector<uint32_t> types = {GetComponentTypeId<std::decay_t<Ts>>()...};
+            AdEntity entity = CreateEntityRaw(std::move(types));
+            if (!entity.IsValid()) {
+                return entity;
+            }
+            (static_cast<void>(*static_cast<std::decay_t<Ts> *>(
+                    GetComponentRaw(entity, GetComponentTypeId<std::decay_t<Ts>>())) = std::forward<Ts>(components)), ...);
+            return entity;
+        }
+
+        void DestroyEntity(AdEntity entity);
+
+        bool IsAlive(AdEntity entity) const;
+
+        uint32_t GetEntityCount() const { return mAliveCount; }
+
+        // 已有时直接赋值
+        template<typename T>
+        T &AddComponent(AdEntity entity, T component = T()) {
+            T *ptr = static_cast<T *>(AddComponentRaw(entity, GetComponentTypeId<T>()));
+            *ptr = std::move(component);
+            return *ptr;
+        }
+
+        template<typename T>
+        void RemoveComponent(AdEntity entity) { RemoveComponentRaw(entity, GetComponentTypeId<T>()); }
+
+        // 不存在时返回空
+        template<typename T>
+        T *GetComponent(AdEntity entity) const {
+            return static_cast<T *>(GetComponentRaw(entity, GetComponentTypeId<T>()));
+        }
+
+        template<typename T>
+        bool HasComponent(AdEntity entity) const { return GetComponent<T>(entity) != nullptr; }
+
+        // 类型擦除的接口, 新增的组件为默认构造
+        AdEntity CreateEntityRaw(std::vector<uint32_t> componentTypes);
+
+        void *AddComponentRaw(AdEntity entity, uint32_t typeId);
+
+        void RemoveComponentRaw(AdEntity entity, uint32_t typeId);
+
+        void *GetComponentRaw(AdEntity entity, uint32_t typeId) const;
+
+        uint32_t GetArchetypeCount() const { return static_cast<uint32_t>(mArchetypes.size()); }
+
+        AdArchetype *GetArchetype(uint32_t index) const { return mArchetypes[index].get(); }
+
+        // 每次结构改变递增, 查询据此判断是否需要重新收集块
+        uint64_t GetStructureVersion() const { return mStructureVersion; }
+
+    private:
+        struct EntityRecord {
+            uint32_t generation = 0;
+            uint32_t archetype = UINT32_MAX;  // 空闲时为 UINT32_MAX
+            uint32_t chunk = 0;
+            uint32_t row = 0;
+        };
+
+        const EntityRecord *FindRecord(AdEntity entity) const;
+
+        uint32_t GetOrCreateArchetype(std::vector<uint32_t> componentTypes);
+
+        // 把实体移动到目标原型, 两边都有的组件移动过去, 只有目标有的组件默认构造
+        void MoveEntity(AdEntity entity, uint32_t targetArchetype);
+
+        // 删除实体在原型中的一行, 组件已经析构或移走
+        void RemoveRow(const EntityRecord &record);
+
+        std::vector<EntityRecord> mRecords;
+        std::vector<uint32_t> mFreeIndices;
+        uint32_t mAliveCount = 0;
+        std::vector<std::unique_ptr<AdArchetype>> mArchetypes;
+        std::map<std::vector<uint32_t>, uint32_t> mArchetypeLookup;
+        uint64_t mStructureVersion = 0;
+    };
+
+    /**
+     * 遍历包含 Ts 所有组件的实体, 以块为单位, 每个组件一个紧凑数组
+     *
+     * 单线程时直接用 ForEachChunk / ForEach, 结构改变后会自动重新收集
+     * 多线程时先在主线程调用 Update, 之后各线程用 ForEachChunk(begin, end, func) 处理不同的块区间,
+     * 或者直接用 ForEachChunk(AdJobSystem &, func) / ForEach(AdJobSystem &, func) 按块分给任务系统
+     */
+    template<typename... Ts>
+    class AdQuery {
+    public:
+        explicit AdQuery(AdWorld &world) : mWorld(world) {
+            mMask.reset();
+            (mMask.set(GetComponentTypeId<Ts>()), ...);
+        }
+
+        void Update() {
+            if (mStructureVersion == mWorld.GetStructureVersion()) {
+                return;
+            }
+            mStructureVersion = mWorld.GetStructureVersion();
+            mChunks.clear();
+            for (uint32_t i = 0; i < mWorld.GetArchetypeCount(); i++) {
+                AdArchetype *archetype = mWorld.GetArchetype(i);
+                if ((archetype->GetMask() & mMask) != mMask) {
+                    continue;
+                }
+                std::array<uint32_t, sizeof...(Ts)> columns = {
+                    static_cast<uint32_t>(archetype->GetColumn(GetComponentTypeId<Ts>()))...
+                };
+                for (uint32_t chunk = 0; chunk < archetype->GetChunkCount(); chunk++) {
+                    mChunks.push_back({archetype, chunk, columns});
+                }
+            }
+        }
+
+        uint32_t GetChunkCount() const { return static_cast<uint32_t>(mChunks.size()); }
+
+        // func(uint32_t count, const AdEntity *entities, Ts *...components)
+        template<typename Func>
+        void ForEachChunk(uint32_t begin, uint32_t end, Func &&func) const {
+            end = std::min(end, GetChunkCount());
+            for (uint32_t i = begin; i < end; i++) {
+                InvokeChunk(mChunks[i], func, std::index_sequence_for<Ts...>());
+            }
+        }
+
+        template<typename Func>
+        void ForEachChunk(Func &&func) {
+            Update();
+            ForEachChunk(0, GetChunkCount(), std::forward<Func>(func));
+        }
+
+        // 每 batchSize 个块一个任务, 返回时全部完成; func 会在多个线程上同时调用
+        template<typename Func>
+        void ForEachChunk(AdJobSystem &jobSystem, const Func &func, uint32_t batchSize = 1) {
+            Update();
+            jobSystem.ParallelFor(GetChunkCount(), batchSize, [this, &func](uint32_t begin, uint32_t end) {
+                ForEachChunk(begin, end, func);
+            });
+        }
+
+        // func(AdEntity entity, Ts &...components)
+        template<typename Func>
+        void ForEach(Func &&func) {
+            ForEachChunk([&func](uint32_t count, const AdEntity *entities, Ts *... components) {
+                for (uint32_t i = 0; i < count; i++) {
+                    func(entities[i], components[i]...);
+                }
+            });
+        }
+
+        template<typename Func>
+        void ForEach(AdJobSystem &jobSystem, const Func &func, uint32_t batchSize = 1) {
+            ForEachChunk(jobSystem, [&func](uint32_t count, const AdEntity *entities, Ts *... components) {
+                for (uint32_t i = 0; i < count; i++) {
+                    func(entities[i], components[i]...);
+                }
+            }, batchSize);
+        }
+
+    private:
+        struct ChunkRef {
+            AdArchetype *archetype;
+            uint32_t chunk;
+            std::array<uint32_t, sizeof...(Ts)> columns;
+        };
+
+        template<typename Func, size_t... Is>
+        static void InvokeChunk(const ChunkRef &ref, Func &func, std::index_sequence<Is...>) {
+            func(ref.archetype->GetEntityCount(ref.chunk), ref.archetype->GetEntities(ref.chunk),
+                 static_cast<Ts *>(ref.archetype->GetColumnData(ref.chunk, ref.columns[Is]))...);
+        }
+
+        AdWorld &mWorld;
+        AdComponentMask mMask;
+        uint64_t mStructureVersion = UINT64_MAX;
+        std::vector<ChunkRef> mChunks;
+    };
+}
+
+#endif
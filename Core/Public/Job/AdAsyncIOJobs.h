@@ -0,0 +1,31 @@
+#ifndef AD_ASYNC_IO_JOBS_H
+#define AD_ASYNC_IO_JOBS_H
+
+#include "Job/AdJobSystem.h"
+#include "FileSystem/AdAsyncIO.h"
+
+namespace ade {
+    /**
+     * AdAsyncIO 的完成回调在 IO 线程上执行; 包装后 IO 线程只把回调作为任务投递到任务系统, 立即处理下一个请求
+     * AdFileView 持有数据, 复制到任务中仍然有效; 任务系统需要比 AdAsyncIO 晚销毁
+     */
+    inline AdIOCallback RunOnJobSystem(AdJobSystem &jobSystem, AdIOCallback callback) {
+        if (!callback) {
+            return {};
+        }
+        return [&jobSystem, callback = std::move(callback)](AdIOStatus status, const AdFileView &data) {
+            jobSystem.Run([callback, status, data]() { callback(status, data); });
+        };
+    }
+
+    // 所有请求的回调都在任务系统中执行
+    inline std::vector<AdIOHandle> SubmitBatch(AdAsyncIO &asyncIO, AdJobSystem &jobSystem,
+                                               std::vector<AdIORequest> requests) {
+        for (AdIORequest &request: requests) {
+            request.callback = RunOnJobSystem(jobSystem, std::move(request.callback));
+        }
+        return asyncIO.SubmitBatch(std::move(requests));
+    }
+}
+
+#endif
@@ -0,0 +1,180 @@
+#ifndef AD_JOB_SYSTEM_H
+#define AD_JOB_SYSTEM_H
+
+#include "Job/AdWorkStealingDeque.h"
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+namespace ade {
+    class AdJobCounter;
+
+    // 任务槽, 闭包不超过 PAYLOAD_SIZE 时直接放在槽内, 否则在堆上
+    struct alignas(64) AdJob {
+        static constexpr uint32_t PAYLOAD_SIZE = 40;
+
+        void (*invoke)(AdJob *job) = nullptr;       // 执行并析构闭包
+        AdJobCounter *counter = nullptr;
+        std::atomic<bool> bInUse{false};
+        alignas(8) uint8_t payload[PAYLOAD_SIZE];
+    };
+
+    /**
+     * 任务计数: 每关联一个任务加一, 任务完成时减一, 归零表示这一批任务全部完成
+     * 可以挂接后续任务(AdJobSystem::RunAfter), 归零时自动调度; 归零后可以继续复用
+     */
+    class AdJobCounter {
+    public:
+        AdJobCounter() = default;
+
+        AdJobCounter(const AdJobCounter &) = delete;
+
+        AdJobCounter &operator=(const AdJobCounter &) = delete;
+
+        bool IsDone() const { return mState.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class AdJobSystem;
+
+        // 未完成任务数 * 2, 最低位表示最后一个任务正在取出后续任务; 两者都为零才算完成,
+        // 这样最后一次修改 mState 之后不再访问计数, 等待者返回后可以立即销毁它
+        std::atomic<uint32_t> mState{0};
+        std::mutex mMutex;
+        std::vector<AdJob *> mContinuations;
+    };
+
+    struct AdJobSystemSettings {
+        uint32_t workerCount = 0;           // 工作线程数(不含创建任务系统的线程), 0 时为 CPU 核数 - 1
+        bool bPinWorkers = false;           // 工作线程 i 绑定到核 i, 创建线程不绑定
+    };
+
+    /**
+     * 全引擎共用的任务调度器:
+     * 每个工作线程一个 Chase-Lev 队列, 自己产生的任务后进先出, 空闲时随机从其他线程窃取
+     * 创建任务系统的线程(通常是主线程)也有自己的队列, 在 Wait 时参与执行; 其他线程提交的任务进入共享队列
+     *
+     * 依赖关系用 AdJobCounter 表达: Wait 等待计数归零(期间执行其他任务, 不阻塞线程), RunAfter 在计数归零后调度
+     * 等待时不切换栈(不使用纤程), 任务中可以嵌套提交和等待
+     */
+    class AdJobSystem {
+    public:
+        static constexpr uint32_t MAX_JOBS_PER_THREAD = 4096;
+
+        explicit AdJobSystem(const AdJobSystemSettings &settings = {});
+
+        ~AdJobSystem();
+
+        AdJobSystem(const AdJobSystem &) = delete;
+
+        AdJobSystem &operator=(const AdJobSystem &) = delete;
+
+        // 不含创建线程
+        uint32_t GetWorkerCount() const { return static_cast<uint32_t>(mThreads.size()); }
+
+        /**
+         * 调度 func(), 当前线程的任务槽用完时先执行其他任务腾出槽位
+         * @param counter   可以为空; 不为空时调度前加一, 完成后减一
+         */
+        template<typename Func>
+        void Run(Func &&func, AdJobCounter *counter = nullptr) {
+            Schedule(CreateJob(std::forward<Func>(func), counter));
+        }
+
+        // dependency 归零后调度 func(), dependency 已经为零时立即调度
+        template<typename Func>
+        void RunAfter(AdJobCounter *dependency, Func &&func, AdJobCounter *counter = nullptr) {
+            AddContinuation(dependency, CreateJob(std::forward<Func>(func), counter));
+        }
+
+        // 计数归零前执行其他任务
+        void Wait(AdJobCounter *counter);
+
+        /**
+         * 把 [0, count) 分成每段 batchSize 个并行执行 func(begin, end), 全部完成后返回
+         * 第一段在当前线程执行
+         */
+        template<typename Func>
+        void ParallelFor(uint32_t count, uint32_t batchSize, const Func &func) {
+            batchSize = std::max(batchSize, 1u);
+            if (count <= batchSize) {
+                if (count > 0) {
+                    func(0u, count);
+                }
+                return;
+            }
+            AdJobCounter counter;
+            for (uint32_t begin = batchSize; begin < count; begin += batchSize) {
+                uint32_t end = std::min(begin + batchSize, count);
+                Run([&func, begin, end]() { func(begin, end); }, &counter);
+            }
+            func(0u, batchSize);
+            Wait(&counter);
+        }
+
+    private:
+        struct alignas(64) WorkerQueue {
+            AdWorkStealingDeque<AdJob *, MAX_JOBS_PER_THREAD> deque;
+            std::vector<AdJob> jobs = std::vector<AdJob>(MAX_JOBS_PER_THREAD);
+            uint32_t nextJob = 0;
+        };
+
+        template<typename Func>
+        AdJob *CreateJob(Func &&func, AdJobCounter *counter) {
+            using Closure = std::decay_t<Func>;
+            AdJob *job = AllocateJob();
+            if constexpr (sizeof(Closure) <= AdJob::PAYLOAD_SIZE && alignof(Closure) <= 8) {
+                new(job->payload) Closure(std::forward<Func>(func));
+                job->invoke = [](AdJob *self) {
+                    Closure *closure = reinterpret_cast<Closure *>(self->payload);
+                    (*closure)();
+                    closure->~Closure();
+                };
+            } else {
+                *reinterpret_cast<Closure **>(job->payload) = new Closure(std::forward<Func>(func));
+                job->invoke = [](AdJob *self) {
+                    Closure *closure = *reinterpret_cast<Closure **>(self->payload);
+                    (*closure)();
+                    delete closure;
+                };
+            }
+            job->counter = counter;
+            if (counter) {
+                counter->mState.fetch_add(2, std::memory_order_relaxed);
+            }
+            return job;
+        }
+
+        // 当前线程在本任务系统中的队列下标, 外部线程返回 UINT32_MAX
+        uint32_t GetQueueIndex() const;
+
+        // 总是返回空闲槽位, 没有时先执行其他任务
+        AdJob *AllocateJob();
+
+        void Schedule(AdJob *job);
+
+        void AddContinuation(AdJobCounter *dependency, AdJob *job);
+
+        AdJob *FindJob(uint32_t queueIndex);
+
+        void Execute(AdJob *job);
+
+        void WorkerMain(uint32_t queueIndex);
+
+        // 0 为创建线程, 1.. 为工作线程; 最后一个为外部线程共用的任务槽(mExternalMutex 保护)
+        std::vector<std::unique_ptr<WorkerQueue>> mQueues;
+        std::mutex mExternalMutex;
+        std::deque<AdJob *> mExternalJobs;
+        std::atomic<uint32_t> mExternalJobCount{0};
+
+        // 空闲线程睡眠: 提交任务时递增 mWakeEpoch, 有睡眠线程才加锁通知
+        std::mutex mSleepMutex;
+        std::condition_variable mSleepCondition;
+        std::atomic<uint64_t> mWakeEpoch{0};
+        std::atomic<uint32_t> mSleepingCount{0};
+        std::atomic<bool> bStop{false};
+
+        std::vector<std::thread> mThreads;
+    };
+}
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef AD_TASK_GRAPH_H
+#define AD_TASK_GRAPH_H
+
+#include "Job/AdJobSystem.h"
+
+namespace ade {
+
+    /**
+     * 有依赖关系的任务图, 建好后每帧重复执行:
+     * Run 时没有前置任务的任务立即调度, 每个任务完成后把后继的剩余依赖数减一, 归零时调度后继
+     * 任务内部可以继续用 AdJobSystem 拆分并行工作
+     * 增删任务和依赖只能在不执行时进行
+     */
+    class AdTaskGraph {
+    public:
+        using TaskFunc = std::function<void()>;
+
+        AdTaskGraph() = default;
+
+        AdTaskGraph(const AdTaskGraph &) = delete;
+
+        AdTaskGraph &operator=(const AdTaskGraph &) = delete;
+
+        // 返回任务 id
+        uint32_t AddTask(const std::string &name, TaskFunc func);
+
+        // after 在 before 完成后才开始
+        void AddDependency(uint32_t before, uint32_t after);
+
+        uint32_t GetTaskCount() const { return static_cast<uint32_t>(mTasks.size()); }
+
+        const std::string &GetTaskName(uint32_t task) const { return mTasks[task].name; }
+
+        // 执行所有任务, 全部完成后返回; 依赖有环时报错且不执行
+        void Run(AdJobSystem &jobSystem);
+
+        void Clear();
+
+    private:
+        struct Task {
+            std::string name;
+            TaskFunc func;
+            std::vector<uint32_t> successors;
+            uint32_t dependencyCount = 0;
+        };
+
+        bool Validate();
+
+        void RunTask(AdJobSystem &jobSystem, AdJobCounter &counter, uint32_t task);
+
+        std::vector<Task> mTasks;
+        std::unique_ptr<std::atomic<uint32_t>[]> mPendingCounts;
+        bool bValidated = false;
+        bool bValid = false;
+    };
+}
+
+#endif
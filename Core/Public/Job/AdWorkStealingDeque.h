@@ -0,0 +1,90 @@
+#ifndef AD_WORK_STEALING_DEQUE_H
+#define AD_WORK_STEALING_DEQUE_H
+
+#include "AdEngine.h"
+#include <atomic>
+
+namespace ade {
+
+    /**
+     * Chase-Lev 工作窃取队列(固定容量, 按 Lê 等人 2013 年的 C11 内存序):
+     * 所有者线程在底部 Push / Pop(后进先出, 缓存友好), 其他线程从顶部 Steal(先进先出)
+     * 只在最后一个元素上所有者与窃取者竞争, 用一次 CAS 决定
+     * T 需为可以原子读写的小类型(指针、下标)
+     */
+    template<typename T, uint32_t Capacity>
+    class AdWorkStealingDeque {
+        static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        AdWorkStealingDeque() = default;
+
+        AdWorkStealingDeque(const AdWorkStealingDeque &) = delete;
+
+        AdWorkStealingDeque &operator=(const AdWorkStealingDeque &) = delete;
+
+        // 仅所有者调用, 满时返回 false
+        bool Push(T item) {
+            int64_t bottom = mBottom.load(std::memory_order_relaxed);
+            int64_t top = mTop.load(std::memory_order_acquire);
+            if (bottom - top >= static_cast<int64_t>(Capacity)) {
+                return false;
+            }
+            mBuffer[bottom & MASK].store(item, std::memory_order_relaxed);
+            mBottom.store(bottom + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 仅所有者调用
+        bool Pop(T &outItem) {
+            int64_t bottom = mBottom.load(std::memory_order_relaxed) - 1;
+            mBottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t top = mTop.load(std::memory_order_relaxed);
+            if (top > bottom) {
+                mBottom.store(bottom + 1, std::memory_order_relaxed);
+                return false;
+            }
+            outItem = mBuffer[bottom & MASK].load(std::memory_order_relaxed);
+            if (top == bottom) {
+                // 最后一个元素, 与窃取者竞争
+                bool bWon = mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                         std::memory_order_relaxed);
+                mBottom.store(bottom + 1, std::memory_order_relaxed);
+                return bWon;
+            }
+            return true;
+        }
+
+        // 任意线程调用, 队列为空或竞争失败时返回 false
+        bool Steal(T &outItem) {
+            int64_t top = mTop.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t bottom = mBottom.load(std::memory_order_acquire);
+            if (top >= bottom) {
+                return false;
+            }
+            T item = mBuffer[top & MASK].load(std::memory_order_relaxed);
+            if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return false;
+            }
+            outItem = item;
+            return true;
+        }
+
+        // 近似值, 仅用于调度判断
+        bool IsEmpty() const {
+            return mBottom.load(std::memory_order_relaxed) <= mTop.load(std::memory_order_relaxed);
+        }
+
+    private:
+        static constexpr int64_t MASK = Capacity - 1;
+
+        // 顶部被窃取者频繁写, 与所有者写的底部分开缓存行
+        alignas(64) std::atomic<int64_t> mTop{0};
+        alignas(64) std::atomic<int64_t> mBottom{0};
+        alignas(64) std::atomic<T> mBuffer[Capacity]{};
+    };
+}
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef AD_PARALLEL_CULLING_H
+#define AD_PARALLEL_CULLING_H
+
+#include "Culling/AdFrustumCuller.h"
+#include "Culling/AdSoftwareOcclusion.h"
+#include "Job/AdJobSystem.h"
+
+namespace ade {
+    /**
+     * 用任务系统执行 Platform 中的剔除, 剔除类本身不依赖 Core, 只提供按区间调用的接口
+     * 每段结果先写在输出数组中该段的起始位置, 全部完成后按顺序拼接, 结果与单线程调用完全相同
+     * 数量不超过 batchSize 时直接在当前线程执行
+     */
+
+    // 等价于 culler.Cull(frustum, outIndices), outIndices 至少 culler.GetCount() 个元素
+    uint32_t ParallelCull(AdJobSystem &jobSystem, const AdFrustumCuller &culler, const AdFrustum &frustum,
+                          uint32_t *outIndices, uint32_t batchSize = 4096);
+
+    // 等价于 culler.CullViews(frustums, viewCount, 0, culler.GetCount(), outIndices, outCounts)
+    void ParallelCullViews(AdJobSystem &jobSystem, const AdFrustumCuller &culler, const AdFrustum *frustums,
+                           uint32_t viewCount, uint32_t *const *outIndices, uint32_t *outCounts,
+                           uint32_t batchSize = 4096);
+
+    // 等价于 occlusion.Rasterize(), 各分块互不相关
+    void ParallelRasterize(AdJobSystem &jobSystem, AdSoftwareOcclusion &occlusion, uint32_t batchSize = 4);
+
+    // 等价于 occlusion.CullBoxes(boxes, count, outVisibleIndices, baseIndex)
+    uint32_t ParallelCullBoxes(AdJobSystem &jobSystem, const AdSoftwareOcclusion &occlusion,
+                               const AdBoundingBox *boxes, uint32_t count, uint32_t *outVisibleIndices,
+                               uint32_t baseIndex = 0, uint32_t batchSize = 1024);
+}
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef AD_RENDER_PROXY_H
+#define AD_RENDER_PROXY_H
+
+#include "Math/AdMatrix.h"
+#include "Culling/AdBounds.h"
+#include "Memory/AdFrameArena.h"
+#include <mutex>
+
+namespace ade {
+
+    // 一个可绘制对象在某一帧的快照, 只包含渲染需要的数据, 不引用游戏侧对象
+    struct AdRenderProxy {
+        AdMat4 world;
+        AdBoundingBox bounds;
+        uint32_t objectId = 0;
+        uint32_t meshId = 0;
+        uint32_t materialId = 0;
+    };
+
+    struct AdRenderView {
+        AdMat4 view;
+        AdMat4 projection;
+        AdMat4 viewProjection;
+        AdVec3 position;
+    };
+
+    /**
+     * 一帧交给渲染线程的全部数据: 游戏线程在 Extract 阶段写入, 之后只读, 直到渲染线程用完归还
+     * Extract 阶段的任务可以并行 AddProxies, 每次追加一段; 渲染侧通过 const 引用访问
+     * 帧内的临时数据(可见列表、排序键等)从 GetArena 分配, 帧被归还重用时统一回收
+     */
+    class AdRenderFrame {
+    public:
+        AdRenderFrame() = default;
+
+        AdRenderFrame(const AdRenderFrame &) = delete;
+
+        AdRenderFrame &operator=(const AdRenderFrame &) = delete;
+
+        // 保留容量, 避免每帧重新分配
+        void Reset(uint64_t frameIndex) {
+            mFrameIndex = frameIndex;
+            mView = {};
+            mProxies.clear();
+            mArena.Reset();
+        }
+
+        void SetView(const AdRenderView &view) { mView = view; }
+
+        // 返回这一段的起始下标
+        uint32_t AddProxies(const AdRenderProxy *proxies, uint32_t count) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            uint32_t first = static_cast<uint32_t>(mProxies.size());
+            mProxies.insert(mProxies.end(), proxies, proxies + count);
+            return first;
+        }
+
+        uint32_t AddProxy(const AdRenderProxy &proxy) { return AddProxies(&proxy, 1); }
+
+        uint64_t GetFrameIndex() const { return mFrameIndex; }
+
+        const AdRenderView &GetView() const { return mView; }
+
+        const std::vector<AdRenderProxy> &GetProxies() const { return mProxies; }
+
+        // 线程安全, 游戏侧和渲染侧都可以分配
+        AdFrameArena &GetArena() const { return mArena; }
+
+    private:
+        uint64_t mFrameIndex = 0;
+        AdRenderView mView;
+        std::vector<AdRenderProxy> mProxies;
+        std::mutex mMutex;
+        mutable AdFrameArena mArena;
+    };
+}
+
+#endif
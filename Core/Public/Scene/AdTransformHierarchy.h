@@ -0,0 +1,113 @@
+#ifndef AD_TRANSFORM_HIERARCHY_H
+#define AD_TRANSFORM_HIERARCHY_H
+
+#include "Math/AdMatrix.h"
+#include "Job/AdJobSystem.h"
+
+namespace ade {
+
+    // 相对父节点的变换, rotation 为四元数 xyzw
+    struct AdLocalTransform {
+        float position[3] = {0.0f, 0.0f, 0.0f};
+        float rotation[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+        float scale[3] = {1.0f, 1.0f, 1.0f};
+    };
+
+    /**
+     * 场景变换层级: 节点用稳定的句柄访问, 数据按深度排序存放在各自的数组中(局部变换、世界矩阵、父节点、脏标记)
+     * 同一深度的节点连续存放, 兄弟节点相邻; 父节点总在子节点所在层之前
+     *
+     * Update 时逐层处理: 局部变换被修改或父节点世界矩阵变化的节点才重新计算, 其他节点只检查一个标记
+     * 同一层的节点互不依赖, 可以分给多个线程: Update(AdJobSystem &), 或者自行调度
+     *   BeginUpdate -> 对每一层 [GetLevelRange] 分段调用 UpdateRange(层与层之间需要同步)
+     * 增删节点或改变父节点后, 下一次 BeginUpdate 重新排序
+     */
+    class AdTransformHierarchy {
+    public:
+        static constexpr uint32_t INVALID = UINT32_MAX;
+
+        AdTransformHierarchy() = default;
+
+        AdTransformHierarchy(const AdTransformHierarchy &) = delete;
+
+        AdTransformHierarchy &operator=(const AdTransformHierarchy &) = delete;
+
+        uint32_t GetNodeCount() const { return mNodeCount; }
+
+        // parent 为 INVALID 时为根节点
+        uint32_t CreateNode(uint32_t parent = INVALID, const AdLocalTransform &local = {});
+
+        // 同时销毁整个子树
+        void DestroyNode(uint32_t node);
+
+        bool IsValid(uint32_t node) const { return node < mNodeToIndex.size() && mNodeToIndex[node] != INVALID; }
+
+        uint32_t GetParent(uint32_t node) const { return mNodeParents[node]; }
+
+        // 不能把节点挂到自己的子树下
+        void SetParent(uint32_t node, uint32_t parent);
+
+        const AdLocalTransform &GetLocalTransform(uint32_t node) const { return mLocals[mNodeToIndex[node]]; }
+
+        void SetLocalTransform(uint32_t node, const AdLocalTransform &local);
+
+        // 列主序, 最近一次 Update 的结果
+        const float *GetWorldMatrix(uint32_t node) const { return mWorlds[mNodeToIndex[node]].Data(); }
+
+        // 最近一次 Update 中世界矩阵是否重新计算过, 用于增量更新包围盒、GPU 数据等
+        bool IsWorldChanged(uint32_t node) const { return mWorldChanged[mNodeToIndex[node]] != 0; }
+
+        // 追加最近一次 Update 中世界矩阵变化的节点句柄
+        void GetChangedNodes(std::vector<uint32_t> &outNodes) const;
+
+        // 单线程更新全部层
+        void Update();
+
+        // 每层分段并行更新, 层与层之间等待; 节点少的层直接在当前线程执行
+        void Update(AdJobSystem &jobSystem, uint32_t batchSize = 1024);
+
+        // 需要时重新按深度排序, 之后 GetLevelCount / GetLevelRange 有效
+        void BeginUpdate();
+
+        uint32_t GetLevelCount() const { return static_cast<uint32_t>(mLevelOffsets.size()) - 1; }
+
+        // 层内节点的存储下标范围 [begin, end)
+        void GetLevelRange(uint32_t level, uint32_t &outBegin, uint32_t &outEnd) const {
+            outBegin = mLevelOffsets[level];
+            outEnd = mLevelOffsets[level + 1];
+        }
+
+        // 更新存储下标 [begin, end) 的节点, 范围必须在同一层内, 且上一层已经更新完成
+        void UpdateRange(uint32_t begin, uint32_t end);
+
+    private:
+        // 按深度重新排序所有存储数组, 重新计算每层的范围
+        void RebuildOrder();
+
+        void LinkChild(uint32_t parent, uint32_t node);
+
+        void UnlinkChild(uint32_t node);
+
+        // 按句柄存储, 子节点为双向链表; 已销毁的句柄 mNodeToIndex 为 INVALID
+        std::vector<uint32_t> mNodeToIndex;
+        std::vector<uint32_t> mNodeParents;
+        std::vector<uint32_t> mFirstChildren;
+        std::vector<uint32_t> mNextSiblings;
+        std::vector<uint32_t> mPrevSiblings;
+        std::vector<uint32_t> mFreeNodes;
+
+        // 按存储下标, 深度排序; 重新排序前可能留有已销毁节点的位置
+        std::vector<uint32_t> mIndexToNode;
+        std::vector<uint32_t> mParentIndices;
+        std::vector<AdLocalTransform> mLocals;
+        std::vector<AdMat4> mWorlds;
+        std::vector<uint8_t> mLocalDirty;
+        std::vector<uint8_t> mWorldChanged;
+        std::vector<uint32_t> mDepths;
+        std::vector<uint32_t> mLevelOffsets = {0};
+        uint32_t mNodeCount = 0;
+        bool bOrderDirty = false;
+    };
+}
+
+#endif
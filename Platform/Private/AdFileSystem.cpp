@@ -0,0 +1,112 @@
+#include "AdFileSystem.h"
+#include "AdLog.h"
+
+namespace ade {
+
+    static const char *AD_DEFAULT_ARCHIVE_NAME = "Resource.adpak";
+
+    std::shared_mutex AdFileSystem::sMutex{};
+    std::vector<std::shared_ptr<AdArchive>> AdFileSystem::sArchives{};
+    std::string AdFileSystem::sLooseRootDir = AD_DEFINE_RES_ROOT_DIR;
+    bool AdFileSystem::bLooseFileFallback = true;
+
+    void AdFileSystem::Init(const std::string &looseRootDir) {
+        {
+            std::unique_lock<std::shared_mutex> lock(sMutex);
+            sLooseRootDir = looseRootDir;
+            if (!sLooseRootDir.empty() && sLooseRootDir.back() != '/') {
+                sLooseRootDir += '/';
+            }
+        }
+        Mount(sLooseRootDir + AD_DEFAULT_ARCHIVE_NAME);
+    }
+
+    bool AdFileSystem::Mount(const std::string &archivePath) {
+        std::shared_ptr<AdArchive> archive = AdArchive::Open(archivePath);
+        if (!archive) {
+            LOG_D("Skip mount archive: {0}", archivePath);
+            return false;
+        }
+        std::unique_lock<std::shared_mutex> lock(sMutex);
+        sArchives.insert(sArchives.begin(), archive);
+        return true;
+    }
+
+    void AdFileSystem::UnmountAll() {
+        std::unique_lock<std::shared_mutex> lock(sMutex);
+        sArchives.clear();
+    }
+
+    void AdFileSystem::SetLooseFileFallback(bool bEnable) {
+        std::unique_lock<std::shared_mutex> lock(sMutex);
+        bLooseFileFallback = bEnable;
+    }
+
+    AdFileView AdFileSystem::Read(const std::string &path) {
+        std::string normalizedPath = NormalizeResourcePath(path);
+        {
+            std::shared_lock<std::shared_mutex> lock(sMutex);
+            for (const auto &archive: sArchives) {
+                if (const AdArchiveEntry *entry = archive->FindEntry(normalizedPath)) {
+                    return archive->Read(*entry);
+                }
+            }
+            if (!bLooseFileFallback) {
+                LOG_E("Could not find {0} in mounted archives.", normalizedPath);
+                return {};
+            }
+        }
+        return ReadLooseFile(normalizedPath);
+    }
+
+    bool AdFileSystem::Exists(const std::string &path) {
+        std::string normalizedPath = NormalizeResourcePath(path);
+        std::shared_lock<std::shared_mutex> lock(sMutex);
+        for (const auto &archive: sArchives) {
+            if (archive->FindEntry(normalizedPath)) {
+                return true;
+            }
+        }
+        return bLooseFileFallback && std::ifstream(sLooseRootDir + normalizedPath).good();
+    }
+
+    bool AdFileSystem::Resolve(const std::string &path, AdFileLocation &outLocation) {
+        std::string normalizedPath = NormalizeResourcePath(path);
+        std::shared_lock<std::shared_mutex> lock(sMutex);
+        for (const auto &archive: sArchives) {
+            if (const AdArchiveEntry *entry = archive->FindEntry(normalizedPath)) {
+                outLocation.filePath = archive->GetPath();
+                outLocation.bLooseFile = false;
+                outLocation.offset = entry->offset;
+                outLocation.storedSize = entry->storedSize;
+                outLocation.size = entry->size;
+                outLocation.compression = static_cast<AdCompression>(entry->compression);
+                return true;
+            }
+        }
+        if (!bLooseFileFallback) {
+            return false;
+        }
+        outLocation = {};
+        outLocation.filePath = sLooseRootDir + normalizedPath;
+        outLocation.bLooseFile = true;
+        return true;
+    }
+
+    AdFileView AdFileSystem::ReadLooseFile(const std::string &path) {
+        std::string fullPath;
+        {
+            std::shared_lock<std::shared_mutex> lock(sMutex);
+            fullPath = sLooseRootDir + path;
+        }
+        std::ifstream file(fullPath, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            LOG_E("Could not open file: {0}", fullPath);
+            return {};
+        }
+        auto buffer = std::make_shared<std::vector<uint8_t>>(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char *>(buffer->data()), buffer->size());
+        return {buffer->data(), buffer->size(), buffer};
+    }
+}
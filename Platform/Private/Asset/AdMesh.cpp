@@ -0,0 +1,90 @@
+#include "Asset/AdMesh.h"
+#include "AdFileSystem.h"
+#include "AdLog.h"
+
+namespace ade {
+
+    std::unique_ptr<AdMesh> AdMesh::Load(const std::string &path) {
+        AdFileView view = AdFileSystem::Read(path);
+        if (!view) {
+            LOG_E("Could not read mesh: {0}", path);
+            return nullptr;
+        }
+        std::unique_ptr<AdMesh> mesh = Create(std::move(view));
+        if (!mesh) {
+            LOG_E("Invalid mesh file or version mismatch, recook it: {0}", path);
+        }
+        return mesh;
+    }
+
+    // 索引和 meshlet 会被直接上传给 GPU, 越界的值在着色器中读写缓冲区之外, 加载时逐个检查
+    static bool ValidateMeshData(const AdMeshHeader &header, const uint8_t *data) {
+        const uint8_t *indices = data + header.index.offset;
+        for (uint32_t i = 0; i < header.indexCount; i++) {
+            uint32_t index = header.indexSize == sizeof(uint16_t) ? reinterpret_cast<const uint16_t *>(indices)[i]
+                                                                  : reinterpret_cast<const uint32_t *>(indices)[i];
+            if (index >= header.vertexCount) {
+                return false;
+            }
+        }
+
+        const auto *meshlets = reinterpret_cast<const AdMeshlet *>(data + header.meshlet.offset);
+        const auto *meshletVertices = reinterpret_cast<const uint32_t *>(data + header.meshletVertex.offset);
+        const auto *meshletTriangles = reinterpret_cast<const uint32_t *>(data + header.meshletTriangle.offset);
+        uint64_t meshletCount = header.meshlet.size / sizeof(AdMeshlet);
+        uint64_t meshletVertexCount = header.meshletVertex.size / sizeof(uint32_t);
+        uint64_t meshletTriangleCount = header.meshletTriangle.size / sizeof(uint32_t);
+        for (uint64_t i = 0; i < meshletCount; i++) {
+            const AdMeshlet &meshlet = meshlets[i];
+            if (meshlet.vertexCount > AD_MESHLET_MAX_VERTICES || meshlet.triangleCount > AD_MESHLET_MAX_TRIANGLES
+                || uint64_t(meshlet.vertexOffset) + meshlet.vertexCount > meshletVertexCount
+                || uint64_t(meshlet.triangleOffset) + meshlet.triangleCount > meshletTriangleCount) {
+                return false;
+            }
+            for (uint32_t v = 0; v < meshlet.vertexCount; v++) {
+                if (meshletVertices[meshlet.vertexOffset + v] >= header.vertexCount) {
+                    return false;
+                }
+            }
+            for (uint32_t t = 0; t < meshlet.triangleCount; t++) {
+                uint32_t packed = meshletTriangles[meshlet.triangleOffset + t];
+                if ((packed & 0xff) >= meshlet.vertexCount || ((packed >> 8) & 0xff) >= meshlet.vertexCount
+                    || ((packed >> 16) & 0xff) >= meshlet.vertexCount) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    std::unique_ptr<AdMesh> AdMesh::Create(AdFileView view) {
+        // 打包条目和散文件都至少按 16 字节对齐, 流可以直接按类型访问
+        if (reinterpret_cast<uintptr_t>(view.GetData()) % alignof(AdMeshHeader) != 0) {
+            return nullptr;
+        }
+        const AdMeshHeader *header = GetMeshHeader(view.GetData(), view.GetSize());
+        if (!header || !ValidateMeshData(*header, view.GetData())) {
+            return nullptr;
+        }
+        return std::unique_ptr<AdMesh>(new AdMesh(std::move(view), header));
+    }
+
+    uint32_t AdMesh::GetIndex(uint32_t i) const {
+        const uint8_t *indices = GetStreamData(mHeader->index);
+        return mHeader->indexSize == sizeof(uint16_t) ? reinterpret_cast<const uint16_t *>(indices)[i]
+                                                      : reinterpret_cast<const uint32_t *>(indices)[i];
+    }
+
+    void AdMesh::GetVertexInputDescription(std::vector<VkVertexInputBindingDescription> &outBindings,
+                                           std::vector<VkVertexInputAttributeDescription> &outAttributes) {
+        outBindings = {
+                {.binding = 0, .stride = sizeof(AdMeshPosition), .inputRate = VK_VERTEX_INPUT_RATE_VERTEX},
+                {.binding = 1, .stride = sizeof(AdMeshAttribute), .inputRate = VK_VERTEX_INPUT_RATE_VERTEX}
+        };
+        outAttributes = {
+                {.location = 0, .binding = 0, .format = VK_FORMAT_R16G16B16A16_UNORM, .offset = 0},
+                {.location = 1, .binding = 1, .format = VK_FORMAT_R16G16_SNORM, .offset = offsetof(AdMeshAttribute, normal)},
+                {.location = 2, .binding = 1, .format = VK_FORMAT_R16G16_UNORM, .offset = offsetof(AdMeshAttribute, uv)}
+        };
+    }
+}
@@ -0,0 +1,574 @@
+#include "Culling/AdBvh.h"
+#include "AdLog.h"
+#include <cmath>
+
+namespace ade {
+
+    // SAH 构建时每个轴的分桶数量
+    static constexpr uint32_t SAH_BIN_COUNT = 12;
+
+    enum AdBvhOverlap {
+        AD_BVH_OVERLAP_OUTSIDE,
+        AD_BVH_OVERLAP_INTERSECT,
+        AD_BVH_OVERLAP_INSIDE           // 节点完全在查询范围内, 子树不用再测试
+    };
+
+    static float SurfaceArea(const AdBoundingBox &box) {
+        float dx = box.max[0] - box.min[0];
+        float dy = box.max[1] - box.min[1];
+        float dz = box.max[2] - box.min[2];
+        return 2.0f * (dx * dy + dy * dz + dz * dx);
+    }
+
+    static AdBoundingBox Union(const AdBoundingBox &a, const AdBoundingBox &b) {
+        AdBoundingBox box = a;
+        box.Expand(b);
+        return box;
+    }
+
+    static bool Contains(const AdBoundingBox &outer, const AdBoundingBox &inner) {
+        for (int i = 0; i < 3; i++) {
+            if (inner.min[i] < outer.min[i] || inner.max[i] > outer.max[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static float Centroid(const AdBoundingBox &box, int axis) {
+        return (box.min[axis] + box.max[axis]) * 0.5f;
+    }
+
+    // 遍历用的栈, 常见深度内不分配内存
+    template<typename T>
+    class AdBvhStack {
+    public:
+        void Push(T node) {
+            if (mSize < INLINE_SIZE) {
+                mInline[mSize] = node;
+            } else {
+                mOverflow.push_back(node);
+            }
+            mSize++;
+        }
+
+        T Pop() {
+            mSize--;
+            if (mSize < INLINE_SIZE) {
+                return mInline[mSize];
+            }
+            T node = mOverflow.back();
+            mOverflow.pop_back();
+            return node;
+        }
+
+        bool IsEmpty() const { return mSize == 0; }
+
+    private:
+        static constexpr uint32_t INLINE_SIZE = 64;
+        T mInline[INLINE_SIZE];
+        uint32_t mSize = 0;
+        std::vector<T> mOverflow;
+    };
+
+    // 查询时节点与父节点传下来的状态, 例如视锥剔除中父节点已经完全在内侧的平面
+    struct AdBvhQueryEntry {
+        uint32_t node;
+        uint32_t state;
+    };
+
+    void AdBvh::Clear() {
+        mNodes.clear();
+        mRoot = INVALID;
+        mFreeList = INVALID;
+        mLeafCount = 0;
+    }
+
+    uint32_t AdBvh::AllocateNode() {
+        uint32_t node;
+        if (mFreeList != INVALID) {
+            node = mFreeList;
+            mFreeList = mNodes[node].parent;
+        } else {
+            node = static_cast<uint32_t>(mNodes.size());
+            mNodes.emplace_back();
+        }
+        Node &n = mNodes[node];
+        n.box = {};
+        n.parent = INVALID;
+        n.children[0] = n.children[1] = INVALID;
+        n.userData = INVALID;
+        n.height = 0;
+        return node;
+    }
+
+    void AdBvh::FreeNode(uint32_t node) {
+        mNodes[node].parent = mFreeList;
+        mNodes[node].children[0] = mNodes[node].children[1] = INVALID;
+        mNodes[node].height = -1;
+        mFreeList = node;
+    }
+
+    void AdBvh::Build(const AdBoundingBox *boxes, const uint32_t *userData, uint32_t count, uint32_t *outProxies) {
+        Clear();
+        mNodes.reserve(size_t(count) * 2);
+        std::vector<uint32_t> leaves(count);
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t leaf = AllocateNode();
+            mNodes[leaf].box = boxes[i];
+            mNodes[leaf].userData = userData ? userData[i] : i;
+            leaves[i] = leaf;
+            if (outProxies) {
+                outProxies[i] = leaf;
+            }
+        }
+        mLeafCount = count;
+        if (count > 0) {
+            mRoot = BuildRange(leaves, 0, count);
+            mNodes[mRoot].parent = INVALID;
+        }
+    }
+
+    void AdBvh::Rebuild() {
+        std::vector<uint32_t> leaves;
+        leaves.reserve(mLeafCount);
+        for (uint32_t i = 0; i < mNodes.size(); i++) {
+            if (mNodes[i].height == 0) {
+                leaves.push_back(i);
+            } else if (mNodes[i].height > 0) {
+                FreeNode(i);
+            }
+        }
+        mRoot = INVALID;
+        if (!leaves.empty()) {
+            mRoot = BuildRange(leaves, 0, static_cast<uint32_t>(leaves.size()));
+            mNodes[mRoot].parent = INVALID;
+        }
+    }
+
+    uint32_t AdBvh::BuildRange(std::vector<uint32_t> &leaves, uint32_t begin, uint32_t end) {
+        if (end - begin == 1) {
+            return leaves[begin];
+        }
+
+        AdBoundingBox centroidBounds;
+        for (uint32_t i = begin; i < end; i++) {
+            const AdBoundingBox &box = mNodes[leaves[i]].box;
+            float centroid[3] = {Centroid(box, 0), Centroid(box, 1), Centroid(box, 2)};
+            centroidBounds.Expand(centroid);
+        }
+
+        // 三个轴上分桶, 代价为 左侧数量 * 左侧表面积 + 右侧数量 * 右侧表面积, 取最小的切分
+        int bestAxis = -1;
+        uint32_t bestSplit = 0;
+        float bestCost = FLT_MAX;
+        for (int axis = 0; axis < 3; axis++) {
+            float extent = centroidBounds.max[axis] - centroidBounds.min[axis];
+            if (extent <= 0.0f) {
+                continue;
+            }
+            float scale = static_cast<float>(SAH_BIN_COUNT) / extent;
+            AdBoundingBox binBoxes[SAH_BIN_COUNT];
+            uint32_t binCounts[SAH_BIN_COUNT] = {};
+            for (uint32_t i = begin; i < end; i++) {
+                const AdBoundingBox &box = mNodes[leaves[i]].box;
+                uint32_t bin = std::min(SAH_BIN_COUNT - 1, static_cast<uint32_t>(
+                        (Centroid(box, axis) - centroidBounds.min[axis]) * scale));
+                binBoxes[bin].Expand(box);
+                binCounts[bin]++;
+            }
+            // 从右往左累计, rightCosts[i] 为桶 [i, SAH_BIN_COUNT) 的代价
+            float rightCosts[SAH_BIN_COUNT];
+            AdBoundingBox rightBox;
+            uint32_t rightCount = 0;
+            for (uint32_t bin = SAH_BIN_COUNT - 1; bin > 0; bin--) {
+                rightBox.Expand(binBoxes[bin]);
+                rightCount += binCounts[bin];
+                rightCosts[bin] = rightCount > 0 ? static_cast<float>(rightCount) * SurfaceArea(rightBox) : 0.0f;
+            }
+            AdBoundingBox leftBox;
+            uint32_t leftCount = 0;
+            for (uint32_t split = 1; split < SAH_BIN_COUNT; split++) {
+                leftBox.Expand(binBoxes[split - 1]);
+                leftCount += binCounts[split - 1];
+                if (leftCount == 0 || leftCount == end - begin) {
+                    continue;
+                }
+                float cost = static_cast<float>(leftCount) * SurfaceArea(leftBox) + rightCosts[split];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = split;
+                }
+            }
+        }
+
+        uint32_t middle;
+        if (bestAxis >= 0) {
+            float axisMin = centroidBounds.min[bestAxis];
+            float scale = static_cast<float>(SAH_BIN_COUNT) / (centroidBounds.max[bestAxis] - axisMin);
+            middle = static_cast<uint32_t>(std::partition(leaves.begin() + begin, leaves.begin() + end,
+                                                          [&](uint32_t leaf) {
+                uint32_t bin = std::min(SAH_BIN_COUNT - 1, static_cast<uint32_t>(
+                        (Centroid(mNodes[leaf].box, bestAxis) - axisMin) * scale));
+                return bin < bestSplit;
+            }) - leaves.begin());
+        } else {
+            // 中心点重合, 按数量对半分
+            middle = begin + (end - begin) / 2;
+        }
+
+        uint32_t left = BuildRange(leaves, begin, middle);
+        uint32_t right = BuildRange(leaves, middle, end);
+        uint32_t node = AllocateNode();
+        Node &n = mNodes[node];
+        n.children[0] = left;
+        n.children[1] = right;
+        n.box = Union(mNodes[left].box, mNodes[right].box);
+        n.height = 1 + std::max(mNodes[left].height, mNodes[right].height);
+        mNodes[left].parent = node;
+        mNodes[right].parent = node;
+        return node;
+    }
+
+    uint32_t AdBvh::Insert(const AdBoundingBox &box, uint32_t userData) {
+        uint32_t leaf = AllocateNode();
+        Node &n = mNodes[leaf];
+        n.box = box;
+        for (int i = 0; i < 3; i++) {
+            n.box.min[i] -= mFatMargin;
+            n.box.max[i] += mFatMargin;
+        }
+        n.userData = userData;
+        InsertLeaf(leaf);
+        mLeafCount++;
+        return leaf;
+    }
+
+    void AdBvh::Remove(uint32_t proxy) {
+        if (proxy >= mNodes.size() || mNodes[proxy].height != 0) {
+            LOG_E("Bvh remove invalid proxy {0}", proxy);
+            return;
+        }
+        RemoveLeaf(proxy);
+        FreeNode(proxy);
+        mLeafCount--;
+    }
+
+    bool AdBvh::Update(uint32_t proxy, const AdBoundingBox &box) {
+        if (proxy >= mNodes.size() || mNodes[proxy].height != 0) {
+            LOG_E("Bvh update invalid proxy {0}", proxy);
+            return false;
+        }
+        if (Contains(mNodes[proxy].box, box)) {
+            return false;
+        }
+        RemoveLeaf(proxy);
+        AdBoundingBox &fatBox = mNodes[proxy].box;
+        fatBox = box;
+        for (int i = 0; i < 3; i++) {
+            fatBox.min[i] -= mFatMargin;
+            fatBox.max[i] += mFatMargin;
+        }
+        InsertLeaf(proxy);
+        return true;
+    }
+
+    void AdBvh::InsertLeaf(uint32_t leaf) {
+        if (mRoot == INVALID) {
+            mRoot = leaf;
+            mNodes[leaf].parent = INVALID;
+            return;
+        }
+
+        // 自顶向下找代价最小的兄弟节点: 在这里新建父节点, 或者继续下到某个子节点
+        // 祖先节点因为包含新叶子而增加的表面积是下行的继承代价
+        const AdBoundingBox leafBox = mNodes[leaf].box;
+        uint32_t index = mRoot;
+        while (!mNodes[index].IsLeaf()) {
+            const Node &node = mNodes[index];
+            float area = SurfaceArea(node.box);
+            float combinedArea = SurfaceArea(Union(node.box, leafBox));
+            float cost = 2.0f * combinedArea;
+            float inheritanceCost = 2.0f * (combinedArea - area);
+            float childCosts[2];
+            for (int c = 0; c < 2; c++) {
+                const Node &child = mNodes[node.children[c]];
+                float childArea = SurfaceArea(Union(leafBox, child.box));
+                childCosts[c] = (child.IsLeaf() ? childArea : childArea - SurfaceArea(child.box)) + inheritanceCost;
+            }
+            if (cost < childCosts[0] && cost < childCosts[1]) {
+                break;
+            }
+            index = childCosts[0] < childCosts[1] ? node.children[0] : node.children[1];
+        }
+
+        uint32_t sibling = index;
+        uint32_t oldParent = mNodes[sibling].parent;
+        uint32_t newParent = AllocateNode();
+        Node &parent = mNodes[newParent];
+        parent.parent = oldParent;
+        parent.box = Union(leafBox, mNodes[sibling].box);
+        parent.height = mNodes[sibling].height + 1;
+        parent.children[0] = sibling;
+        parent.children[1] = leaf;
+        if (oldParent != INVALID) {
+            Node &old = mNodes[oldParent];
+            old.children[old.children[0] == sibling ? 0 : 1] = newParent;
+        } else {
+            mRoot = newParent;
+        }
+        mNodes[sibling].parent = newParent;
+        mNodes[leaf].parent = newParent;
+
+        // 向上更新包围盒和高度
+        index = newParent;
+        while (index != INVALID) {
+            index = Balance(index);
+            Node &node = mNodes[index];
+            node.height = 1 + std::max(mNodes[node.children[0]].height, mNodes[node.children[1]].height);
+            node.box = Union(mNodes[node.children[0]].box, mNodes[node.children[1]].box);
+            index = node.parent;
+        }
+    }
+
+    void AdBvh::RemoveLeaf(uint32_t leaf) {
+        if (leaf == mRoot) {
+            mRoot = INVALID;
+            return;
+        }
+        uint32_t parent = mNodes[leaf].parent;
+        uint32_t grandParent = mNodes[parent].parent;
+        uint32_t sibling = mNodes[parent].children[0] == leaf ? mNodes[parent].children[1]
+                                                              : mNodes[parent].children[0];
+        FreeNode(parent);
+        mNodes[sibling].parent = grandParent;
+        if (grandParent == INVALID) {
+            mRoot = sibling;
+            return;
+        }
+        Node &grand = mNodes[grandParent];
+        grand.children[grand.children[0] == parent ? 0 : 1] = sibling;
+
+        uint32_t index = grandParent;
+        while (index != INVALID) {
+            index = Balance(index);
+            Node &node = mNodes[index];
+            node.height = 1 + std::max(mNodes[node.children[0]].height, mNodes[node.children[1]].height);
+            node.box = Union(mNodes[node.children[0]].box, mNodes[node.children[1]].box);
+            index = node.parent;
+        }
+    }
+
+    uint32_t AdBvh::Balance(uint32_t iA) {
+        Node &A = mNodes[iA];
+        if (A.IsLeaf() || A.height < 2) {
+            return iA;
+        }
+        uint32_t iB = A.children[0];
+        uint32_t iC = A.children[1];
+        Node &B = mNodes[iB];
+        Node &C = mNodes[iC];
+        int32_t balance = C.height - B.height;
+
+        // 把较高的子节点提到 A 的位置, 它较高的子节点留在下面, 较矮的交给 A
+        if (balance > 1 || balance < -1) {
+            bool bRotateC = balance > 1;
+            uint32_t iUp = bRotateC ? iC : iB;
+            uint32_t iStay = bRotateC ? iB : iC;
+            Node &up = mNodes[iUp];
+            uint32_t iF = up.children[0];
+            uint32_t iG = up.children[1];
+
+            up.children[0] = iA;
+            up.parent = A.parent;
+            A.parent = iUp;
+            if (up.parent != INVALID) {
+                Node &upParent = mNodes[up.parent];
+                upParent.children[upParent.children[0] == iA ? 0 : 1] = iUp;
+            } else {
+                mRoot = iUp;
+            }
+
+            uint32_t iHigh = mNodes[iF].height > mNodes[iG].height ? iF : iG;
+            uint32_t iLow = iHigh == iF ? iG : iF;
+            up.children[1] = iHigh;
+            A.children[bRotateC ? 1 : 0] = iLow;
+            mNodes[iLow].parent = iA;
+            A.box = Union(mNodes[iStay].box, mNodes[iLow].box);
+            A.height = 1 + std::max(mNodes[iStay].height, mNodes[iLow].height);
+            up.box = Union(A.box, mNodes[iHigh].box);
+            up.height = 1 + std::max(A.height, mNodes[iHigh].height);
+            return iUp;
+        }
+        return iA;
+    }
+
+    template<typename OverlapFunc>
+    void AdBvh::Query(OverlapFunc overlap, std::vector<uint32_t> &outUserData) const {
+        if (mRoot == INVALID) {
+            return;
+        }
+        AdBvhStack<AdBvhQueryEntry> stack;
+        stack.Push({mRoot, 0});
+        while (!stack.IsEmpty()) {
+            AdBvhQueryEntry entry = stack.Pop();
+            const Node &node = mNodes[entry.node];
+            AdBvhOverlap result = overlap(node.box, entry.state);
+            if (result == AD_BVH_OVERLAP_OUTSIDE) {
+                continue;
+            }
+            if (node.IsLeaf()) {
+                outUserData.push_back(node.userData);
+            } else if (result == AD_BVH_OVERLAP_INSIDE) {
+                CollectLeaves(node.children[0], outUserData);
+                CollectLeaves(node.children[1], outUserData);
+            } else {
+                stack.Push({node.children[0], entry.state});
+                stack.Push({node.children[1], entry.state});
+            }
+        }
+    }
+
+    void AdBvh::CollectLeaves(uint32_t root, std::vector<uint32_t> &outUserData) const {
+        AdBvhStack<uint32_t> stack;
+        stack.Push(root);
+        while (!stack.IsEmpty()) {
+            const Node &node = mNodes[stack.Pop()];
+            if (node.IsLeaf()) {
+                outUserData.push_back(node.userData);
+            } else {
+                stack.Push(node.children[0]);
+                stack.Push(node.children[1]);
+            }
+        }
+    }
+
+    void AdBvh::QueryFrustum(const AdFrustum &frustum, std::vector<uint32_t> &outUserData) const {
+        // state 的第 i 位表示父节点已经完全在第 i 个平面内侧, 子节点不用再测试
+        Query([&frustum](const AdBoundingBox &box, uint32_t &insideMask) {
+            float center[3], extent[3];
+            for (int i = 0; i < 3; i++) {
+                center[i] = (box.min[i] + box.max[i]) * 0.5f;
+                extent[i] = (box.max[i] - box.min[i]) * 0.5f;
+            }
+            AdBvhOverlap result = AD_BVH_OVERLAP_INSIDE;
+            for (int p = 0; p < 6; p++) {
+                if (insideMask & (1u << p)) {
+                    continue;
+                }
+                const float *plane = frustum.planes[p];
+                float distance = plane[0] * center[0] + plane[1] * center[1] + plane[2] * center[2] + plane[3];
+                float radius = std::fabs(plane[0]) * extent[0] + std::fabs(plane[1]) * extent[1]
+                               + std::fabs(plane[2]) * extent[2];
+                if (distance + radius < 0.0f) {
+                    return AD_BVH_OVERLAP_OUTSIDE;
+                }
+                if (distance - radius < 0.0f) {
+                    result = AD_BVH_OVERLAP_INTERSECT;
+                } else {
+                    insideMask |= 1u << p;
+                }
+            }
+            return result;
+        }, outUserData);
+    }
+
+    void AdBvh::QueryBox(const AdBoundingBox &query, std::vector<uint32_t> &outUserData) const {
+        Query([&query](const AdBoundingBox &box, uint32_t &) {
+            for (int i = 0; i < 3; i++) {
+                if (box.max[i] < query.min[i] || box.min[i] > query.max[i]) {
+                    return AD_BVH_OVERLAP_OUTSIDE;
+                }
+            }
+            return Contains(query, box) ? AD_BVH_OVERLAP_INSIDE : AD_BVH_OVERLAP_INTERSECT;
+        }, outUserData);
+    }
+
+    void AdBvh::QuerySphere(const AdBoundingSphere &sphere, std::vector<uint32_t> &outUserData) const {
+        float radiusSquared = sphere.radius * sphere.radius;
+        Query([&sphere, radiusSquared](const AdBoundingBox &box, uint32_t &) {
+            // 最近点和最远角到球心的距离
+            float nearest = 0.0f;
+            float farthest = 0.0f;
+            for (int i = 0; i < 3; i++) {
+                float c = sphere.center[i];
+                float d = c < box.min[i] ? box.min[i] - c : (c > box.max[i] ? c - box.max[i] : 0.0f);
+                nearest += d * d;
+                float f = std::max(std::fabs(c - box.min[i]), std::fabs(c - box.max[i]));
+                farthest += f * f;
+            }
+            if (nearest > radiusSquared) {
+                return AD_BVH_OVERLAP_OUTSIDE;
+            }
+            return farthest <= radiusSquared ? AD_BVH_OVERLAP_INSIDE : AD_BVH_OVERLAP_INTERSECT;
+        }, outUserData);
+    }
+
+    // 射线与包围盒的进入距离, 起点在盒内时为 0, 不相交或超过 maxDistance 时返回负数
+    static float IntersectRayBox(const AdRay &ray, const float invDirection[3], const AdBoundingBox &box,
+                                 float maxDistance) {
+        float tMin = 0.0f;
+        float tMax = maxDistance;
+        for (int i = 0; i < 3; i++) {
+            float t0 = (box.min[i] - ray.origin[i]) * invDirection[i];
+            float t1 = (box.max[i] - ray.origin[i]) * invDirection[i];
+            if (t0 > t1) {
+                std::swap(t0, t1);
+            }
+            // 方向分量为 0 且起点在平板边界上时为 NaN, 此时不收窄范围
+            tMin = t0 > tMin ? t0 : tMin;
+            tMax = t1 < tMax ? t1 : tMax;
+            if (tMin > tMax) {
+                return -1.0f;
+            }
+        }
+        return tMin;
+    }
+
+    bool AdBvh::RayCast(const AdRay &ray, AdRayHit &outHit,
+                        const std::function<float(uint32_t userData, const AdRay &ray)> &hitTest) const {
+        outHit = {};
+        if (mRoot == INVALID) {
+            return false;
+        }
+        float invDirection[3];
+        for (int i = 0; i < 3; i++) {
+            invDirection[i] = 1.0f / ray.direction[i];
+        }
+
+        float closest = ray.maxDistance;
+        AdBvhStack<uint32_t> stack;
+        stack.Push(mRoot);
+        while (!stack.IsEmpty()) {
+            const Node &node = mNodes[stack.Pop()];
+            if (IntersectRayBox(ray, invDirection, node.box, closest) < 0.0f) {
+                continue;
+            }
+            if (node.IsLeaf()) {
+                float distance = hitTest ? hitTest(node.userData, ray)
+                                         : IntersectRayBox(ray, invDirection, node.box, closest);
+                if (distance >= 0.0f && distance <= closest) {
+                    closest = distance;
+                    outHit.userData = node.userData;
+                    outHit.distance = distance;
+                }
+                continue;
+            }
+            // 近的子节点后入栈, 先遍历, 尽早缩短 closest
+            float distances[2];
+            for (int c = 0; c < 2; c++) {
+                distances[c] = IntersectRayBox(ray, invDirection, mNodes[node.children[c]].box, closest);
+            }
+            int nearChild = (distances[1] >= 0.0f && (distances[0] < 0.0f || distances[1] < distances[0])) ? 1 : 0;
+            int farChild = 1 - nearChild;
+            if (distances[farChild] >= 0.0f) {
+                stack.Push(node.children[farChild]);
+            }
+            if (distances[nearChild] >= 0.0f) {
+                stack.Push(node.children[nearChild]);
+            }
+        }
+        return outHit.userData != INVALID;
+    }
+}
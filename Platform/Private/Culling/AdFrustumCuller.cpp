@@ -0,0 +1,175 @@
+#include "Culling/AdFrustumCuller.h"
+#include "Culling/AdCullingSimd.h"
+#include "AdLog.h"
+#include <cmath>
+
+namespace ade {
+
+    // 空包围体的半径, 与任何平面的距离都是负数
+    static constexpr float EMPTY_RADIUS = -FLT_MAX;
+
+    void ExtractFrustumPlanes(const float viewProj[16], AdFrustum &outFrustum) {
+        // 列主序, 第 i 行为 (m[i], m[4 + i], m[8 + i], m[12 + i])
+        float rows[4][4];
+        for (int r = 0; r < 4; r++) {
+            for (int c = 0; c < 4; c++) {
+                rows[r][c] = viewProj[c * 4 + r];
+            }
+        }
+        // 左右下上: w +- x, w +- y; 近: z >= 0; 远: z <= w
+        for (int c = 0; c < 4; c++) {
+            outFrustum.planes[0][c] = rows[3][c] + rows[0][c];
+            outFrustum.planes[1][c] = rows[3][c] - rows[0][c];
+            outFrustum.planes[2][c] = rows[3][c] + rows[1][c];
+            outFrustum.planes[3][c] = rows[3][c] - rows[1][c];
+            outFrustum.planes[4][c] = rows[2][c];
+            outFrustum.planes[5][c] = rows[3][c] - rows[2][c];
+        }
+        for (float *plane: outFrustum.planes) {
+            float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+            if (length > 0.0f) {
+                for (int c = 0; c < 4; c++) {
+                    plane[c] /= length;
+                }
+            }
+        }
+    }
+
+    void AdFrustumCuller::Resize(uint32_t count) {
+        size_t capacity = size_t(count) + AD_LANE_COUNT;
+        for (std::vector<float> *stream: {&mCenterX, &mCenterY, &mCenterZ, &mExtentX, &mExtentY, &mExtentZ}) {
+            stream->resize(capacity, 0.0f);
+        }
+        mRadius.resize(capacity, EMPTY_RADIUS);
+        // 缩小后把多出来的位置重置为空, 扩大时再用不会残留旧数据
+        for (size_t i = count; i < std::min(size_t(mCount), capacity); i++) {
+            SetEmpty(i);
+        }
+        mCount = count;
+    }
+
+    void AdFrustumCuller::SetEmpty(size_t index) {
+        mCenterX[index] = mCenterY[index] = mCenterZ[index] = 0.0f;
+        mExtentX[index] = mExtentY[index] = mExtentZ[index] = 0.0f;
+        mRadius[index] = EMPTY_RADIUS;
+    }
+
+    void AdFrustumCuller::SetBounds(uint32_t index, const AdBoundingBox &box) {
+        if (index >= mCount) {
+            LOG_E("Frustum culler bounds index {0} out of range {1}", index, mCount);
+            return;
+        }
+        if (!box.IsValid()) {
+            SetEmpty(index);
+            return;
+        }
+        mCenterX[index] = (box.min[0] + box.max[0]) * 0.5f;
+        mCenterY[index] = (box.min[1] + box.max[1]) * 0.5f;
+        mCenterZ[index] = (box.min[2] + box.max[2]) * 0.5f;
+        mExtentX[index] = (box.max[0] - box.min[0]) * 0.5f;
+        mExtentY[index] = (box.max[1] - box.min[1]) * 0.5f;
+        mExtentZ[index] = (box.max[2] - box.min[2]) * 0.5f;
+        mRadius[index] = 0.0f;
+    }
+
+    void AdFrustumCuller::SetBounds(uint32_t index, const AdBoundingSphere &sphere) {
+        if (index >= mCount) {
+            LOG_E("Frustum culler bounds index {0} out of range {1}", index, mCount);
+            return;
+        }
+        mCenterX[index] = sphere.center[0];
+        mCenterY[index] = sphere.center[1];
+        mCenterZ[index] = sphere.center[2];
+        mExtentX[index] = mExtentY[index] = mExtentZ[index] = 0.0f;
+        mRadius[index] = sphere.radius;
+    }
+
+    // 平面常量广播到每一路
+    struct AdFrustumLanes {
+        AdLaneF normal[6][3];
+        AdLaneF absNormal[6][3];
+        AdLaneF distance[6];
+    };
+
+    static void LoadFrustumLanes(const AdFrustum &frustum, AdFrustumLanes &outLanes) {
+        for (int p = 0; p < 6; p++) {
+            for (int c = 0; c < 3; c++) {
+                outLanes.normal[p][c] = LaneSet(frustum.planes[p][c]);
+                outLanes.absNormal[p][c] = LaneSet(std::fabs(frustum.planes[p][c]));
+            }
+            outLanes.distance[p] = LaneSet(frustum.planes[p][3]);
+        }
+    }
+
+    // 包围体不完全在任何一个平面外侧时可见: dot(n, c) + w >= -(r + dot(|n|, e))
+    static uint32_t TestFrustumLanes(const AdFrustumLanes &frustum, AdLaneF centerX, AdLaneF centerY, AdLaneF centerZ,
+                                     AdLaneF extentX, AdLaneF extentY, AdLaneF extentZ, AdLaneF radius) {
+        const AdLaneF minusOne = LaneSet(-1.0f);
+        AdLaneF inside = LaneGreaterEqual(radius, radius);
+        for (int p = 0; p < 6; p++) {
+            AdLaneF distance = LaneMulAdd(frustum.normal[p][0], centerX,
+                                          LaneMulAdd(frustum.normal[p][1], centerY,
+                                                     LaneMulAdd(frustum.normal[p][2], centerZ, frustum.distance[p])));
+            AdLaneF reach = LaneMulAdd(frustum.absNormal[p][0], extentX,
+                                       LaneMulAdd(frustum.absNormal[p][1], extentY,
+                                                  LaneMulAdd(frustum.absNormal[p][2], extentZ, radius)));
+            inside = LaneAnd(inside, LaneGreaterEqual(distance, LaneMul(minusOne, reach)));
+        }
+        return LaneMask(inside);
+    }
+
+    // 无分支压缩: 每一路都写入, 只有可见的路推进计数; 写入位置不会超过已处理的数量
+    static uint32_t AppendVisible(uint32_t mask, uint32_t baseIndex, uint32_t laneCount, uint32_t *outIndices,
+                                  uint32_t count) {
+        if (mask == 0) {
+            return count;
+        }
+        for (uint32_t lane = 0; lane < laneCount; lane++) {
+            outIndices[count] = baseIndex + lane;
+            count += (mask >> lane) & 1u;
+        }
+        return count;
+    }
+
+    uint32_t AdFrustumCuller::Cull(const AdFrustum &frustum, uint32_t begin, uint32_t end,
+                                   uint32_t *outIndices) const {
+        uint32_t count = 0;
+        CullViews(&frustum, 1, begin, end, &outIndices, &count);
+        return count;
+    }
+
+    void AdFrustumCuller::CullViews(const AdFrustum *frustums, uint32_t viewCount, uint32_t begin, uint32_t end,
+                                    uint32_t *const *outIndices, uint32_t *outCounts) const {
+        // 平面常量放在栈上, 视图较多时分几次遍历
+        if (viewCount > MAX_VIEW_COUNT) {
+            for (uint32_t view = 0; view < viewCount; view += MAX_VIEW_COUNT) {
+                CullViews(frustums + view, std::min(MAX_VIEW_COUNT, viewCount - view), begin, end, outIndices + view,
+                          outCounts + view);
+            }
+            return;
+        }
+        end = std::min(end, mCount);
+        AdFrustumLanes lanes[MAX_VIEW_COUNT];
+        for (uint32_t view = 0; view < viewCount; view++) {
+            LoadFrustumLanes(frustums[view], lanes[view]);
+            outCounts[view] = 0;
+        }
+
+        for (uint32_t i = begin; i < end; i += AD_LANE_COUNT) {
+            AdLaneF centerX = LaneLoad(&mCenterX[i]);
+            AdLaneF centerY = LaneLoad(&mCenterY[i]);
+            AdLaneF centerZ = LaneLoad(&mCenterZ[i]);
+            AdLaneF extentX = LaneLoad(&mExtentX[i]);
+            AdLaneF extentY = LaneLoad(&mExtentY[i]);
+            AdLaneF extentZ = LaneLoad(&mExtentZ[i]);
+            AdLaneF radius = LaneLoad(&mRadius[i]);
+            // 最后一批超出 end 的路不输出
+            uint32_t laneCount = std::min(AD_LANE_COUNT, end - i);
+            for (uint32_t view = 0; view < viewCount; view++) {
+                uint32_t mask = TestFrustumLanes(lanes[view], centerX, centerY, centerZ, extentX, extentY, extentZ,
+                                                 radius);
+                outCounts[view] = AppendVisible(mask, i, laneCount, outIndices[view], outCounts[view]);
+            }
+        }
+    }
+}
@@ -0,0 +1,371 @@
+#include "Culling/AdSoftwareOcclusion.h"
+#include "Culling/AdCullingSimd.h"
+#include "Asset/AdMesh.h"
+#include <cmath>
+#include <cstring>
+
+namespace ade {
+
+    // 列主序 4x4 矩阵乘法: out = a * b
+    static void MultiplyMatrix(const float a[16], const float b[16], float out[16]) {
+        for (int c = 0; c < 4; c++) {
+            for (int r = 0; r < 4; r++) {
+                out[c * 4 + r] = a[r] * b[c * 4] + a[4 + r] * b[c * 4 + 1] + a[8 + r] * b[c * 4 + 2]
+                                 + a[12 + r] * b[c * 4 + 3];
+            }
+        }
+    }
+
+    static void TransformPoint(const float m[16], float x, float y, float z, float outClip[4]) {
+        for (int r = 0; r < 4; r++) {
+            outClip[r] = m[r] * x + m[4 + r] * y + m[8 + r] * z + m[12 + r];
+        }
+    }
+
+    AdSoftwareOcclusion::AdSoftwareOcclusion(const AdSoftwareOcclusionSettings &settings) {
+        mTileCountX = std::max(1u, (settings.width + TILE_WIDTH - 1) / TILE_WIDTH);
+        mTileCountY = std::max(1u, (settings.height + TILE_HEIGHT - 1) / TILE_HEIGHT);
+        mWidth = mTileCountX * TILE_WIDTH;
+        mHeight = mTileCountY * TILE_HEIGHT;
+        mDepth.resize(size_t(mWidth) * mHeight, 1.0f);
+        mBlockCountX = mWidth / BLOCK_SIZE;
+        mBlockMaxDepth.resize(size_t(mBlockCountX) * (mHeight / BLOCK_SIZE), 1.0f);
+        mTileBins.resize(GetTileCount());
+    }
+
+    void AdSoftwareOcclusion::Begin(const float viewProj[16]) {
+        memcpy(mViewProj, viewProj, sizeof(mViewProj));
+        mTriangles.clear();
+        for (std::vector<uint32_t> &bin: mTileBins) {
+            bin.clear();
+        }
+    }
+
+    void AdSoftwareOcclusion::AddOccluder(const float *positions, uint32_t vertexCount, uint32_t stride,
+                                          const uint32_t *indices, uint32_t indexCount, const float model[16]) {
+        float modelViewProj[16];
+        if (model) {
+            MultiplyMatrix(mViewProj, model, modelViewProj);
+        } else {
+            memcpy(modelViewProj, mViewProj, sizeof(modelViewProj));
+        }
+
+        mScreenVertices.resize(vertexCount);
+        const uint8_t *vertexData = reinterpret_cast<const uint8_t *>(positions);
+        for (uint32_t i = 0; i < vertexCount; i++) {
+            const float *p = reinterpret_cast<const float *>(vertexData + size_t(i) * stride);
+            float clip[4];
+            TransformPoint(modelViewProj, p[0], p[1], p[2], clip);
+            ScreenVertex &v = mScreenVertices[i];
+            v.bValid = clip[3] > 1e-5f && clip[2] >= 0.0f;
+            float invW = v.bValid ? 1.0f / clip[3] : 0.0f;
+            // NDC -> 像素, Vulkan 的 y 向下, 与深度缓冲的行一致
+            v.x = (clip[0] * invW * 0.5f + 0.5f) * static_cast<float>(mWidth);
+            v.y = (clip[1] * invW * 0.5f + 0.5f) * static_cast<float>(mHeight);
+            v.z = clip[2] * invW;
+        }
+        for (uint32_t i = 0; i + 2 < indexCount; i += 3) {
+            if (indices[i] >= vertexCount || indices[i + 1] >= vertexCount || indices[i + 2] >= vertexCount) {
+                continue;
+            }
+            SetupTriangle(mScreenVertices[indices[i]], mScreenVertices[indices[i + 1]],
+                          mScreenVertices[indices[i + 2]]);
+        }
+    }
+
+    void AdSoftwareOcclusion::AddOccluder(const AdMesh &mesh, const float model[16], uint32_t lod) {
+        const AdMeshHeader &header = mesh.GetHeader();
+        if (header.lodCount == 0) {
+            return;
+        }
+        const AdMeshLod &meshLod = mesh.GetLod(std::min(lod, header.lodCount - 1));
+        std::vector<float> positions(size_t(header.vertexCount) * 3);
+        const AdMeshPosition *quantized = mesh.GetPositions();
+        for (uint32_t i = 0; i < header.vertexCount; i++) {
+            DecodeMeshPosition(header, quantized[i], &positions[size_t(i) * 3]);
+        }
+        std::vector<uint32_t> indices(meshLod.indexCount);
+        for (uint32_t i = 0; i < meshLod.indexCount; i++) {
+            indices[i] = mesh.GetIndex(meshLod.indexOffset + i);
+        }
+        AddOccluder(positions.data(), header.vertexCount, sizeof(float) * 3, indices.data(),
+                    static_cast<uint32_t>(indices.size()), model);
+    }
+
+    void AdSoftwareOcclusion::SetupTriangle(const ScreenVertex &v0, const ScreenVertex &v1, const ScreenVertex &v2) {
+        if (!v0.bValid || !v1.bValid || !v2.bValid) {
+            return;
+        }
+        // 统一成正面积, 三个边函数在内部都不小于 0
+        const ScreenVertex *v[3] = {&v0, &v1, &v2};
+        float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+        if (area < 0.0f) {
+            std::swap(v[1], v[2]);
+            area = -area;
+        }
+        if (area < 1e-8f) {
+            return;
+        }
+
+        // 覆盖像素中心的范围, 先限制在屏幕附近再转换成整数
+        float width = static_cast<float>(mWidth);
+        float height = static_cast<float>(mHeight);
+        float minX = std::clamp(std::min({v0.x, v1.x, v2.x}), -1.0f, width + 1.0f);
+        float maxX = std::clamp(std::max({v0.x, v1.x, v2.x}), -1.0f, width + 1.0f);
+        float minY = std::clamp(std::min({v0.y, v1.y, v2.y}), -1.0f, height + 1.0f);
+        float maxY = std::clamp(std::max({v0.y, v1.y, v2.y}), -1.0f, height + 1.0f);
+        Triangle triangle;
+        triangle.minX = std::max(0, static_cast<int32_t>(std::ceil(minX - 0.5f)));
+        triangle.maxX = std::min(static_cast<int32_t>(mWidth) - 1, static_cast<int32_t>(std::floor(maxX - 0.5f)));
+        triangle.minY = std::max(0, static_cast<int32_t>(std::ceil(minY - 0.5f)));
+        triangle.maxY = std::min(static_cast<int32_t>(mHeight) - 1, static_cast<int32_t>(std::floor(maxY - 0.5f)));
+        if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) {
+            return;
+        }
+
+        // 共享边在两个三角形中方向相反; 总是按固定的顶点顺序计算再取反, 两边的边函数严格互为相反数,
+        // 否则舍入(尤其是 FMA)不同会让边上的像素两边都不覆盖, 遮挡体出现裂缝
+        for (int i = 0; i < 3; i++) {
+            const ScreenVertex *a = v[i];
+            const ScreenVertex *b = v[(i + 1) % 3];
+            bool bFlip = a->x > b->x || (a->x == b->x && a->y > b->y);
+            if (bFlip) {
+                std::swap(a, b);
+            }
+            float edgeA = a->y - b->y;
+            float edgeB = b->x - a->x;
+            float edgeC = -(edgeA * a->x + edgeB * a->y);
+            triangle.edgeA[i] = bFlip ? -edgeA : edgeA;
+            triangle.edgeB[i] = bFlip ? -edgeB : edgeB;
+            triangle.edgeC[i] = bFlip ? -edgeC : edgeC;
+        }
+        // 深度在屏幕空间是线性的
+        const ScreenVertex &p0 = *v[0];
+        const ScreenVertex &p1 = *v[1];
+        const ScreenVertex &p2 = *v[2];
+        float invArea = 1.0f / area;
+        triangle.depthA = ((p1.z - p0.z) * (p2.y - p0.y) - (p2.z - p0.z) * (p1.y - p0.y)) * invArea;
+        triangle.depthB = ((p2.z - p0.z) * (p1.x - p0.x) - (p1.z - p0.z) * (p2.x - p0.x)) * invArea;
+        triangle.depthC = p0.z - triangle.depthA * p0.x - triangle.depthB * p0.y;
+
+        uint32_t triangleIndex = static_cast<uint32_t>(mTriangles.size());
+        mTriangles.push_back(triangle);
+        for (int32_t ty = triangle.minY / static_cast<int32_t>(TILE_HEIGHT);
+             ty <= triangle.maxY / static_cast<int32_t>(TILE_HEIGHT); ty++) {
+            for (int32_t tx = triangle.minX / static_cast<int32_t>(TILE_WIDTH);
+                 tx <= triangle.maxX / static_cast<int32_t>(TILE_WIDTH); tx++) {
+                mTileBins[ty * mTileCountX + tx].push_back(triangleIndex);
+            }
+        }
+    }
+
+    void AdSoftwareOcclusion::RasterizeTiles(uint32_t beginTile, uint32_t endTile) {
+        endTile = std::min(endTile, GetTileCount());
+        for (uint32_t tile = beginTile; tile < endTile; tile++) {
+            RasterizeTile(tile);
+        }
+    }
+
+    void AdSoftwareOcclusion::RasterizeTile(uint32_t tile) {
+        int32_t tileX = static_cast<int32_t>((tile % mTileCountX) * TILE_WIDTH);
+        int32_t tileY = static_cast<int32_t>((tile / mTileCountX) * TILE_HEIGHT);
+        for (uint32_t y = 0; y < TILE_HEIGHT; y++) {
+            std::fill_n(&mDepth[size_t(tileY + y) * mWidth + tileX], TILE_WIDTH, 1.0f);
+        }
+
+        const AdLaneF laneOffset = LaneAdd(LaneIndex(), LaneSet(0.5f));
+        const AdLaneF zero = LaneSet(0.0f);
+        for (uint32_t triangleIndex: mTileBins[tile]) {
+            const Triangle &t = mTriangles[triangleIndex];
+            // 起点对齐到 SIMD 宽度, 多出来的像素由边函数排除
+            int32_t beginX = std::max(t.minX, tileX);
+            beginX = tileX + ((beginX - tileX) & ~static_cast<int32_t>(AD_LANE_COUNT - 1));
+            int32_t endX = std::min(t.maxX, tileX + static_cast<int32_t>(TILE_WIDTH) - 1);
+            int32_t beginY = std::max(t.minY, tileY);
+            int32_t endY = std::min(t.maxY, tileY + static_cast<int32_t>(TILE_HEIGHT) - 1);
+
+            const AdLaneF edgeA0 = LaneSet(t.edgeA[0]), edgeA1 = LaneSet(t.edgeA[1]), edgeA2 = LaneSet(t.edgeA[2]);
+            const AdLaneF depthA = LaneSet(t.depthA);
+            for (int32_t y = beginY; y <= endY; y++) {
+                float centerY = static_cast<float>(y) + 0.5f;
+                AdLaneF rowEdge0 = LaneSet(t.edgeB[0] * centerY + t.edgeC[0]);
+                AdLaneF rowEdge1 = LaneSet(t.edgeB[1] * centerY + t.edgeC[1]);
+                AdLaneF rowEdge2 = LaneSet(t.edgeB[2] * centerY + t.edgeC[2]);
+                AdLaneF rowDepth = LaneSet(t.depthB * centerY + t.depthC);
+                float *depthRow = &mDepth[size_t(y) * mWidth];
+                for (int32_t x = beginX; x <= endX; x += AD_LANE_COUNT) {
+                    AdLaneF centerX = LaneAdd(LaneSet(static_cast<float>(x)), laneOffset);
+                    AdLaneF inside = LaneAnd(LaneAnd(LaneGreaterEqual(LaneMulAdd(edgeA0, centerX, rowEdge0), zero),
+                                                     LaneGreaterEqual(LaneMulAdd(edgeA1, centerX, rowEdge1), zero)),
+                                             LaneGreaterEqual(LaneMulAdd(edgeA2, centerX, rowEdge2), zero));
+                    if (LaneMask(inside) == 0) {
+                        continue;
+                    }
+                    AdLaneF depth = LaneMulAdd(depthA, centerX, rowDepth);
+                    AdLaneF old = LaneLoad(depthRow + x);
+                    LaneStore(depthRow + x, LaneSelect(inside, LaneMin(old, depth), old));
+                }
+            }
+        }
+
+        for (uint32_t by = 0; by < TILE_HEIGHT / BLOCK_SIZE; by++) {
+            for (uint32_t bx = 0; bx < TILE_WIDTH / BLOCK_SIZE; bx++) {
+                uint32_t pixelX = tileX + bx * BLOCK_SIZE;
+                uint32_t pixelY = tileY + by * BLOCK_SIZE;
+                AdLaneF maxDepth = LaneSet(0.0f);
+                for (uint32_t y = 0; y < BLOCK_SIZE; y++) {
+                    const float *depthRow = &mDepth[size_t(pixelY + y) * mWidth + pixelX];
+                    for (uint32_t x = 0; x < BLOCK_SIZE; x += AD_LANE_COUNT) {
+                        maxDepth = LaneMax(maxDepth, LaneLoad(depthRow + x));
+                    }
+                }
+                float lanes[AD_LANE_COUNT];
+                LaneStore(lanes, maxDepth);
+                mBlockMaxDepth[size_t(pixelY / BLOCK_SIZE) * mBlockCountX + pixelX / BLOCK_SIZE] =
+                        *std::max_element(lanes, lanes + AD_LANE_COUNT);
+            }
+        }
+    }
+
+    bool AdSoftwareOcclusion::IsVisible(const AdBoundingBox &box) const {
+        float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX, minDepth = FLT_MAX;
+        for (int i = 0; i < 8; i++) {
+            float clip[4];
+            TransformPoint(mViewProj, (i & 1) ? box.max[0] : box.min[0], (i & 2) ? box.max[1] : box.min[1],
+                           (i & 4) ? box.max[2] : box.min[2], clip);
+            if (clip[3] <= 1e-5f || clip[2] < 0.0f) {
+                return true;
+            }
+            float invW = 1.0f / clip[3];
+            float x = (clip[0] * invW * 0.5f + 0.5f) * static_cast<float>(mWidth);
+            float y = (clip[1] * invW * 0.5f + 0.5f) * static_cast<float>(mHeight);
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
+            minY = std::min(minY, y);
+            maxY = std::max(maxY, y);
+            minDepth = std::min(minDepth, clip[2] * invW);
+        }
+        return IsRectVisible(minX, maxX, minY, maxY, minDepth);
+    }
+
+    bool AdSoftwareOcclusion::IsRectVisible(float minX, float maxX, float minY, float maxY, float minDepth) const {
+        // 与矩形有重叠的所有像素; 先限制在屏幕附近, 避免 w 接近 0 时转换成整数溢出, 不小于 -1 后可以用截断代替 floor
+        float width = static_cast<float>(mWidth);
+        float height = static_cast<float>(mHeight);
+        int32_t beginX = std::max(0, static_cast<int32_t>(std::clamp(minX, -1.0f, width) + 1.0f) - 1);
+        int32_t endX = std::min(static_cast<int32_t>(mWidth) - 1,
+                                static_cast<int32_t>(std::clamp(maxX, -1.0f, width) + 1.0f) - 1);
+        int32_t beginY = std::max(0, static_cast<int32_t>(std::clamp(minY, -1.0f, height) + 1.0f) - 1);
+        int32_t endY = std::min(static_cast<int32_t>(mHeight) - 1,
+                                static_cast<int32_t>(std::clamp(maxY, -1.0f, height) + 1.0f) - 1);
+        if (beginX > endX || beginY > endY || minDepth > 1.0f) {
+            return false;
+        }
+
+        // 任意一个像素的深度不比包围盒最近点更近就可见
+        for (uint32_t by = beginY / BLOCK_SIZE; by <= endY / BLOCK_SIZE; by++) {
+            for (uint32_t bx = beginX / BLOCK_SIZE; bx <= endX / BLOCK_SIZE; bx++) {
+                if (mBlockMaxDepth[size_t(by) * mBlockCountX + bx] >= minDepth
+                    && IsBlockVisible(bx, by, beginX, endX, beginY, endY, minDepth)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool AdSoftwareOcclusion::IsBlockVisible(uint32_t blockX, uint32_t blockY, int32_t beginX, int32_t endX,
+                                             int32_t beginY, int32_t endY, float nearest) const {
+        int32_t blockBeginX = static_cast<int32_t>(blockX * BLOCK_SIZE);
+        int32_t blockBeginY = static_cast<int32_t>(blockY * BLOCK_SIZE);
+        int32_t rowBegin = std::max(beginY, blockBeginY);
+        int32_t rowEnd = std::min(endY, blockBeginY + static_cast<int32_t>(BLOCK_SIZE) - 1);
+        int32_t blockEndX = blockBeginX + static_cast<int32_t>(BLOCK_SIZE) - 1;
+        // 只比较块与矩形重叠的列
+        const AdLaneF firstX = LaneSet(static_cast<float>(std::max(beginX, blockBeginX)));
+        const AdLaneF lastX = LaneSet(static_cast<float>(std::min(endX, blockEndX)));
+        const AdLaneF nearestDepth = LaneSet(nearest);
+        for (int32_t y = rowBegin; y <= rowEnd; y++) {
+            const float *depthRow = &mDepth[size_t(y) * mWidth];
+            for (int32_t x = blockBeginX; x <= blockEndX; x += AD_LANE_COUNT) {
+                AdLaneF pixelX = LaneAdd(LaneSet(static_cast<float>(x)), LaneIndex());
+                AdLaneF inRange = LaneAnd(LaneGreaterEqual(pixelX, firstX), LaneGreaterEqual(lastX, pixelX));
+                if (LaneMask(LaneAnd(inRange, LaneGreaterEqual(LaneLoad(depthRow + x), nearestDepth))) != 0) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    uint32_t AdSoftwareOcclusion::CullBoxes(const AdBoundingBox *boxes, uint32_t count, uint32_t *outVisibleIndices,
+                                            uint32_t baseIndex) const {
+        uint32_t visibleCount = 0;
+        const AdLaneF half = LaneSet(0.5f);
+        const AdLaneF width = LaneSet(static_cast<float>(mWidth));
+        const AdLaneF height = LaneSet(static_cast<float>(mHeight));
+        const AdLaneF minW = LaneSet(1e-5f);
+        const AdLaneF zero = LaneSet(0.0f);
+        AdLaneF matrix[16];
+        for (int i = 0; i < 16; i++) {
+            matrix[i] = LaneSet(mViewProj[i]);
+        }
+
+        // 每路一个包围盒, 8 个角依次投影, 得到屏幕矩形和最近深度
+        uint32_t i = 0;
+        for (; i + AD_LANE_COUNT <= count; i += AD_LANE_COUNT) {
+            float bounds[6][AD_LANE_COUNT];
+            for (uint32_t lane = 0; lane < AD_LANE_COUNT; lane++) {
+                for (int c = 0; c < 3; c++) {
+                    bounds[c][lane] = boxes[i + lane].min[c];
+                    bounds[3 + c][lane] = boxes[i + lane].max[c];
+                }
+            }
+            AdLaneF boxMin[3] = {LaneLoad(bounds[0]), LaneLoad(bounds[1]), LaneLoad(bounds[2])};
+            AdLaneF boxMax[3] = {LaneLoad(bounds[3]), LaneLoad(bounds[4]), LaneLoad(bounds[5])};
+            AdLaneF rectMinX = LaneSet(FLT_MAX), rectMaxX = LaneSet(-FLT_MAX);
+            AdLaneF rectMinY = LaneSet(FLT_MAX), rectMaxY = LaneSet(-FLT_MAX);
+            AdLaneF minDepth = LaneSet(FLT_MAX);
+            AdLaneF nearClip = LaneLess(zero, zero);
+            for (int corner = 0; corner < 8; corner++) {
+                AdLaneF x = (corner & 1) ? boxMax[0] : boxMin[0];
+                AdLaneF y = (corner & 2) ? boxMax[1] : boxMin[1];
+                AdLaneF z = (corner & 4) ? boxMax[2] : boxMin[2];
+                AdLaneF clip[4];
+                for (int r = 0; r < 4; r++) {
+                    clip[r] = LaneMulAdd(matrix[r], x, LaneMulAdd(matrix[4 + r], y,
+                                                                 LaneMulAdd(matrix[8 + r], z, matrix[12 + r])));
+                }
+                nearClip = LaneOr(nearClip, LaneOr(LaneGreaterEqual(minW, clip[3]), LaneLess(clip[2], zero)));
+                AdLaneF invW = LaneDiv(LaneSet(1.0f), LaneMax(clip[3], minW));
+                AdLaneF screenX = LaneMul(LaneMulAdd(LaneMul(clip[0], invW), half, half), width);
+                AdLaneF screenY = LaneMul(LaneMulAdd(LaneMul(clip[1], invW), half, half), height);
+                rectMinX = LaneMin(rectMinX, screenX);
+                rectMaxX = LaneMax(rectMaxX, screenX);
+                rectMinY = LaneMin(rectMinY, screenY);
+                rectMaxY = LaneMax(rectMaxY, screenY);
+                minDepth = LaneMin(minDepth, LaneMul(clip[2], invW));
+            }
+
+            float rect[5][AD_LANE_COUNT];
+            LaneStore(rect[0], rectMinX);
+            LaneStore(rect[1], rectMaxX);
+            LaneStore(rect[2], rectMinY);
+            LaneStore(rect[3], rectMaxY);
+            LaneStore(rect[4], minDepth);
+            uint32_t nearClipMask = LaneMask(nearClip);
+            for (uint32_t lane = 0; lane < AD_LANE_COUNT; lane++) {
+                if ((nearClipMask & (1u << lane))
+                    || IsRectVisible(rect[0][lane], rect[1][lane], rect[2][lane], rect[3][lane], rect[4][lane])) {
+                    outVisibleIndices[visibleCount++] = baseIndex + i + lane;
+                }
+            }
+        }
+        for (; i < count; i++) {
+            if (IsVisible(boxes[i])) {
+                outVisibleIndices[visibleCount++] = baseIndex + i;
+            }
+        }
+        return visibleCount;
+    }
+}
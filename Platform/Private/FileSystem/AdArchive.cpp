@@ -0,0 +1,280 @@
+#include "FileSystem/AdArchive.h"
+#include "AdHash.h"
+#include "AdLog.h"
+#include "Memory/AdAlign.h"
+
+#ifdef AD_ENGINE_WITH_LZ4
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+#ifdef AD_ENGINE_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+namespace ade {
+
+    bool IsCompressionSupported(AdCompression compression) {
+        switch (compression) {
+            case AdCompression::None:
+                return true;
+#ifdef AD_ENGINE_WITH_LZ4
+            case AdCompression::LZ4:
+                return true;
+#endif
+#ifdef AD_ENGINE_WITH_ZSTD
+            case AdCompression::Zstd:
+                return true;
+#endif
+            default:
+                return false;
+        }
+    }
+
+    bool Compress(AdCompression compression, const uint8_t *src, size_t srcSize, std::vector<uint8_t> &outData) {
+        switch (compression) {
+            case AdCompression::None:
+                outData.assign(src, src + srcSize);
+                return true;
+#ifdef AD_ENGINE_WITH_LZ4
+            case AdCompression::LZ4: {
+                outData.resize(LZ4_compressBound(static_cast<int>(srcSize)));
+                int size = LZ4_compress_HC(reinterpret_cast<const char *>(src), reinterpret_cast<char *>(outData.data()),
+                                           static_cast<int>(srcSize), static_cast<int>(outData.size()),
+                                           LZ4HC_CLEVEL_MAX);
+                outData.resize(size > 0 ? size : 0);
+                return size > 0;
+            }
+#endif
+#ifdef AD_ENGINE_WITH_ZSTD
+            case AdCompression::Zstd: {
+                outData.resize(ZSTD_compressBound(srcSize));
+                size_t size = ZSTD_compress(outData.data(), outData.size(), src, srcSize, 19);
+                if (ZSTD_isError(size)) {
+                    outData.clear();
+                    return false;
+                }
+                outData.resize(size);
+                return true;
+            }
+#endif
+            default:
+                return false;
+        }
+    }
+
+    bool Decompress(AdCompression compression, const uint8_t *src, size_t srcSize, uint8_t *dst, size_t dstSize) {
+        switch (compression) {
+            case AdCompression::None:
+                if (srcSize != dstSize) {
+                    return false;
+                }
+                memcpy(dst, src, srcSize);
+                return true;
+#ifdef AD_ENGINE_WITH_LZ4
+            case AdCompression::LZ4: {
+                int result = LZ4_decompress_safe(reinterpret_cast<const char *>(src), reinterpret_cast<char *>(dst),
+                                                 static_cast<int>(srcSize), static_cast<int>(dstSize));
+                return result >= 0 && static_cast<size_t>(result) == dstSize;
+            }
+#endif
+#ifdef AD_ENGINE_WITH_ZSTD
+            case AdCompression::Zstd:
+                return ZSTD_decompress(dst, dstSize, src, srcSize) == dstSize;
+#endif
+            default:
+                return false;
+        }
+    }
+
+    std::string NormalizeResourcePath(const std::string &path) {
+        std::string result = path;
+        std::replace(result.begin(), result.end(), '\\', '/');
+        size_t start = 0;
+        while (start < result.size()) {
+            if (result[start] == '/') {
+                start++;
+            } else if (result.compare(start, 2, "./") == 0) {
+                start += 2;
+            } else {
+                break;
+            }
+        }
+        return result.substr(start);
+    }
+
+    // [offset, offset + size) 在 [0, limit) 内, 不会溢出
+    static bool IsRangeInside(uint64_t offset, uint64_t size, uint64_t limit) {
+        return offset <= limit && size <= limit - offset;
+    }
+
+    std::shared_ptr<AdArchive> AdArchive::Open(const std::string &path) {
+        std::shared_ptr<AdArchive> archive(new AdArchive());
+        if (!archive->mMappedFile.Open(path)) {
+            return nullptr;
+        }
+
+        const uint8_t *base = archive->mMappedFile.GetData();
+        size_t fileSize = archive->mMappedFile.GetSize();
+        if (fileSize < sizeof(AdArchiveHeader)) {
+            LOG_E("Archive {0} is too small.", path);
+            return nullptr;
+        }
+        const auto *header = reinterpret_cast<const AdArchiveHeader *>(base);
+        if (header->magic != AD_ARCHIVE_MAGIC || header->version != AD_ARCHIVE_VERSION) {
+            LOG_E("Archive {0} has invalid header: magic {1:x}, version {2}", path, header->magic, header->version);
+            return nullptr;
+        }
+        if (!IsRangeInside(header->entryOffset, uint64_t(header->entryCount) * sizeof(AdArchiveEntry), fileSize)
+            || !IsRangeInside(header->stringTableOffset, header->stringTableSize, fileSize)) {
+            LOG_E("Archive {0} is truncated.", path);
+            return nullptr;
+        }
+
+        // 之后查找和读取不再检查范围, 这里一次性校验所有条目, 损坏的归档整个拒绝
+        const auto *entries = reinterpret_cast<const AdArchiveEntry *>(base + header->entryOffset);
+        for (uint32_t i = 0; i < header->entryCount; i++) {
+            const AdArchiveEntry &entry = entries[i];
+            bool bStored = entry.compression != static_cast<uint32_t>(AdCompression::None)
+                           || entry.storedSize == entry.size;
+            if (!IsRangeInside(entry.pathOffset, entry.pathLength, header->stringTableSize)
+                || !IsRangeInside(entry.offset, entry.storedSize, fileSize) || !bStored) {
+                LOG_E("Archive {0} entry {1} is out of range.", path, i);
+                return nullptr;
+            }
+        }
+
+        archive->mPath = path;
+        archive->mHeader = header;
+        archive->mEntries = entries;
+        archive->mStringTable = reinterpret_cast<const char *>(base + header->stringTableOffset);
+        LOG_D("Mount archive {0}: {1} entries, {2} bytes", path, header->entryCount, fileSize);
+        return archive;
+    }
+
+    const AdArchiveEntry *AdArchive::FindEntry(const std::string &path) const {
+        if (!mHeader) {
+            return nullptr;
+        }
+        uint64_t hash = HashString(path);
+        const AdArchiveEntry *begin = mEntries;
+        const AdArchiveEntry *end = mEntries + mHeader->entryCount;
+        const AdArchiveEntry *it = std::lower_bound(begin, end, hash, [](const AdArchiveEntry &entry, uint64_t value) {
+            return entry.pathHash < value;
+        });
+        // 哈希冲突时比较完整路径
+        for (; it != end && it->pathHash == hash; ++it) {
+            if (it->pathLength == path.size() && memcmp(mStringTable + it->pathOffset, path.data(), path.size()) == 0) {
+                return it;
+            }
+        }
+        return nullptr;
+    }
+
+    AdFileView AdArchive::Read(const AdArchiveEntry &entry) const {
+        // 范围已经在 Open 时校验
+        const uint8_t *src = mMappedFile.GetData() + entry.offset;
+
+        auto compression = static_cast<AdCompression>(entry.compression);
+        if (compression == AdCompression::None) {
+            // 零拷贝: 视图持有归档的引用, 卸载后数据依然有效
+            return {src, entry.size, shared_from_this()};
+        }
+
+        if (!IsCompressionSupported(compression)) {
+            LOG_E("Archive entry {0} use unsupported compression {1}.", GetEntryPath(entry), entry.compression);
+            return {};
+        }
+        auto buffer = std::make_shared<std::vector<uint8_t>>(entry.size);
+        if (!Decompress(compression, src, entry.storedSize, buffer->data(), buffer->size())) {
+            LOG_E("Decompress archive entry {0} failed.", GetEntryPath(entry));
+            return {};
+        }
+        return {buffer->data(), buffer->size(), buffer};
+    }
+
+    std::string AdArchive::GetEntryPath(const AdArchiveEntry &entry) const {
+        return {mStringTable + entry.pathOffset, entry.pathLength};
+    }
+
+    bool AdArchiveWriter::AddFile(const std::string &path, std::vector<uint8_t> data, AdCompression compression) {
+        PendingEntry entry{NormalizeResourcePath(path), {}, data.size(), compression};
+        if (!mPaths.insert(entry.path).second) {
+            LOG_E("Archive already contains {0}", entry.path);
+            return false;
+        }
+        if (compression != AdCompression::None) {
+            // 压缩收益太小时按原样存储, 读取时可以零拷贝
+            if (!Compress(compression, data.data(), data.size(), entry.data) || entry.data.size() >= data.size() * 9 / 10) {
+                entry.compression = AdCompression::None;
+            }
+        }
+        if (entry.compression == AdCompression::None) {
+            entry.data = std::move(data);
+        }
+        mEntries.push_back(std::move(entry));
+        return true;
+    }
+
+    bool AdArchiveWriter::Write(const std::string &outPath) const {
+        std::vector<const PendingEntry *> sorted;
+        for (const auto &entry: mEntries) {
+            sorted.push_back(&entry);
+        }
+        std::sort(sorted.begin(), sorted.end(), [](const PendingEntry *a, const PendingEntry *b) {
+            return HashString(a->path) < HashString(b->path);
+        });
+
+        AdArchiveHeader header{
+                .magic = AD_ARCHIVE_MAGIC,
+                .version = AD_ARCHIVE_VERSION,
+                .entryCount = static_cast<uint32_t>(sorted.size()),
+                .alignment = mAlignment,
+                .entryOffset = sizeof(AdArchiveHeader),
+                .stringTableOffset = 0,
+                .stringTableSize = 0
+        };
+
+        std::string stringTable;
+        std::vector<AdArchiveEntry> entries(sorted.size());
+        for (size_t i = 0; i < sorted.size(); i++) {
+            entries[i].pathHash = HashString(sorted[i]->path);
+            entries[i].pathOffset = stringTable.size();
+            entries[i].pathLength = sorted[i]->path.size();
+            entries[i].compression = static_cast<uint32_t>(sorted[i]->compression);
+            entries[i].storedSize = sorted[i]->data.size();
+            entries[i].size = sorted[i]->size;
+            stringTable += sorted[i]->path;
+        }
+        header.stringTableOffset = header.entryOffset + entries.size() * sizeof(AdArchiveEntry);
+        header.stringTableSize = stringTable.size();
+
+        uint64_t offset = header.stringTableOffset + header.stringTableSize;
+        for (auto &entry: entries) {
+            offset = AlignUp(offset, mAlignment);
+            entry.offset = offset;
+            offset += entry.storedSize;
+        }
+
+        std::ofstream out(outPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            LOG_E("Could not write archive: {0}", outPath);
+            return false;
+        }
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(AdArchiveEntry));
+        out.write(stringTable.data(), stringTable.size());
+
+        uint64_t written = header.stringTableOffset + header.stringTableSize;
+        const char padding[256] = {};
+        for (size_t i = 0; i < entries.size(); i++) {
+            while (written < entries[i].offset) {
+                uint64_t count = std::min<uint64_t>(entries[i].offset - written, sizeof(padding));
+                out.write(padding, count);
+                written += count;
+            }
+            out.write(reinterpret_cast<const char *>(sorted[i]->data.data()), sorted[i]->data.size());
+            written += sorted[i]->data.size();
+        }
+        return static_cast<bool>(out);
+    }
+}
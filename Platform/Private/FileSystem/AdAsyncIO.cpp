@@ -0,0 +1,607 @@
+#include "FileSystem/AdAsyncIO.h"
+#include "AdLog.h"
+#include "Memory/AdMemoryTracker.h"
+#include <cerrno>
+
+#if defined(AD_ENGINE_PLATFORM_LINUX) && __has_include(<linux/io_uring.h>)
+#define AD_ENGINE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <sys/syscall.h>
+#endif
+
+#ifdef AD_ENGINE_PLATFORM_WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace ade {
+
+    class AdIORequestState {
+    public:
+        AdIORequest request;
+        AdFileLocation location;
+        std::atomic<AdIOStatus> status{AdIOStatus::Pending};
+        std::atomic<bool> bCancelled{false};
+        std::promise<AdFileView> promise;
+        std::shared_future<AdFileView> future = promise.get_future().share();
+
+        intptr_t file = -1;
+        std::shared_ptr<std::vector<uint8_t>> buffer;
+        uint64_t readSize = 0;
+        uint64_t bytesRead = 0;
+    };
+
+    AdIOStatus AdIOHandle::GetStatus() const {
+        return mState ? mState->status.load(std::memory_order_acquire) : AdIOStatus::Failed;
+    }
+
+    void AdIOHandle::Cancel() const {
+        if (mState) {
+            mState->bCancelled.store(true, std::memory_order_release);
+        }
+    }
+
+    std::shared_future<AdFileView> AdIOHandle::GetFuture() const {
+        return mState ? mState->future : std::shared_future<AdFileView>{};
+    }
+
+    // ------------------------ 文件句柄缓存 ------------------------
+    // 同一个归档会被大量请求读取, 只打开一次
+    class AdAsyncIO::FileCache {
+    public:
+        ~FileCache() {
+            for (const auto &item: mFiles) {
+#ifdef AD_ENGINE_PLATFORM_WIN32
+                CloseHandle(reinterpret_cast<HANDLE>(item.second.file));
+#else
+                close(static_cast<int>(item.second.file));
+#endif
+            }
+        }
+
+        bool Open(const std::string &path, intptr_t &outFile, uint64_t &outSize) {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto it = mFiles.find(path);
+            if (it != mFiles.end()) {
+                outFile = it->second.file;
+                outSize = it->second.size;
+                return true;
+            }
+#ifdef AD_ENGINE_PLATFORM_WIN32
+            HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                        FILE_ATTRIBUTE_NORMAL, nullptr);
+            LARGE_INTEGER size;
+            if (handle == INVALID_HANDLE_VALUE) {
+                return false;
+            }
+            if (!GetFileSizeEx(handle, &size)) {
+                CloseHandle(handle);
+                return false;
+            }
+            FileInfo info{reinterpret_cast<intptr_t>(handle), static_cast<uint64_t>(size.QuadPart)};
+#else
+            int fd = open(path.c_str(), O_RDONLY);
+            struct stat st{};
+            if (fd < 0) {
+                return false;
+            }
+            if (fstat(fd, &st) != 0) {
+                close(fd);
+                return false;
+            }
+            FileInfo info{fd, static_cast<uint64_t>(st.st_size)};
+#endif
+            mFiles[path] = info;
+            outFile = info.file;
+            outSize = info.size;
+            return true;
+        }
+
+        static int64_t ReadAt(intptr_t file, uint8_t *dst, uint64_t size, uint64_t offset) {
+#ifdef AD_ENGINE_PLATFORM_WIN32
+            OVERLAPPED overlapped{};
+            overlapped.Offset = static_cast<DWORD>(offset);
+            overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            DWORD bytesRead = 0;
+            DWORD toRead = static_cast<DWORD>(std::min<uint64_t>(size, 0x40000000));
+            if (!ReadFile(reinterpret_cast<HANDLE>(file), dst, toRead, &bytesRead, &overlapped)) {
+                return -1;
+            }
+            return bytesRead;
+#else
+            return pread(static_cast<int>(file), dst, size, static_cast<off_t>(offset));
+#endif
+        }
+
+    private:
+        struct FileInfo {
+            intptr_t file;
+            uint64_t size;
+        };
+        std::mutex mMutex;
+        std::unordered_map<std::string, FileInfo> mFiles;
+    };
+
+    // ------------------------ io_uring ------------------------
+#ifdef AD_ENGINE_IO_URING
+    // 直接使用系统调用, 不依赖 liburing
+    class AdAsyncIO::IOUring {
+    public:
+        ~IOUring() {
+            if (mSqes) munmap(mSqes, mSqesSize);
+            if (mCqPtr && mCqPtr != mSqPtr) munmap(mCqPtr, mCqSize);
+            if (mSqPtr) munmap(mSqPtr, mSqSize);
+            if (mRingFd >= 0) close(mRingFd);
+            if (mEventFd >= 0) close(mEventFd);
+        }
+
+        bool Init(uint32_t entries) {
+            io_uring_params params{};
+            mRingFd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+            if (mRingFd < 0) {
+                return false;
+            }
+            mSqSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+            mCqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            bool bSingleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+            if (bSingleMmap) {
+                mSqSize = mCqSize = std::max(mSqSize, mCqSize);
+            }
+            mSqPtr = mmap(nullptr, mSqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mRingFd,
+                          IORING_OFF_SQ_RING);
+            if (mSqPtr == MAP_FAILED) {
+                mSqPtr = nullptr;
+                return false;
+            }
+            mCqPtr = bSingleMmap ? mSqPtr : mmap(nullptr, mCqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                                 mRingFd, IORING_OFF_CQ_RING);
+            if (mCqPtr == MAP_FAILED) {
+                mCqPtr = nullptr;
+                return false;
+            }
+            mSqesSize = params.sq_entries * sizeof(io_uring_sqe);
+            mSqes = static_cast<io_uring_sqe *>(mmap(nullptr, mSqesSize, PROT_READ | PROT_WRITE,
+                                                     MAP_SHARED | MAP_POPULATE, mRingFd, IORING_OFF_SQES));
+            if (mSqes == MAP_FAILED) {
+                mSqes = nullptr;
+                return false;
+            }
+
+            auto *sq = static_cast<uint8_t *>(mSqPtr);
+            mSqHead = reinterpret_cast<uint32_t *>(sq + params.sq_off.head);
+            mSqTail = reinterpret_cast<uint32_t *>(sq + params.sq_off.tail);
+            mSqMask = *reinterpret_cast<uint32_t *>(sq + params.sq_off.ring_mask);
+            mSqArray = reinterpret_cast<uint32_t *>(sq + params.sq_off.array);
+            mSqEntries = params.sq_entries;
+            mSqLocalTail = *mSqTail;
+
+            auto *cq = static_cast<uint8_t *>(mCqPtr);
+            mCqHead = reinterpret_cast<uint32_t *>(cq + params.cq_off.head);
+            mCqTail = reinterpret_cast<uint32_t *>(cq + params.cq_off.tail);
+            mCqMask = *reinterpret_cast<uint32_t *>(cq + params.cq_off.ring_mask);
+            mCqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+            mEventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+            return mEventFd >= 0;
+        }
+
+        io_uring_sqe *GetSqe() {
+            uint32_t tail = mSqLocalTail;
+            uint32_t head = __atomic_load_n(mSqHead, __ATOMIC_ACQUIRE);
+            if (tail - head >= mSqEntries) {
+                return nullptr;
+            }
+            uint32_t index = tail & mSqMask;
+            io_uring_sqe *sqe = &mSqes[index];
+            memset(sqe, 0, sizeof(io_uring_sqe));
+            mSqArray[index] = index;
+            mSqLocalTail = tail + 1;
+            mToSubmit++;
+            return sqe;
+        }
+
+        bool PrepareRead(int fd, uint8_t *dst, uint32_t size, uint64_t offset, uint64_t userData) {
+            io_uring_sqe *sqe = GetSqe();
+            if (!sqe) {
+                return false;
+            }
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = fd;
+            sqe->addr = reinterpret_cast<uint64_t>(dst);
+            sqe->len = size;
+            sqe->off = offset;
+            sqe->user_data = userData;
+            return true;
+        }
+
+        // 监听 eventfd, 提交新请求时唤醒 IO 线程
+        bool PrepareWakeUpPoll() {
+            io_uring_sqe *sqe = GetSqe();
+            if (!sqe) {
+                return false;
+            }
+            sqe->opcode = IORING_OP_POLL_ADD;
+            sqe->fd = mEventFd;
+            sqe->poll32_events = POLLIN;
+            sqe->user_data = 0;
+            return true;
+        }
+
+        int SubmitAndWait(uint32_t waitCount) {
+            // sqe 填写完成后再对内核可见
+            __atomic_store_n(mSqTail, mSqLocalTail, __ATOMIC_RELEASE);
+            int result = static_cast<int>(syscall(__NR_io_uring_enter, mRingFd, mToSubmit, waitCount,
+                                                  waitCount > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0));
+            if (result >= 0) {
+                mToSubmit -= result;
+            }
+            return result;
+        }
+
+        bool PopCqe(io_uring_cqe &outCqe) {
+            uint32_t head = *mCqHead;
+            if (head == __atomic_load_n(mCqTail, __ATOMIC_ACQUIRE)) {
+                return false;
+            }
+            outCqe = mCqes[head & mCqMask];
+            __atomic_store_n(mCqHead, head + 1, __ATOMIC_RELEASE);
+            return true;
+        }
+
+        void Signal() const {
+            uint64_t value = 1;
+            ssize_t ret = write(mEventFd, &value, sizeof(value));
+            (void) ret;
+        }
+
+        // eventfd 是非阻塞的, 没有待处理的信号时返回 EAGAIN, 无需清除
+        void ClearSignal() const {
+            uint64_t value;
+            ssize_t ret = read(mEventFd, &value, sizeof(value));
+            if (ret < 0 && errno != EAGAIN && errno != EINTR) {
+                LOG_W("Async io could not clear eventfd: {0}", strerror(errno));
+            }
+        }
+
+    private:
+        int mRingFd = -1;
+        int mEventFd = -1;
+        void *mSqPtr = nullptr;
+        void *mCqPtr = nullptr;
+        size_t mSqSize = 0;
+        size_t mCqSize = 0;
+        io_uring_sqe *mSqes = nullptr;
+        size_t mSqesSize = 0;
+
+        uint32_t *mSqHead = nullptr;
+        uint32_t *mSqTail = nullptr;
+        uint32_t *mSqArray = nullptr;
+        uint32_t mSqMask = 0;
+        uint32_t mSqEntries = 0;
+        uint32_t mSqLocalTail = 0;
+        uint32_t mToSubmit = 0;
+
+        uint32_t *mCqHead = nullptr;
+        uint32_t *mCqTail = nullptr;
+        uint32_t mCqMask = 0;
+        io_uring_cqe *mCqes = nullptr;
+    };
+#else
+    class AdAsyncIO::IOUring {
+    public:
+        bool Init(uint32_t) { return false; }
+
+        void Signal() const {}
+    };
+#endif
+
+    // ------------------------ AdAsyncIO ------------------------
+
+    AdAsyncIO::AdAsyncIO(const AdAsyncIOSettings &settings) : mSettings(settings) {
+        mFileCache = std::make_unique<FileCache>();
+
+        if (settings.bPreferIOUring) {
+            mIOUring = std::make_unique<IOUring>();
+            // 多预留一个位置给唤醒用的 poll
+            if (!mIOUring->Init(settings.queueDepth + 1)) {
+                LOG_W("io_uring is not available, fallback to pread thread pool.");
+                mIOUring.reset();
+            }
+        }
+
+        if (mIOUring) {
+            mThreads.emplace_back(&AdAsyncIO::IOUringThreadMain, this);
+        } else {
+            for (uint32_t i = 0; i < std::max(1u, settings.fallbackThreadCount); i++) {
+                mThreads.emplace_back(&AdAsyncIO::FallbackThreadMain, this);
+            }
+        }
+        LOG_D("Async io backend: {0}, queue depth: {1}", mIOUring ? "io_uring" : "pread", settings.queueDepth);
+    }
+
+    AdAsyncIO::~AdAsyncIO() {
+        std::vector<std::shared_ptr<AdIORequestState>> pendingRequests;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            bStop = true;
+            for (auto &queue: mPendingRequests) {
+                pendingRequests.insert(pendingRequests.end(), queue.begin(), queue.end());
+                queue.clear();
+            }
+        }
+        for (const auto &state: pendingRequests) {
+            state->bCancelled = true;
+            CompleteRequest(state, false);
+        }
+        WakeUp();
+        mCondition.notify_all();
+        for (auto &thread: mThreads) {
+            thread.join();
+        }
+    }
+
+    AdIOHandle AdAsyncIO::Submit(AdIORequest request) {
+        auto state = std::make_shared<AdIORequestState>();
+        state->request = std::move(request);
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mPendingRequests[static_cast<uint32_t>(state->request.priority)].push_back(state);
+        }
+        WakeUp();
+        return AdIOHandle(state);
+    }
+
+    std::vector<AdIOHandle> AdAsyncIO::SubmitBatch(std::vector<AdIORequest> requests) {
+        std::vector<AdIOHandle> handles;
+        handles.reserve(requests.size());
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (auto &request: requests) {
+                auto state = std::make_shared<AdIORequestState>();
+                state->request = std::move(request);
+                mPendingRequests[static_cast<uint32_t>(state->request.priority)].push_back(state);
+                handles.emplace_back(state);
+            }
+        }
+        WakeUp();
+        return handles;
+    }
+
+    void AdAsyncIO::WakeUp() {
+        if (mIOUring) {
+            mIOUring->Signal();
+        } else {
+            mCondition.notify_all();
+        }
+    }
+
+    std::shared_ptr<AdIORequestState> AdAsyncIO::PopRequest() {
+        while (true) {
+            std::shared_ptr<AdIORequestState> state;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                for (auto &queue: mPendingRequests) {
+                    if (!queue.empty()) {
+                        state = std::move(queue.front());
+                        queue.pop_front();
+                        break;
+                    }
+                }
+            }
+            if (!state) {
+                return nullptr;
+            }
+            // 排队中被取消的请求直接丢弃
+            if (state->bCancelled.load(std::memory_order_acquire)) {
+                CompleteRequest(state, false);
+                continue;
+            }
+            return state;
+        }
+    }
+
+    bool AdAsyncIO::PrepareRequest(const std::shared_ptr<AdIORequestState> &state) {
+        if (!AdFileSystem::Resolve(state->request.path, state->location)) {
+            LOG_E("Async io could not resolve {0}", state->request.path);
+            return false;
+        }
+        uint64_t fileSize = 0;
+        if (!mFileCache->Open(state->location.filePath, state->file, fileSize)) {
+            LOG_E("Async io could not open {0}", state->location.filePath);
+            return false;
+        }
+        if (state->location.bLooseFile) {
+            // 散文件读取整个文件
+            state->location.offset = 0;
+            state->location.storedSize = fileSize;
+            state->location.size = fileSize;
+        }
+        if (state->location.offset > fileSize || state->location.storedSize > fileSize - state->location.offset) {
+            LOG_E("Async io read {0} out of range.", state->request.path);
+            return false;
+        }
+        state->readSize = state->location.storedSize;
+        state->buffer = std::make_shared<std::vector<uint8_t>>(state->readSize);
+        state->status.store(AdIOStatus::InFlight, std::memory_order_release);
+        mInFlightCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void AdAsyncIO::CompleteRequest(const std::shared_ptr<AdIORequestState> &state, bool bSuccess) {
+        if (state->status.load(std::memory_order_relaxed) == AdIOStatus::InFlight) {
+            mInFlightCount.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        AdIOStatus status = AdIOStatus::Completed;
+        AdFileView view;
+        if (state->bCancelled.load(std::memory_order_acquire)) {
+            status = AdIOStatus::Cancelled;
+        } else if (!bSuccess) {
+            status = AdIOStatus::Failed;
+        } else if (state->location.compression != AdCompression::None) {
+            auto decompressed = std::make_shared<std::vector<uint8_t>>(state->location.size);
+            if (Decompress(state->location.compression, state->buffer->data(), state->buffer->size(),
+                           decompressed->data(), decompressed->size())) {
+                view = AdFileView(decompressed->data(), decompressed->size(), decompressed);
+            } else {
+                LOG_E("Async io decompress {0} failed.", state->request.path);
+                status = AdIOStatus::Failed;
+            }
+        } else {
+            view = AdFileView(state->buffer->data(), state->buffer->size(), state->buffer);
+        }
+        state->buffer.reset();
+        state->status.store(status, std::memory_order_release);
+
+        if (state->request.callback) {
+            state->request.callback(status, view);
+        }
+        state->promise.set_value(std::move(view));
+    }
+
+    void AdAsyncIO::IOUringThreadMain() {
+        AdMemoryTagScope memoryTag(AdMemoryTag::Assets);
+#ifdef AD_ENGINE_IO_URING
+        std::unordered_map<AdIORequestState *, std::shared_ptr<AdIORequestState>> inFlightRequests;
+        std::vector<std::shared_ptr<AdIORequestState>> resubmitRequests;
+
+        auto prepareRead = [this](const std::shared_ptr<AdIORequestState> &state) {
+            uint64_t remain = state->readSize - state->bytesRead;
+            auto size = static_cast<uint32_t>(std::min<uint64_t>(remain, 0x40000000));
+            return mIOUring->PrepareRead(static_cast<int>(state->file), state->buffer->data() + state->bytesRead,
+                                         size, state->location.offset + state->bytesRead,
+                                         reinterpret_cast<uint64_t>(state.get()));
+        };
+
+        mIOUring->PrepareWakeUpPoll();
+        while (true) {
+            bool bShouldStop;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                bShouldStop = bStop;
+            }
+            if (bShouldStop && inFlightRequests.empty() && resubmitRequests.empty()) {
+                break;
+            }
+
+            // 1. 短读取的剩余部分优先, 然后按优先级取新请求
+            while (!resubmitRequests.empty() && inFlightRequests.size() < mSettings.queueDepth) {
+                auto state = std::move(resubmitRequests.back());
+                resubmitRequests.pop_back();
+                if (!prepareRead(state)) {
+                    resubmitRequests.push_back(std::move(state));
+                    break;
+                }
+                inFlightRequests[state.get()] = std::move(state);
+            }
+            while (!bShouldStop && resubmitRequests.empty() && inFlightRequests.size() < mSettings.queueDepth) {
+                std::shared_ptr<AdIORequestState> state = PopRequest();
+                if (!state) {
+                    break;
+                }
+                if (!PrepareRequest(state)) {
+                    CompleteRequest(state, false);
+                    continue;
+                }
+                if (state->readSize == 0) {
+                    CompleteRequest(state, true);
+                    continue;
+                }
+                if (!prepareRead(state)) {
+                    resubmitRequests.push_back(std::move(state));
+                    break;
+                }
+                inFlightRequests[state.get()] = std::move(state);
+            }
+
+            // 2. 提交并等待至少一个完成事件(新请求到达时由 eventfd 唤醒)
+            int result = mIOUring->SubmitAndWait(1);
+            if (result < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                LOG_E("io_uring_enter failed: {0}", strerror(errno));
+                break;
+            }
+
+            // 3. 处理完成事件
+            io_uring_cqe cqe{};
+            while (mIOUring->PopCqe(cqe)) {
+                if (cqe.user_data == 0) {
+                    mIOUring->ClearSignal();
+                    mIOUring->PrepareWakeUpPoll();
+                    continue;
+                }
+                auto it = inFlightRequests.find(reinterpret_cast<AdIORequestState *>(cqe.user_data));
+                if (it == inFlightRequests.end()) {
+                    continue;
+                }
+                std::shared_ptr<AdIORequestState> state = std::move(it->second);
+                inFlightRequests.erase(it);
+
+                if (cqe.res == -EAGAIN || cqe.res == -EINTR) {
+                    resubmitRequests.push_back(std::move(state));
+                } else if (cqe.res <= 0) {
+                    if (cqe.res < 0) {
+                        LOG_E("Async io read {0} failed: {1}", state->request.path, strerror(-cqe.res));
+                    }
+                    CompleteRequest(state, false);
+                } else {
+                    // 此时 res 一定为正数
+                    state->bytesRead += static_cast<uint64_t>(cqe.res);
+                    if (state->bytesRead < state->readSize && !state->bCancelled.load(std::memory_order_relaxed)) {
+                        resubmitRequests.push_back(std::move(state));
+                    } else {
+                        CompleteRequest(state, state->bytesRead == state->readSize);
+                    }
+                }
+            }
+        }
+
+        for (auto &item: inFlightRequests) {
+            CompleteRequest(item.second, false);
+        }
+#endif
+    }
+
+    void AdAsyncIO::FallbackThreadMain() {
+        AdMemoryTagScope memoryTag(AdMemoryTag::Assets);
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mCondition.wait(lock, [this]() {
+                    return bStop || !mPendingRequests[0].empty() || !mPendingRequests[1].empty();
+                });
+                if (bStop) {
+                    return;
+                }
+            }
+            std::shared_ptr<AdIORequestState> state = PopRequest();
+            if (!state) {
+                continue;
+            }
+            if (!PrepareRequest(state)) {
+                CompleteRequest(state, false);
+                continue;
+            }
+            bool bSuccess = true;
+            while (state->bytesRead < state->readSize && !state->bCancelled.load(std::memory_order_relaxed)) {
+                int64_t count = FileCache::ReadAt(state->file, state->buffer->data() + state->bytesRead,
+                                                  state->readSize - state->bytesRead,
+                                                  state->location.offset + state->bytesRead);
+                if (count < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (count <= 0) {
+                    bSuccess = false;
+                    break;
+                }
+                state->bytesRead += static_cast<uint64_t>(count);
+            }
+            CompleteRequest(state, bSuccess);
+        }
+    }
+}
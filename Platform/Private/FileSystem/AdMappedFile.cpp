@@ -0,0 +1,94 @@
+#include "FileSystem/AdMappedFile.h"
+#include "AdLog.h"
+
+#ifdef AD_ENGINE_PLATFORM_WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace ade {
+    AdMappedFile::~AdMappedFile() {
+        Close();
+    }
+
+#ifdef AD_ENGINE_PLATFORM_WIN32
+    bool AdMappedFile::Open(const std::string &path) {
+        Close();
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+            CloseHandle(file);
+            return false;
+        }
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            CloseHandle(file);
+            return false;
+        }
+        void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!data) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+        mFileHandle = file;
+        mMappingHandle = mapping;
+        mData = static_cast<const uint8_t *>(data);
+        mSize = static_cast<size_t>(size.QuadPart);
+        return true;
+    }
+
+    void AdMappedFile::Close() {
+        if (mData) {
+            UnmapViewOfFile(mData);
+            CloseHandle(mMappingHandle);
+            CloseHandle(mFileHandle);
+        }
+        mData = nullptr;
+        mSize = 0;
+        mFileHandle = nullptr;
+        mMappingHandle = nullptr;
+    }
+#else
+    bool AdMappedFile::Open(const std::string &path) {
+        Close();
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            return false;
+        }
+        void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            LOG_E("mmap {0} failed.", path);
+            close(fd);
+            return false;
+        }
+        mFd = fd;
+        mData = static_cast<const uint8_t *>(data);
+        mSize = st.st_size;
+        return true;
+    }
+
+    void AdMappedFile::Close() {
+        if (mData) {
+            munmap(const_cast<uint8_t *>(mData), mSize);
+            close(mFd);
+        }
+        mData = nullptr;
+        mSize = 0;
+        mFd = -1;
+    }
+#endif
+}
@@ -1,12 +1,236 @@
 #include "Graphic/AdVKQueue.h"
+#include "Graphic/AdVKAllocator.h"
+#include "Memory/AdLinearAllocator.h"
 
 namespace ade{
-    AdVKQueue::AdVKQueue(uint32_t familyIndex, uint32_t index, VkQueue queue, bool canPresent)
-            : mFamilyIndex(familyIndex), mIndex(index), mQueue(queue), canPresent(canPresent){
-        LOG_T("Create a new queue: {0} - {1} - {2}, present: {3}", mFamilyIndex, index, (void*)queue, canPresent);
+    AdVKQueue::AdVKQueue(VkDevice device, uint32_t familyIndex, uint32_t index, VkQueue queue, bool canPresent,
+                         bool bTimelineSemaphore, bool bSubmitThread)
+            : mDevice(device), mFamilyIndex(familyIndex), mIndex(index), mQueue(queue), canPresent(canPresent){
+        LOG_T("Create a new queue: {0} - {1} - {2}, present: {3}, submit thread: {4}", mFamilyIndex, index,
+              (void*)queue, canPresent, bSubmitThread);
+
+        if (bTimelineSemaphore) {
+            VkSemaphoreTypeCreateInfo typeInfo = {
+                    .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+                    .pNext = nullptr,
+                    .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+                    .initialValue = 0
+            };
+            VkSemaphoreCreateInfo semaphoreInfo = {
+                    .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+                    .pNext = &typeInfo,
+                    .flags = 0
+            };
+            CALL_VK(vkCreateSemaphore(mDevice, &semaphoreInfo, AdVKAllocator::GetCallbacks(), &mTimelineSemaphore));
+        }
+        if (bSubmitThread) {
+            mRequests = std::make_unique<AdSpscQueue<Request, MAX_PENDING_REQUESTS>>();
+            mSubmitThread = std::thread(&AdVKQueue::SubmitThreadMain, this);
+        }
+    }
+
+    AdVKQueue::~AdVKQueue() {
+        if (mSubmitThread.joinable()) {
+            Flush();
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                bStop = true;
+            }
+            mRequestCondition.notify_one();
+            mSubmitThread.join();
+        }
+        if (mTimelineSemaphore != VK_NULL_HANDLE) {
+            // 信号量不能在队列仍在使用时销毁
+            vkQueueWaitIdle(mQueue);
+            vkDestroySemaphore(mDevice, mTimelineSemaphore, AdVKAllocator::GetCallbacks());
+        }
+    }
+
+    uint64_t AdVKQueue::Submit(AdVKSubmitRequest request) {
+        uint64_t value = ++mNextValue;
+        Request item;
+        item.value = value;
+        item.submit = std::move(request);
+        Enqueue(std::move(item));
+        return value;
+    }
+
+    void AdVKQueue::Present(AdVKPresentRequest request) {
+        if (!canPresent) {
+            LOG_E("Queue {0} - {1} can not present.", mFamilyIndex, mIndex);
+            return;
+        }
+        Request item;
+        item.bPresent = true;
+        item.present = std::move(request);
+        Enqueue(std::move(item));
+    }
+
+    void AdVKQueue::Enqueue(Request &&request) {
+        if (!mSubmitThread.joinable()) {
+            Process(request);
+            return;
+        }
+        mPendingCount.fetch_add(1, std::memory_order_relaxed);
+        // 队列满说明驱动已经落后很多, 只能等提交线程取走
+        while (!mRequests->TryPush(std::move(request))) {
+            std::this_thread::yield();
+        }
+        // 放入后再进出一次锁: 提交线程在锁内检查队列为空并睡眠, 这里的通知不会丢失
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+        }
+        mRequestCondition.notify_one();
+    }
+
+    void AdVKQueue::Process(Request &request) {
+        if (request.bPresent) {
+            AdVKPresentRequest &present = request.present;
+            // 二值信号量必须在等待之前提交发出操作
+            // 同一个队列上的提交一定已经在这之前处理
+            if (present.signalQueue && present.signalQueue != this) {
+                present.signalQueue->WaitSubmitted(present.signalValue);
+            }
+            VkPresentInfoKHR presentInfo = {
+                    .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
+                    .pNext = nullptr,
+                    .waitSemaphoreCount = static_cast<uint32_t>(present.waitSemaphores.size()),
+                    .pWaitSemaphores = present.waitSemaphores.data(),
+                    .swapchainCount = 1,
+                    .pSwapchains = &present.swapchain,
+                    .pImageIndices = &present.imageIndex,
+                    .pResults = nullptr
+            };
+            VkResult result = vkQueuePresentKHR(mQueue, &presentInfo);
+            if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR && result != VK_ERROR_OUT_OF_DATE_KHR) {
+                LOG_E("Present failed: {0}", vk_result_string(result));
+            }
+            mLastPresentResult.store(result, std::memory_order_release);
+            return;
+        }
+
+        AdVKSubmitRequest &submit = request.submit;
+        // 追加时间线信号量后的数组放在线程临时内存, 每次提交不再向堆申请
+        AdScratchScope scratch;
+        uint32_t signalCount = static_cast<uint32_t>(submit.signalSemaphores.size());
+        uint32_t waitCount = static_cast<uint32_t>(submit.waitSemaphores.size());
+        bool bTimeline = mTimelineSemaphore != VK_NULL_HANDLE;
+        VkSemaphore *signalSemaphores = scratch.AllocateArray<VkSemaphore>(signalCount + 1);
+        uint64_t *signalValues = scratch.AllocateArray<uint64_t>(signalCount + 1);
+        uint64_t *waitValues = scratch.AllocateArray<uint64_t>(waitCount + 1);
+        for (uint32_t i = 0; i < signalCount; i++) {
+            signalSemaphores[i] = submit.signalSemaphores[i];
+            signalValues[i] = 0;
+        }
+        // 有时间线信号量时, 二值信号量对应的值被忽略
+        for (uint32_t i = 0; i < waitCount; i++) {
+            waitValues[i] = i < submit.waitValues.size() ? submit.waitValues[i] : 0;
+        }
+        if (bTimeline) {
+            signalSemaphores[signalCount] = mTimelineSemaphore;
+            signalValues[signalCount] = request.value;
+            signalCount++;
+        }
+        bool bTimelineInfo = bTimeline || !submit.waitValues.empty();
+        VkTimelineSemaphoreSubmitInfo timelineInfo = {
+                .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+                .pNext = nullptr,
+                .waitSemaphoreValueCount = bTimelineInfo ? waitCount : 0,
+                .pWaitSemaphoreValues = waitValues,
+                .signalSemaphoreValueCount = signalCount,
+                .pSignalSemaphoreValues = signalValues
+        };
+        VkSubmitInfo submitInfo = {
+                .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+                .pNext = bTimelineInfo ? &timelineInfo : nullptr,
+                .waitSemaphoreCount = waitCount,
+                .pWaitSemaphores = submit.waitSemaphores.data(),
+                .pWaitDstStageMask = submit.waitStages.data(),
+                .commandBufferCount = static_cast<uint32_t>(submit.commandBuffers.size()),
+                .pCommandBuffers = submit.commandBuffers.data(),
+                .signalSemaphoreCount = signalCount,
+                .pSignalSemaphores = signalSemaphores
+        };
+        CALL_VK(vkQueueSubmit(mQueue, 1, &submitInfo, submit.fence));
+
+        mSubmittedValue.store(request.value, std::memory_order_release);
+        if (mSubmitThread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+            }
+            mSubmittedCondition.notify_all();
+        }
+    }
+
+    void AdVKQueue::WaitSubmitted(uint64_t value) const {
+        if (mSubmittedValue.load(std::memory_order_acquire) >= value) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mMutex);
+        mSubmittedCondition.wait(lock, [this, value]() {
+            return mSubmittedValue.load(std::memory_order_acquire) >= value;
+        });
+    }
+
+    void AdVKQueue::SubmitThreadMain() {
+        Request request;
+        while (true) {
+            if (mRequests->TryPop(request)) {
+                Process(request);
+                if (mPendingCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    {
+                        std::lock_guard<std::mutex> lock(mMutex);
+                    }
+                    mSubmittedCondition.notify_all();
+                }
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mMutex);
+            mRequestCondition.wait(lock, [this]() { return bStop || !mRequests->IsEmpty(); });
+            if (bStop && mRequests->IsEmpty()) {
+                return;
+            }
+        }
+    }
+
+    void AdVKQueue::Flush() {
+        if (!mSubmitThread.joinable()) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mMutex);
+        mSubmittedCondition.wait(lock, [this]() { return mPendingCount.load(std::memory_order_acquire) == 0; });
+    }
+
+    uint64_t AdVKQueue::GetCompletedValue() const {
+        uint64_t value = 0;
+        if (mTimelineSemaphore != VK_NULL_HANDLE) {
+            CALL_VK(vkGetSemaphoreCounterValue(mDevice, mTimelineSemaphore, &value));
+        }
+        return value;
+    }
+
+    bool AdVKQueue::WaitForValue(uint64_t value, uint64_t timeout) const {
+        if (mTimelineSemaphore == VK_NULL_HANDLE) {
+            return false;
+        }
+        VkSemaphoreWaitInfo waitInfo = {
+                .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+                .pNext = nullptr,
+                .flags = 0,
+                .semaphoreCount = 1,
+                .pSemaphores = &mTimelineSemaphore,
+                .pValues = &value
+        };
+        VkResult result = vkWaitSemaphores(mDevice, &waitInfo, timeout);
+        if (result != VK_SUCCESS && result != VK_TIMEOUT) {
+            LOG_E("Wait timeline semaphore failed: {0}", vk_result_string(result));
+        }
+        return result == VK_SUCCESS;
     }
 
-    void AdVKQueue::WaitIdle() const {
+    void AdVKQueue::WaitIdle() {
+        // 先让提交线程把请求交完, 之后它不会再访问 VkQueue
+        Flush();
         CALL_VK(vkQueueWaitIdle(mQueue));
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,223 @@
+#include "Graphic/AdVKAllocator.h"
+#include "Memory/AdPoolAllocator.h"
+#include "Memory/AdMemoryTracker.h"
+#include "Memory/AdAlign.h"
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+namespace ade {
+    static const char *const SCOPE_NAMES[] = {"Command", "Object", "Cache", "Device", "Instance"};
+
+    struct ScopeCounters {
+        std::atomic<uint64_t> allocCount{0};
+        std::atomic<uint64_t> pooledCount{0};
+        std::atomic<uint64_t> liveCount{0};
+        std::atomic<uint64_t> liveBytes{0};
+        std::atomic<uint64_t> peakBytes{0};
+        std::atomic<uint64_t> internalBytes{0};
+    };
+
+    static ScopeCounters sCounters[AD_VK_ALLOCATION_SCOPE_COUNT];
+
+    // 每块前面的头部, 记录大小、scope、所在的池和到实际内存起始的偏移
+    struct alignas(16) AllocationHeader {
+        uint64_t size;
+        uint32_t offset;
+        uint8_t scope;
+        uint8_t sizeClass;
+    };
+
+    static constexpr size_t HEADER_ALIGNMENT = alignof(AllocationHeader);
+    static constexpr uint8_t NO_SIZE_CLASS = 0xFF;
+    // object scope 的分配大多是几十到几百字节的驱动对象
+    static constexpr size_t SIZE_CLASSES[] = {64, 128, 256, 512};
+    static constexpr uint32_t SIZE_CLASS_COUNT = ARRAY_SIZE(SIZE_CLASSES);
+
+    struct SizeClassPool {
+        SizeClassPool(size_t size) : pool(size + sizeof(AllocationHeader), HEADER_ALIGNMENT, 64) {}
+
+        std::mutex mutex;
+        AdPoolAllocator pool;
+    };
+
+    static SizeClassPool *GetPools() {
+        static SizeClassPool pools[SIZE_CLASS_COUNT] = {SIZE_CLASSES[0], SIZE_CLASSES[1], SIZE_CLASSES[2],
+                                                        SIZE_CLASSES[3]};
+        return pools;
+    }
+
+    static uint8_t GetSizeClass(size_t size, size_t alignment, VkSystemAllocationScope scope) {
+        if (scope != VK_SYSTEM_ALLOCATION_SCOPE_OBJECT || alignment > HEADER_ALIGNMENT) {
+            return NO_SIZE_CLASS;
+        }
+        for (uint32_t i = 0; i < SIZE_CLASS_COUNT; i++) {
+            if (size <= SIZE_CLASSES[i]) {
+                return static_cast<uint8_t>(i);
+            }
+        }
+        return NO_SIZE_CLASS;
+    }
+
+    static void OnAllocate(size_t size, uint32_t scope, bool bPooled) {
+        ScopeCounters &counters = sCounters[scope];
+        counters.allocCount.fetch_add(1, std::memory_order_relaxed);
+        if (bPooled) {
+            counters.pooledCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        counters.liveCount.fetch_add(1, std::memory_order_relaxed);
+        uint64_t live = counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+        uint64_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+        while (live > peak && !counters.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+    }
+
+    static void OnFree(size_t size, uint32_t scope) {
+        ScopeCounters &counters = sCounters[scope];
+        counters.liveCount.fetch_sub(1, std::memory_order_relaxed);
+        counters.liveBytes.fetch_sub(size, std::memory_order_relaxed);
+    }
+
+    static void *Allocate(size_t size, size_t alignment, VkSystemAllocationScope scope) {
+        if (size == 0) {
+            return nullptr;
+        }
+        AdMemoryTagScope tagScope(AdMemoryTag::Renderer);
+        uint8_t sizeClass = GetSizeClass(size, alignment, scope);
+        uintptr_t base;
+        uintptr_t user;
+        if (sizeClass != NO_SIZE_CLASS) {
+            SizeClassPool &pool = GetPools()[sizeClass];
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            // 异常不能穿过驱动的 C 回调, 按 Vulkan 的约定返回 nullptr
+            try {
+                base = reinterpret_cast<uintptr_t>(pool.pool.Allocate());
+            } catch (const std::bad_alloc &) {
+                return nullptr;
+            }
+            user = base + sizeof(AllocationHeader);
+        } else {
+            alignment = std::max(alignment, HEADER_ALIGNMENT);
+            size_t padding = alignment > HEADER_ALIGNMENT ? alignment : 0;
+            if (size > SIZE_MAX - sizeof(AllocationHeader) - padding) {
+                return nullptr;
+            }
+            base = reinterpret_cast<uintptr_t>(::operator new(size + sizeof(AllocationHeader) + padding,
+                                                              std::align_val_t(HEADER_ALIGNMENT), std::nothrow));
+            if (!base) {
+                return nullptr;
+            }
+            user = AlignUp(base + sizeof(AllocationHeader), alignment);
+        }
+        AllocationHeader *header = reinterpret_cast<AllocationHeader *>(user) - 1;
+        header->size = size;
+        header->offset = static_cast<uint32_t>(user - base);
+        header->scope = static_cast<uint8_t>(scope);
+        header->sizeClass = sizeClass;
+        OnAllocate(size, scope, sizeClass != NO_SIZE_CLASS);
+        return reinterpret_cast<void *>(user);
+    }
+
+    static void Free(void *ptr) {
+        if (!ptr) {
+            return;
+        }
+        AllocationHeader *header = static_cast<AllocationHeader *>(ptr) - 1;
+        OnFree(header->size, header->scope);
+        void *base = static_cast<uint8_t *>(ptr) - header->offset;
+        if (header->sizeClass != NO_SIZE_CLASS) {
+            SizeClassPool &pool = GetPools()[header->sizeClass];
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            pool.pool.Free(base);
+        } else {
+            ::operator delete(base, std::align_val_t(HEADER_ALIGNMENT));
+        }
+    }
+
+    static void *VKAPI_PTR VkAllocation(void *, size_t size, size_t alignment, VkSystemAllocationScope scope) {
+        return Allocate(size, alignment, scope);
+    }
+
+    static void *VKAPI_PTR VkReallocation(void *, void *original, size_t size, size_t alignment,
+                                          VkSystemAllocationScope scope) {
+        if (!original) {
+            return Allocate(size, alignment, scope);
+        }
+        if (size == 0) {
+            Free(original);
+            return nullptr;
+        }
+        AllocationHeader *header = static_cast<AllocationHeader *>(original) - 1;
+        // 还在同一个池块里, 原地修改大小
+        if (header->sizeClass != NO_SIZE_CLASS && header->scope == scope &&
+            GetSizeClass(size, alignment, scope) == header->sizeClass) {
+            OnFree(header->size, header->scope);
+            OnAllocate(size, header->scope, true);
+            header->size = size;
+            return original;
+        }
+        // 失败时原内存保持不变
+        void *result = Allocate(size, alignment, scope);
+        if (result) {
+            memcpy(result, original, std::min<size_t>(size, header->size));
+            Free(original);
+        }
+        return result;
+    }
+
+    static void VKAPI_PTR VkFree(void *, void *memory) {
+        Free(memory);
+    }
+
+    static void VKAPI_PTR VkInternalAllocation(void *, size_t size, VkInternalAllocationType,
+                                               VkSystemAllocationScope scope) {
+        sCounters[scope].internalBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    static void VKAPI_PTR VkInternalFree(void *, size_t size, VkInternalAllocationType,
+                                         VkSystemAllocationScope scope) {
+        sCounters[scope].internalBytes.fetch_sub(size, std::memory_order_relaxed);
+    }
+
+    static const VkAllocationCallbacks sCallbacks = {
+            .pUserData = nullptr,
+            .pfnAllocation = VkAllocation,
+            .pfnReallocation = VkReallocation,
+            .pfnFree = VkFree,
+            .pfnInternalAllocation = VkInternalAllocation,
+            .pfnInternalFree = VkInternalFree,
+    };
+
+    const VkAllocationCallbacks *AdVKAllocator::GetCallbacks() {
+        return &sCallbacks;
+    }
+
+    AdVKAllocationStats AdVKAllocator::GetStats(VkSystemAllocationScope scope) {
+        const ScopeCounters &counters = sCounters[scope];
+        AdVKAllocationStats stats;
+        stats.allocCount = counters.allocCount.load(std::memory_order_relaxed);
+        stats.pooledCount = counters.pooledCount.load(std::memory_order_relaxed);
+        stats.liveCount = counters.liveCount.load(std::memory_order_relaxed);
+        stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+        stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+        stats.internalBytes = counters.internalBytes.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    const char *AdVKAllocator::GetScopeName(VkSystemAllocationScope scope) {
+        return SCOPE_NAMES[scope];
+    }
+
+    void AdVKAllocator::Report() {
+        LOG_I("-----------------------------");
+        LOG_I("Vulkan host allocations:");
+        for (uint32_t i = 0; i < AD_VK_ALLOCATION_SCOPE_COUNT; i++) {
+            AdVKAllocationStats stats = GetStats(static_cast<VkSystemAllocationScope>(i));
+            LOG_I("{0:<8} live {1} / {2} bytes, peak {3} bytes, total {4} ({5} pooled), internal {6} bytes",
+                  SCOPE_NAMES[i], stats.liveCount, stats.liveBytes, stats.peakBytes, stats.allocCount,
+                  stats.pooledCount, stats.internalBytes);
+        }
+        LOG_I("-----------------------------");
+    }
+}
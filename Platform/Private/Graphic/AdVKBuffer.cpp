@@ -0,0 +1,107 @@
+#include "Graphic/AdVKBuffer.h"
+#include "Graphic/AdVKAllocator.h"
+#include "Graphic/AdDevice.h"
+#include "Graphic/AdVKGraphicContext.h"
+#include <algorithm>
+#include <cstring>
+
+namespace ade {
+
+    static constexpr VkDeviceSize AD_MAX_UPDATE_BUFFER_SIZE = 65536;
+
+    uint32_t FindMemoryType(const VkPhysicalDeviceMemoryProperties &properties, uint32_t typeBits,
+                            VkMemoryPropertyFlags flags) {
+        for (uint32_t i = 0; i < properties.memoryTypeCount; i++) {
+            if ((typeBits & (1u << i)) && (properties.memoryTypes[i].propertyFlags & flags) == flags) {
+                return i;
+            }
+        }
+        return UINT32_MAX;
+    }
+
+    AdVKBuffer::AdVKBuffer(AdVKDevice *device, VkBufferUsageFlags usage, VkDeviceSize size, const void *data)
+            : mDevice(device), mSize(size) {
+        if (!device) {
+            LOG_E("Must create a vulkan device before create buffer.");
+            return;
+        }
+        VkBufferCreateInfo bufferCI = {
+                .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+                .size = std::max<VkDeviceSize>(size, 4),
+                .usage = usage,
+                .sharingMode = VK_SHARING_MODE_EXCLUSIVE
+        };
+        CALL_VK(vkCreateBuffer(device->GetHandle(), &bufferCI, AdVKAllocator::GetCallbacks(), &mBuffer));
+
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(device->GetHandle(), mBuffer, &requirements);
+        const VkPhysicalDeviceMemoryProperties &properties = device->GetContext()->GetPhysicalDeviceMemoryProperties();
+        uint32_t memoryType = FindMemoryType(properties, requirements.memoryTypeBits,
+                                             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+        if (memoryType == UINT32_MAX) {
+            memoryType = FindMemoryType(properties, requirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+        }
+        if (memoryType == UINT32_MAX) {
+            LOG_E("Could not find host visible memory for buffer, size: {0}", size);
+            return;
+        }
+        VkMemoryPropertyFlags memoryFlags = properties.memoryTypes[memoryType].propertyFlags;
+        bDeviceLocal = memoryFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        bCoherent = memoryFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+        VkMemoryAllocateInfo allocateInfo = {
+                .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+                .allocationSize = requirements.size,
+                .memoryTypeIndex = memoryType
+        };
+        CALL_VK(vkAllocateMemory(device->GetHandle(), &allocateInfo, AdVKAllocator::GetCallbacks(), &mMemory));
+        CALL_VK(vkBindBufferMemory(device->GetHandle(), mBuffer, mMemory, 0));
+        CALL_VK(vkMapMemory(device->GetHandle(), mMemory, 0, VK_WHOLE_SIZE, 0, &mMappedData));
+
+        if (data) {
+            WriteData(data, size);
+        }
+    }
+
+    AdVKBuffer::~AdVKBuffer() {
+        VkDevice device = mDevice ? mDevice->GetHandle() : VK_NULL_HANDLE;
+        if (mMemory != VK_NULL_HANDLE) {
+            if (mMappedData) {
+                vkUnmapMemory(device, mMemory);
+            }
+            vkFreeMemory(device, mMemory, AdVKAllocator::GetCallbacks());
+        }
+        if (mBuffer != VK_NULL_HANDLE) {
+            vkDestroyBuffer(device, mBuffer, AdVKAllocator::GetCallbacks());
+        }
+    }
+
+    void AdVKBuffer::WriteData(const void *data, VkDeviceSize size, VkDeviceSize offset) {
+        if (!mMappedData || offset + size > mSize) {
+            LOG_E("Write buffer out of range: offset {0}, size {1}, buffer size {2}", offset, size, mSize);
+            return;
+        }
+        memcpy(static_cast<uint8_t *>(mMappedData) + offset, data, size);
+        if (!bCoherent) {
+            VkMappedMemoryRange range = {
+                    .sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+                    .memory = mMemory,
+                    .offset = 0,
+                    .size = VK_WHOLE_SIZE
+            };
+            CALL_VK(vkFlushMappedMemoryRanges(mDevice->GetHandle(), 1, &range));
+        }
+    }
+
+    void CmdUpdateBufferChunked(VkCommandBuffer cmdBuffer, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size,
+                                const void *data) {
+        const uint8_t *bytes = static_cast<const uint8_t *>(data);
+        while (size > 0) {
+            VkDeviceSize chunkSize = std::min(size, AD_MAX_UPDATE_BUFFER_SIZE);
+            vkCmdUpdateBuffer(cmdBuffer, buffer, offset, chunkSize, bytes);
+            offset += chunkSize;
+            bytes += chunkSize;
+            size -= chunkSize;
+        }
+    }
+}
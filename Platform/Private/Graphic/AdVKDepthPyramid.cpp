@@ -0,0 +1,313 @@
+#include "Graphic/AdVKDepthPyramid.h"
+#include "Graphic/AdVKAllocator.h"
+#include "Graphic/AdDevice.h"
+#include "Graphic/AdVKGraphicContext.h"
+
+namespace ade {
+
+    // 每个工作组负责第 0 层 64x64 的区域, 与 Asset/Shader/DepthPyramid.comp 一致
+    static constexpr uint32_t AD_DEPTH_PYRAMID_TILE_SIZE = 64;
+    // 第 0 层最大 4096: 两级 64x64 归约
+    static constexpr uint32_t AD_DEPTH_PYRAMID_MAX_SIZE = AD_DEPTH_PYRAMID_TILE_SIZE * AD_DEPTH_PYRAMID_TILE_SIZE;
+    // 最后一个工作组从这一层开始生成剩余的层级
+    static constexpr uint32_t AD_DEPTH_PYRAMID_SHARED_MIP = 6;
+    // 在 AdVKPipelineCache 中注册的 layout 名字
+    static const char *AD_DEPTH_PYRAMID_LAYOUT = "DepthPyramid";
+
+    enum AdDepthPyramidBinding : uint32_t {
+        AD_DEPTH_PYRAMID_BINDING_DEPTH = 0,
+        AD_DEPTH_PYRAMID_BINDING_MIPS,
+        AD_DEPTH_PYRAMID_BINDING_SHARED_MIP,
+        AD_DEPTH_PYRAMID_BINDING_COUNTER,
+        AD_DEPTH_PYRAMID_BINDING_COUNT
+    };
+
+    struct AdDepthPyramidPushConstants {
+        uint32_t depthSize[2];
+        uint32_t pyramidSize[2];
+        uint32_t mipLevels;
+        uint32_t groupCount;
+    };
+
+    static uint32_t PreviousPowerOfTwo(uint32_t value) {
+        uint32_t result = 1;
+        while (result * 2 <= value) {
+            result *= 2;
+        }
+        return result;
+    }
+
+    static uint32_t GetGroupCount(uint32_t width, uint32_t height) {
+        return ((width + AD_DEPTH_PYRAMID_TILE_SIZE - 1) / AD_DEPTH_PYRAMID_TILE_SIZE)
+               * ((height + AD_DEPTH_PYRAMID_TILE_SIZE - 1) / AD_DEPTH_PYRAMID_TILE_SIZE);
+    }
+
+    AdVKDepthPyramid::AdVKDepthPyramid(AdVKDevice *device, AdVKPipelineCache *pipelineCache, VkImageView depthView,
+                                       uint32_t depthWidth, uint32_t depthHeight)
+            : mDevice(device), mPipelineCache(pipelineCache), mDepthWidth(depthWidth), mDepthHeight(depthHeight) {
+        if (!device || !pipelineCache) {
+            LOG_E("Must create a vulkan device and pipeline cache before create depth pyramid.");
+            return;
+        }
+        if (depthView == VK_NULL_HANDLE || depthWidth == 0 || depthHeight == 0) {
+            LOG_E("Invalid depth buffer for depth pyramid: {0}x{1}", depthWidth, depthHeight);
+            return;
+        }
+        mWidth = std::min(PreviousPowerOfTwo(depthWidth), AD_DEPTH_PYRAMID_MAX_SIZE);
+        mHeight = std::min(PreviousPowerOfTwo(depthHeight), AD_DEPTH_PYRAMID_MAX_SIZE);
+        mMipLevels = 1;
+        while ((std::max(mWidth, mHeight) >> mMipLevels) > 0) {
+            mMipLevels++;
+        }
+        if (!CreateImage()) {
+            return;
+        }
+        uint32_t zero = 0;
+        mCounterBuffer = std::make_unique<AdVKBuffer>(device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, sizeof(zero), &zero);
+        CreateDescriptorSet(depthView);
+
+        VkPushConstantRange pushConstantRange = {
+                .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+                .offset = 0,
+                .size = sizeof(AdDepthPyramidPushConstants)
+        };
+        VkPipelineLayoutCreateInfo pipelineLayoutCI = {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+                .setLayoutCount = 1,
+                .pSetLayouts = &mDescriptorSetLayout,
+                .pushConstantRangeCount = 1,
+                .pPushConstantRanges = &pushConstantRange
+        };
+        CALL_VK(vkCreatePipelineLayout(device->GetHandle(), &pipelineLayoutCI,
+                                       AdVKAllocator::GetCallbacks(), &mPipelineLayout));
+
+        pipelineCache->RegisterPipelineLayout(AD_DEPTH_PYRAMID_LAYOUT, mPipelineLayout);
+        AdVKPipelineKey key;
+        key.computeShader = "Shader/DepthPyramid.comp.spv";
+        key.pipelineLayout = AD_DEPTH_PYRAMID_LAYOUT;
+        mPipeline = pipelineCache->GetOrCreateComputePipeline(key, mPipelineLayout);
+        if (!mPipeline) {
+            return;
+        }
+        LOG_D("Depth pyramid: {0}x{1}, {2} mips, from depth {3}x{4}", mWidth, mHeight, mMipLevels, depthWidth,
+              depthHeight);
+    }
+
+    AdVKDepthPyramid::~AdVKDepthPyramid() {
+        if (!mDevice) {
+            return;
+        }
+        VkDevice device = mDevice->GetHandle();
+        if (mPipelineLayout != VK_NULL_HANDLE) {
+            mPipelineCache->UnregisterPipelineLayout(AD_DEPTH_PYRAMID_LAYOUT, mPipelineLayout);
+            vkDestroyPipelineLayout(device, mPipelineLayout, AdVKAllocator::GetCallbacks());
+        }
+        if (mDescriptorPool != VK_NULL_HANDLE) {
+            vkDestroyDescriptorPool(device, mDescriptorPool, AdVKAllocator::GetCallbacks());
+        }
+        if (mDescriptorSetLayout != VK_NULL_HANDLE) {
+            vkDestroyDescriptorSetLayout(device, mDescriptorSetLayout, AdVKAllocator::GetCallbacks());
+        }
+        if (mSampler != VK_NULL_HANDLE) {
+            vkDestroySampler(device, mSampler, AdVKAllocator::GetCallbacks());
+        }
+        for (VkImageView view: mMipViews) {
+            vkDestroyImageView(device, view, AdVKAllocator::GetCallbacks());
+        }
+        if (mImageView != VK_NULL_HANDLE) {
+            vkDestroyImageView(device, mImageView, AdVKAllocator::GetCallbacks());
+        }
+        if (mImage != VK_NULL_HANDLE) {
+            vkDestroyImage(device, mImage, AdVKAllocator::GetCallbacks());
+        }
+        if (mMemory != VK_NULL_HANDLE) {
+            vkFreeMemory(device, mMemory, AdVKAllocator::GetCallbacks());
+        }
+    }
+
+    bool AdVKDepthPyramid::CreateImage() {
+        VkDevice device = mDevice->GetHandle();
+        VkImageCreateInfo imageCI = {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+                .imageType = VK_IMAGE_TYPE_2D,
+                .format = VK_FORMAT_R32_SFLOAT,
+                .extent = {mWidth, mHeight, 1},
+                .mipLevels = mMipLevels,
+                .arrayLayers = 1,
+                .samples = VK_SAMPLE_COUNT_1_BIT,
+                .tiling = VK_IMAGE_TILING_OPTIMAL,
+                .usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+                .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+        };
+        CALL_VK(vkCreateImage(device, &imageCI, AdVKAllocator::GetCallbacks(), &mImage));
+
+        VkMemoryRequirements requirements;
+        vkGetImageMemoryRequirements(device, mImage, &requirements);
+        const VkPhysicalDeviceMemoryProperties &properties = mDevice->GetContext()->GetPhysicalDeviceMemoryProperties();
+        uint32_t memoryType = FindMemoryType(properties, requirements.memoryTypeBits,
+                                             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        if (memoryType == UINT32_MAX) {
+            LOG_E("Could not find device local memory for depth pyramid.");
+            return false;
+        }
+        VkMemoryAllocateInfo allocateInfo = {
+                .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+                .allocationSize = requirements.size,
+                .memoryTypeIndex = memoryType
+        };
+        CALL_VK(vkAllocateMemory(device, &allocateInfo, AdVKAllocator::GetCallbacks(), &mMemory));
+        CALL_VK(vkBindImageMemory(device, mImage, mMemory, 0));
+
+        VkImageViewCreateInfo viewCI = {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+                .image = mImage,
+                .viewType = VK_IMAGE_VIEW_TYPE_2D,
+                .format = VK_FORMAT_R32_SFLOAT,
+                .subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, mMipLevels, 0, 1}
+        };
+        CALL_VK(vkCreateImageView(device, &viewCI, AdVKAllocator::GetCallbacks(), &mImageView));
+        mMipViews.resize(mMipLevels, VK_NULL_HANDLE);
+        for (uint32_t i = 0; i < mMipLevels; i++) {
+            viewCI.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, i, 1, 0, 1};
+            CALL_VK(vkCreateImageView(device, &viewCI, AdVKAllocator::GetCallbacks(), &mMipViews[i]));
+        }
+
+        // 最近点采样, 由着色器自己取覆盖范围内的最大值
+        VkSamplerCreateInfo samplerCI = {
+                .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+                .magFilter = VK_FILTER_NEAREST,
+                .minFilter = VK_FILTER_NEAREST,
+                .mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+                .addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+                .addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+                .addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+                .minLod = 0.0f,
+                .maxLod = VK_LOD_CLAMP_NONE
+        };
+        CALL_VK(vkCreateSampler(device, &samplerCI, AdVKAllocator::GetCallbacks(), &mSampler));
+        return true;
+    }
+
+    void AdVKDepthPyramid::CreateDescriptorSet(VkImageView depthView) {
+        VkDevice device = mDevice->GetHandle();
+        VkDescriptorSetLayoutBinding bindings[] = {
+                {AD_DEPTH_PYRAMID_BINDING_DEPTH, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1,
+                 VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+                {AD_DEPTH_PYRAMID_BINDING_MIPS, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, MAX_MIP_LEVELS,
+                 VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+                {AD_DEPTH_PYRAMID_BINDING_SHARED_MIP, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1,
+                 VK_SHADER_STAGE_COMPUTE_BIT, nullptr},
+                {AD_DEPTH_PYRAMID_BINDING_COUNTER, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1,
+                 VK_SHADER_STAGE_COMPUTE_BIT, nullptr}
+        };
+        VkDescriptorSetLayoutCreateInfo setLayoutCI = {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+                .bindingCount = ARRAY_SIZE(bindings),
+                .pBindings = bindings
+        };
+        CALL_VK(vkCreateDescriptorSetLayout(device, &setLayoutCI,
+                                            AdVKAllocator::GetCallbacks(), &mDescriptorSetLayout));
+
+        VkDescriptorPoolSize poolSizes[] = {
+                {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1},
+                {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, MAX_MIP_LEVELS + 1},
+                {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1}
+        };
+        VkDescriptorPoolCreateInfo poolCI = {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+                .maxSets = 1,
+                .poolSizeCount = ARRAY_SIZE(poolSizes),
+                .pPoolSizes = poolSizes
+        };
+        CALL_VK(vkCreateDescriptorPool(device, &poolCI, AdVKAllocator::GetCallbacks(), &mDescriptorPool));
+        VkDescriptorSetAllocateInfo allocateInfo = {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+                .descriptorPool = mDescriptorPool,
+                .descriptorSetCount = 1,
+                .pSetLayouts = &mDescriptorSetLayout
+        };
+        CALL_VK(vkAllocateDescriptorSets(device, &allocateInfo, &mDescriptorSet));
+
+        VkDescriptorImageInfo depthInfo = {mSampler, depthView, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL};
+        // 着色器不会写超出 mipLevels 的层级, 多余的数组元素指向最后一层占位
+        VkDescriptorImageInfo mipInfos[MAX_MIP_LEVELS];
+        for (uint32_t i = 0; i < MAX_MIP_LEVELS; i++) {
+            mipInfos[i] = {VK_NULL_HANDLE, mMipViews[std::min(i, mMipLevels - 1)], VK_IMAGE_LAYOUT_GENERAL};
+        }
+        VkDescriptorImageInfo sharedMipInfo = mipInfos[AD_DEPTH_PYRAMID_SHARED_MIP];
+        VkDescriptorBufferInfo counterInfo = mCounterBuffer->GetDescriptorInfo();
+        VkWriteDescriptorSet writes[] = {
+                {
+                        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                        .dstSet = mDescriptorSet,
+                        .dstBinding = AD_DEPTH_PYRAMID_BINDING_DEPTH,
+                        .descriptorCount = 1,
+                        .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                        .pImageInfo = &depthInfo
+                },
+                {
+                        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                        .dstSet = mDescriptorSet,
+                        .dstBinding = AD_DEPTH_PYRAMID_BINDING_MIPS,
+                        .descriptorCount = MAX_MIP_LEVELS,
+                        .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                        .pImageInfo = mipInfos
+                },
+                {
+                        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                        .dstSet = mDescriptorSet,
+                        .dstBinding = AD_DEPTH_PYRAMID_BINDING_SHARED_MIP,
+                        .descriptorCount = 1,
+                        .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                        .pImageInfo = &sharedMipInfo
+                },
+                {
+                        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                        .dstSet = mDescriptorSet,
+                        .dstBinding = AD_DEPTH_PYRAMID_BINDING_COUNTER,
+                        .descriptorCount = 1,
+                        .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                        .pBufferInfo = &counterInfo
+                }
+        };
+        vkUpdateDescriptorSets(device, ARRAY_SIZE(writes), writes, 0, nullptr);
+    }
+
+    void AdVKDepthPyramid::CmdBuild(VkCommandBuffer cmdBuffer) const {
+        if (!mPipeline) {
+            return;
+        }
+        // 内容每次都全部重写, 不需要保留; 等上一次的读取(遮挡剔除)结束
+        VkImageMemoryBarrier writeBarrier = {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_SHADER_READ_BIT,
+                .dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+                .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                .newLayout = VK_IMAGE_LAYOUT_GENERAL,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = mImage,
+                .subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, mMipLevels, 0, 1}
+        };
+        vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                             0, nullptr, 0, nullptr, 1, &writeBarrier);
+
+        AdDepthPyramidPushConstants constants = {
+                {mDepthWidth, mDepthHeight}, {mWidth, mHeight}, mMipLevels, GetGroupCount(mWidth, mHeight)
+        };
+        mPipeline->Bind(cmdBuffer);
+        vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mPipelineLayout, 0, 1, &mDescriptorSet,
+                                0, nullptr);
+        vkCmdPushConstants(cmdBuffer, mPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+        vkCmdDispatch(cmdBuffer, constants.groupCount, 1, 1);
+
+        VkMemoryBarrier readBarrier = {
+                .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_SHADER_READ_BIT
+        };
+        vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                             1, &readBarrier, 0, nullptr, 0, nullptr);
+    }
+}
@@ -0,0 +1,298 @@
+#include "Graphic/AdVKGeometryBuffer.h"
+#include "Graphic/AdVKAllocator.h"
+#include "Graphic/AdDevice.h"
+#include "Asset/AdMesh.h"
+#include <algorithm>
+#include <cstring>
+
+namespace ade {
+
+    // vkCmdUpdateBuffer 的大小必须是 4 的倍数
+    static_assert(sizeof(AdMeshPosition) % 4 == 0 && sizeof(AdMeshAttribute) % 4 == 0);
+    static_assert(sizeof(AdGeometryMeshInfo) % 4 == 0);
+
+    enum AdGeometryBinding : uint32_t {
+        AD_GEOMETRY_BINDING_MESH_INFO = 0,
+        AD_GEOMETRY_BINDING_POSITION,
+        AD_GEOMETRY_BINDING_ATTRIBUTE,
+        AD_GEOMETRY_BINDING_COUNT
+    };
+
+    AdVKGeometryBuffer::AdVKGeometryBuffer(AdVKDevice *device, const AdGeometryBufferSettings &settings)
+            : mDevice(device), mSettings(settings), mVertexAllocator(settings.vertexCapacity),
+              mIndexAllocator(settings.indexCapacity) {
+        mMeshDirtyFlags.resize(settings.maxMeshCount, false);
+        if (!device) {
+            LOG_E("Must create a vulkan device before create geometry buffer.");
+            return;
+        }
+        if (!device->IsDrawIndirectFirstInstanceEnabled()) {
+            LOG_W("Device does not support drawIndirectFirstInstance, indirect draws must use firstInstance 0.");
+        }
+        VkBufferUsageFlags storageUsage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        mPositionBuffer = std::make_unique<AdVKBuffer>(device, storageUsage,
+                                                       uint64_t(settings.vertexCapacity) * sizeof(AdMeshPosition));
+        mAttributeBuffer = std::make_unique<AdVKBuffer>(device, storageUsage,
+                                                        uint64_t(settings.vertexCapacity) * sizeof(AdMeshAttribute));
+        mIndexBuffer = std::make_unique<AdVKBuffer>(device, VK_BUFFER_USAGE_INDEX_BUFFER_BIT
+                                                            | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                    uint64_t(settings.indexCapacity) * sizeof(uint32_t));
+        mMeshInfoBuffer = std::make_unique<AdVKBuffer>(device, storageUsage,
+                                                       uint64_t(settings.maxMeshCount) * sizeof(AdGeometryMeshInfo));
+
+        // 计算着色器剔除时也需要读取网格信息
+        VkDescriptorSetLayoutBinding bindings[AD_GEOMETRY_BINDING_COUNT];
+        for (uint32_t i = 0; i < AD_GEOMETRY_BINDING_COUNT; i++) {
+            bindings[i] = {
+                    .binding = i,
+                    .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    .descriptorCount = 1,
+                    .stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_COMPUTE_BIT
+            };
+        }
+        VkDescriptorSetLayoutCreateInfo setLayoutCI = {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+                .bindingCount = ARRAY_SIZE(bindings),
+                .pBindings = bindings
+        };
+        CALL_VK(vkCreateDescriptorSetLayout(device->GetHandle(), &setLayoutCI,
+                                            AdVKAllocator::GetCallbacks(), &mDescriptorSetLayout));
+
+        VkDescriptorPoolSize poolSize = {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, AD_GEOMETRY_BINDING_COUNT};
+        VkDescriptorPoolCreateInfo poolCI = {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+                .maxSets = 1,
+                .poolSizeCount = 1,
+                .pPoolSizes = &poolSize
+        };
+        CALL_VK(vkCreateDescriptorPool(device->GetHandle(), &poolCI, AdVKAllocator::GetCallbacks(), &mDescriptorPool));
+        VkDescriptorSetAllocateInfo allocateInfo = {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+                .descriptorPool = mDescriptorPool,
+                .descriptorSetCount = 1,
+                .pSetLayouts = &mDescriptorSetLayout
+        };
+        CALL_VK(vkAllocateDescriptorSets(device->GetHandle(), &allocateInfo, &mDescriptorSet));
+
+        const AdVKBuffer *buffers[AD_GEOMETRY_BINDING_COUNT] = {
+                mMeshInfoBuffer.get(), mPositionBuffer.get(), mAttributeBuffer.get()
+        };
+        VkDescriptorBufferInfo bufferInfos[AD_GEOMETRY_BINDING_COUNT];
+        VkWriteDescriptorSet writes[AD_GEOMETRY_BINDING_COUNT];
+        for (uint32_t i = 0; i < AD_GEOMETRY_BINDING_COUNT; i++) {
+            bufferInfos[i] = buffers[i]->GetDescriptorInfo();
+            writes[i] = {
+                    .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                    .dstSet = mDescriptorSet,
+                    .dstBinding = i,
+                    .descriptorCount = 1,
+                    .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    .pBufferInfo = &bufferInfos[i]
+            };
+        }
+        vkUpdateDescriptorSets(device->GetHandle(), ARRAY_SIZE(writes), writes, 0, nullptr);
+        LOG_D("Geometry buffer: {0} vertices, {1} indices, {2} meshes, device local: {3}", settings.vertexCapacity,
+              settings.indexCapacity, settings.maxMeshCount, mPositionBuffer->IsDeviceLocal());
+    }
+
+    AdVKGeometryBuffer::~AdVKGeometryBuffer() {
+        if (mDescriptorPool != VK_NULL_HANDLE) {
+            vkDestroyDescriptorPool(mDevice->GetHandle(), mDescriptorPool, AdVKAllocator::GetCallbacks());
+        }
+        if (mDescriptorSetLayout != VK_NULL_HANDLE) {
+            vkDestroyDescriptorSetLayout(mDevice->GetHandle(), mDescriptorSetLayout, AdVKAllocator::GetCallbacks());
+        }
+    }
+
+    uint32_t AdVKGeometryBuffer::AddMesh(const AdMesh &mesh) {
+        const AdMeshHeader &header = mesh.GetHeader();
+        if (mFreeMeshIds.empty() && mMeshes.size() >= mSettings.maxMeshCount) {
+            LOG_E("Geometry buffer is full: {0} meshes", mMeshes.size());
+            return INVALID_MESH_ID;
+        }
+        uint64_t firstVertex = mVertexAllocator.Allocate(header.vertexCount);
+        if (firstVertex == AdRangeAllocator::INVALID_OFFSET) {
+            LOG_E("Geometry buffer out of vertex space: {0} used, request {1}", mVertexAllocator.GetUsedSize(),
+                  header.vertexCount);
+            return INVALID_MESH_ID;
+        }
+        uint64_t firstIndex = mIndexAllocator.Allocate(header.indexCount);
+        if (firstIndex == AdRangeAllocator::INVALID_OFFSET) {
+            LOG_E("Geometry buffer out of index space: {0} used, request {1}", mIndexAllocator.GetUsedSize(),
+                  header.indexCount);
+            mVertexAllocator.Free(firstVertex, header.vertexCount);
+            return INVALID_MESH_ID;
+        }
+
+        // 之前提交的帧可能还在读这段空间的旧数据, 先拷贝下来, 在 CmdUpload 中写入
+        PendingMesh pendingMesh;
+        pendingMesh.positions.assign(mesh.GetPositions(), mesh.GetPositions() + header.vertexCount);
+        pendingMesh.attributes.assign(mesh.GetAttributes(), mesh.GetAttributes() + header.vertexCount);
+        // 索引仍然相对网格自己的顶点, 绘制时通过 vertexOffset 加上 firstVertex
+        pendingMesh.indices.resize(header.indexCount);
+        for (uint32_t i = 0; i < header.indexCount; i++) {
+            pendingMesh.indices[i] = mesh.GetIndex(i);
+        }
+
+        AdGeometryMesh geometryMesh{};
+        geometryMesh.firstVertex = static_cast<uint32_t>(firstVertex);
+        geometryMesh.vertexCount = header.vertexCount;
+        geometryMesh.firstIndex = static_cast<uint32_t>(firstIndex);
+        geometryMesh.indexCount = header.indexCount;
+        geometryMesh.lodCount = header.lodCount;
+        for (uint32_t i = 0; i < header.lodCount; i++) {
+            geometryMesh.lods[i] = header.lods[i];
+            geometryMesh.lods[i].indexOffset += geometryMesh.firstIndex;
+        }
+        float radiusSq = 0.0f;
+        for (int c = 0; c < 3; c++) {
+            float half = (header.boundsMax[c] - header.boundsMin[c]) * 0.5f;
+            geometryMesh.boundingSphere[c] = header.boundsMin[c] + half;
+            radiusSq += half * half;
+        }
+        geometryMesh.boundingSphere[3] = std::sqrt(radiusSq);
+
+        AdGeometryMeshInfo meshInfo{};
+        memcpy(meshInfo.positionScale, header.positionScale, sizeof(header.positionScale));
+        memcpy(meshInfo.positionOffset, header.positionOffset, sizeof(header.positionOffset));
+        memcpy(meshInfo.uvScaleOffset, header.uvScale, sizeof(header.uvScale));
+        memcpy(meshInfo.uvScaleOffset + 2, header.uvOffset, sizeof(header.uvOffset));
+        memcpy(meshInfo.boundingSphere, geometryMesh.boundingSphere, sizeof(meshInfo.boundingSphere));
+        meshInfo.firstVertex = geometryMesh.firstVertex;
+        meshInfo.lodCount = geometryMesh.lodCount;
+        for (uint32_t i = 0; i < geometryMesh.lodCount; i++) {
+            meshInfo.lods[i] = {geometryMesh.lods[i].indexOffset, geometryMesh.lods[i].indexCount,
+                                geometryMesh.lods[i].error, 0};
+        }
+
+        uint32_t meshId;
+        if (!mFreeMeshIds.empty()) {
+            meshId = mFreeMeshIds.back();
+            mFreeMeshIds.pop_back();
+            mMeshes[meshId] = geometryMesh;
+            mMeshInfos[meshId] = meshInfo;
+        } else {
+            meshId = static_cast<uint32_t>(mMeshes.size());
+            mMeshes.push_back(geometryMesh);
+            mMeshInfos.push_back(meshInfo);
+        }
+        pendingMesh.meshId = meshId;
+        mPendingMeshes.push_back(std::move(pendingMesh));
+        MarkMeshInfoDirty(meshId);
+        return meshId;
+    }
+
+    void AdVKGeometryBuffer::RemoveMesh(uint32_t meshId) {
+        if (!IsValidMesh(meshId)) {
+            return;
+        }
+        AdGeometryMesh &mesh = mMeshes[meshId];
+        mVertexAllocator.Free(mesh.firstVertex, mesh.vertexCount);
+        mIndexAllocator.Free(mesh.firstIndex, mesh.indexCount);
+        mesh = {};
+        mFreeMeshIds.push_back(meshId);
+        mPendingMeshes.erase(std::remove_if(mPendingMeshes.begin(), mPendingMeshes.end(),
+                                            [meshId](const PendingMesh &pending) { return pending.meshId == meshId; }),
+                             mPendingMeshes.end());
+        // lodCount 为 0 时 GPU 剔除会跳过引用这个网格的实例
+        mMeshInfos[meshId] = {};
+        MarkMeshInfoDirty(meshId);
+    }
+
+    void AdVKGeometryBuffer::MarkMeshInfoDirty(uint32_t meshId) {
+        if (!mMeshDirtyFlags[meshId]) {
+            mMeshDirtyFlags[meshId] = true;
+            mDirtyMeshIds.push_back(meshId);
+        }
+    }
+
+    void AdVKGeometryBuffer::CmdUpload(VkCommandBuffer cmdBuffer) {
+        if (!mMeshInfoBuffer || (mPendingMeshes.empty() && mDirtyMeshIds.empty())) {
+            return;
+        }
+        // 之前的剔除和绘制读完之后才能写入; 删除后重新分配的空间可能还在被读取
+        VkMemoryBarrier uploadBarrier = {
+                .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INDEX_READ_BIT,
+                .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT
+        };
+        vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT
+                                        | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &uploadBarrier, 0, nullptr, 0, nullptr);
+
+        for (const PendingMesh &pending: mPendingMeshes) {
+            const AdGeometryMesh &mesh = mMeshes[pending.meshId];
+            CmdUpdateBufferChunked(cmdBuffer, mPositionBuffer->GetHandle(),
+                                   uint64_t(mesh.firstVertex) * sizeof(AdMeshPosition),
+                                   pending.positions.size() * sizeof(AdMeshPosition), pending.positions.data());
+            CmdUpdateBufferChunked(cmdBuffer, mAttributeBuffer->GetHandle(),
+                                   uint64_t(mesh.firstVertex) * sizeof(AdMeshAttribute),
+                                   pending.attributes.size() * sizeof(AdMeshAttribute), pending.attributes.data());
+            CmdUpdateBufferChunked(cmdBuffer, mIndexBuffer->GetHandle(), uint64_t(mesh.firstIndex) * sizeof(uint32_t),
+                                   pending.indices.size() * sizeof(uint32_t), pending.indices.data());
+        }
+        mPendingMeshes.clear();
+
+        // 连续的下标合并成一次更新
+        std::sort(mDirtyMeshIds.begin(), mDirtyMeshIds.end());
+        size_t i = 0;
+        while (i < mDirtyMeshIds.size()) {
+            uint32_t first = mDirtyMeshIds[i];
+            uint32_t count = 1;
+            while (i + count < mDirtyMeshIds.size() && mDirtyMeshIds[i + count] == first + count) {
+                count++;
+            }
+            CmdUpdateBufferChunked(cmdBuffer, mMeshInfoBuffer->GetHandle(),
+                                   uint64_t(first) * sizeof(AdGeometryMeshInfo),
+                                   uint64_t(count) * sizeof(AdGeometryMeshInfo), &mMeshInfos[first]);
+            i += count;
+        }
+        for (uint32_t meshId: mDirtyMeshIds) {
+            mMeshDirtyFlags[meshId] = false;
+        }
+        mDirtyMeshIds.clear();
+
+        VkMemoryBarrier readBarrier = {
+                .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INDEX_READ_BIT
+        };
+        vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT
+                             | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &readBarrier, 0, nullptr, 0, nullptr);
+    }
+
+    VkDrawIndexedIndirectCommand AdVKGeometryBuffer::GetDrawCommand(uint32_t meshId, uint32_t lod,
+                                                                    uint32_t instanceCount,
+                                                                    uint32_t firstInstance) const {
+        const AdGeometryMesh &mesh = mMeshes[meshId];
+        const AdMeshLod &meshLod = mesh.lods[std::min(lod, mesh.lodCount - 1)];
+        return {
+                .indexCount = meshLod.indexCount,
+                .instanceCount = instanceCount,
+                .firstIndex = meshLod.indexOffset,
+                .vertexOffset = static_cast<int32_t>(mesh.firstVertex),
+                .firstInstance = firstInstance
+        };
+    }
+
+    void AdVKGeometryBuffer::CmdBind(VkCommandBuffer cmdBuffer, VkPipelineBindPoint bindPoint,
+                                     VkPipelineLayout pipelineLayout, uint32_t set) const {
+        vkCmdBindDescriptorSets(cmdBuffer, bindPoint, pipelineLayout, set, 1, &mDescriptorSet, 0, nullptr);
+        if (bindPoint == VK_PIPELINE_BIND_POINT_GRAPHICS) {
+            vkCmdBindIndexBuffer(cmdBuffer, mIndexBuffer->GetHandle(), 0, VK_INDEX_TYPE_UINT32);
+        }
+    }
+
+    void AdVKGeometryBuffer::CmdDrawIndirect(VkCommandBuffer cmdBuffer, VkBuffer commandBuffer, VkDeviceSize offset,
+                                            uint32_t drawCount) const {
+        if (mDevice->IsMultiDrawIndirectEnabled() || drawCount <= 1) {
+            vkCmdDrawIndexedIndirect(cmdBuffer, commandBuffer, offset, drawCount, sizeof(VkDrawIndexedIndirectCommand));
+            return;
+        }
+        for (uint32_t i = 0; i < drawCount; i++) {
+            vkCmdDrawIndexedIndirect(cmdBuffer, commandBuffer, offset + i * sizeof(VkDrawIndexedIndirectCommand), 1,
+                                     sizeof(VkDrawIndexedIndirectCommand));
+        }
+    }
+}
@@ -0,0 +1,446 @@
+#include "Graphic/AdVKGpuScene.h"
+#include "Graphic/AdVKAllocator.h"
+#include "Graphic/AdDevice.h"
+#include "Graphic/AdVKDepthPyramid.h"
+#include <algorithm>
+#include <cstring>
+
+namespace ade {
+
+    // 与 Asset/Shader/GpuSceneCull.comp 的 local_size_x 一致
+    static constexpr uint32_t AD_GPU_CULL_GROUP_SIZE = 64;
+    // 与 AdGpuSceneCull.glsl 的 AD_GPU_CULL_FLAG_EARLY 一致
+    static constexpr uint32_t AD_GPU_CULL_FLAG_EARLY = 1;
+    // 在 AdVKPipelineCache 中注册的 layout 名字
+    static const char *AD_GPU_SCENE_CULL_LAYOUT = "GpuSceneCull";
+    static const char *AD_GPU_SCENE_OCCLUSION_CULL_LAYOUT = "GpuSceneOcclusionCull";
+    // vkCmdUpdateBuffer 的大小必须是 4 的倍数
+    static_assert(sizeof(AdGeometryInstance) % 4 == 0);
+
+    enum AdGpuSceneBinding : uint32_t {
+        AD_GPU_SCENE_BINDING_INSTANCE = 0,
+        AD_GPU_SCENE_BINDING_DRAW_COMMAND,
+        AD_GPU_SCENE_BINDING_DRAW_COUNT,
+        AD_GPU_SCENE_BINDING_BUCKET_OFFSET,
+        AD_GPU_SCENE_BINDING_VISIBILITY,
+        AD_GPU_SCENE_BINDING_COUNT
+    };
+
+    AdVKGpuScene::AdVKGpuScene(AdVKDevice *device, AdVKPipelineCache *pipelineCache, AdVKGeometryBuffer *geometry,
+                               const AdGpuSceneSettings &settings) : mDevice(device), mPipelineCache(pipelineCache),
+                                                                     mGeometry(geometry), mSettings(settings) {
+        mBucketInstanceCounts.resize(settings.maxBucketCount, 0);
+        mBucketOffsets.resize(settings.maxBucketCount, 0);
+        mCulledBucketInstanceCounts.resize(settings.maxBucketCount, 0);
+        mInstanceBuckets.resize(settings.maxInstanceCount, INVALID_INSTANCE_ID);
+        mInstanceDirtyFlags.resize(settings.maxInstanceCount, false);
+        if (!device || !pipelineCache || !geometry) {
+            LOG_E("Must create a vulkan device, pipeline cache and geometry buffer before create gpu scene.");
+            return;
+        }
+        // 绘制命令的 firstInstance 是实例槽位, GeometryPull.vert 用 gl_InstanceIndex 读取实例数据
+        if (!device->IsDrawIndirectFirstInstanceEnabled()) {
+            LOG_E("Gpu scene requires drawIndirectFirstInstance, which the device does not support.");
+            return;
+        }
+        mInstanceBuffer = std::make_unique<AdVKBuffer>(device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+                                                               | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                       uint64_t(settings.maxInstanceCount) * sizeof(AdGeometryInstance));
+        // 每个实例最多一条绘制命令, 所有桶的区间加起来不会超过实例容量
+        mDrawCommandBuffer = std::make_unique<AdVKBuffer>(
+                device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT
+                        | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                uint64_t(settings.maxInstanceCount) * sizeof(VkDrawIndexedIndirectCommand));
+        mDrawCountBuffer = std::make_unique<AdVKBuffer>(
+                device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT
+                        | VK_BUFFER_USAGE_TRANSFER_DST_BIT, uint64_t(settings.maxBucketCount) * sizeof(uint32_t));
+        mBucketOffsetBuffer = std::make_unique<AdVKBuffer>(device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+                                                                   | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                           uint64_t(settings.maxBucketCount) * sizeof(uint32_t),
+                                                           mBucketOffsets.data());
+        // 初始都不可见, 新实例在第二阶段才会被绘制
+        std::vector<uint32_t> visibility(settings.maxInstanceCount, 0);
+        mVisibilityBuffer = std::make_unique<AdVKBuffer>(device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                         visibility.size() * sizeof(uint32_t), visibility.data());
+        CreateDescriptorSet();
+
+        VkDescriptorSetLayout setLayouts[] = {geometry->GetDescriptorSetLayout(), mDescriptorSetLayout};
+        VkPushConstantRange pushConstantRange = {
+                .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+                .offset = 0,
+                .size = sizeof(AdGpuCullPushConstants)
+        };
+        VkPipelineLayoutCreateInfo pipelineLayoutCI = {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+                .setLayoutCount = ARRAY_SIZE(setLayouts),
+                .pSetLayouts = setLayouts,
+                .pushConstantRangeCount = 1,
+                .pPushConstantRanges = &pushConstantRange
+        };
+        CALL_VK(vkCreatePipelineLayout(device->GetHandle(), &pipelineLayoutCI,
+                                       AdVKAllocator::GetCallbacks(), &mCullPipelineLayout));
+
+        pipelineCache->RegisterPipelineLayout(AD_GPU_SCENE_CULL_LAYOUT, mCullPipelineLayout);
+        AdVKPipelineKey cullKey;
+        cullKey.computeShader = "Shader/GpuSceneCull.comp.spv";
+        cullKey.pipelineLayout = AD_GPU_SCENE_CULL_LAYOUT;
+        mCullPipeline = pipelineCache->GetOrCreateComputePipeline(cullKey, mCullPipelineLayout);
+        if (!mCullPipeline) {
+            return;
+        }
+        CreateOcclusionPipeline();
+        LOG_D("Gpu scene: {0} instances, {1} buckets, draw indirect count: {2}", settings.maxInstanceCount,
+              settings.maxBucketCount, device->IsDrawIndirectCountEnabled());
+    }
+
+    AdVKGpuScene::~AdVKGpuScene() {
+        if (!mDevice) {
+            return;
+        }
+        VkDevice device = mDevice->GetHandle();
+        if (mOcclusionPipelineLayout != VK_NULL_HANDLE) {
+            mPipelineCache->UnregisterPipelineLayout(AD_GPU_SCENE_OCCLUSION_CULL_LAYOUT, mOcclusionPipelineLayout);
+            vkDestroyPipelineLayout(device, mOcclusionPipelineLayout, AdVKAllocator::GetCallbacks());
+        }
+        if (mPyramidDescriptorPool != VK_NULL_HANDLE) {
+            vkDestroyDescriptorPool(device, mPyramidDescriptorPool, AdVKAllocator::GetCallbacks());
+        }
+        if (mPyramidSetLayout != VK_NULL_HANDLE) {
+            vkDestroyDescriptorSetLayout(device, mPyramidSetLayout, AdVKAllocator::GetCallbacks());
+        }
+        if (mCullPipelineLayout != VK_NULL_HANDLE) {
+            mPipelineCache->UnregisterPipelineLayout(AD_GPU_SCENE_CULL_LAYOUT, mCullPipelineLayout);
+            vkDestroyPipelineLayout(device, mCullPipelineLayout, AdVKAllocator::GetCallbacks());
+        }
+        if (mDescriptorPool != VK_NULL_HANDLE) {
+            vkDestroyDescriptorPool(device, mDescriptorPool, AdVKAllocator::GetCallbacks());
+        }
+        if (mDescriptorSetLayout != VK_NULL_HANDLE) {
+            vkDestroyDescriptorSetLayout(device, mDescriptorSetLayout, AdVKAllocator::GetCallbacks());
+        }
+    }
+
+    void AdVKGpuScene::CreateDescriptorSet() {
+        VkDescriptorSetLayoutBinding bindings[AD_GPU_SCENE_BINDING_COUNT];
+        for (uint32_t i = 0; i < AD_GPU_SCENE_BINDING_COUNT; i++) {
+            bindings[i] = {
+                    .binding = i,
+                    .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    .descriptorCount = 1,
+                    .stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_COMPUTE_BIT
+            };
+        }
+        VkDescriptorSetLayoutCreateInfo setLayoutCI = {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+                .bindingCount = ARRAY_SIZE(bindings),
+                .pBindings = bindings
+        };
+        CALL_VK(vkCreateDescriptorSetLayout(mDevice->GetHandle(), &setLayoutCI,
+                                            AdVKAllocator::GetCallbacks(), &mDescriptorSetLayout));
+
+        VkDescriptorPoolSize poolSize = {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, AD_GPU_SCENE_BINDING_COUNT};
+        VkDescriptorPoolCreateInfo poolCI = {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+                .maxSets = 1,
+                .poolSizeCount = 1,
+                .pPoolSizes = &poolSize
+        };
+        CALL_VK(vkCreateDescriptorPool(mDevice->GetHandle(), &poolCI, AdVKAllocator::GetCallbacks(), &mDescriptorPool));
+        VkDescriptorSetAllocateInfo allocateInfo = {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+                .descriptorPool = mDescriptorPool,
+                .descriptorSetCount = 1,
+                .pSetLayouts = &mDescriptorSetLayout
+        };
+        CALL_VK(vkAllocateDescriptorSets(mDevice->GetHandle(), &allocateInfo, &mDescriptorSet));
+
+        const AdVKBuffer *buffers[AD_GPU_SCENE_BINDING_COUNT] = {
+                mInstanceBuffer.get(), mDrawCommandBuffer.get(), mDrawCountBuffer.get(), mBucketOffsetBuffer.get(),
+                mVisibilityBuffer.get()
+        };
+        VkDescriptorBufferInfo bufferInfos[AD_GPU_SCENE_BINDING_COUNT];
+        VkWriteDescriptorSet writes[AD_GPU_SCENE_BINDING_COUNT];
+        for (uint32_t i = 0; i < AD_GPU_SCENE_BINDING_COUNT; i++) {
+            bufferInfos[i] = buffers[i]->GetDescriptorInfo();
+            writes[i] = {
+                    .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                    .dstSet = mDescriptorSet,
+                    .dstBinding = i,
+                    .descriptorCount = 1,
+                    .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    .pBufferInfo = &bufferInfos[i]
+            };
+        }
+        vkUpdateDescriptorSets(mDevice->GetHandle(), ARRAY_SIZE(writes), writes, 0, nullptr);
+    }
+
+    void AdVKGpuScene::CreateOcclusionPipeline() {
+        VkDevice device = mDevice->GetHandle();
+        VkDescriptorSetLayoutBinding binding = {
+                .binding = 0,
+                .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                .descriptorCount = 1,
+                .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT
+        };
+        VkDescriptorSetLayoutCreateInfo setLayoutCI = {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+                .bindingCount = 1,
+                .pBindings = &binding
+        };
+        CALL_VK(vkCreateDescriptorSetLayout(device, &setLayoutCI, AdVKAllocator::GetCallbacks(), &mPyramidSetLayout));
+
+        VkDescriptorPoolSize poolSize = {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1};
+        VkDescriptorPoolCreateInfo poolCI = {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+                .maxSets = 1,
+                .poolSizeCount = 1,
+                .pPoolSizes = &poolSize
+        };
+        CALL_VK(vkCreateDescriptorPool(device, &poolCI, AdVKAllocator::GetCallbacks(), &mPyramidDescriptorPool));
+        VkDescriptorSetAllocateInfo allocateInfo = {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+                .descriptorPool = mPyramidDescriptorPool,
+                .descriptorSetCount = 1,
+                .pSetLayouts = &mPyramidSetLayout
+        };
+        CALL_VK(vkAllocateDescriptorSets(device, &allocateInfo, &mPyramidDescriptorSet));
+
+        VkDescriptorSetLayout setLayouts[] = {mGeometry->GetDescriptorSetLayout(), mDescriptorSetLayout,
+                                              mPyramidSetLayout};
+        VkPushConstantRange pushConstantRange = {
+                .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+                .offset = 0,
+                .size = sizeof(AdGpuCullPushConstants)
+        };
+        VkPipelineLayoutCreateInfo pipelineLayoutCI = {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+                .setLayoutCount = ARRAY_SIZE(setLayouts),
+                .pSetLayouts = setLayouts,
+                .pushConstantRangeCount = 1,
+                .pPushConstantRanges = &pushConstantRange
+        };
+        CALL_VK(vkCreatePipelineLayout(device, &pipelineLayoutCI,
+                                       AdVKAllocator::GetCallbacks(), &mOcclusionPipelineLayout));
+
+        mPipelineCache->RegisterPipelineLayout(AD_GPU_SCENE_OCCLUSION_CULL_LAYOUT, mOcclusionPipelineLayout);
+        AdVKPipelineKey occlusionKey;
+        occlusionKey.computeShader = "Shader/GpuSceneOcclusionCull.comp.spv";
+        occlusionKey.pipelineLayout = AD_GPU_SCENE_OCCLUSION_CULL_LAYOUT;
+        mOcclusionPipeline = mPipelineCache->GetOrCreateComputePipeline(occlusionKey, mOcclusionPipelineLayout);
+    }
+
+    void AdVKGpuScene::SetDepthPyramid(const AdVKDepthPyramid *depthPyramid) {
+        if (mPyramidDescriptorSet == VK_NULL_HANDLE) {
+            return;
+        }
+        bHasDepthPyramid = depthPyramid && depthPyramid->GetImageView() != VK_NULL_HANDLE;
+        if (!bHasDepthPyramid) {
+            return;
+        }
+        VkDescriptorImageInfo imageInfo = {depthPyramid->GetSampler(), depthPyramid->GetImageView(),
+                                           VK_IMAGE_LAYOUT_GENERAL};
+        VkWriteDescriptorSet write = {
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet = mPyramidDescriptorSet,
+                .dstBinding = 0,
+                .descriptorCount = 1,
+                .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                .pImageInfo = &imageInfo
+        };
+        vkUpdateDescriptorSets(mDevice->GetHandle(), 1, &write, 0, nullptr);
+    }
+
+    uint32_t AdVKGpuScene::AddInstance(uint32_t meshId, uint32_t bucket, const float model[16], uint32_t materialId) {
+        if (!mInstanceBuffer) {
+            return INVALID_INSTANCE_ID;
+        }
+        if (!mGeometry->IsValidMesh(meshId) || bucket >= mSettings.maxBucketCount) {
+            LOG_E("Invalid gpu scene instance: mesh {0}, bucket {1}", meshId, bucket);
+            return INVALID_INSTANCE_ID;
+        }
+        uint32_t instanceId;
+        if (!mFreeInstanceIds.empty()) {
+            instanceId = mFreeInstanceIds.back();
+            mFreeInstanceIds.pop_back();
+        } else if (mInstanceCount < mSettings.maxInstanceCount) {
+            instanceId = mInstanceCount++;
+            mInstances.emplace_back();
+        } else {
+            LOG_E("Gpu scene is full: {0} instances", mInstanceCount);
+            return INVALID_INSTANCE_ID;
+        }
+
+        AdGeometryInstance &instance = mInstances[instanceId];
+        memcpy(instance.model, model, sizeof(instance.model));
+        instance.meshId = meshId;
+        instance.materialId = materialId;
+        instance.bucket = bucket;
+        MarkInstanceDirty(instanceId);
+
+        mInstanceBuckets[instanceId] = bucket;
+        mBucketInstanceCounts[bucket]++;
+        bBucketOffsetsDirty = true;
+        return instanceId;
+    }
+
+    void AdVKGpuScene::UpdateInstance(uint32_t instanceId, const float model[16]) {
+        if (instanceId >= mInstanceCount || mInstanceBuckets[instanceId] == INVALID_INSTANCE_ID) {
+            return;
+        }
+        memcpy(mInstances[instanceId].model, model, sizeof(AdGeometryInstance::model));
+        MarkInstanceDirty(instanceId);
+    }
+
+    void AdVKGpuScene::RemoveInstance(uint32_t instanceId) {
+        if (instanceId >= mInstanceCount) {
+            return;
+        }
+        uint32_t bucket = mInstanceBuckets[instanceId];
+        if (bucket == INVALID_INSTANCE_ID) {
+            return;
+        }
+        mInstanceBuckets[instanceId] = INVALID_INSTANCE_ID;
+        mBucketInstanceCounts[bucket]--;
+        bBucketOffsetsDirty = true;
+
+        // 空槽位仍然会被派发, 剔除着色器直接跳过
+        mInstances[instanceId].meshId = AdVKGeometryBuffer::INVALID_MESH_ID;
+        MarkInstanceDirty(instanceId);
+        mFreeInstanceIds.push_back(instanceId);
+    }
+
+    void AdVKGpuScene::MarkInstanceDirty(uint32_t instanceId) {
+        if (!mInstanceDirtyFlags[instanceId]) {
+            mInstanceDirtyFlags[instanceId] = true;
+            mDirtyInstanceIds.push_back(instanceId);
+        }
+    }
+
+    void AdVKGpuScene::CmdUploadPending(VkCommandBuffer cmdBuffer) {
+        if (bBucketOffsetsDirty) {
+            uint32_t offset = 0;
+            for (uint32_t i = 0; i < mSettings.maxBucketCount; i++) {
+                mBucketOffsets[i] = offset;
+                offset += mBucketInstanceCounts[i];
+            }
+            mCulledBucketInstanceCounts = mBucketInstanceCounts;
+            CmdUpdateBufferChunked(cmdBuffer, mBucketOffsetBuffer->GetHandle(), 0,
+                                   mBucketOffsets.size() * sizeof(uint32_t), mBucketOffsets.data());
+            bBucketOffsetsDirty = false;
+        }
+        if (mDirtyInstanceIds.empty()) {
+            return;
+        }
+
+        // 连续的槽位合并成一次更新
+        std::sort(mDirtyInstanceIds.begin(), mDirtyInstanceIds.end());
+        size_t i = 0;
+        while (i < mDirtyInstanceIds.size()) {
+            uint32_t first = mDirtyInstanceIds[i];
+            uint32_t count = 1;
+            while (i + count < mDirtyInstanceIds.size() && mDirtyInstanceIds[i + count] == first + count) {
+                count++;
+            }
+            CmdUpdateBufferChunked(cmdBuffer, mInstanceBuffer->GetHandle(), uint64_t(first) * sizeof(AdGeometryInstance),
+                                   uint64_t(count) * sizeof(AdGeometryInstance), &mInstances[first]);
+            i += count;
+        }
+        for (uint32_t instanceId: mDirtyInstanceIds) {
+            mInstanceDirtyFlags[instanceId] = false;
+        }
+        mDirtyInstanceIds.clear();
+    }
+
+    void AdVKGpuScene::CmdCull(VkCommandBuffer cmdBuffer, const AdGpuCullView &view, AdGpuCullPass pass) {
+        bool bOcclusion = pass == AD_GPU_CULL_PASS_LATE;
+        if (bOcclusion && !bHasDepthPyramid) {
+            LOG_E("Gpu scene late cull requires a depth pyramid.");
+            return;
+        }
+        const AdVKComputePipeline *pipeline = bOcclusion ? mOcclusionPipeline : mCullPipeline;
+        VkPipelineLayout pipelineLayout = bOcclusion ? mOcclusionPipelineLayout : mCullPipelineLayout;
+        if (!pipeline) {
+            return;
+        }
+        mGeometry->CmdUpload(cmdBuffer);
+
+        // 上一帧(或第一阶段)的剔除和绘制读完之后才能重置命令、写入实例和桶区间
+        VkMemoryBarrier resetBarrier = {
+                .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT,
+                .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT
+        };
+        vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT
+                                        | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &resetBarrier, 0, nullptr, 0, nullptr);
+        CmdUploadPending(cmdBuffer);
+        vkCmdFillBuffer(cmdBuffer, mDrawCountBuffer->GetHandle(), 0, VK_WHOLE_SIZE, 0);
+        if (!mDevice->IsDrawIndirectCountEnabled() && mInstanceCount > 0) {
+            // 没有 count 缓冲时按桶容量绘制, 未写入的命令必须是 0
+            vkCmdFillBuffer(cmdBuffer, mDrawCommandBuffer->GetHandle(), 0,
+                            uint64_t(mInstanceCount) * sizeof(VkDrawIndexedIndirectCommand), 0);
+        }
+        // 实例数据之后还会被绘制的顶点着色器读取
+        VkMemoryBarrier fillBarrier = {
+                .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+        };
+        vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, 0,
+                             1, &fillBarrier, 0, nullptr, 0, nullptr);
+
+        AdGpuCullPushConstants constants{};
+        memcpy(constants.viewProj, view.viewProj, sizeof(constants.viewProj));
+        memcpy(constants.cameraPosition, view.cameraPosition, sizeof(constants.cameraPosition));
+        constants.projectionScale = view.projectionScale;
+        constants.instanceCount = mInstanceCount;
+        constants.maxPixelError = view.maxPixelError;
+        constants.bucketCount = mSettings.maxBucketCount;
+        constants.flags = pass == AD_GPU_CULL_PASS_EARLY ? AD_GPU_CULL_FLAG_EARLY : 0;
+
+        pipeline->Bind(cmdBuffer);
+        mGeometry->CmdBind(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0);
+        vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 1, 1,
+                                &mDescriptorSet, 0, nullptr);
+        if (bOcclusion) {
+            vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 2, 1,
+                                    &mPyramidDescriptorSet, 0, nullptr);
+        }
+        vkCmdPushConstants(cmdBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants),
+                           &constants);
+        if (mInstanceCount > 0) {
+            vkCmdDispatch(cmdBuffer, (mInstanceCount + AD_GPU_CULL_GROUP_SIZE - 1) / AD_GPU_CULL_GROUP_SIZE, 1, 1);
+        }
+
+        // 可见性由下一帧的剔除读取
+        VkMemoryBarrier cullBarrier = {
+                .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT
+        };
+        vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                             1, &cullBarrier, 0, nullptr, 0, nullptr);
+    }
+
+    void AdVKGpuScene::CmdDrawBucket(VkCommandBuffer cmdBuffer, uint32_t bucket, VkPipelineLayout pipelineLayout) const {
+        // 使用最近一次 CmdCull 写入 GPU 的桶区间, 之后增删的实例等到下一次剔除才参与绘制
+        uint32_t maxDrawCount = bucket < mSettings.maxBucketCount ? mCulledBucketInstanceCounts[bucket] : 0;
+        if (!mCullPipeline || maxDrawCount == 0) {
+            return;
+        }
+        mGeometry->CmdBind(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0);
+        vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 1, 1,
+                                &mDescriptorSet, 0, nullptr);
+
+        VkDeviceSize commandOffset = uint64_t(mBucketOffsets[bucket]) * sizeof(VkDrawIndexedIndirectCommand);
+        if (mDevice->IsDrawIndirectCountEnabled()) {
+            vkCmdDrawIndexedIndirectCount(cmdBuffer, mDrawCommandBuffer->GetHandle(), commandOffset,
+                                          mDrawCountBuffer->GetHandle(), uint64_t(bucket) * sizeof(uint32_t),
+                                          maxDrawCount, sizeof(VkDrawIndexedIndirectCommand));
+            return;
+        }
+        mGeometry->CmdDrawIndirect(cmdBuffer, mDrawCommandBuffer->GetHandle(), commandOffset, maxDrawCount);
+    }
+}
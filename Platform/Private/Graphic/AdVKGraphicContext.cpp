@@ -1,4 +1,5 @@
 #include "Graphic/AdVKGraphicContext.h"
+#include "Graphic/AdVKAllocator.h"
 #include "Window/AdGLFWwindow.h"
 
 namespace ade {
@@ -31,9 +32,12 @@ namespace ade {
     }
 
     AdVKGraphicContext::~AdVKGraphicContext() {
-        vkDestroySurfaceKHR(mInstance, mSurface, nullptr);
+        vkDestroySurfaceKHR(mInstance, mSurface, AdVKAllocator::GetCallbacks());
 
-        vkDestroyInstance(mInstance, nullptr);
+        vkDestroyInstance(mInstance, AdVKAllocator::GetCallbacks());
+
+        // 此时驱动应该已经归还所有 host 内存
+        AdVKAllocator::Report();
     }
 
     // Vulkan 验证层日志回调
@@ -142,7 +146,7 @@ namespace ade {
         };
 
 
-        CALL_VK(vkCreateInstance(&instanceCI, nullptr, &mInstance));
+        CALL_VK(vkCreateInstance(&instanceCI, AdVKAllocator::GetCallbacks(), &mInstance));
         LOG_T("{0} : instance : {1}", __FUNCTION__, (void *) mInstance);
     }
 
@@ -157,7 +161,8 @@ namespace ade {
             LOG_E("this window is not a glfw window.");
             return;
         }
-        CALL_VK(glfwCreateWindowSurface(mInstance, glfwWindow->GetWindowHandle(), nullptr, &mSurface));
+        CALL_VK(glfwCreateWindowSurface(mInstance, glfwWindow->GetWindowHandle(),
+                                        AdVKAllocator::GetCallbacks(), &mSurface));
         LOG_T("{0} : surface : {1}", __FUNCTION__, (void *) mSurface);
     }
 
@@ -0,0 +1,352 @@
+#include "Graphic/AdVKMeshletPass.h"
+#include "Graphic/AdVKAllocator.h"
+#include "Graphic/AdDevice.h"
+#include "Graphic/AdVKGraphicContext.h"
+#include "Asset/AdMesh.h"
+#include <cstring>
+
+namespace ade {
+
+    // 与 Asset/Shader/Meshlet.task 的 local_size_x 一致
+    static constexpr uint32_t AD_MESHLET_TASK_GROUP_SIZE = 32;
+
+    enum AdMeshletBinding : uint32_t {
+        AD_MESHLET_BINDING_MESH_INFO = 0,
+        AD_MESHLET_BINDING_POSITION,
+        AD_MESHLET_BINDING_ATTRIBUTE,
+        AD_MESHLET_BINDING_MESHLET,
+        AD_MESHLET_BINDING_MESHLET_VERTEX,
+        AD_MESHLET_BINDING_MESHLET_TRIANGLE,
+        AD_MESHLET_BINDING_CULLED_INDEX,
+        AD_MESHLET_BINDING_DRAW_COMMAND,
+        AD_MESHLET_BINDING_COUNT
+    };
+
+    static VkDescriptorType GetBindingDescriptorType(uint32_t binding) {
+        if (binding == AD_MESHLET_BINDING_MESH_INFO) {
+            return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        }
+        // 按绘制槽位偏移
+        if (binding == AD_MESHLET_BINDING_CULLED_INDEX || binding == AD_MESHLET_BINDING_DRAW_COMMAND) {
+            return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+        }
+        return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    }
+
+    static uint32_t AlignSlotSize(uint64_t size, VkDeviceSize alignment) {
+        return static_cast<uint32_t>((size + alignment - 1) / alignment * alignment);
+    }
+
+    // AdMeshDequantize(Asset/Shader/Include/AdMesh.glsl)
+    struct AdMeshletMeshInfo {
+        float positionScale[4];
+        float positionOffset[4];
+        float uvScaleOffset[4];
+    };
+
+    AdVKMeshletMesh::~AdVKMeshletMesh() {
+        if (mDescriptorPool != VK_NULL_HANDLE) {
+            vkDestroyDescriptorPool(mDevice->GetHandle(), mDescriptorPool, AdVKAllocator::GetCallbacks());
+        }
+    }
+
+    AdVKMeshletPass::AdVKMeshletPass(AdVKDevice *device, AdVKPipelineCache *pipelineCache, VkFormat colorFormat,
+                                     VkFormat depthFormat) : mDevice(device), mPipelineCache(pipelineCache) {
+        if (!device || !pipelineCache) {
+            LOG_E("Must create a vulkan device and pipeline cache before create meshlet pass.");
+            return;
+        }
+        bUseMeshShader = device->GetSettings().bEnableMeshShader && device->GetMeshShaderSupport().bMeshShader;
+        mStageFlags = bUseMeshShader ? VK_SHADER_STAGE_TASK_BIT_EXT | VK_SHADER_STAGE_MESH_BIT_EXT
+                                     : VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(device->GetContext()->GetPhysicalDevice(), &properties);
+        mStorageOffsetAlignment = std::max<VkDeviceSize>(properties.limits.minStorageBufferOffsetAlignment,
+                                                         sizeof(uint32_t));
+        CreateLayout();
+
+        // 两条路径的 layout 阶段不同, 用不同的名字注册
+        mPipelineKey.pipelineLayout = bUseMeshShader ? "MeshletPass" : "MeshletPassFallback";
+        mPipelineCache->RegisterPipelineLayout(mPipelineKey.pipelineLayout, mPipelineLayout);
+
+        mPipelineKey.colorFormat = colorFormat;
+        mPipelineKey.depthFormat = depthFormat;
+        mPipelineKey.fragmentShader = "Shader/Meshlet.frag.spv";
+        if (bUseMeshShader) {
+            mPipelineKey.taskShader = "Shader/Meshlet.task.spv";
+            mPipelineKey.meshShader = "Shader/Meshlet.mesh.spv";
+        } else {
+            mPipelineKey.vertexShader = "Shader/MeshletFallback.vert.spv";
+            AdMesh::GetVertexInputDescription(mPipelineKey.vertexBindings, mPipelineKey.vertexAttributes);
+
+            AdVKPipelineKey cullKey;
+            cullKey.computeShader = "Shader/MeshletCull.comp.spv";
+            cullKey.pipelineLayout = mPipelineKey.pipelineLayout;
+            mCullPipeline = mPipelineCache->GetOrCreateComputePipeline(cullKey, mPipelineLayout);
+            if (!mCullPipeline) {
+                return;
+            }
+        }
+        // 默认状态: 深度测试 + 背面剔除, 渲染时可以通过动态状态覆盖
+        mPipelineKey.state.depthTestEnable = depthFormat != VK_FORMAT_UNDEFINED;
+        mPipelineKey.state.depthWriteEnable = depthFormat != VK_FORMAT_UNDEFINED;
+        mPipeline = mPipelineCache->GetOrCreatePipeline(mPipelineKey, mPipelineLayout);
+        LOG_D("Meshlet pass: {0}", bUseMeshShader ? "mesh shader" : "compute cull fallback");
+    }
+
+    AdVKMeshletPass::~AdVKMeshletPass() {
+        if (!mDevice) {
+            return;
+        }
+        VkDevice device = mDevice->GetHandle();
+        if (mPipelineLayout != VK_NULL_HANDLE) {
+            mPipelineCache->UnregisterPipelineLayout(mPipelineKey.pipelineLayout, mPipelineLayout);
+            vkDestroyPipelineLayout(device, mPipelineLayout, AdVKAllocator::GetCallbacks());
+        }
+        if (mDescriptorSetLayout != VK_NULL_HANDLE) {
+            vkDestroyDescriptorSetLayout(device, mDescriptorSetLayout, AdVKAllocator::GetCallbacks());
+        }
+    }
+
+    void AdVKMeshletPass::CreateLayout() {
+        VkDescriptorSetLayoutBinding bindings[AD_MESHLET_BINDING_COUNT];
+        for (uint32_t i = 0; i < AD_MESHLET_BINDING_COUNT; i++) {
+            bindings[i] = {
+                    .binding = i,
+                    .descriptorType = GetBindingDescriptorType(i),
+                    .descriptorCount = 1,
+                    .stageFlags = mStageFlags
+            };
+        }
+        VkDescriptorSetLayoutCreateInfo setLayoutCI = {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+                .bindingCount = ARRAY_SIZE(bindings),
+                .pBindings = bindings
+        };
+        CALL_VK(vkCreateDescriptorSetLayout(mDevice->GetHandle(), &setLayoutCI,
+                                            AdVKAllocator::GetCallbacks(), &mDescriptorSetLayout));
+
+        VkPushConstantRange pushConstantRange = {
+                .stageFlags = mStageFlags,
+                .offset = 0,
+                .size = sizeof(AdMeshletPushConstants)
+        };
+        VkPipelineLayoutCreateInfo pipelineLayoutCI = {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+                .setLayoutCount = 1,
+                .pSetLayouts = &mDescriptorSetLayout,
+                .pushConstantRangeCount = 1,
+                .pPushConstantRanges = &pushConstantRange
+        };
+        CALL_VK(vkCreatePipelineLayout(mDevice->GetHandle(), &pipelineLayoutCI,
+                                       AdVKAllocator::GetCallbacks(), &mPipelineLayout));
+    }
+
+    std::unique_ptr<AdVKMeshletMesh> AdVKMeshletPass::CreateMesh(const AdMesh &mesh, uint32_t drawSlotCount) const {
+        const AdMeshHeader &header = mesh.GetHeader();
+        if (header.meshlet.size == 0) {
+            LOG_E("Mesh has no meshlet, recook it.");
+            return nullptr;
+        }
+        std::unique_ptr<AdVKMeshletMesh> result(new AdVKMeshletMesh(mDevice));
+        result->mLodCount = header.lodCount;
+        std::copy(header.lods, header.lods + header.lodCount, result->mLods);
+
+        AdMeshletMeshInfo meshInfo{};
+        memcpy(meshInfo.positionScale, header.positionScale, sizeof(header.positionScale));
+        memcpy(meshInfo.positionOffset, header.positionOffset, sizeof(header.positionOffset));
+        memcpy(meshInfo.uvScaleOffset, header.uvScale, sizeof(header.uvScale));
+        memcpy(meshInfo.uvScaleOffset + 2, header.uvOffset, sizeof(header.uvOffset));
+
+        auto createStreamBuffer = [&](const AdMeshStream &stream, VkBufferUsageFlags usage) {
+            return std::make_unique<AdVKBuffer>(mDevice, usage, stream.size, mesh.GetStreamData(stream));
+        };
+        // 回退路径把顶点流直接作为顶点缓冲使用
+        VkBufferUsageFlags vertexUsage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+        result->mMeshInfoBuffer = std::make_unique<AdVKBuffer>(mDevice, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                                                               sizeof(meshInfo), &meshInfo);
+        result->mPositionBuffer = createStreamBuffer(header.position, vertexUsage);
+        result->mAttributeBuffer = createStreamBuffer(header.attribute, vertexUsage);
+        result->mMeshletBuffer = createStreamBuffer(header.meshlet, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        result->mMeshletVertexBuffer = createStreamBuffer(header.meshletVertex, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        result->mMeshletTriangleBuffer = createStreamBuffer(header.meshletTriangle, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        if (!bUseMeshShader) {
+            // 任意一级 LOD 的索引都不会超过整个索引流; 槽位起始按动态偏移的要求对齐
+            result->mDrawSlotCount = std::max(drawSlotCount, 1u);
+            result->mCulledIndexSlotSize = AlignSlotSize(uint64_t(header.indexCount) * sizeof(uint32_t),
+                                                         mStorageOffsetAlignment);
+            result->mDrawCommandSlotSize = AlignSlotSize(sizeof(VkDrawIndexedIndirectCommand),
+                                                         mStorageOffsetAlignment);
+            result->mCulledIndexBuffer = std::make_unique<AdVKBuffer>(
+                    mDevice, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                    uint64_t(result->mCulledIndexSlotSize) * result->mDrawSlotCount);
+            result->mDrawCommandBuffer = std::make_unique<AdVKBuffer>(
+                    mDevice, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT
+                             | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                    uint64_t(result->mDrawCommandSlotSize) * result->mDrawSlotCount);
+        }
+
+        // 每个网格一个描述符集
+        VkDescriptorPoolSize poolSizes[] = {
+                {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1},
+                {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, AD_MESHLET_BINDING_COUNT - 3},
+                {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 2}
+        };
+        VkDescriptorPoolCreateInfo poolCI = {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+                .maxSets = 1,
+                .poolSizeCount = ARRAY_SIZE(poolSizes),
+                .pPoolSizes = poolSizes
+        };
+        CALL_VK(vkCreateDescriptorPool(mDevice->GetHandle(), &poolCI,
+                                       AdVKAllocator::GetCallbacks(), &result->mDescriptorPool));
+        VkDescriptorSetAllocateInfo allocateInfo = {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+                .descriptorPool = result->mDescriptorPool,
+                .descriptorSetCount = 1,
+                .pSetLayouts = &mDescriptorSetLayout
+        };
+        CALL_VK(vkAllocateDescriptorSets(mDevice->GetHandle(), &allocateInfo, &result->mDescriptorSet));
+
+        // mesh shader 路径没有回退用的缓冲, 绑定一个已有的缓冲占位
+        const AdVKBuffer *buffers[AD_MESHLET_BINDING_COUNT] = {
+                result->mMeshInfoBuffer.get(), result->mPositionBuffer.get(), result->mAttributeBuffer.get(),
+                result->mMeshletBuffer.get(), result->mMeshletVertexBuffer.get(), result->mMeshletTriangleBuffer.get(),
+                result->mCulledIndexBuffer ? result->mCulledIndexBuffer.get() : result->mMeshletVertexBuffer.get(),
+                result->mDrawCommandBuffer ? result->mDrawCommandBuffer.get() : result->mMeshletVertexBuffer.get()
+        };
+        VkDescriptorBufferInfo bufferInfos[AD_MESHLET_BINDING_COUNT];
+        VkWriteDescriptorSet writes[AD_MESHLET_BINDING_COUNT];
+        for (uint32_t i = 0; i < AD_MESHLET_BINDING_COUNT; i++) {
+            bufferInfos[i] = buffers[i]->GetDescriptorInfo();
+            writes[i] = {
+                    .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                    .dstSet = result->mDescriptorSet,
+                    .dstBinding = i,
+                    .descriptorCount = 1,
+                    .descriptorType = GetBindingDescriptorType(i),
+                    .pBufferInfo = &bufferInfos[i]
+            };
+        }
+        // 动态绑定的范围是一个槽位
+        if (!bUseMeshShader) {
+            bufferInfos[AD_MESHLET_BINDING_CULLED_INDEX].range = result->mCulledIndexSlotSize;
+            bufferInfos[AD_MESHLET_BINDING_DRAW_COMMAND].range = result->mDrawCommandSlotSize;
+        }
+        vkUpdateDescriptorSets(mDevice->GetHandle(), ARRAY_SIZE(writes), writes, 0, nullptr);
+        return result;
+    }
+
+    bool AdVKMeshletPass::GetDrawSlotOffsets(const AdVKMeshletMesh &mesh, uint32_t drawSlot,
+                                             uint32_t outOffsets[2]) const {
+        if (drawSlot >= mesh.mDrawSlotCount) {
+            LOG_E("Meshlet draw slot {0} is out of range, mesh has {1} slots.", drawSlot, mesh.mDrawSlotCount);
+            return false;
+        }
+        // 与绑定顺序一致: culled index, draw command
+        outOffsets[0] = drawSlot * mesh.mCulledIndexSlotSize;
+        outOffsets[1] = drawSlot * mesh.mDrawCommandSlotSize;
+        return true;
+    }
+
+    AdMeshletPushConstants AdVKMeshletPass::GetPushConstants(const AdVKMeshletMesh &mesh, uint32_t lod,
+                                                             const float modelViewProj[16],
+                                                             const float cameraPosition[3]) const {
+        const AdMeshLod &meshLod = mesh.GetLod(std::min(lod, mesh.GetLodCount() - 1));
+        AdMeshletPushConstants constants{};
+        memcpy(constants.modelViewProj, modelViewProj, sizeof(constants.modelViewProj));
+        memcpy(constants.cameraPosition, cameraPosition, sizeof(float) * 3);
+        constants.meshletOffset = meshLod.meshletOffset;
+        constants.meshletCount = meshLod.meshletCount;
+        return constants;
+    }
+
+    void AdVKMeshletPass::CmdCull(VkCommandBuffer cmdBuffer, const AdVKMeshletMesh &mesh, uint32_t drawSlot,
+                                  uint32_t lod, const float modelViewProj[16], const float cameraPosition[3]) const {
+        if (bUseMeshShader || !mCullPipeline) {
+            return;
+        }
+        uint32_t slotOffsets[2];
+        if (!GetDrawSlotOffsets(mesh, drawSlot, slotOffsets)) {
+            return;
+        }
+        AdMeshletPushConstants constants = GetPushConstants(mesh, lod, modelViewProj, cameraPosition);
+
+        // 上一帧的间接绘制读完之后才能重置
+        VkMemoryBarrier resetBarrier = {
+                .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT,
+                .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT
+        };
+        vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                             1, &resetBarrier, 0, nullptr, 0, nullptr);
+        VkDrawIndexedIndirectCommand drawCommand = {0, 1, 0, 0, 0};
+        vkCmdUpdateBuffer(cmdBuffer, mesh.mDrawCommandBuffer->GetHandle(), slotOffsets[1], sizeof(drawCommand),
+                          &drawCommand);
+        VkMemoryBarrier updateBarrier = {
+                .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+        };
+        vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                             1, &updateBarrier, 0, nullptr, 0, nullptr);
+
+        // 每个工作组处理一个 meshlet
+        mCullPipeline->Bind(cmdBuffer);
+        vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mPipelineLayout, 0, 1,
+                                &mesh.mDescriptorSet, ARRAY_SIZE(slotOffsets), slotOffsets);
+        vkCmdPushConstants(cmdBuffer, mPipelineLayout, mStageFlags, 0, sizeof(constants), &constants);
+        vkCmdDispatch(cmdBuffer, constants.meshletCount, 1, 1);
+
+        VkMemoryBarrier cullBarrier = {
+                .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT
+        };
+        vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0,
+                             1, &cullBarrier, 0, nullptr, 0, nullptr);
+    }
+
+    void AdVKMeshletPass::CmdDraw(VkCommandBuffer cmdBuffer, const AdVKMeshletMesh &mesh, uint32_t drawSlot,
+                                  uint32_t lod, const float modelViewProj[16], const float cameraPosition[3],
+                                  const AdVKPipelineState &state) const {
+        if (!mPipeline) {
+            return;
+        }
+        // 不能动态设置的状态与默认管线不同时, 换成缓存中这个状态的管线, 同时记录下来供下次启动预创建
+        const AdVKPipeline *pipeline = mPipeline;
+        if (state.GetHash(mDevice->GetDynamicStateSupport()) != mPipeline->GetStateHash()) {
+            AdVKPipelineKey key = mPipelineKey;
+            key.state = state;
+            pipeline = mPipelineCache->GetOrCreatePipeline(key, mPipelineLayout);
+            if (!pipeline) {
+                return;
+            }
+        }
+        // mesh shader 路径不使用槽位, 动态偏移为 0
+        uint32_t slotOffsets[2] = {0, 0};
+        if (!bUseMeshShader && !GetDrawSlotOffsets(mesh, drawSlot, slotOffsets)) {
+            return;
+        }
+        AdMeshletPushConstants constants = GetPushConstants(mesh, lod, modelViewProj, cameraPosition);
+        pipeline->Bind(cmdBuffer, state);
+        vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipelineLayout, 0, 1,
+                                &mesh.mDescriptorSet, ARRAY_SIZE(slotOffsets), slotOffsets);
+        vkCmdPushConstants(cmdBuffer, mPipelineLayout, mStageFlags, 0, sizeof(constants), &constants);
+
+        if (bUseMeshShader) {
+            // 每个 task 工作组剔除 32 个 meshlet, 再为可见的 meshlet 各启动一个 mesh 工作组
+            uint32_t groupCount = (constants.meshletCount + AD_MESHLET_TASK_GROUP_SIZE - 1) / AD_MESHLET_TASK_GROUP_SIZE;
+            mDevice->GetMeshShaderSupport().vkCmdDrawMeshTasksEXT(cmdBuffer, groupCount, 1, 1);
+            return;
+        }
+        VkBuffer vertexBuffers[] = {mesh.mPositionBuffer->GetHandle(), mesh.mAttributeBuffer->GetHandle()};
+        VkDeviceSize offsets[] = {0, 0};
+        vkCmdBindVertexBuffers(cmdBuffer, 0, ARRAY_SIZE(vertexBuffers), vertexBuffers, offsets);
+        vkCmdBindIndexBuffer(cmdBuffer, mesh.mCulledIndexBuffer->GetHandle(), slotOffsets[0], VK_INDEX_TYPE_UINT32);
+        vkCmdDrawIndexedIndirect(cmdBuffer, mesh.mDrawCommandBuffer->GetHandle(), slotOffsets[1], 1,
+                                 sizeof(VkDrawIndexedIndirectCommand));
+    }
+}
@@ -0,0 +1,351 @@
+#include "Graphic/AdVKPipeline.h"
+#include "Graphic/AdVKAllocator.h"
+#include "Graphic/AdDevice.h"
+#include "AdHash.h"
+#include "AdFileSystem.h"
+
+namespace ade {
+
+    // 受限的动态 topology 只能在同一类图元之间切换
+    static VkPrimitiveTopology GetTopologyClass(VkPrimitiveTopology topology) {
+        switch (topology) {
+            case VK_PRIMITIVE_TOPOLOGY_POINT_LIST:
+                return VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+            case VK_PRIMITIVE_TOPOLOGY_LINE_LIST:
+            case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP:
+            case VK_PRIMITIVE_TOPOLOGY_LINE_LIST_WITH_ADJACENCY:
+            case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP_WITH_ADJACENCY:
+                return VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+            case VK_PRIMITIVE_TOPOLOGY_PATCH_LIST:
+                return VK_PRIMITIVE_TOPOLOGY_PATCH_LIST;
+            default:
+                return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        }
+    }
+
+    AdVKPipelineState AdVKPipelineState::GetBakedState(const AdVKDynamicStateSupport &support) const {
+        const AdVKPipelineState defaults{};
+        AdVKPipelineState baked = *this;
+        if (support.bExtendedDynamicState) {
+            baked.topology = support.bDynamicPrimitiveTopologyUnrestricted ? defaults.topology
+                                                                           : GetTopologyClass(topology);
+            baked.cullMode = defaults.cullMode;
+            baked.frontFace = defaults.frontFace;
+            baked.depthTestEnable = defaults.depthTestEnable;
+            baked.depthWriteEnable = defaults.depthWriteEnable;
+            baked.depthCompareOp = defaults.depthCompareOp;
+            baked.stencilTestEnable = defaults.stencilTestEnable;
+        }
+        if (support.bExtendedDynamicState2) {
+            baked.rasterizerDiscardEnable = defaults.rasterizerDiscardEnable;
+            baked.depthBiasEnable = defaults.depthBiasEnable;
+            baked.primitiveRestartEnable = defaults.primitiveRestartEnable;
+        }
+        if (support.bDepthClampEnable) baked.depthClampEnable = defaults.depthClampEnable;
+        if (support.bPolygonMode) baked.polygonMode = defaults.polygonMode;
+        if (support.bRasterizationSamples) baked.rasterizationSamples = defaults.rasterizationSamples;
+        if (support.bAlphaToCoverageEnable) baked.alphaToCoverageEnable = defaults.alphaToCoverageEnable;
+        if (support.bLogicOpEnable) baked.logicOpEnable = defaults.logicOpEnable;
+        if (support.bColorBlendEnable) baked.blendEnable = defaults.blendEnable;
+        if (support.bColorBlendEquation) {
+            baked.srcColorBlendFactor = defaults.srcColorBlendFactor;
+            baked.dstColorBlendFactor = defaults.dstColorBlendFactor;
+            baked.colorBlendOp = defaults.colorBlendOp;
+            baked.srcAlphaBlendFactor = defaults.srcAlphaBlendFactor;
+            baked.dstAlphaBlendFactor = defaults.dstAlphaBlendFactor;
+            baked.alphaBlendOp = defaults.alphaBlendOp;
+        }
+        if (support.bColorWriteMask) baked.colorWriteMask = defaults.colorWriteMask;
+        return baked;
+    }
+
+    uint64_t AdVKPipelineState::GetHash(const AdVKDynamicStateSupport &support) const {
+        return HashPod(GetBakedState(support));
+    }
+
+    void AdVKPipelineState::GetDynamicStates(const AdVKDynamicStateSupport &support,
+                                             std::vector<VkDynamicState> &outStates) {
+        outStates.clear();
+        outStates.push_back(VK_DYNAMIC_STATE_VIEWPORT);
+        outStates.push_back(VK_DYNAMIC_STATE_SCISSOR);
+        if (support.bExtendedDynamicState) {
+            outStates.push_back(VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY);
+            outStates.push_back(VK_DYNAMIC_STATE_CULL_MODE);
+            outStates.push_back(VK_DYNAMIC_STATE_FRONT_FACE);
+            outStates.push_back(VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE);
+            outStates.push_back(VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE);
+            outStates.push_back(VK_DYNAMIC_STATE_DEPTH_COMPARE_OP);
+            outStates.push_back(VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE);
+        }
+        if (support.bExtendedDynamicState2) {
+            outStates.push_back(VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE);
+            outStates.push_back(VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE);
+            outStates.push_back(VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE);
+        }
+        if (support.bDepthClampEnable) outStates.push_back(VK_DYNAMIC_STATE_DEPTH_CLAMP_ENABLE_EXT);
+        if (support.bPolygonMode) outStates.push_back(VK_DYNAMIC_STATE_POLYGON_MODE_EXT);
+        if (support.bRasterizationSamples) outStates.push_back(VK_DYNAMIC_STATE_RASTERIZATION_SAMPLES_EXT);
+        if (support.bAlphaToCoverageEnable) outStates.push_back(VK_DYNAMIC_STATE_ALPHA_TO_COVERAGE_ENABLE_EXT);
+        if (support.bLogicOpEnable) outStates.push_back(VK_DYNAMIC_STATE_LOGIC_OP_ENABLE_EXT);
+        if (support.bColorBlendEnable) outStates.push_back(VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT);
+        if (support.bColorBlendEquation) outStates.push_back(VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT);
+        if (support.bColorWriteMask) outStates.push_back(VK_DYNAMIC_STATE_COLOR_WRITE_MASK_EXT);
+    }
+
+    void AdVKPipelineState::CmdSetDynamicState(VkCommandBuffer cmdBuffer, const AdVKDynamicStateSupport &support,
+                                               bool bInputAssembly) const {
+        if (support.bExtendedDynamicState) {
+            if (bInputAssembly) {
+                support.vkCmdSetPrimitiveTopology(cmdBuffer, topology);
+            }
+            support.vkCmdSetCullMode(cmdBuffer, cullMode);
+            support.vkCmdSetFrontFace(cmdBuffer, frontFace);
+            support.vkCmdSetDepthTestEnable(cmdBuffer, depthTestEnable);
+            support.vkCmdSetDepthWriteEnable(cmdBuffer, depthWriteEnable);
+            support.vkCmdSetDepthCompareOp(cmdBuffer, depthCompareOp);
+            support.vkCmdSetStencilTestEnable(cmdBuffer, stencilTestEnable);
+        }
+        if (support.bExtendedDynamicState2) {
+            support.vkCmdSetRasterizerDiscardEnable(cmdBuffer, rasterizerDiscardEnable);
+            support.vkCmdSetDepthBiasEnable(cmdBuffer, depthBiasEnable);
+            if (bInputAssembly) {
+                support.vkCmdSetPrimitiveRestartEnable(cmdBuffer, primitiveRestartEnable);
+            }
+        }
+        if (support.bDepthClampEnable) {
+            support.vkCmdSetDepthClampEnableEXT(cmdBuffer, depthClampEnable);
+        }
+        if (support.bPolygonMode) {
+            support.vkCmdSetPolygonModeEXT(cmdBuffer, polygonMode);
+        }
+        if (support.bRasterizationSamples) {
+            support.vkCmdSetRasterizationSamplesEXT(cmdBuffer, rasterizationSamples);
+        }
+        if (support.bAlphaToCoverageEnable) {
+            support.vkCmdSetAlphaToCoverageEnableEXT(cmdBuffer, alphaToCoverageEnable);
+        }
+        if (support.bLogicOpEnable) {
+            support.vkCmdSetLogicOpEnableEXT(cmdBuffer, logicOpEnable);
+        }
+        if (support.bColorBlendEnable) {
+            support.vkCmdSetColorBlendEnableEXT(cmdBuffer, 0, 1, &blendEnable);
+        }
+        if (support.bColorBlendEquation) {
+            VkColorBlendEquationEXT equation = {
+                    .srcColorBlendFactor = srcColorBlendFactor,
+                    .dstColorBlendFactor = dstColorBlendFactor,
+                    .colorBlendOp = colorBlendOp,
+                    .srcAlphaBlendFactor = srcAlphaBlendFactor,
+                    .dstAlphaBlendFactor = dstAlphaBlendFactor,
+                    .alphaBlendOp = alphaBlendOp
+            };
+            support.vkCmdSetColorBlendEquationEXT(cmdBuffer, 0, 1, &equation);
+        }
+        if (support.bColorWriteMask) {
+            support.vkCmdSetColorWriteMaskEXT(cmdBuffer, 0, 1, &colorWriteMask);
+        }
+    }
+
+    AdVKPipeline::AdVKPipeline(AdVKDevice *device, const AdVKPipelineDesc &desc, VkPipelineCache pipelineCache)
+            : mDevice(device) {
+        if (!device) {
+            LOG_E("Must create a vulkan device before create pipeline.");
+            return;
+        }
+        if (desc.renderPass == VK_NULL_HANDLE && !device->IsDynamicRenderingEnabled()) {
+            LOG_E("Create pipeline without render pass, but dynamic rendering is not enabled.");
+            return;
+        }
+
+        bMeshPipeline = desc.meshShader != VK_NULL_HANDLE;
+        if (bMeshPipeline && !device->GetMeshShaderSupport().bMeshShader) {
+            LOG_E("Create mesh shader pipeline, but mesh shader is not enabled.");
+            return;
+        }
+
+        const AdVKDynamicStateSupport &support = device->GetDynamicStateSupport();
+        const AdVKPipelineState state = desc.state.GetBakedState(support);
+        mStateHash = HashPod(state);
+
+        // 1. shader stage
+        std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
+        auto addShaderStage = [&shaderStages](VkShaderStageFlagBits stage, VkShaderModule module) {
+            if (module != VK_NULL_HANDLE) {
+                shaderStages.push_back({
+                        .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                        .stage = stage,
+                        .module = module,
+                        .pName = "main"
+                });
+            }
+        };
+        if (bMeshPipeline) {
+            addShaderStage(VK_SHADER_STAGE_TASK_BIT_EXT, desc.taskShader);
+            addShaderStage(VK_SHADER_STAGE_MESH_BIT_EXT, desc.meshShader);
+        } else {
+            addShaderStage(VK_SHADER_STAGE_VERTEX_BIT, desc.vertexShader);
+        }
+        addShaderStage(VK_SHADER_STAGE_FRAGMENT_BIT, desc.fragmentShader);
+
+        // 2. 固定功能状态
+        VkPipelineVertexInputStateCreateInfo vertexInputStateCI = {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+                .vertexBindingDescriptionCount = static_cast<uint32_t>(desc.vertexBindings.size()),
+                .pVertexBindingDescriptions = desc.vertexBindings.data(),
+                .vertexAttributeDescriptionCount = static_cast<uint32_t>(desc.vertexAttributes.size()),
+                .pVertexAttributeDescriptions = desc.vertexAttributes.data()
+        };
+        VkPipelineInputAssemblyStateCreateInfo inputAssemblyStateCI = {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+                .topology = state.topology,
+                .primitiveRestartEnable = state.primitiveRestartEnable
+        };
+        VkPipelineViewportStateCreateInfo viewportStateCI = {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+                .viewportCount = 1,
+                .scissorCount = 1
+        };
+        VkPipelineRasterizationStateCreateInfo rasterizationStateCI = {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+                .depthClampEnable = state.depthClampEnable,
+                .rasterizerDiscardEnable = state.rasterizerDiscardEnable,
+                .polygonMode = state.polygonMode,
+                .cullMode = state.cullMode,
+                .frontFace = state.frontFace,
+                .depthBiasEnable = state.depthBiasEnable,
+                .lineWidth = 1.f
+        };
+        VkPipelineMultisampleStateCreateInfo multisampleStateCI = {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+                .rasterizationSamples = state.rasterizationSamples,
+                .alphaToCoverageEnable = state.alphaToCoverageEnable
+        };
+        VkPipelineDepthStencilStateCreateInfo depthStencilStateCI = {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+                .depthTestEnable = state.depthTestEnable,
+                .depthWriteEnable = state.depthWriteEnable,
+                .depthCompareOp = state.depthCompareOp,
+                .stencilTestEnable = state.stencilTestEnable,
+                .minDepthBounds = 0.f,
+                .maxDepthBounds = 1.f
+        };
+        VkPipelineColorBlendAttachmentState colorBlendAttachment = {
+                .blendEnable = state.blendEnable,
+                .srcColorBlendFactor = state.srcColorBlendFactor,
+                .dstColorBlendFactor = state.dstColorBlendFactor,
+                .colorBlendOp = state.colorBlendOp,
+                .srcAlphaBlendFactor = state.srcAlphaBlendFactor,
+                .dstAlphaBlendFactor = state.dstAlphaBlendFactor,
+                .alphaBlendOp = state.alphaBlendOp,
+                .colorWriteMask = state.colorWriteMask
+        };
+        VkPipelineColorBlendStateCreateInfo colorBlendStateCI = {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+                .logicOpEnable = state.logicOpEnable,
+                .logicOp = state.logicOp,
+                .attachmentCount = 1,
+                .pAttachments = &colorBlendAttachment
+        };
+
+        // 3. 动态状态
+        std::vector<VkDynamicState> dynamicStates;
+        AdVKPipelineState::GetDynamicStates(support, dynamicStates);
+        if (bMeshPipeline) {
+            // mesh 管线没有图元装配阶段
+            dynamicStates.erase(std::remove_if(dynamicStates.begin(), dynamicStates.end(), [](VkDynamicState state) {
+                return state == VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY || state == VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE;
+            }), dynamicStates.end());
+        }
+        VkPipelineDynamicStateCreateInfo dynamicStateCI = {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+                .dynamicStateCount = static_cast<uint32_t>(dynamicStates.size()),
+                .pDynamicStates = dynamicStates.data()
+        };
+
+        VkPipelineRenderingCreateInfo renderingCI = {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+                .colorAttachmentCount = 1,
+                .pColorAttachmentFormats = &desc.colorFormat,
+                .depthAttachmentFormat = desc.depthFormat
+        };
+
+        VkGraphicsPipelineCreateInfo pipelineCI = {
+                .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+                .pNext = desc.renderPass == VK_NULL_HANDLE ? &renderingCI : nullptr,
+                .stageCount = static_cast<uint32_t>(shaderStages.size()),
+                .pStages = shaderStages.data(),
+                .pVertexInputState = bMeshPipeline ? nullptr : &vertexInputStateCI,
+                .pInputAssemblyState = bMeshPipeline ? nullptr : &inputAssemblyStateCI,
+                .pViewportState = &viewportStateCI,
+                .pRasterizationState = &rasterizationStateCI,
+                .pMultisampleState = &multisampleStateCI,
+                .pDepthStencilState = &depthStencilStateCI,
+                .pColorBlendState = &colorBlendStateCI,
+                .pDynamicState = &dynamicStateCI,
+                .layout = desc.pipelineLayout,
+                .renderPass = desc.renderPass,
+                .subpass = desc.subpass
+        };
+        CALL_VK(vkCreateGraphicsPipelines(device->GetHandle(), pipelineCache, 1, &pipelineCI,
+                                          AdVKAllocator::GetCallbacks(), &mPipeline));
+        LOG_T("Create pipeline: {0}, state hash: {1:x}, dynamic state count: {2}", (void *) mPipeline, mStateHash,
+              dynamicStates.size());
+    }
+
+    AdVKPipeline::~AdVKPipeline() {
+        if (mPipeline != VK_NULL_HANDLE) {
+            vkDestroyPipeline(mDevice->GetHandle(), mPipeline, AdVKAllocator::GetCallbacks());
+        }
+    }
+
+    void AdVKPipeline::Bind(VkCommandBuffer cmdBuffer, const AdVKPipelineState &state) const {
+        vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipeline);
+        state.CmdSetDynamicState(cmdBuffer, mDevice->GetDynamicStateSupport(), !bMeshPipeline);
+    }
+
+    AdVKComputePipeline::AdVKComputePipeline(AdVKDevice *device, VkShaderModule computeShader,
+                                             VkPipelineLayout pipelineLayout, VkPipelineCache pipelineCache)
+            : mDevice(device) {
+        if (!device) {
+            LOG_E("Must create a vulkan device before create pipeline.");
+            return;
+        }
+        VkComputePipelineCreateInfo pipelineCI = {
+                .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+                .stage = {
+                        .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                        .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+                        .module = computeShader,
+                        .pName = "main"
+                },
+                .layout = pipelineLayout
+        };
+        CALL_VK(vkCreateComputePipelines(device->GetHandle(), pipelineCache, 1, &pipelineCI,
+                                         AdVKAllocator::GetCallbacks(), &mPipeline));
+        LOG_T("Create compute pipeline: {0}", (void *) mPipeline);
+    }
+
+    AdVKComputePipeline::~AdVKComputePipeline() {
+        if (mPipeline != VK_NULL_HANDLE) {
+            vkDestroyPipeline(mDevice->GetHandle(), mPipeline, AdVKAllocator::GetCallbacks());
+        }
+    }
+
+    VkShaderModule CreateShaderModule(AdVKDevice *device, const std::string &path) {
+        AdFileView code = AdFileSystem::Read(path);
+        if (!code) {
+            LOG_E("Could not read shader file: {0}", path);
+            return VK_NULL_HANDLE;
+        }
+
+        VkShaderModuleCreateInfo shaderModuleCI = {
+                .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+                .codeSize = code.GetSize(),
+                .pCode = reinterpret_cast<const uint32_t *>(code.GetData())
+        };
+        VkShaderModule shaderModule = VK_NULL_HANDLE;
+        CALL_VK(vkCreateShaderModule(device->GetHandle(), &shaderModuleCI,
+                                     AdVKAllocator::GetCallbacks(), &shaderModule));
+        return shaderModule;
+    }
+}
@@ -0,0 +1,456 @@
+#include "Graphic/AdVKPipelineCache.h"
+#include "Graphic/AdVKAllocator.h"
+#include "Graphic/AdDevice.h"
+#include "AdHash.h"
+#include <atomic>
+#include <thread>
+#include <filesystem>
+
+namespace ade {
+
+    static constexpr uint32_t AD_PIPELINE_USAGE_MAGIC = 0x55504441; // "ADPU"
+    static constexpr uint32_t AD_PIPELINE_USAGE_VERSION = 2;
+    static const char *AD_PIPELINE_USAGE_FILE = "PipelineUsage.bin";
+    static const char *AD_PIPELINE_CACHE_FILE = "PipelineCache.bin";
+
+    uint64_t AdVKPipelineKey::GetHash(const AdVKPipelineState &bakedState) const {
+        // 计算管线与状态和顶点输入无关
+        if (IsCompute()) {
+            return HashString(pipelineLayout, HashString(computeShader));
+        }
+        uint64_t hash = HashString(vertexShader);
+        hash = HashString(fragmentShader, hash);
+        hash = HashString(taskShader, hash);
+        hash = HashString(meshShader, hash);
+        hash = HashString(pipelineLayout, hash);
+        hash = HashBytes(vertexBindings.data(), vertexBindings.size() * sizeof(VkVertexInputBindingDescription), hash);
+        hash = HashBytes(vertexAttributes.data(), vertexAttributes.size() * sizeof(VkVertexInputAttributeDescription),
+                         hash);
+        hash = HashPod(colorFormat, hash);
+        hash = HashPod(depthFormat, hash);
+        return HashPod(bakedState, hash);
+    }
+
+    AdVKPipelineCache::AdVKPipelineCache(AdVKDevice *device, const std::string &cacheDir)
+            : mDevice(device), mCacheDir(cacheDir) {
+        LoadPipelineCache();
+
+        std::vector<AdVKPipelineKey> keys;
+        if (LoadUsage(keys)) {
+            for (auto &key: keys) {
+                if (mRecordedKeyHashes.insert(key.GetHash()).second) {
+                    mRecordedKeys.push_back(std::move(key));
+                }
+            }
+            LOG_D("Load {0} recorded pipeline keys.", mRecordedKeys.size());
+        }
+    }
+
+    AdVKPipelineCache::~AdVKPipelineCache() {
+        Save();
+
+        VkDevice device = mDevice->GetHandle();
+        mPipelines.clear();
+        for (const auto &item: mShaderModules) {
+            vkDestroyShaderModule(device, item.second, AdVKAllocator::GetCallbacks());
+        }
+        if (mPipelineCache != VK_NULL_HANDLE) {
+            vkDestroyPipelineCache(device, mPipelineCache, AdVKAllocator::GetCallbacks());
+        }
+    }
+
+    void AdVKPipelineCache::RegisterPipelineLayout(const std::string &name, VkPipelineLayout layout) {
+        bool bPrewarm;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mPipelineLayouts[name] = layout;
+            bPrewarm = bPrewarmRequested;
+        }
+        if (bPrewarm) {
+            PrewarmRegistered(&name);
+        }
+    }
+
+    void AdVKPipelineCache::UnregisterPipelineLayout(const std::string &name, VkPipelineLayout layout) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mPipelineLayouts.find(name);
+        if (it != mPipelineLayouts.end() && it->second == layout) {
+            mPipelineLayouts.erase(it);
+        }
+    }
+
+    template<typename CreateFunc>
+    AdVKPipelineCache::PipelineEntry *AdVKPipelineCache::GetOrCreateEntry(const AdVKPipelineKey &key, uint64_t hash,
+                                                                          VkPipelineLayout pipelineLayout,
+                                                                          const CreateFunc &create) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto it = mPipelines.find(hash);
+            if (it != mPipelines.end()) {
+                return &it->second;
+            }
+            if (pipelineLayout == VK_NULL_HANDLE) {
+                auto layoutIt = mPipelineLayouts.find(key.pipelineLayout);
+                if (layoutIt == mPipelineLayouts.end()) {
+                    LOG_E("Pipeline layout {0} is not registered.", key.pipelineLayout);
+                    return nullptr;
+                }
+                pipelineLayout = layoutIt->second;
+            }
+        }
+
+        // 在锁外创建, 多个线程可以同时编译管线
+        PipelineEntry entry{key};
+        if (!create(pipelineLayout, entry)) {
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mRecordedKeyHashes.insert(key.GetHash()).second) {
+            mRecordedKeys.push_back(key);
+            bUsageDirty = true;
+        }
+        // 其他线程已经创建了相同的管线时使用先创建的那个
+        auto result = mPipelines.emplace(hash, std::move(entry));
+        if (result.second) {
+            LOG_T("Pipeline count: {0}", mPipelines.size());
+        }
+        return &result.first->second;
+    }
+
+    AdVKPipeline *AdVKPipelineCache::GetOrCreatePipeline(const AdVKPipelineKey &key, VkPipelineLayout pipelineLayout) {
+        if (key.IsCompute()) {
+            LOG_E("Pipeline key of compute shader {0} is not a graphics pipeline.", key.computeShader);
+            return nullptr;
+        }
+        const AdVKPipelineState bakedState = key.state.GetBakedState(mDevice->GetDynamicStateSupport());
+        PipelineEntry *entry = GetOrCreateEntry(key, key.GetHash(bakedState), pipelineLayout,
+                                                [this, &key](VkPipelineLayout layout, PipelineEntry &outEntry) {
+            AdVKPipelineDesc desc;
+            desc.pipelineLayout = layout;
+            desc.fragmentShader = GetShaderModule(key.fragmentShader);
+            if (desc.fragmentShader == VK_NULL_HANDLE) {
+                return false;
+            }
+            if (!key.meshShader.empty()) {
+                desc.meshShader = GetShaderModule(key.meshShader);
+                if (!key.taskShader.empty()) {
+                    desc.taskShader = GetShaderModule(key.taskShader);
+                    if (desc.taskShader == VK_NULL_HANDLE) {
+                        return false;
+                    }
+                }
+                if (desc.meshShader == VK_NULL_HANDLE) {
+                    return false;
+                }
+            } else {
+                desc.vertexShader = GetShaderModule(key.vertexShader);
+                if (desc.vertexShader == VK_NULL_HANDLE) {
+                    return false;
+                }
+                desc.vertexBindings = key.vertexBindings;
+                desc.vertexAttributes = key.vertexAttributes;
+            }
+            desc.colorFormat = key.colorFormat;
+            desc.depthFormat = key.depthFormat;
+            desc.state = key.state;
+            outEntry.pipeline = std::make_unique<AdVKPipeline>(mDevice, desc, mPipelineCache);
+            return outEntry.pipeline->GetHandle() != VK_NULL_HANDLE;
+        });
+        return entry ? entry->pipeline.get() : nullptr;
+    }
+
+    AdVKComputePipeline *AdVKPipelineCache::GetOrCreateComputePipeline(const AdVKPipelineKey &key,
+                                                                       VkPipelineLayout pipelineLayout) {
+        if (!key.IsCompute()) {
+            LOG_E("Pipeline key without compute shader is not a compute pipeline.");
+            return nullptr;
+        }
+        PipelineEntry *entry = GetOrCreateEntry(key, key.GetHash(), pipelineLayout,
+                                                [this, &key](VkPipelineLayout layout, PipelineEntry &outEntry) {
+            VkShaderModule computeShader = GetShaderModule(key.computeShader);
+            if (computeShader == VK_NULL_HANDLE) {
+                return false;
+            }
+            outEntry.computePipeline = std::make_unique<AdVKComputePipeline>(mDevice, computeShader, layout,
+                                                                             mPipelineCache);
+            return outEntry.computePipeline->GetHandle() != VK_NULL_HANDLE;
+        });
+        return entry ? entry->computePipeline.get() : nullptr;
+    }
+
+    uint32_t PrewarmPipelineKeys(const std::vector<AdVKPipelineKey> &keys, uint32_t threadCount,
+                                 const AdParallelExecutor &executor,
+                                 const std::function<bool(const AdVKPipelineKey &key)> &create) {
+        if (keys.empty()) {
+            return 0;
+        }
+        std::atomic<uint32_t> createdCount{0};
+        auto task = [&keys, &create, &createdCount](uint32_t index) {
+            if (create(keys[index])) {
+                createdCount.fetch_add(1, std::memory_order_relaxed);
+            }
+        };
+
+        if (executor) {
+            executor(static_cast<uint32_t>(keys.size()), task);
+        } else {
+            if (threadCount == 0) {
+                threadCount = std::max(1u, std::thread::hardware_concurrency());
+            }
+            threadCount = std::min<uint32_t>(threadCount, keys.size());
+
+            std::atomic<uint32_t> nextIndex{0};
+            std::vector<std::thread> workers;
+            for (uint32_t i = 0; i < threadCount; i++) {
+                workers.emplace_back([&]() {
+                    for (uint32_t index = nextIndex++; index < keys.size(); index = nextIndex++) {
+                        task(index);
+                    }
+                });
+            }
+            for (auto &worker: workers) {
+                worker.join();
+            }
+        }
+        return createdCount.load();
+    }
+
+    uint32_t AdVKPipelineCache::Prewarm(uint32_t threadCount, const AdParallelExecutor &executor) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            bPrewarmRequested = true;
+            mPrewarmThreadCount = threadCount;
+            mPrewarmExecutor = executor;
+        }
+        return PrewarmRegistered(nullptr);
+    }
+
+    uint32_t AdVKPipelineCache::PrewarmRegistered(const std::string *layoutName) {
+        const AdVKDynamicStateSupport &support = mDevice->GetDynamicStateSupport();
+        std::vector<AdVKPipelineKey> keys;
+        uint32_t threadCount;
+        AdParallelExecutor executor;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (const AdVKPipelineKey &key: mRecordedKeys) {
+                if ((layoutName && key.pipelineLayout != *layoutName) || !mPipelineLayouts.count(key.pipelineLayout)) {
+                    continue;
+                }
+                uint64_t hash = key.IsCompute() ? key.GetHash() : key.GetHash(key.state.GetBakedState(support));
+                if (!mPipelines.count(hash)) {
+                    keys.push_back(key);
+                }
+            }
+            threadCount = mPrewarmThreadCount;
+            executor = mPrewarmExecutor;
+        }
+
+        uint32_t createdCount = PrewarmPipelineKeys(keys, threadCount, executor, [this](const AdVKPipelineKey &key) {
+            return key.IsCompute() ? GetOrCreateComputePipeline(key) != nullptr : GetOrCreatePipeline(key) != nullptr;
+        });
+        if (!keys.empty()) {
+            LOG_I("Prewarm {0}/{1} recorded pipelines of layout {2}, pipeline count: {3}", createdCount, keys.size(),
+                  layoutName ? *layoutName : "*", GetPipelineCount());
+        }
+        return createdCount;
+    }
+
+    std::future<uint32_t> AdVKPipelineCache::PrewarmAsync(uint32_t threadCount, const AdParallelExecutor &executor) {
+        return std::async(std::launch::async, [this, threadCount, executor]() {
+            return Prewarm(threadCount, executor);
+        });
+    }
+
+    void AdVKPipelineCache::Save() {
+        SavePipelineCache();
+        SaveUsage();
+    }
+
+    uint32_t AdVKPipelineCache::GetPipelineCount() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mPipelines.size();
+    }
+
+    VkShaderModule AdVKPipelineCache::GetShaderModule(const std::string &path) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto it = mShaderModules.find(path);
+            if (it != mShaderModules.end()) {
+                return it->second;
+            }
+        }
+
+        // 读文件和创建在锁外进行, 不阻塞查找其他 shader 的线程
+        VkShaderModule shaderModule = CreateShaderModule(mDevice, path);
+        if (shaderModule == VK_NULL_HANDLE) {
+            return VK_NULL_HANDLE;
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto result = mShaderModules.emplace(path, shaderModule);
+        if (!result.second) {
+            // 其他线程已经创建了相同的 shader
+            vkDestroyShaderModule(mDevice->GetHandle(), shaderModule, AdVKAllocator::GetCallbacks());
+        }
+        return result.first->second;
+    }
+
+    // ------------------------ 使用记录文件 ------------------------
+    // header: magic, version, sizeof(AdVKPipelineState), key count
+    // key   : 6 x (u32 length + chars), color/depth format, bindings, attributes, state
+
+    // 所有字符串和数组都为空时一个 key 的大小, 用来在分配之前校验 key count
+    static constexpr uint64_t AD_PIPELINE_USAGE_MIN_KEY_SIZE = 6 * sizeof(uint32_t) + 2 * sizeof(VkFormat)
+                                                               + 2 * sizeof(uint32_t) + sizeof(AdVKPipelineState);
+
+    static void WriteString(std::ofstream &out, const std::string &str) {
+        uint32_t length = str.size();
+        out.write(reinterpret_cast<const char *>(&length), sizeof(length));
+        out.write(str.data(), length);
+    }
+
+    static bool ReadString(std::ifstream &in, std::string &str) {
+        uint32_t length = 0;
+        if (!in.read(reinterpret_cast<char *>(&length), sizeof(length)) || length > 4096) {
+            return false;
+        }
+        str.resize(length);
+        return static_cast<bool>(in.read(str.data(), length));
+    }
+
+    template<typename T>
+    static void WriteArray(std::ofstream &out, const std::vector<T> &array) {
+        uint32_t count = array.size();
+        out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+        out.write(reinterpret_cast<const char *>(array.data()), count * sizeof(T));
+    }
+
+    template<typename T>
+    static bool ReadArray(std::ifstream &in, std::vector<T> &array) {
+        uint32_t count = 0;
+        if (!in.read(reinterpret_cast<char *>(&count), sizeof(count)) || count > 64) {
+            return false;
+        }
+        array.resize(count);
+        return static_cast<bool>(in.read(reinterpret_cast<char *>(array.data()), count * sizeof(T)));
+    }
+
+    bool LoadPipelineUsage(const std::string &path, std::vector<AdVKPipelineKey> &outKeys) {
+        outKeys.clear();
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in.is_open()) {
+            return false;
+        }
+        const uint64_t fileSize = static_cast<uint64_t>(in.tellg());
+        in.seekg(0);
+        uint32_t header[4] = {};
+        if (!in.read(reinterpret_cast<char *>(header), sizeof(header)) || header[0] != AD_PIPELINE_USAGE_MAGIC
+            || header[1] != AD_PIPELINE_USAGE_VERSION || header[2] != sizeof(AdVKPipelineState)) {
+            LOG_W("Pipeline usage file is out of date, ignore it.");
+            return false;
+        }
+        // 损坏的 key count 可能非常大, 先确认剩余的文件放得下这么多 key
+        if (static_cast<uint64_t>(header[3]) * AD_PIPELINE_USAGE_MIN_KEY_SIZE > fileSize - sizeof(header)) {
+            LOG_W("Pipeline usage file is broken, ignore it.");
+            return false;
+        }
+
+        outKeys.resize(header[3]);
+        for (auto &key: outKeys) {
+            if (!ReadString(in, key.vertexShader) || !ReadString(in, key.fragmentShader)
+                || !ReadString(in, key.taskShader) || !ReadString(in, key.meshShader)
+                || !ReadString(in, key.computeShader) || !ReadString(in, key.pipelineLayout)
+                || !in.read(reinterpret_cast<char *>(&key.colorFormat), sizeof(key.colorFormat))
+                || !in.read(reinterpret_cast<char *>(&key.depthFormat), sizeof(key.depthFormat))
+                || !ReadArray(in, key.vertexBindings) || !ReadArray(in, key.vertexAttributes)
+                || !in.read(reinterpret_cast<char *>(&key.state), sizeof(key.state))) {
+                LOG_W("Pipeline usage file is broken, ignore it.");
+                outKeys.clear();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool SavePipelineUsage(const std::string &path, const std::vector<AdVKPipelineKey> &keys) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            LOG_W("Could not write pipeline usage file: {0}", path);
+            return false;
+        }
+        uint32_t header[4] = {AD_PIPELINE_USAGE_MAGIC, AD_PIPELINE_USAGE_VERSION, sizeof(AdVKPipelineState),
+                              static_cast<uint32_t>(keys.size())};
+        out.write(reinterpret_cast<const char *>(header), sizeof(header));
+        for (const auto &key: keys) {
+            WriteString(out, key.vertexShader);
+            WriteString(out, key.fragmentShader);
+            WriteString(out, key.taskShader);
+            WriteString(out, key.meshShader);
+            WriteString(out, key.computeShader);
+            WriteString(out, key.pipelineLayout);
+            out.write(reinterpret_cast<const char *>(&key.colorFormat), sizeof(key.colorFormat));
+            out.write(reinterpret_cast<const char *>(&key.depthFormat), sizeof(key.depthFormat));
+            WriteArray(out, key.vertexBindings);
+            WriteArray(out, key.vertexAttributes);
+            out.write(reinterpret_cast<const char *>(&key.state), sizeof(key.state));
+        }
+        return static_cast<bool>(out);
+    }
+
+    bool AdVKPipelineCache::LoadUsage(std::vector<AdVKPipelineKey> &outKeys) const {
+        return LoadPipelineUsage(mCacheDir + AD_PIPELINE_USAGE_FILE, outKeys);
+    }
+
+    void AdVKPipelineCache::SaveUsage() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!bUsageDirty) {
+            return;
+        }
+        std::error_code ec;
+        std::filesystem::create_directories(mCacheDir, ec);
+        if (SavePipelineUsage(mCacheDir + AD_PIPELINE_USAGE_FILE, mRecordedKeys)) {
+            bUsageDirty = false;
+            LOG_D("Save {0} pipeline keys.", mRecordedKeys.size());
+        }
+    }
+
+    // ------------------------ VkPipelineCache ------------------------
+
+    void AdVKPipelineCache::LoadPipelineCache() {
+        std::vector<char> data;
+        std::ifstream in(mCacheDir + AD_PIPELINE_CACHE_FILE, std::ios::binary | std::ios::ate);
+        if (in.is_open()) {
+            data.resize(in.tellg());
+            in.seekg(0);
+            in.read(data.data(), data.size());
+        }
+
+        // 驱动会校验 header, 不匹配时自动忽略初始数据
+        VkPipelineCacheCreateInfo pipelineCacheCI = {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+                .initialDataSize = data.size(),
+                .pInitialData = data.empty() ? nullptr : data.data()
+        };
+        CALL_VK(vkCreatePipelineCache(mDevice->GetHandle(), &pipelineCacheCI,
+                                      AdVKAllocator::GetCallbacks(), &mPipelineCache));
+        LOG_T("Pipeline cache: {0}, initial size: {1}", (void *) mPipelineCache, data.size());
+    }
+
+    void AdVKPipelineCache::SavePipelineCache() {
+        if (mPipelineCache == VK_NULL_HANDLE) {
+            return;
+        }
+        size_t size = 0;
+        CALL_VK(vkGetPipelineCacheData(mDevice->GetHandle(), mPipelineCache, &size, nullptr));
+        std::vector<char> data(size);
+        CALL_VK(vkGetPipelineCacheData(mDevice->GetHandle(), mPipelineCache, &size, data.data()));
+
+        std::error_code ec;
+        std::filesystem::create_directories(mCacheDir, ec);
+        std::ofstream out(mCacheDir + AD_PIPELINE_CACHE_FILE, std::ios::binary | std::ios::trunc);
+        if (out.is_open()) {
+            out.write(data.data(), size);
+        }
+    }
+}
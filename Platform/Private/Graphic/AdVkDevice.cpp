@@ -4,6 +4,7 @@
 
 #include "Graphic/AdDevice.h"
 #include "Graphic/AdVKGraphicContext.h"
+#include "Graphic/AdVKAllocator.h"
 #include "Graphic/AdVkQueue.h"
 
 using namespace ade;
@@ -15,12 +16,27 @@ const DeviceFeature requestedExtensions[] = {
         { "VK_KHR_portability_subset", true },
 #elif AD_ENGINE_PLATFORM_LINUX
 #endif
+        // 可选: 扩展动态状态, 1.3 设备上 1/2 已经是核心功能
+        {VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME, false},
+        {VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME, false},
+        {VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME, false},
+        // 可选: mesh shader, 不支持时走计算着色器剔除的回退路径
+        {VK_EXT_MESH_SHADER_EXTENSION_NAME, false},
 };
 
+static bool IsExtensionEnabled(const char *name, uint32_t enableExtensionCount, const char *enableExtensions[]) {
+    for (uint32_t i = 0; i < enableExtensionCount; i++) {
+        if (strcmp(enableExtensions[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 AdVKDevice::AdVKDevice(AdVKGraphicContext *context,
                        uint32_t graphicQueueCount,
                        uint32_t presentQueueCount,
-                       const ade::AdVkSettings &settings) {
+                       const ade::AdVkSettings &settings) : mContext(context), mSettings(settings) {
     if (!context) {
         LOG_E("Must create a vulkan graphic context before create device.");
         return;
@@ -41,7 +57,7 @@ AdVKDevice::AdVKDevice(AdVKGraphicContext *context,
 
     // --------------- 1.构建队列信息 ---------------
     std::vector<float> graphicQueuePriorities(graphicQueueCount, 0.f);
-    std::vector<float> presentQueuePriorities(graphicQueueCount, 1.f);
+    std::vector<float> presentQueuePriorities(presentQueueCount, 1.f);
 
     bool bSameQueueFamilyIndex = context->IsSameGraphicPresentQueueFamily();
     uint32_t sameQueueCount = graphicQueueCount;
@@ -54,6 +70,7 @@ AdVKDevice::AdVKDevice(AdVKGraphicContext *context,
         }
         graphicQueuePriorities.insert(graphicQueuePriorities.end(), presentQueuePriorities.begin(),
                                       presentQueuePriorities.end());
+        graphicQueuePriorities.resize(sameQueueCount);
     }
 
     VkDeviceQueueCreateInfo queueInfos[2] = {
@@ -93,10 +110,170 @@ AdVKDevice::AdVKDevice(AdVKGraphicContext *context,
         return;
     }
 
-    // --------------- 3.创建逻辑设备 ---------------
+    // --------------- 3.逻辑设备特性 ---------------
+    // 只开启显式需要的特性
+    VkPhysicalDeviceProperties physicalDeviceProperties;
+    vkGetPhysicalDeviceProperties(context->GetPhysicalDevice(), &physicalDeviceProperties);
+    bool bCore13 = physicalDeviceProperties.apiVersion >= VK_API_VERSION_1_3;
+
+    bool bCore12 = physicalDeviceProperties.apiVersion >= VK_API_VERSION_1_2;
+
+    VkPhysicalDeviceVulkan12Features vulkan12Features = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES
+    };
+    VkPhysicalDeviceVulkan13Features vulkan13Features = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES
+    };
+    VkPhysicalDeviceExtendedDynamicStateFeaturesEXT eds1Features = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT
+    };
+    VkPhysicalDeviceExtendedDynamicState2FeaturesEXT eds2Features = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_2_FEATURES_EXT
+    };
+    VkPhysicalDeviceExtendedDynamicState3FeaturesEXT eds3Features = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT
+    };
+    VkPhysicalDeviceExtendedDynamicState3PropertiesEXT eds3Properties = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_PROPERTIES_EXT
+    };
+
+    VkPhysicalDeviceMeshShaderFeaturesEXT meshShaderFeatures = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT
+    };
+    VkPhysicalDeviceMeshShaderPropertiesEXT meshShaderProperties = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_PROPERTIES_EXT
+    };
+
+    VkPhysicalDeviceFeatures2 features2 = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+            .pNext = nullptr
+    };
+    void **featureChainTail = &features2.pNext;
+    auto appendFeature = [&featureChainTail](auto *feature) {
+        *featureChainTail = feature;
+        featureChainTail = &feature->pNext;
+    };
+
+    bool bEds1Extension = IsExtensionEnabled(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME,
+                                             enableExtensionCount, enableExtensions);
+    bool bEds2Extension = IsExtensionEnabled(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME,
+                                             enableExtensionCount, enableExtensions);
+    bool bEds3Extension = IsExtensionEnabled(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME,
+                                             enableExtensionCount, enableExtensions);
+    bool bMeshShaderExtension = IsExtensionEnabled(VK_EXT_MESH_SHADER_EXTENSION_NAME,
+                                                   enableExtensionCount, enableExtensions);
+    if (bCore12) {
+        appendFeature(&vulkan12Features);
+    }
+    if (bCore13) {
+        appendFeature(&vulkan13Features);
+    }
+    if (settings.bEnableMeshShader && bMeshShaderExtension) {
+        appendFeature(&meshShaderFeatures);
+    }
+    if (settings.bEnableExtendedDynamicState) {
+        if (bEds1Extension) appendFeature(&eds1Features);
+        if (bEds2Extension) appendFeature(&eds2Features);
+        if (bEds3Extension) appendFeature(&eds3Features);
+    }
+    vkGetPhysicalDeviceFeatures2(context->GetPhysicalDevice(), &features2);
+    // 核心特性只开启间接绘制需要的: 一次提交多个绘制, 以及用 firstInstance 索引每个绘制的数据
+    VkBool32 multiDrawIndirect = features2.features.multiDrawIndirect;
+    VkBool32 drawIndirectFirstInstance = features2.features.drawIndirectFirstInstance;
+    features2.features = {};
+    features2.features.multiDrawIndirect = multiDrawIndirect;
+    features2.features.drawIndirectFirstInstance = drawIndirectFirstInstance;
+    bMultiDrawIndirect = multiDrawIndirect;
+    bDrawIndirectFirstInstance = drawIndirectFirstInstance;
+
+    // 1.2 核心功能里只保留 GPU 剔除需要的 drawIndirectCount, 以及队列报告提交完成用的时间线信号量
+    VkBool32 drawIndirectCount = vulkan12Features.drawIndirectCount;
+    VkBool32 timelineSemaphore = vulkan12Features.timelineSemaphore;
+    bDrawIndirectCount = drawIndirectCount;
+    bTimelineSemaphore = timelineSemaphore;
+    void *vulkan12Next = vulkan12Features.pNext;
+    vulkan12Features = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+            .pNext = vulkan12Next,
+            .drawIndirectCount = drawIndirectCount,
+            .timelineSemaphore = timelineSemaphore
+    };
+
+    // 1.3 核心功能里只保留渲染路径需要的
+    VkBool32 dynamicRendering = vulkan13Features.dynamicRendering;
+    bDynamicRendering = dynamicRendering;
+    void *vulkan13Next = vulkan13Features.pNext;
+    vulkan13Features = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
+            .pNext = vulkan13Next,
+            .dynamicRendering = dynamicRendering
+    };
+
+    if (settings.bEnableExtendedDynamicState) {
+        if (bEds3Extension) {
+            VkPhysicalDeviceProperties2 properties2 = {
+                    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+                    .pNext = &eds3Properties
+            };
+            vkGetPhysicalDeviceProperties2(context->GetPhysicalDevice(), &properties2);
+        }
+
+        // 1.3 设备上 1/2 是必须支持的核心功能
+        mDynamicStateSupport.bExtendedDynamicState = bCore13 || eds1Features.extendedDynamicState;
+        mDynamicStateSupport.bExtendedDynamicState2 = bCore13 || eds2Features.extendedDynamicState2;
+        mDynamicStateSupport.bDynamicPrimitiveTopologyUnrestricted = eds3Properties.dynamicPrimitiveTopologyUnrestricted;
+        mDynamicStateSupport.bDepthClampEnable = eds3Features.extendedDynamicState3DepthClampEnable;
+        mDynamicStateSupport.bPolygonMode = eds3Features.extendedDynamicState3PolygonMode;
+        mDynamicStateSupport.bRasterizationSamples = eds3Features.extendedDynamicState3RasterizationSamples;
+        mDynamicStateSupport.bAlphaToCoverageEnable = eds3Features.extendedDynamicState3AlphaToCoverageEnable;
+        mDynamicStateSupport.bLogicOpEnable = eds3Features.extendedDynamicState3LogicOpEnable;
+        mDynamicStateSupport.bColorBlendEnable = eds3Features.extendedDynamicState3ColorBlendEnable;
+        mDynamicStateSupport.bColorBlendEquation = eds3Features.extendedDynamicState3ColorBlendEquation;
+        mDynamicStateSupport.bColorWriteMask = eds3Features.extendedDynamicState3ColorWriteMask;
+
+        // 不使用的 EDS3 特性不开启
+        eds3Features = {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT,
+                .pNext = eds3Features.pNext,
+                .extendedDynamicState3DepthClampEnable = eds3Features.extendedDynamicState3DepthClampEnable,
+                .extendedDynamicState3PolygonMode = eds3Features.extendedDynamicState3PolygonMode,
+                .extendedDynamicState3RasterizationSamples = eds3Features.extendedDynamicState3RasterizationSamples,
+                .extendedDynamicState3AlphaToCoverageEnable = eds3Features.extendedDynamicState3AlphaToCoverageEnable,
+                .extendedDynamicState3LogicOpEnable = eds3Features.extendedDynamicState3LogicOpEnable,
+                .extendedDynamicState3ColorBlendEnable = eds3Features.extendedDynamicState3ColorBlendEnable,
+                .extendedDynamicState3ColorBlendEquation = eds3Features.extendedDynamicState3ColorBlendEquation,
+                .extendedDynamicState3ColorWriteMask = eds3Features.extendedDynamicState3ColorWriteMask,
+        };
+    }
+
+    if (settings.bEnableMeshShader && bMeshShaderExtension) {
+        VkPhysicalDeviceProperties2 properties2 = {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+                .pNext = &meshShaderProperties
+        };
+        vkGetPhysicalDeviceProperties2(context->GetPhysicalDevice(), &properties2);
+
+        // meshlet 剔除在 task shader 中完成, 两者都支持才走 mesh shader 路径
+        mMeshShaderSupport.bTaskShader = meshShaderFeatures.taskShader;
+        mMeshShaderSupport.bMeshShader = meshShaderFeatures.meshShader && meshShaderFeatures.taskShader;
+        mMeshShaderSupport.maxMeshOutputVertices = meshShaderProperties.maxMeshOutputVertices;
+        mMeshShaderSupport.maxMeshOutputPrimitives = meshShaderProperties.maxMeshOutputPrimitives;
+        mMeshShaderSupport.maxTaskWorkGroupInvocations = meshShaderProperties.maxTaskWorkGroupInvocations;
+        mMeshShaderSupport.maxPreferredTaskWorkGroupInvocations = meshShaderProperties.maxPreferredTaskWorkGroupInvocations;
+        mMeshShaderSupport.maxPreferredMeshWorkGroupInvocations = meshShaderProperties.maxPreferredMeshWorkGroupInvocations;
+
+        meshShaderFeatures = {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT,
+                .pNext = meshShaderFeatures.pNext,
+                .taskShader = meshShaderFeatures.taskShader,
+                .meshShader = meshShaderFeatures.meshShader
+        };
+    }
+
+    // --------------- 4.创建逻辑设备 ---------------
     VkDeviceCreateInfo deviceCI = {
             .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
-            .pNext = nullptr,
+            .pNext = &features2,
             .flags = 0,
             .queueCreateInfoCount = static_cast<uint32_t>(bSameQueueFamilyIndex ? 1 : 2),
             .pQueueCreateInfos = queueInfos,
@@ -106,24 +283,137 @@ AdVKDevice::AdVKDevice(AdVKGraphicContext *context,
             .ppEnabledExtensionNames = enableExtensionCount > 0 ? enableExtensions : nullptr,
             .pEnabledFeatures = nullptr
     };
-    CALL_VK(vkCreateDevice(context->GetPhysicalDevice(), &deviceCI, nullptr, &mDevice));
+    CALL_VK(vkCreateDevice(context->GetPhysicalDevice(), &deviceCI, AdVKAllocator::GetCallbacks(), &mDevice));
     LOG_T("VkDevice: {0}", (void *) mDevice);
 
-    for (int i = 0; i < graphicQueueCount; i++) {
-        VkQueue queue;
-        vkGetDeviceQueue(mDevice, graphicQueueFamilyInfo.queueFamilyIndex, i, &queue);
-        mGraphicQueues.push_back(std::make_shared<AdVKQueue>(graphicQueueFamilyInfo.queueFamilyIndex, i, queue, false));
+    if (settings.bEnableExtendedDynamicState) {
+        LoadDynamicStateFunctions();
+    }
+    if (mMeshShaderSupport.bMeshShader) {
+        LoadMeshShaderFunctions();
     }
-    for (int i = 0; i < presentQueueCount; i++) {
+
+    // 同一个族时显示队列排在图形队列之后; 族内队列不够时多个 AdVKQueue 会拿到同一个 VkQueue,
+    // 这时共用一个 AdVKQueue, 保证每个 VkQueue 只有一个提交线程
+    std::vector<std::shared_ptr<AdVKQueue>> sameFamilyQueues(bSameQueueFamilyIndex ? sameQueueCount : 0);
+    auto getQueue = [&](uint32_t familyIndex, uint32_t index, bool canPresent) {
+        if (bSameQueueFamilyIndex) {
+            index = std::min(index, sameQueueCount - 1);
+            if (sameFamilyQueues[index]) {
+                return sameFamilyQueues[index];
+            }
+        }
         VkQueue queue;
-        vkGetDeviceQueue(mDevice, presentQueueFamilyInfo.queueFamilyIndex, i, &queue);
-        mPresentQueues.push_back(std::make_shared<AdVKQueue>(presentQueueFamilyInfo.queueFamilyIndex, i, queue, true));
+        vkGetDeviceQueue(mDevice, familyIndex, index, &queue);
+        auto result = std::make_shared<AdVKQueue>(mDevice, familyIndex, index, queue, canPresent, bTimelineSemaphore,
+                                                  settings.bEnableSubmitThread);
+        if (bSameQueueFamilyIndex) {
+            sameFamilyQueues[index] = result;
+        }
+        return result;
+    };
+    for (uint32_t i = 0; i < graphicQueueCount; i++) {
+        mGraphicQueues.push_back(getQueue(graphicQueueFamilyInfo.queueFamilyIndex, i, bSameQueueFamilyIndex));
+    }
+    for (uint32_t i = 0; i < presentQueueCount; i++) {
+        uint32_t index = bSameQueueFamilyIndex ? graphicQueueCount + i : i;
+        mPresentQueues.push_back(getQueue(presentQueueFamilyInfo.queueFamilyIndex, index, true));
     }
 }
 
 AdVKDevice::~AdVKDevice() {
+    // 先停掉队列的提交线程并销毁时间线信号量, 之后再等待设备空闲
+    mGraphicQueues.clear();
+    mPresentQueues.clear();
     // 销毁设备之前确保所有队列的命令执行完毕
     vkDeviceWaitIdle(mDevice);
-    vkDestroyDevice(mDevice, nullptr);
+    vkDestroyDevice(mDevice, AdVKAllocator::GetCallbacks());
 }
 
+void AdVKDevice::LoadDynamicStateFunctions() {
+    // 先找核心函数, 再找扩展函数
+    auto loadFunction = [this](const char *coreName, const char *extName) {
+        PFN_vkVoidFunction function = coreName ? vkGetDeviceProcAddr(mDevice, coreName) : nullptr;
+        if (!function && extName) {
+            function = vkGetDeviceProcAddr(mDevice, extName);
+        }
+        return function;
+    };
+#define AD_LOAD_DYNAMIC_STATE_FUNC(member, coreName, extName) \
+    mDynamicStateSupport.member = reinterpret_cast<decltype(mDynamicStateSupport.member)>(loadFunction(coreName, extName))
+
+    AdVKDynamicStateSupport &support = mDynamicStateSupport;
+    if (support.bExtendedDynamicState) {
+        AD_LOAD_DYNAMIC_STATE_FUNC(vkCmdSetCullMode, "vkCmdSetCullMode", "vkCmdSetCullModeEXT");
+        AD_LOAD_DYNAMIC_STATE_FUNC(vkCmdSetFrontFace, "vkCmdSetFrontFace", "vkCmdSetFrontFaceEXT");
+        AD_LOAD_DYNAMIC_STATE_FUNC(vkCmdSetPrimitiveTopology, "vkCmdSetPrimitiveTopology",
+                                   "vkCmdSetPrimitiveTopologyEXT");
+        AD_LOAD_DYNAMIC_STATE_FUNC(vkCmdSetDepthTestEnable, "vkCmdSetDepthTestEnable", "vkCmdSetDepthTestEnableEXT");
+        AD_LOAD_DYNAMIC_STATE_FUNC(vkCmdSetDepthWriteEnable, "vkCmdSetDepthWriteEnable",
+                                   "vkCmdSetDepthWriteEnableEXT");
+        AD_LOAD_DYNAMIC_STATE_FUNC(vkCmdSetDepthCompareOp, "vkCmdSetDepthCompareOp", "vkCmdSetDepthCompareOpEXT");
+        AD_LOAD_DYNAMIC_STATE_FUNC(vkCmdSetStencilTestEnable, "vkCmdSetStencilTestEnable",
+                                   "vkCmdSetStencilTestEnableEXT");
+        support.bExtendedDynamicState = support.vkCmdSetCullMode && support.vkCmdSetFrontFace &&
+                                        support.vkCmdSetPrimitiveTopology && support.vkCmdSetDepthTestEnable &&
+                                        support.vkCmdSetDepthWriteEnable && support.vkCmdSetDepthCompareOp &&
+                                        support.vkCmdSetStencilTestEnable;
+    }
+    if (support.bExtendedDynamicState2) {
+        AD_LOAD_DYNAMIC_STATE_FUNC(vkCmdSetRasterizerDiscardEnable, "vkCmdSetRasterizerDiscardEnable",
+                                   "vkCmdSetRasterizerDiscardEnableEXT");
+        AD_LOAD_DYNAMIC_STATE_FUNC(vkCmdSetDepthBiasEnable, "vkCmdSetDepthBiasEnable", "vkCmdSetDepthBiasEnableEXT");
+        AD_LOAD_DYNAMIC_STATE_FUNC(vkCmdSetPrimitiveRestartEnable, "vkCmdSetPrimitiveRestartEnable",
+                                   "vkCmdSetPrimitiveRestartEnableEXT");
+        support.bExtendedDynamicState2 = support.vkCmdSetRasterizerDiscardEnable && support.vkCmdSetDepthBiasEnable &&
+                                         support.vkCmdSetPrimitiveRestartEnable;
+    }
+
+    AD_LOAD_DYNAMIC_STATE_FUNC(vkCmdSetDepthClampEnableEXT, nullptr, "vkCmdSetDepthClampEnableEXT");
+    AD_LOAD_DYNAMIC_STATE_FUNC(vkCmdSetPolygonModeEXT, nullptr, "vkCmdSetPolygonModeEXT");
+    AD_LOAD_DYNAMIC_STATE_FUNC(vkCmdSetRasterizationSamplesEXT, nullptr, "vkCmdSetRasterizationSamplesEXT");
+    AD_LOAD_DYNAMIC_STATE_FUNC(vkCmdSetAlphaToCoverageEnableEXT, nullptr, "vkCmdSetAlphaToCoverageEnableEXT");
+    AD_LOAD_DYNAMIC_STATE_FUNC(vkCmdSetLogicOpEnableEXT, nullptr, "vkCmdSetLogicOpEnableEXT");
+    AD_LOAD_DYNAMIC_STATE_FUNC(vkCmdSetColorBlendEnableEXT, nullptr, "vkCmdSetColorBlendEnableEXT");
+    AD_LOAD_DYNAMIC_STATE_FUNC(vkCmdSetColorBlendEquationEXT, nullptr, "vkCmdSetColorBlendEquationEXT");
+    AD_LOAD_DYNAMIC_STATE_FUNC(vkCmdSetColorWriteMaskEXT, nullptr, "vkCmdSetColorWriteMaskEXT");
+    support.bDepthClampEnable &= support.vkCmdSetDepthClampEnableEXT != nullptr;
+    support.bPolygonMode &= support.vkCmdSetPolygonModeEXT != nullptr;
+    support.bRasterizationSamples &= support.vkCmdSetRasterizationSamplesEXT != nullptr;
+    support.bAlphaToCoverageEnable &= support.vkCmdSetAlphaToCoverageEnableEXT != nullptr;
+    support.bLogicOpEnable &= support.vkCmdSetLogicOpEnableEXT != nullptr;
+    support.bColorBlendEnable &= support.vkCmdSetColorBlendEnableEXT != nullptr;
+    support.bColorBlendEquation &= support.vkCmdSetColorBlendEquationEXT != nullptr;
+    support.bColorWriteMask &= support.vkCmdSetColorWriteMaskEXT != nullptr;
+#undef AD_LOAD_DYNAMIC_STATE_FUNC
+
+    LOG_D("-----------------------------");
+    LOG_D("Extended dynamic state:");
+    LOG_D("EDS1 {0}, EDS2 {1}, unrestricted topology {2}", support.bExtendedDynamicState,
+          support.bExtendedDynamicState2, support.bDynamicPrimitiveTopologyUnrestricted);
+    LOG_D("EDS3 depth clamp {0}, polygon mode {1}, samples {2}, alpha to coverage {3}", support.bDepthClampEnable,
+          support.bPolygonMode, support.bRasterizationSamples, support.bAlphaToCoverageEnable);
+    LOG_D("EDS3 logic op {0}, blend enable {1}, blend equation {2}, write mask {3}", support.bLogicOpEnable,
+          support.bColorBlendEnable, support.bColorBlendEquation, support.bColorWriteMask);
+    LOG_D("-----------------------------");
+}
+
+
+
+void AdVKDevice::LoadMeshShaderFunctions() {
+    AdVKMeshShaderSupport &support = mMeshShaderSupport;
+    support.vkCmdDrawMeshTasksEXT = reinterpret_cast<PFN_vkCmdDrawMeshTasksEXT>(
+            vkGetDeviceProcAddr(mDevice, "vkCmdDrawMeshTasksEXT"));
+    support.vkCmdDrawMeshTasksIndirectEXT = reinterpret_cast<PFN_vkCmdDrawMeshTasksIndirectEXT>(
+            vkGetDeviceProcAddr(mDevice, "vkCmdDrawMeshTasksIndirectEXT"));
+    support.vkCmdDrawMeshTasksIndirectCountEXT = reinterpret_cast<PFN_vkCmdDrawMeshTasksIndirectCountEXT>(
+            vkGetDeviceProcAddr(mDevice, "vkCmdDrawMeshTasksIndirectCountEXT"));
+    support.bMeshShader = support.vkCmdDrawMeshTasksEXT && support.vkCmdDrawMeshTasksIndirectEXT;
+
+    LOG_D("-----------------------------");
+    LOG_D("Mesh shader: {0}, task shader {1}", support.bMeshShader, support.bTaskShader);
+    LOG_D("max output vertices {0}, primitives {1}, preferred task/mesh invocations {2}/{3}",
+          support.maxMeshOutputVertices, support.maxMeshOutputPrimitives,
+          support.maxPreferredTaskWorkGroupInvocations, support.maxPreferredMeshWorkGroupInvocations);
+    LOG_D("-----------------------------");
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "Math/AdMathKernels.h"
+#include "Culling/AdCullingSimd.h"
+
+namespace ade {
+
+#if defined(__AVX__)
+    // 两列放在一个 256 位寄存器中, a 的每一列在高低两半各广播一份
+    static inline void MultiplyMatrix(const AdMat4 &a, const AdMat4 &b, AdMat4 &out) {
+        __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a.columns[0].Data()));
+        __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a.columns[1].Data()));
+        __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a.columns[2].Data()));
+        __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a.columns[3].Data()));
+        for (int i = 0; i < 4; i += 2) {
+            __m256 columns = _mm256_loadu_ps(b.columns[i].Data());
+            __m256 result = _mm256_mul_ps(a0, _mm256_permute_ps(columns, 0x00));
+            result = _mm256_add_ps(result, _mm256_mul_ps(a1, _mm256_permute_ps(columns, 0x55)));
+            result = _mm256_add_ps(result, _mm256_mul_ps(a2, _mm256_permute_ps(columns, 0xAA)));
+            result = _mm256_add_ps(result, _mm256_mul_ps(a3, _mm256_permute_ps(columns, 0xFF)));
+            _mm256_storeu_ps(out.columns[i].Data(), result);
+        }
+    }
+#else
+    static inline void MultiplyMatrix(const AdMat4 &a, const AdMat4 &b, AdMat4 &out) {
+        out = a * b;
+    }
+#endif
+
+    void MultiplyMatrices(const AdMat4 &a, const AdMat4 *b, AdMat4 *out, uint32_t count) {
+        // a 可能是 out 中的元素, 先复制
+        AdMat4 left = a;
+        for (uint32_t i = 0; i < count; i++) {
+            MultiplyMatrix(left, b[i], out[i]);
+        }
+    }
+
+    void MultiplyMatrices(const AdMat4 *a, const AdMat4 *b, AdMat4 *out, uint32_t count) {
+        for (uint32_t i = 0; i < count; i++) {
+            MultiplyMatrix(a[i], b[i], out[i]);
+        }
+    }
+
+    void TransformPoints(const AdMat4 &m, const AdVec3 *points, AdVec3 *out, uint32_t count) {
+#ifdef AD_MATH_SSE
+        __m128 c0 = m.columns[0].Load();
+        __m128 c1 = m.columns[1].Load();
+        __m128 c2 = m.columns[2].Load();
+        __m128 c3 = m.columns[3].Load();
+        for (uint32_t i = 0; i < count; i++) {
+            __m128 result = _mm_add_ps(c3, _mm_mul_ps(c0, _mm_set1_ps(points[i].x)));
+            result = _mm_add_ps(result, _mm_mul_ps(c1, _mm_set1_ps(points[i].y)));
+            result = _mm_add_ps(result, _mm_mul_ps(c2, _mm_set1_ps(points[i].z)));
+            alignas(16) float stored[4];
+            _mm_store_ps(stored, result);
+            out[i] = {stored[0], stored[1], stored[2]};
+        }
+#else
+        for (uint32_t i = 0; i < count; i++) {
+            out[i] = TransformPoint(m, points[i]);
+        }
+#endif
+    }
+
+    void TransformPoints(const AdMat4 &m, const float *x, const float *y, const float *z,
+                         float *outX, float *outY, float *outZ, uint32_t count) {
+        // 矩阵的 12 个元素各广播成一个寄存器
+        AdLaneF lanes[4][3];
+        for (int c = 0; c < 4; c++) {
+            for (int r = 0; r < 3; r++) {
+                lanes[c][r] = LaneSet(m.columns[c][r]);
+            }
+        }
+        uint32_t i = 0;
+        for (; i + AD_LANE_COUNT <= count; i += AD_LANE_COUNT) {
+            AdLaneF px = LaneLoad(x + i);
+            AdLaneF py = LaneLoad(y + i);
+            AdLaneF pz = LaneLoad(z + i);
+            float *outputs[3] = {outX, outY, outZ};
+            for (int r = 0; r < 3; r++) {
+                AdLaneF result = LaneMulAdd(lanes[0][r], px, lanes[3][r]);
+                result = LaneMulAdd(lanes[1][r], py, result);
+                result = LaneMulAdd(lanes[2][r], pz, result);
+                LaneStore(outputs[r] + i, result);
+            }
+        }
+        for (; i < count; i++) {
+            AdVec3 p = TransformPoint(m, {x[i], y[i], z[i]});
+            outX[i] = p.x;
+            outY[i] = p.y;
+            outZ[i] = p.z;
+        }
+    }
+
+    void TransformBoxes(const AdMat4 *matrices, const AdBoundingBox *boxes, AdBoundingBox *out, uint32_t count) {
+        for (uint32_t i = 0; i < count; i++) {
+            out[i] = TransformBox(matrices[i], boxes[i]);
+        }
+    }
+}
@@ -0,0 +1,105 @@
+#include "Math/AdMatrix.h"
+
+namespace ade {
+
+    AdMat4 AdMat4::LookAt(const AdVec3 &eye, const AdVec3 &target, const AdVec3 &up) {
+        AdVec3 f = Normalize(target - eye);
+        AdVec3 s = Normalize(Cross(f, up));
+        AdVec3 u = Cross(s, f);
+        return {
+            {s.x, u.x, -f.x, 0.0f},
+            {s.y, u.y, -f.y, 0.0f},
+            {s.z, u.z, -f.z, 0.0f},
+            {-Dot(s, eye), -Dot(u, eye), Dot(f, eye), 1.0f}
+        };
+    }
+
+    AdMat4 AdMat4::Perspective(float fovY, float aspect, float zNear, float zFar) {
+        float f = 1.0f / std::tan(fovY * 0.5f);
+        // 视空间 z = -zNear 映射到深度 0, z = -zFar 映射到 1
+        float depthScale = zFar > 0.0f ? zFar / (zNear - zFar) : -1.0f;
+        float depthOffset = zFar > 0.0f ? zNear * zFar / (zNear - zFar) : -zNear;
+        return {
+            {f / aspect, 0.0f, 0.0f, 0.0f},
+            {0.0f, f, 0.0f, 0.0f},
+            {0.0f, 0.0f, depthScale, -1.0f},
+            {0.0f, 0.0f, depthOffset, 0.0f}
+        };
+    }
+
+    AdMat4 AdMat4::Orthographic(float left, float right, float bottom, float top, float zNear, float zFar) {
+        return {
+            {2.0f / (right - left), 0.0f, 0.0f, 0.0f},
+            {0.0f, 2.0f / (top - bottom), 0.0f, 0.0f},
+            {0.0f, 0.0f, 1.0f / (zNear - zFar), 0.0f},
+            {-(right + left) / (right - left), -(top + bottom) / (top - bottom), zNear / (zNear - zFar), 1.0f}
+        };
+    }
+
+    AdMat4 Inverse(const AdMat4 &m) {
+        // 按 2x2 子式展开的伴随矩阵
+        const float *a = m.Data();
+        float s0 = a[0] * a[5] - a[4] * a[1];
+        float s1 = a[0] * a[6] - a[4] * a[2];
+        float s2 = a[0] * a[7] - a[4] * a[3];
+        float s3 = a[1] * a[6] - a[5] * a[2];
+        float s4 = a[1] * a[7] - a[5] * a[3];
+        float s5 = a[2] * a[7] - a[6] * a[3];
+        float c5 = a[10] * a[15] - a[14] * a[11];
+        float c4 = a[9] * a[15] - a[13] * a[11];
+        float c3 = a[9] * a[14] - a[13] * a[10];
+        float c2 = a[8] * a[15] - a[12] * a[11];
+        float c1 = a[8] * a[14] - a[12] * a[10];
+        float c0 = a[8] * a[13] - a[12] * a[9];
+        float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        if (det == 0.0f) {
+            return {};
+        }
+        float invDet = 1.0f / det;
+
+        AdMat4 result;
+        float *r = result.Data();
+        r[0] = (a[5] * c5 - a[6] * c4 + a[7] * c3) * invDet;
+        r[1] = (-a[1] * c5 + a[2] * c4 - a[3] * c3) * invDet;
+        r[2] = (a[13] * s5 - a[14] * s4 + a[15] * s3) * invDet;
+        r[3] = (-a[9] * s5 + a[10] * s4 - a[11] * s3) * invDet;
+        r[4] = (-a[4] * c5 + a[6] * c2 - a[7] * c1) * invDet;
+        r[5] = (a[0] * c5 - a[2] * c2 + a[3] * c1) * invDet;
+        r[6] = (-a[12] * s5 + a[14] * s2 - a[15] * s1) * invDet;
+        r[7] = (a[8] * s5 - a[10] * s2 + a[11] * s1) * invDet;
+        r[8] = (a[4] * c4 - a[5] * c2 + a[7] * c0) * invDet;
+        r[9] = (-a[0] * c4 + a[1] * c2 - a[3] * c0) * invDet;
+        r[10] = (a[12] * s4 - a[13] * s2 + a[15] * s0) * invDet;
+        r[11] = (-a[8] * s4 + a[9] * s2 - a[11] * s0) * invDet;
+        r[12] = (-a[4] * c3 + a[5] * c1 - a[6] * c0) * invDet;
+        r[13] = (a[0] * c3 - a[1] * c1 + a[2] * c0) * invDet;
+        r[14] = (-a[12] * s3 + a[13] * s1 - a[14] * s0) * invDet;
+        r[15] = (a[8] * s3 - a[9] * s1 + a[10] * s0) * invDet;
+        return result;
+    }
+
+    AdMat4 InverseAffine(const AdMat4 &m) {
+        // 3x3 部分的逆为各列叉积组成的行除以行列式, 平移取反后再变换
+        AdVec3 c0 = m.columns[0].XYZ();
+        AdVec3 c1 = m.columns[1].XYZ();
+        AdVec3 c2 = m.columns[2].XYZ();
+        AdVec3 r0 = Cross(c1, c2);
+        AdVec3 r1 = Cross(c2, c0);
+        AdVec3 r2 = Cross(c0, c1);
+        float det = Dot(c0, r0);
+        if (det == 0.0f) {
+            return {};
+        }
+        float invDet = 1.0f / det;
+        r0 *= invDet;
+        r1 *= invDet;
+        r2 *= invDet;
+        AdVec3 t = m.columns[3].XYZ();
+        return {
+            {r0.x, r1.x, r2.x, 0.0f},
+            {r0.y, r1.y, r2.y, 0.0f},
+            {r0.z, r1.z, r2.z, 0.0f},
+            {-Dot(r0, t), -Dot(r1, t), -Dot(r2, t), 1.0f}
+        };
+    }
+}
@@ -0,0 +1,60 @@
+#include "Memory/AdFrameArena.h"
+#include "Memory/AdAlign.h"
+#include "AdLog.h"
+
+namespace ade {
+    AdFrameArena::AdFrameArena(size_t capacity) : mCapacity(capacity) {
+        if (mCapacity > 0) {
+            mData = static_cast<uint8_t *>(::operator new(mCapacity,
+                                                          std::align_val_t(AdLinearAllocator::BLOCK_ALIGNMENT)));
+        }
+    }
+
+    AdFrameArena::~AdFrameArena() {
+        if (mData) {
+            ::operator delete(mData, std::align_val_t(AdLinearAllocator::BLOCK_ALIGNMENT));
+        }
+    }
+
+    void *AdFrameArena::Allocate(size_t size, size_t alignment) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(mData);
+        size_t offset = mOffset.load(std::memory_order_relaxed);
+        while (offset <= mCapacity) {
+            size_t aligned = AlignUp(base + offset, alignment) - base;
+            if (aligned + size > mCapacity) {
+                break;
+            }
+            if (mOffset.compare_exchange_weak(offset, aligned + size, std::memory_order_relaxed)) {
+                return mData + aligned;
+            }
+        }
+
+        // 容量不足: 标记已满, 之后的分配直接走溢出块
+        mOffset.store(mCapacity + 1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(mOverflowMutex);
+        mOverflowSize += size + alignment;
+        return mOverflow.Allocate(size, alignment);
+    }
+
+    void AdFrameArena::Reset() {
+        mLastFrameSize = GetUsedSize();
+        if (mOverflowSize > 0) {
+            // 扩大到峰值的两倍以内的 2 的幂, 避免每帧都溢出
+            size_t capacity = std::max<size_t>(mCapacity, AdLinearAllocator::BLOCK_ALIGNMENT);
+            while (capacity < mLastFrameSize) {
+                capacity *= 2;
+            }
+            LOG_W("Frame arena overflowed by {0} bytes, grow from {1} to {2} bytes.", mOverflowSize, mCapacity,
+                  capacity);
+            if (mData) {
+                ::operator delete(mData, std::align_val_t(AdLinearAllocator::BLOCK_ALIGNMENT));
+            }
+            mData = static_cast<uint8_t *>(::operator new(capacity,
+                                                          std::align_val_t(AdLinearAllocator::BLOCK_ALIGNMENT)));
+            mCapacity = capacity;
+            mOverflow.Release();
+            mOverflowSize = 0;
+        }
+        mOffset.store(0, std::memory_order_relaxed);
+    }
+}
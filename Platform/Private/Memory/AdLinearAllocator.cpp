@@ -0,0 +1,74 @@
+#include "Memory/AdLinearAllocator.h"
+#include "Memory/AdAlign.h"
+
+namespace ade {
+    // 每个线程的临时内存
+    static constexpr size_t THREAD_SCRATCH_BLOCK_SIZE = 256 * 1024;
+
+    AdLinearAllocator::AdLinearAllocator(size_t blockSize) : mBlockSize(std::max<size_t>(blockSize, BLOCK_ALIGNMENT)) {
+    }
+
+    AdLinearAllocator::~AdLinearAllocator() {
+        Release();
+    }
+
+    void AdLinearAllocator::Release() {
+        for (const Block &block: mBlocks) {
+            ::operator delete(block.data, std::align_val_t(BLOCK_ALIGNMENT));
+        }
+        mBlocks.clear();
+        mCurrentBlock = 0;
+        mOffset = 0;
+    }
+
+    void *AdLinearAllocator::Allocate(size_t size, size_t alignment) {
+        // 先在当前块和之前留下的块中找, 都放不下时才申请新块
+        while (mCurrentBlock < mBlocks.size()) {
+            Block &block = mBlocks[mCurrentBlock];
+            uintptr_t base = reinterpret_cast<uintptr_t>(block.data);
+            size_t offset = AlignUp(base + mOffset, alignment) - base;
+            if (offset + size <= block.size) {
+                mOffset = offset + size;
+                return block.data + offset;
+            }
+            mCurrentBlock++;
+            mOffset = 0;
+        }
+
+        // 超大的分配单独一块
+        size_t blockSize = std::max(mBlockSize, size + alignment);
+        uint8_t *data = static_cast<uint8_t *>(::operator new(blockSize, std::align_val_t(BLOCK_ALIGNMENT)));
+        mBlocks.push_back({data, blockSize});
+        mCurrentBlock = static_cast<uint32_t>(mBlocks.size()) - 1;
+        size_t offset = AlignUp(reinterpret_cast<uintptr_t>(data), alignment) - reinterpret_cast<uintptr_t>(data);
+        mOffset = offset + size;
+        return data + offset;
+    }
+
+    void AdLinearAllocator::Rewind(const Marker &marker) {
+        assert(marker.block < mCurrentBlock || (marker.block == mCurrentBlock && marker.offset <= mOffset));
+        mCurrentBlock = marker.block;
+        mOffset = marker.offset;
+    }
+
+    size_t AdLinearAllocator::GetUsedSize() const {
+        size_t size = mOffset;
+        for (uint32_t i = 0; i < mCurrentBlock && i < mBlocks.size(); i++) {
+            size += mBlocks[i].size;
+        }
+        return size;
+    }
+
+    size_t AdLinearAllocator::GetCapacity() const {
+        size_t capacity = 0;
+        for (const Block &block: mBlocks) {
+            capacity += block.size;
+        }
+        return capacity;
+    }
+
+    AdLinearAllocator &AdLinearAllocator::GetThreadScratch() {
+        static thread_local AdLinearAllocator scratch(THREAD_SCRATCH_BLOCK_SIZE);
+        return scratch;
+    }
+}
@@ -0,0 +1,266 @@
+#include "Memory/AdMemoryTracker.h"
+
+#ifdef AD_ENGINE_MEMORY_TRACKING
+#include "Memory/AdAlign.h"
+#include "AdLog.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace ade {
+    static constexpr uint32_t TAG_COUNT = static_cast<uint32_t>(AdMemoryTag::Count);
+
+    static const char *const TAG_NAMES[] = {"General", "Renderer", "Assets", "Scene", "Logging"};
+
+    // 全部是常量初始化, 在任何静态构造之前的 operator new 中也可以安全使用
+    struct TagCounters {
+        std::atomic<uint64_t> allocCount{0};
+        std::atomic<uint64_t> allocBytes{0};
+        std::atomic<uint64_t> liveCount{0};
+        std::atomic<uint64_t> liveBytes{0};
+        std::atomic<uint64_t> peakBytes{0};
+        std::atomic<uint64_t> frameAllocCount{0};
+        std::atomic<uint64_t> frameAllocBytes{0};
+        std::atomic<uint64_t> lastFrameAllocCount{0};
+        std::atomic<uint64_t> lastFrameAllocBytes{0};
+    };
+
+    static TagCounters sCounters[TAG_COUNT];
+    static AdMemoryTrackerSettings sSettings;
+
+    static std::atomic<uint64_t> sViolationCount{0};
+
+    static thread_local AdMemoryTag tCurrentTag = AdMemoryTag::General;
+    static thread_local uint64_t tAllocCount = 0;
+
+    // 不依赖 assert, NDEBUG 下也能让测试失败
+    static void OnViolation(const char *reason) {
+        sViolationCount.fetch_add(1, std::memory_order_relaxed);
+        if (sSettings.bAbortOnViolation) {
+            LOG_E("{0}, abort.", reason);
+            std::abort();
+        }
+    }
+
+    void AdMemoryTracker::Configure(const AdMemoryTrackerSettings &settings) {
+        sSettings = settings;
+    }
+
+    void AdMemoryTracker::OnAllocate(size_t size, AdMemoryTag tag) {
+        TagCounters &counters = sCounters[static_cast<uint32_t>(tag)];
+        counters.allocCount.fetch_add(1, std::memory_order_relaxed);
+        counters.allocBytes.fetch_add(size, std::memory_order_relaxed);
+        counters.liveCount.fetch_add(1, std::memory_order_relaxed);
+        uint64_t live = counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+        uint64_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+        while (live > peak && !counters.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+        counters.frameAllocCount.fetch_add(1, std::memory_order_relaxed);
+        counters.frameAllocBytes.fetch_add(size, std::memory_order_relaxed);
+        tAllocCount++;
+    }
+
+    void AdMemoryTracker::OnFree(size_t size, AdMemoryTag tag) {
+        TagCounters &counters = sCounters[static_cast<uint32_t>(tag)];
+        counters.liveCount.fetch_sub(1, std::memory_order_relaxed);
+        counters.liveBytes.fetch_sub(size, std::memory_order_relaxed);
+    }
+
+    AdMemoryTagStats AdMemoryTracker::GetStats(AdMemoryTag tag) {
+        const TagCounters &counters = sCounters[static_cast<uint32_t>(tag)];
+        AdMemoryTagStats stats;
+        stats.allocCount = counters.allocCount.load(std::memory_order_relaxed);
+        stats.allocBytes = counters.allocBytes.load(std::memory_order_relaxed);
+        stats.liveCount = counters.liveCount.load(std::memory_order_relaxed);
+        stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+        stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+        stats.frameAllocCount = counters.lastFrameAllocCount.load(std::memory_order_relaxed);
+        stats.frameAllocBytes = counters.lastFrameAllocBytes.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    const char *AdMemoryTracker::GetTagName(AdMemoryTag tag) {
+        return TAG_NAMES[static_cast<uint32_t>(tag)];
+    }
+
+    uint64_t AdMemoryTracker::GetViolationCount() {
+        return sViolationCount.load(std::memory_order_relaxed);
+    }
+
+    void AdMemoryTracker::EndFrame(uint64_t frameIndex) {
+        bool bViolation = false;
+        for (uint32_t i = 0; i < TAG_COUNT; i++) {
+            TagCounters &counters = sCounters[i];
+            uint64_t count = counters.frameAllocCount.exchange(0, std::memory_order_relaxed);
+            uint64_t bytes = counters.frameAllocBytes.exchange(0, std::memory_order_relaxed);
+            counters.lastFrameAllocCount.store(count, std::memory_order_relaxed);
+            counters.lastFrameAllocBytes.store(bytes, std::memory_order_relaxed);
+
+            const AdMemoryBudget &budget = sSettings.budgets[i];
+            if (count > budget.maxAllocsPerFrame || bytes > budget.maxBytesPerFrame) {
+                LOG_W("Frame {0}: {1} allocated {2} times / {3} bytes, over budget {4} times / {5} bytes.",
+                      frameIndex, TAG_NAMES[i], count, bytes, budget.maxAllocsPerFrame, budget.maxBytesPerFrame);
+                bViolation = true;
+            }
+        }
+        if (bViolation) {
+            OnViolation("Heap allocation over frame budget");
+        }
+
+        if (sSettings.reportInterval > 0 && (frameIndex + 1) % sSettings.reportInterval == 0) {
+            Report();
+        }
+    }
+
+    void AdMemoryTracker::Report() {
+        LOG_I("-----------------------------");
+        LOG_I("Heap allocations:");
+        for (uint32_t i = 0; i < TAG_COUNT; i++) {
+            AdMemoryTagStats stats = GetStats(static_cast<AdMemoryTag>(i));
+            LOG_I("{0:<9} live {1} / {2} bytes, peak {3} bytes, last frame {4} / {5} bytes, total {6} / {7} bytes",
+                  TAG_NAMES[i], stats.liveCount, stats.liveBytes, stats.peakBytes, stats.frameAllocCount,
+                  stats.frameAllocBytes, stats.allocCount, stats.allocBytes);
+        }
+        LOG_I("-----------------------------");
+    }
+
+    AdMemoryTagScope::AdMemoryTagScope(AdMemoryTag tag) : mPrevious(tCurrentTag) {
+        tCurrentTag = tag;
+    }
+
+    AdMemoryTagScope::~AdMemoryTagScope() {
+        tCurrentTag = mPrevious;
+    }
+
+    AdMemoryTag AdMemoryTagScope::GetCurrent() {
+        return tCurrentTag;
+    }
+
+    AdNoAllocScope::AdNoAllocScope(const char *name) : mName(name), mStartCount(tAllocCount) {
+    }
+
+    AdNoAllocScope::~AdNoAllocScope() {
+        uint64_t count = tAllocCount - mStartCount;
+        if (count > 0) {
+            LOG_E("{0} allocated {1} times on the heap, expected none.", mName, count);
+            OnViolation("Heap allocation inside AdNoAllocScope");
+        }
+    }
+
+    // 每块前面的头部, 记录大小、标签和到 malloc 返回地址的偏移
+    struct alignas(16) AllocationHeader {
+        uint64_t size;
+        uint32_t offset;
+        AdMemoryTag tag;
+    };
+
+    static size_t GetPadding(size_t alignment) {
+        return alignment > alignof(AllocationHeader) ? alignment : 0;
+    }
+
+    // 加上头部和对齐填充后会溢出的大小
+    static bool IsSizeTooLarge(size_t size, size_t alignment) {
+        return size > SIZE_MAX - sizeof(AllocationHeader) - GetPadding(alignment);
+    }
+
+    static void *TrackedAllocate(size_t size, size_t alignment) {
+        alignment = std::max(alignment, alignof(AllocationHeader));
+        size_t padding = GetPadding(alignment);
+        if (IsSizeTooLarge(size, alignment)) {
+            return nullptr;
+        }
+        uint8_t *base = static_cast<uint8_t *>(std::malloc(size + sizeof(AllocationHeader) + padding));
+        if (!base) {
+            return nullptr;
+        }
+        uintptr_t user = reinterpret_cast<uintptr_t>(base) + sizeof(AllocationHeader);
+        user = AlignUp(user, alignment);
+        AllocationHeader *header = reinterpret_cast<AllocationHeader *>(user) - 1;
+        header->size = size;
+        header->offset = static_cast<uint32_t>(user - reinterpret_cast<uintptr_t>(base));
+        header->tag = tCurrentTag;
+        AdMemoryTracker::OnAllocate(size, header->tag);
+        return reinterpret_cast<void *>(user);
+    }
+
+    static void TrackedFree(void *ptr) {
+        if (!ptr) {
+            return;
+        }
+        AllocationHeader *header = static_cast<AllocationHeader *>(ptr) - 1;
+        AdMemoryTracker::OnFree(header->size, header->tag);
+        std::free(static_cast<uint8_t *>(ptr) - header->offset);
+    }
+
+    static void *TrackedNew(size_t size, size_t alignment) {
+        // new_handler 释放内存也无济于事, 直接失败
+        if (IsSizeTooLarge(size, std::max(alignment, alignof(AllocationHeader)))) {
+            throw std::bad_alloc();
+        }
+        while (true) {
+            if (void *ptr = TrackedAllocate(size, alignment)) {
+                return ptr;
+            }
+            std::new_handler handler = std::get_new_handler();
+            if (!handler) {
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+    }
+}
+
+// 与 AdMemoryTracker 在同一个编译单元, 引用了 AdMemoryTracker 的程序一定会链接进来
+void *operator new(size_t size) { return ade::TrackedNew(size, alignof(std::max_align_t)); }
+
+void *operator new[](size_t size) { return ade::TrackedNew(size, alignof(std::max_align_t)); }
+
+void *operator new(size_t size, std::align_val_t alignment) {
+    return ade::TrackedNew(size, static_cast<size_t>(alignment));
+}
+
+void *operator new[](size_t size, std::align_val_t alignment) {
+    return ade::TrackedNew(size, static_cast<size_t>(alignment));
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    return ade::TrackedAllocate(size, alignof(std::max_align_t));
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+    return ade::TrackedAllocate(size, alignof(std::max_align_t));
+}
+
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return ade::TrackedAllocate(size, static_cast<size_t>(alignment));
+}
+
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return ade::TrackedAllocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void *ptr) noexcept { ade::TrackedFree(ptr); }
+
+void operator delete[](void *ptr) noexcept { ade::TrackedFree(ptr); }
+
+void operator delete(void *ptr, size_t) noexcept { ade::TrackedFree(ptr); }
+
+void operator delete[](void *ptr, size_t) noexcept { ade::TrackedFree(ptr); }
+
+void operator delete(void *ptr, std::align_val_t) noexcept { ade::TrackedFree(ptr); }
+
+void operator delete[](void *ptr, std::align_val_t) noexcept { ade::TrackedFree(ptr); }
+
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept { ade::TrackedFree(ptr); }
+
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept { ade::TrackedFree(ptr); }
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { ade::TrackedFree(ptr); }
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { ade::TrackedFree(ptr); }
+
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { ade::TrackedFree(ptr); }
+
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept { ade::TrackedFree(ptr); }
+#endif
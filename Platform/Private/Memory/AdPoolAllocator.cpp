@@ -0,0 +1,56 @@
+#include "Memory/AdPoolAllocator.h"
+#include "Memory/AdAlign.h"
+#include "AdLog.h"
+
+namespace ade {
+    AdPoolAllocator::AdPoolAllocator(size_t blockSize, size_t alignment, uint32_t blocksPerPage)
+            : mAlignment(std::max(alignment, alignof(void *))), mBlocksPerPage(std::max(blocksPerPage, 1u)) {
+        assert(IsPowerOfTwo(mAlignment));
+        // 空闲时块内存放下一个空闲块的指针
+        blockSize = std::max(blockSize, sizeof(void *));
+        mBlockSize = AlignUp(blockSize, mAlignment);
+    }
+
+    AdPoolAllocator::~AdPoolAllocator() {
+        if (mAllocatedCount > 0) {
+            LOG_W("Pool allocator destroyed with {0} blocks still allocated.", mAllocatedCount);
+        }
+        for (uint8_t *page: mPages) {
+            ::operator delete(page, std::align_val_t(mAlignment));
+        }
+    }
+
+    void AdPoolAllocator::AllocatePage() {
+        // 先扩容页表, 两次申请任意一次抛出 bad_alloc 时池的状态不变, 也不会泄漏页
+        mPages.reserve(mPages.size() + 1);
+        uint8_t *page = static_cast<uint8_t *>(::operator new(mBlockSize * mBlocksPerPage,
+                                                               std::align_val_t(mAlignment)));
+        mPages.push_back(page);
+        // 倒序串起来, 分配时按地址递增取出
+        for (uint32_t i = mBlocksPerPage; i > 0; i--) {
+            void *block = page + (i - 1) * mBlockSize;
+            *static_cast<void **>(block) = mFreeList;
+            mFreeList = block;
+        }
+    }
+
+    void *AdPoolAllocator::Allocate() {
+        if (!mFreeList) {
+            AllocatePage();
+        }
+        void *block = mFreeList;
+        mFreeList = *static_cast<void **>(block);
+        mAllocatedCount++;
+        return block;
+    }
+
+    void AdPoolAllocator::Free(void *ptr) {
+        if (!ptr) {
+            return;
+        }
+        assert(mAllocatedCount > 0);
+        *static_cast<void **>(ptr) = mFreeList;
+        mFreeList = ptr;
+        mAllocatedCount--;
+    }
+}
@@ -0,0 +1,67 @@
+#include "Memory/AdRangeAllocator.h"
+
+namespace ade {
+
+    void AdRangeAllocator::Reset(uint64_t capacity) {
+        mCapacity = capacity;
+        mUsedSize = 0;
+        mFreeRanges.clear();
+        if (capacity > 0) {
+            mFreeRanges[0] = capacity;
+        }
+    }
+
+    uint64_t AdRangeAllocator::Allocate(uint64_t size, uint64_t alignment) {
+        if (size == 0) {
+            return INVALID_OFFSET;
+        }
+        for (auto it = mFreeRanges.begin(); it != mFreeRanges.end(); ++it) {
+            uint64_t rangeOffset = it->first;
+            uint64_t rangeSize = it->second;
+            uint64_t offset = (rangeOffset + alignment - 1) / alignment * alignment;
+            if (offset + size > rangeOffset + rangeSize) {
+                continue;
+            }
+
+            // 对齐产生的头部和剩余的尾部放回空闲列表
+            mFreeRanges.erase(it);
+            if (offset > rangeOffset) {
+                mFreeRanges[rangeOffset] = offset - rangeOffset;
+            }
+            if (offset + size < rangeOffset + rangeSize) {
+                mFreeRanges[offset + size] = rangeOffset + rangeSize - offset - size;
+            }
+            mUsedSize += size;
+            return offset;
+        }
+        return INVALID_OFFSET;
+    }
+
+    void AdRangeAllocator::Free(uint64_t offset, uint64_t size) {
+        if (size == 0 || offset == INVALID_OFFSET) {
+            return;
+        }
+        mUsedSize -= size;
+        auto next = mFreeRanges.lower_bound(offset);
+        if (next != mFreeRanges.end() && offset + size == next->first) {
+            size += next->second;
+            next = mFreeRanges.erase(next);
+        }
+        if (next != mFreeRanges.begin()) {
+            auto prev = std::prev(next);
+            if (prev->first + prev->second == offset) {
+                prev->second += size;
+                return;
+            }
+        }
+        mFreeRanges[offset] = size;
+    }
+
+    uint64_t AdRangeAllocator::GetLargestFreeSize() const {
+        uint64_t largest = 0;
+        for (const auto &range: mFreeRanges) {
+            largest = std::max(largest, range.second);
+        }
+        return largest;
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef AD_FILE_SYSTEM_H
+#define AD_FILE_SYSTEM_H
+
+#include "FileSystem/AdArchive.h"
+#include <shared_mutex>
+
+namespace ade {
+    // 资源在磁盘上的实际位置, 供异步 IO 直接读取
+    struct AdFileLocation {
+        std::string filePath;       // 归档文件或散文件的完整路径
+        bool bLooseFile = false;    // 散文件读取整个文件, 忽略 offset 和大小
+        uint64_t offset = 0;
+        uint64_t storedSize = 0;    // 磁盘上的大小, 打包条目可以为 0
+        uint64_t size = 0;
+        AdCompression compression = AdCompression::None;
+    };
+
+    /**
+     * 虚拟文件系统: 资源路径相对 AD_DEFINE_RES_ROOT_DIR, 例如 Shader/00_hello_triangle.vert.spv
+     * 优先从挂载的 .adpak 中查找(后挂载的优先), 找不到时回退到散文件(开发模式)
+     */
+    class AdFileSystem {
+    public:
+        AdFileSystem() = delete;
+
+        AdFileSystem(const AdFileSystem &) = delete;
+
+        AdFileSystem &operator=(const AdFileSystem &) = delete;
+
+        // 设置散文件根目录, 并挂载根目录下默认的 Resource.adpak(如果存在)
+        static void Init(const std::string &looseRootDir = AD_DEFINE_RES_ROOT_DIR);
+
+        static bool Mount(const std::string &archivePath);
+
+        static void UnmountAll();
+
+        static void SetLooseFileFallback(bool bEnable);
+
+        static AdFileView Read(const std::string &path);
+
+        static bool Exists(const std::string &path);
+
+        static bool Resolve(const std::string &path, AdFileLocation &outLocation);
+
+        static const std::string &GetLooseRootDir() { return sLooseRootDir; }
+
+    private:
+        static AdFileView ReadLooseFile(const std::string &path);
+
+    private:
+        static std::shared_mutex sMutex;
+        static std::vector<std::shared_ptr<AdArchive>> sArchives;
+        static std::string sLooseRootDir;
+        static bool bLooseFileFallback;
+    };
+}
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef AD_HASH_H
+#define AD_HASH_H
+
+#include "AdEngine.h"
+
+namespace ade {
+    constexpr uint64_t AD_HASH_SEED = 0xcbf29ce484222325ull;
+
+    // FNV-1a 64 位哈希, 用于管线状态/资源路径等小块数据
+    inline uint64_t HashBytes(const void *data, size_t size, uint64_t seed = AD_HASH_SEED) {
+        const auto *bytes = static_cast<const uint8_t *>(data);
+        uint64_t hash = seed;
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    inline uint64_t HashString(const std::string &str, uint64_t seed = AD_HASH_SEED) {
+        return HashBytes(str.data(), str.size(), seed);
+    }
+
+    template<typename T>
+    inline uint64_t HashPod(const T &value, uint64_t seed = AD_HASH_SEED) {
+        static_assert(std::is_trivially_copyable<T>::value, "HashPod only accept trivially copyable type.");
+        return HashBytes(&value, sizeof(T), seed);
+    }
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define ADLOG_H
 
 #include "AdEngine.h"
+#include "Memory/AdMemoryTracker.h"
 
 #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
 
@@ -27,11 +28,17 @@ namespace ade {
         static std::shared_ptr<spdlog::logger> sLoggerInstance;
     };
 
-#define LOG_T(...) SPDLOG_LOGGER_TRACE(ade::AdLog::GetLoggerInstance(), __VA_ARGS__)
-#define LOG_D(...) SPDLOG_LOGGER_DEBUG(ade::AdLog::GetLoggerInstance(), __VA_ARGS__)
-#define LOG_I(...) SPDLOG_LOGGER_INFO(ade::AdLog::GetLoggerInstance(), __VA_ARGS__)
-#define LOG_W(...) SPDLOG_LOGGER_WARN(ade::AdLog::GetLoggerInstance(), __VA_ARGS__)
-#define LOG_E(...) SPDLOG_LOGGER_ERROR(ade::AdLog::GetLoggerInstance(), __VA_ARGS__)
+// 格式化和输出产生的堆分配归到 Logging 标签
+#define AD_LOG_TAGGED(logMacro, ...) do {                                          \
+        ade::AdMemoryTagScope adLogMemoryTag(ade::AdMemoryTag::Logging);             \
+        logMacro(ade::AdLog::GetLoggerInstance(), __VA_ARGS__);                      \
+    } while (0)
+
+#define LOG_T(...) AD_LOG_TAGGED(SPDLOG_LOGGER_TRACE, __VA_ARGS__)
+#define LOG_D(...) AD_LOG_TAGGED(SPDLOG_LOGGER_DEBUG, __VA_ARGS__)
+#define LOG_I(...) AD_LOG_TAGGED(SPDLOG_LOGGER_INFO, __VA_ARGS__)
+#define LOG_W(...) AD_LOG_TAGGED(SPDLOG_LOGGER_WARN, __VA_ARGS__)
+#define LOG_E(...) AD_LOG_TAGGED(SPDLOG_LOGGER_ERROR, __VA_ARGS__)
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef AD_MESH_H
+#define AD_MESH_H
+
+#include "Asset/AdMeshFormat.h"
+#include "FileSystem/AdArchive.h"
+#include "Graphic/AdVkCommon.h"
+
+namespace ade {
+    /**
+     * 运行时网格: 直接引用映射的 .mesh 文件, 不做任何解析和拷贝, 加载时只检查索引和 meshlet 不越界
+     * 顶点流和索引流可以原样拷贝到 staging buffer 上传
+     */
+    class AdMesh {
+    public:
+        static std::unique_ptr<AdMesh> Load(const std::string &path);
+
+        static std::unique_ptr<AdMesh> Create(AdFileView view);
+
+        const AdMeshHeader &GetHeader() const { return *mHeader; }
+
+        uint32_t GetVertexCount() const { return mHeader->vertexCount; }
+
+        uint32_t GetIndexCount() const { return mHeader->indexCount; }
+
+        VkIndexType GetIndexType() const {
+            return mHeader->indexSize == sizeof(uint16_t) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+        }
+
+        const uint8_t *GetStreamData(const AdMeshStream &stream) const { return mView.GetData() + stream.offset; }
+
+        const AdMeshPosition *GetPositions() const {
+            return reinterpret_cast<const AdMeshPosition *>(GetStreamData(mHeader->position));
+        }
+
+        const AdMeshAttribute *GetAttributes() const {
+            return reinterpret_cast<const AdMeshAttribute *>(GetStreamData(mHeader->attribute));
+        }
+
+        uint32_t GetIndex(uint32_t i) const;
+
+        uint32_t GetMeshletCount() const { return static_cast<uint32_t>(mHeader->meshlet.size / sizeof(AdMeshlet)); }
+
+        const AdMeshlet *GetMeshlets() const {
+            return reinterpret_cast<const AdMeshlet *>(GetStreamData(mHeader->meshlet));
+        }
+
+        uint32_t GetLodCount() const { return mHeader->lodCount; }
+
+        // 索引范围相对整个索引流, 绘制时作为 firstIndex / indexCount; meshlet 范围同理
+        const AdMeshLod &GetLod(uint32_t lod) const { return mHeader->lods[lod]; }
+
+        // 按实例在屏幕上的投影大小选择 LOD, 参数见 SelectMeshLod
+        uint32_t SelectLod(float distance, float projectionScale, float instanceScale = 1.0f,
+                           float maxPixelError = 1.0f) const {
+            return SelectMeshLod(*mHeader, distance, projectionScale, instanceScale, maxPixelError);
+        }
+
+        static float GetProjectionScale(float viewportHeight, float fovY) {
+            return viewportHeight / (2.0f * std::tan(fovY * 0.5f));
+        }
+
+        /**
+         * 量化顶点对应的顶点输入: binding 0 位置, binding 1 法线和 uv
+         * location 0: R16G16B16A16_UNORM 位置, 1: R16G16_SNORM 八面体法线, 2: R16G16_UNORM uv
+         * 反量化常量(GetHeader 中的 scale/offset)需要通过 push constant 或 uniform 传给着色器
+         */
+        static void GetVertexInputDescription(std::vector<VkVertexInputBindingDescription> &outBindings,
+                                              std::vector<VkVertexInputAttributeDescription> &outAttributes);
+
+    private:
+        AdMesh(AdFileView view, const AdMeshHeader *header) : mView(std::move(view)), mHeader(header) {}
+
+        AdFileView mView;
+        const AdMeshHeader *mHeader;
+    };
+}
+
+#endif
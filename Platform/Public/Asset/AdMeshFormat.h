@@ -0,0 +1,188 @@
+#ifndef AD_MESH_FORMAT_H
+#define AD_MESH_FORMAT_H
+
+#include "AdEngine.h"
+#include <cmath>
+
+namespace ade {
+    /**
+     * 离线烘焙的网格格式(.mesh): AdMeshHeader | 对齐后的顶点流和索引流
+     * 每个流都可以直接作为顶点/索引缓冲上传, 运行时不需要解析
+     *
+     * 顶点被量化以减少带宽和显存:
+     *   流 0 位置: unorm16x4, position = q * positionScale + positionOffset
+     *   流 1 属性: 法线八面体编码 snorm16x2 + uv unorm16x2, uv = q * uvScale + uvOffset
+     * 索引在顶点数不超过 65536 时使用 16 位
+     *
+     * 所有 LOD 共用顶点流, 索引流中依次存放每一级 LOD 的索引
+     * 每一级 LOD 还被划分为若干 meshlet, 供 mesh shader 或计算着色器按簇剔除
+     */
+    constexpr uint32_t AD_MESH_MAGIC = 0x534d4441; // "ADMS"
+    constexpr uint32_t AD_MESH_VERSION = 4;
+    constexpr uint64_t AD_MESH_STREAM_ALIGNMENT = 16;
+    constexpr uint32_t AD_MESH_MAX_LOD_COUNT = 8;
+    constexpr uint32_t AD_MESHLET_MAX_VERTICES = 64;
+    constexpr uint32_t AD_MESHLET_MAX_TRIANGLES = 124;
+
+    struct AdMeshStream {
+        uint64_t offset;            // 相对文件头, 0 表示不存在
+        uint64_t size;
+    };
+
+    struct AdMeshPosition {
+        uint16_t x, y, z, w;        // w 固定为 0, 补齐到 8 字节
+    };
+
+    struct AdMeshAttribute {
+        int16_t normal[2];
+        uint16_t uv[2];
+    };
+
+    struct AdMeshLod {
+        uint32_t indexOffset;       // 以索引为单位
+        uint32_t indexCount;
+        uint32_t meshletOffset;
+        uint32_t meshletCount;
+        float error;                // 相对原始网格的几何误差(物体空间距离)
+        uint32_t reserved[3];
+    };
+
+    /**
+     * 与着色器中的 std430 布局一致(Asset/Shader/Include/AdMeshlet.glsl)
+     * 法线锥: dot(normalize(coneApex - cameraPosition), coneAxis) >= coneCutoff 时整簇背向相机
+     */
+    struct AdMeshlet {
+        float center[3];            // 包围球
+        float radius;
+        float coneApex[3];
+        uint32_t vertexOffset;      // meshletVertex 流中的偏移
+        float coneAxis[3];
+        float coneCutoff;           // 大于 1 表示法线分布太散, 不做背面剔除
+        uint32_t triangleOffset;    // meshletTriangle 流中的偏移
+        uint32_t vertexCount;
+        uint32_t triangleCount;
+        uint32_t reserved;
+    };
+
+    struct AdMeshHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t indexSize;         // 2 或 4
+        uint32_t lodCount;
+        float boundsMin[3];
+        float boundsMax[3];
+        float positionScale[3];     // 反量化常量
+        float positionOffset[3];
+        float uvScale[2];
+        float uvOffset[2];
+        AdMeshStream position;      // AdMeshPosition
+        AdMeshStream attribute;     // AdMeshAttribute
+        AdMeshStream index;         // uint16 / uint32
+        AdMeshStream meshlet;       // AdMeshlet
+        AdMeshStream meshletVertex; // uint32, 指向顶点流
+        AdMeshStream meshletTriangle; // uint32, 每个三角形 3 个 8 位局部顶点索引
+        AdMeshLod lods[AD_MESH_MAX_LOD_COUNT];  // lods[0] 是原始网格, 误差递增
+    };
+
+    // 只校验文件头和流的范围; 索引和 meshlet 的内容由 AdMesh::Create 校验
+    inline const AdMeshHeader *GetMeshHeader(const uint8_t *data, size_t size) {
+        if (size < sizeof(AdMeshHeader)) {
+            return nullptr;
+        }
+        const auto *header = reinterpret_cast<const AdMeshHeader *>(data);
+        if (header->magic != AD_MESH_MAGIC || header->version != AD_MESH_VERSION
+            || (header->indexSize != 2 && header->indexSize != 4)
+            || header->lodCount == 0 || header->lodCount > AD_MESH_MAX_LOD_COUNT) {
+            return nullptr;
+        }
+        uint64_t meshletCount = header->meshlet.size / sizeof(AdMeshlet);
+        for (uint32_t i = 0; i < header->lodCount; i++) {
+            const AdMeshLod &lod = header->lods[i];
+            if (uint64_t(lod.indexOffset) + lod.indexCount > header->indexCount
+                || uint64_t(lod.meshletOffset) + lod.meshletCount > meshletCount) {
+                return nullptr;
+            }
+        }
+        if (header->position.size != uint64_t(header->vertexCount) * sizeof(AdMeshPosition)
+            || header->attribute.size != uint64_t(header->vertexCount) * sizeof(AdMeshAttribute)
+            || header->index.size != uint64_t(header->indexCount) * header->indexSize) {
+            return nullptr;
+        }
+        if (header->meshlet.size % sizeof(AdMeshlet) != 0 || header->meshletVertex.size % sizeof(uint32_t) != 0
+            || header->meshletTriangle.size % sizeof(uint32_t) != 0) {
+            return nullptr;
+        }
+        for (const AdMeshStream *stream: {&header->position, &header->attribute, &header->index, &header->meshlet,
+                                          &header->meshletVertex, &header->meshletTriangle}) {
+            if (stream->offset % AD_MESH_STREAM_ALIGNMENT != 0 || stream->offset > size
+                || stream->size > size - stream->offset) {
+                return nullptr;
+            }
+        }
+        return header;
+    }
+
+    /**
+     * 把 LOD 的物体空间误差投影到屏幕上, 选择误差不超过 maxPixelError 的最粗一级
+     * @param distance          实例包围球到相机的距离
+     * @param projectionScale   viewportHeight / (2 * tan(fovY / 2))
+     * @param instanceScale     实例世界变换的最大缩放
+     */
+    inline uint32_t SelectMeshLod(const AdMeshHeader &header, float distance, float projectionScale,
+                                  float instanceScale = 1.0f, float maxPixelError = 1.0f) {
+        float pixelsPerUnit = projectionScale * instanceScale / std::max(distance, 1e-4f);
+        uint32_t lod = 0;
+        while (lod + 1 < header.lodCount && header.lods[lod + 1].error * pixelsPerUnit <= maxPixelError) {
+            lod++;
+        }
+        return lod;
+    }
+
+    // 量化/反量化, 着色器中对应的实现在 Asset/Shader/Include/AdMesh.glsl
+    inline uint16_t QuantizeUnorm16(float value) {
+        return static_cast<uint16_t>(std::clamp(value, 0.0f, 1.0f) * 65535.0f + 0.5f);
+    }
+
+    inline int16_t QuantizeSnorm16(float value) {
+        return static_cast<int16_t>(std::round(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+    }
+
+    // 八面体编码: 把单位向量映射到 [-1, 1]^2
+    inline void EncodeOctahedral(const float normal[3], int16_t outEncoded[2]) {
+        float length = std::abs(normal[0]) + std::abs(normal[1]) + std::abs(normal[2]);
+        float x = length > 0.0f ? normal[0] / length : 0.0f;
+        float y = length > 0.0f ? normal[1] / length : 0.0f;
+        if (length > 0.0f && normal[2] < 0.0f) {
+            float foldX = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            float foldY = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+            x = foldX;
+            y = foldY;
+        }
+        outEncoded[0] = QuantizeSnorm16(x);
+        outEncoded[1] = QuantizeSnorm16(y);
+    }
+
+    inline void DecodeOctahedral(const int16_t encoded[2], float outNormal[3]) {
+        float x = std::max(encoded[0] / 32767.0f, -1.0f);
+        float y = std::max(encoded[1] / 32767.0f, -1.0f);
+        float z = 1.0f - std::abs(x) - std::abs(y);
+        float t = std::max(-z, 0.0f);
+        x += x >= 0.0f ? -t : t;
+        y += y >= 0.0f ? -t : t;
+        float length = std::sqrt(x * x + y * y + z * z);
+        outNormal[0] = x / length;
+        outNormal[1] = y / length;
+        outNormal[2] = z / length;
+    }
+
+    inline void DecodeMeshPosition(const AdMeshHeader &header, const AdMeshPosition &position, float outPosition[3]) {
+        const uint16_t q[3] = {position.x, position.y, position.z};
+        for (int i = 0; i < 3; i++) {
+            outPosition[i] = q[i] / 65535.0f * header.positionScale[i] + header.positionOffset[i];
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef AD_TEXTURE_FORMAT_H
+#define AD_TEXTURE_FORMAT_H
+
+#include "AdEngine.h"
+
+namespace ade {
+    /**
+     * 离线烘焙的纹理格式(.tex): AdTextureHeader | 对齐后的各级 mip 数据
+     * 数据已经是 GPU 可直接上传的布局, 运行时只需要映射文件并拷贝到 staging buffer
+     */
+    constexpr uint32_t AD_TEXTURE_MAGIC = 0x58544441; // "ADTX"
+    constexpr uint32_t AD_TEXTURE_VERSION = 1;
+    constexpr uint32_t AD_TEXTURE_MAX_MIP_COUNT = 16;
+
+    struct AdTextureMip {
+        uint32_t width;
+        uint32_t height;
+        uint64_t offset;            // 相对文件头
+        uint64_t size;
+    };
+
+    struct AdTextureHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t format;            // VkFormat
+        uint32_t mipCount;
+        AdTextureMip mips[AD_TEXTURE_MAX_MIP_COUNT];
+    };
+
+    inline const AdTextureHeader *GetTextureHeader(const uint8_t *data, size_t size) {
+        if (size < sizeof(AdTextureHeader)) {
+            return nullptr;
+        }
+        const auto *header = reinterpret_cast<const AdTextureHeader *>(data);
+        if (header->magic != AD_TEXTURE_MAGIC || header->version != AD_TEXTURE_VERSION
+            || header->mipCount == 0 || header->mipCount > AD_TEXTURE_MAX_MIP_COUNT) {
+            return nullptr;
+        }
+        const AdTextureMip &lastMip = header->mips[header->mipCount - 1];
+        return lastMip.offset + lastMip.size <= size ? header : nullptr;
+    }
+}
+
+#endif
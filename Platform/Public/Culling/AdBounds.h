@@ -0,0 +1,37 @@
+#ifndef AD_BOUNDS_H
+#define AD_BOUNDS_H
+
+#include "AdEngine.h"
+#include <cfloat>
+
+namespace ade {
+
+    // 世界空间包围盒, 剔除和空间查询共用
+    struct AdBoundingBox {
+        float min[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+        float max[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+        bool IsValid() const { return min[0] <= max[0] && min[1] <= max[1] && min[2] <= max[2]; }
+
+        void Expand(const float point[3]) {
+            for (int i = 0; i < 3; i++) {
+                min[i] = std::min(min[i], point[i]);
+                max[i] = std::max(max[i], point[i]);
+            }
+        }
+
+        void Expand(const AdBoundingBox &box) {
+            for (int i = 0; i < 3; i++) {
+                min[i] = std::min(min[i], box.min[i]);
+                max[i] = std::max(max[i], box.max[i]);
+            }
+        }
+    };
+
+    struct AdBoundingSphere {
+        float center[3];
+        float radius;
+    };
+}
+
+#endif
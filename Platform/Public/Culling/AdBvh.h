@@ -0,0 +1,123 @@
+#ifndef AD_BVH_H
+#define AD_BVH_H
+
+#include "Culling/AdFrustumCuller.h"
+
+namespace ade {
+
+    struct AdRay {
+        float origin[3];
+        float direction[3];             // 不要求单位长度, 距离以 direction 的长度为单位
+        float maxDistance = FLT_MAX;
+    };
+
+    struct AdRayHit {
+        uint32_t userData = UINT32_MAX;
+        float distance = FLT_MAX;
+    };
+
+    /**
+     * 场景空间索引: 每个叶子一个物体, 内部节点包围两个子节点
+     *
+     * 静态内容用 Build 一次性按 SAH(分桶)构建; 动态物体用 Insert / Update / Remove 增量维护,
+     * 插入时按表面积代价选择兄弟节点, 回溯时做旋转保持平衡
+     * 动态叶子的包围盒会扩大 fatMargin, 物体在扩大的范围内移动时 Update 不需要改动树
+     * 增删较多后可以调用 Rebuild 按 SAH 重建内部节点, 代理 id 不变
+     *
+     * 查询都是只读的, 可以在多个线程同时执行; 修改树时不能同时查询
+     */
+    class AdBvh {
+    public:
+        static constexpr uint32_t INVALID = UINT32_MAX;
+
+        explicit AdBvh(float fatMargin = 0.1f) : mFatMargin(fatMargin) {}
+
+        AdBvh(const AdBvh &) = delete;
+
+        AdBvh &operator=(const AdBvh &) = delete;
+
+        uint32_t GetProxyCount() const { return mLeafCount; }
+
+        // 叶子为 0, 空树为 0
+        int32_t GetHeight() const { return mRoot == INVALID ? 0 : mNodes[mRoot].height; }
+
+        uint32_t GetUserData(uint32_t proxy) const { return mNodes[proxy].userData; }
+
+        // 叶子为扩大后的包围盒
+        const AdBoundingBox &GetFatBounds(uint32_t proxy) const { return mNodes[proxy].box; }
+
+        void Clear();
+
+        /**
+         * 清空后按 SAH 构建静态的树, 包围盒不扩大
+         * @param outProxies 可为空, 否则写入每个物体的代理 id
+         */
+        void Build(const AdBoundingBox *boxes, const uint32_t *userData, uint32_t count, uint32_t *outProxies);
+
+        // 保留所有叶子(代理 id 不变), 按 SAH 重建内部节点
+        void Rebuild();
+
+        // 返回代理 id, 之后用于 Update / Remove
+        uint32_t Insert(const AdBoundingBox &box, uint32_t userData);
+
+        void Remove(uint32_t proxy);
+
+        // 包围盒超出扩大的范围时重新插入, 返回是否改动了树
+        bool Update(uint32_t proxy, const AdBoundingBox &box);
+
+        // 与视锥相交的物体, 追加到 outUserData
+        void QueryFrustum(const AdFrustum &frustum, std::vector<uint32_t> &outUserData) const;
+
+        void QueryBox(const AdBoundingBox &box, std::vector<uint32_t> &outUserData) const;
+
+        // 例如点光源的影响范围
+        void QuerySphere(const AdBoundingSphere &sphere, std::vector<uint32_t> &outUserData) const;
+
+        /**
+         * 求最近的命中, 子节点按远近顺序遍历, 比当前命中更远的节点直接跳过
+         * @param hitTest 叶子的精确测试, 返回命中距离, 未命中返回负数; 为空时以叶子包围盒为准
+         */
+        bool RayCast(const AdRay &ray, AdRayHit &outHit,
+                     const std::function<float(uint32_t userData, const AdRay &ray)> &hitTest = nullptr) const;
+
+    private:
+        struct Node {
+            AdBoundingBox box;
+            uint32_t parent;            // 空闲节点时为下一个空闲节点
+            uint32_t children[2];
+            uint32_t userData;
+            int32_t height;             // 叶子为 0, 空闲节点为 -1
+
+            bool IsLeaf() const { return children[0] == INVALID; }
+        };
+
+        uint32_t AllocateNode();
+
+        void FreeNode(uint32_t node);
+
+        void InsertLeaf(uint32_t leaf);
+
+        void RemoveLeaf(uint32_t leaf);
+
+        // 节点的两个子树高度差超过 1 时旋转, 返回旋转后这个位置上的节点
+        uint32_t Balance(uint32_t node);
+
+        // 用 leaves[begin, end) 构建子树, 返回子树根节点
+        uint32_t BuildRange(std::vector<uint32_t> &leaves, uint32_t begin, uint32_t end);
+
+        // overlap(box, state) 判断节点与查询范围的关系, state 从父节点传给子节点, 根节点为 0
+        template<typename OverlapFunc>
+        void Query(OverlapFunc overlap, std::vector<uint32_t> &outUserData) const;
+
+        void CollectLeaves(uint32_t node, std::vector<uint32_t> &outUserData) const;
+
+    private:
+        float mFatMargin;
+        std::vector<Node> mNodes;
+        uint32_t mRoot = INVALID;
+        uint32_t mFreeList = INVALID;
+        uint32_t mLeafCount = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef AD_CULLING_SIMD_H
+#define AD_CULLING_SIMD_H
+
+#include "AdEngine.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define AD_SIMD_LANE_COUNT 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AD_SIMD_LANE_COUNT 4
+#else
+#define AD_SIMD_LANE_COUNT 4
+#define AD_SIMD_SCALAR
+#endif
+
+namespace ade {
+    /**
+     * 剔除内核用的最小 SIMD 封装: 编译时开启 AVX2 为 8 路, 否则 SSE 4 路, 其他平台用标量模拟 4 路
+     * 只包含剔除需要的操作; 比较结果是逐路的全 1 / 全 0 掩码
+     */
+    static constexpr uint32_t AD_LANE_COUNT = AD_SIMD_LANE_COUNT;
+
+#if defined(__AVX2__)
+    using AdLaneF = __m256;
+
+    inline AdLaneF LaneSet(float value) { return _mm256_set1_ps(value); }
+
+    inline AdLaneF LaneIndex() { return _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f); }
+
+    inline AdLaneF LaneLoad(const float *data) { return _mm256_loadu_ps(data); }
+
+    inline void LaneStore(float *data, AdLaneF value) { _mm256_storeu_ps(data, value); }
+
+    inline AdLaneF LaneAdd(AdLaneF a, AdLaneF b) { return _mm256_add_ps(a, b); }
+
+    inline AdLaneF LaneMul(AdLaneF a, AdLaneF b) { return _mm256_mul_ps(a, b); }
+
+    inline AdLaneF LaneDiv(AdLaneF a, AdLaneF b) { return _mm256_div_ps(a, b); }
+
+    // a * b + c, 没有开启 FMA 时分两步
+    inline AdLaneF LaneMulAdd(AdLaneF a, AdLaneF b, AdLaneF c) {
+#if defined(__FMA__)
+        return _mm256_fmadd_ps(a, b, c);
+#else
+        return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+    }
+
+    inline AdLaneF LaneMin(AdLaneF a, AdLaneF b) { return _mm256_min_ps(a, b); }
+
+    inline AdLaneF LaneMax(AdLaneF a, AdLaneF b) { return _mm256_max_ps(a, b); }
+
+    inline AdLaneF LaneGreaterEqual(AdLaneF a, AdLaneF b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+
+    inline AdLaneF LaneLess(AdLaneF a, AdLaneF b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+
+    inline AdLaneF LaneAnd(AdLaneF a, AdLaneF b) { return _mm256_and_ps(a, b); }
+
+    inline AdLaneF LaneOr(AdLaneF a, AdLaneF b) { return _mm256_or_ps(a, b); }
+
+    // mask 为真的路取 a, 否则取 b
+    inline AdLaneF LaneSelect(AdLaneF mask, AdLaneF a, AdLaneF b) { return _mm256_blendv_ps(b, a, mask); }
+
+    inline uint32_t LaneMask(AdLaneF mask) { return static_cast<uint32_t>(_mm256_movemask_ps(mask)); }
+#elif !defined(AD_SIMD_SCALAR)
+    using AdLaneF = __m128;
+
+    inline AdLaneF LaneSet(float value) { return _mm_set1_ps(value); }
+
+    inline AdLaneF LaneIndex() { return _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f); }
+
+    inline AdLaneF LaneLoad(const float *data) { return _mm_loadu_ps(data); }
+
+    inline void LaneStore(float *data, AdLaneF value) { _mm_storeu_ps(data, value); }
+
+    inline AdLaneF LaneAdd(AdLaneF a, AdLaneF b) { return _mm_add_ps(a, b); }
+
+    inline AdLaneF LaneMul(AdLaneF a, AdLaneF b) { return _mm_mul_ps(a, b); }
+
+    inline AdLaneF LaneDiv(AdLaneF a, AdLaneF b) { return _mm_div_ps(a, b); }
+
+    inline AdLaneF LaneMulAdd(AdLaneF a, AdLaneF b, AdLaneF c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+
+    inline AdLaneF LaneMin(AdLaneF a, AdLaneF b) { return _mm_min_ps(a, b); }
+
+    inline AdLaneF LaneMax(AdLaneF a, AdLaneF b) { return _mm_max_ps(a, b); }
+
+    inline AdLaneF LaneGreaterEqual(AdLaneF a, AdLaneF b) { return _mm_cmpge_ps(a, b); }
+
+    inline AdLaneF LaneLess(AdLaneF a, AdLaneF b) { return _mm_cmplt_ps(a, b); }
+
+    inline AdLaneF LaneAnd(AdLaneF a, AdLaneF b) { return _mm_and_ps(a, b); }
+
+    inline AdLaneF LaneOr(AdLaneF a, AdLaneF b) { return _mm_or_ps(a, b); }
+
+    inline AdLaneF LaneSelect(AdLaneF mask, AdLaneF a, AdLaneF b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    inline uint32_t LaneMask(AdLaneF mask) { return static_cast<uint32_t>(_mm_movemask_ps(mask)); }
+#else
+    // 掩码用 1.0 / 0.0 表示
+    struct AdLaneF {
+        float v[AD_SIMD_LANE_COUNT];
+    };
+
+#define AD_LANE_OP(expr) \
+    AdLaneF r; \
+    for (uint32_t i = 0; i < AD_SIMD_LANE_COUNT; i++) { r.v[i] = (expr); } \
+    return r;
+
+    inline AdLaneF LaneSet(float value) { AD_LANE_OP(value) }
+
+    inline AdLaneF LaneIndex() { AD_LANE_OP(static_cast<float>(i)) }
+
+    inline AdLaneF LaneLoad(const float *data) { AD_LANE_OP(data[i]) }
+
+    inline void LaneStore(float *data, AdLaneF value) {
+        for (uint32_t i = 0; i < AD_SIMD_LANE_COUNT; i++) {
+            data[i] = value.v[i];
+        }
+    }
+
+    inline AdLaneF LaneAdd(AdLaneF a, AdLaneF b) { AD_LANE_OP(a.v[i] + b.v[i]) }
+
+    inline AdLaneF LaneMul(AdLaneF a, AdLaneF b) { AD_LANE_OP(a.v[i] * b.v[i]) }
+
+    inline AdLaneF LaneDiv(AdLaneF a, AdLaneF b) { AD_LANE_OP(a.v[i] / b.v[i]) }
+
+    inline AdLaneF LaneMulAdd(AdLaneF a, AdLaneF b, AdLaneF c) { AD_LANE_OP(a.v[i] * b.v[i] + c.v[i]) }
+
+    inline AdLaneF LaneMin(AdLaneF a, AdLaneF b) { AD_LANE_OP(std::min(a.v[i], b.v[i])) }
+
+    inline AdLaneF LaneMax(AdLaneF a, AdLaneF b) { AD_LANE_OP(std::max(a.v[i], b.v[i])) }
+
+    inline AdLaneF LaneGreaterEqual(AdLaneF a, AdLaneF b) { AD_LANE_OP(a.v[i] >= b.v[i] ? 1.0f : 0.0f) }
+
+    inline AdLaneF LaneLess(AdLaneF a, AdLaneF b) { AD_LANE_OP(a.v[i] < b.v[i] ? 1.0f : 0.0f) }
+
+    inline AdLaneF LaneAnd(AdLaneF a, AdLaneF b) { AD_LANE_OP(a.v[i] != 0.0f && b.v[i] != 0.0f ? 1.0f : 0.0f) }
+
+    inline AdLaneF LaneOr(AdLaneF a, AdLaneF b) { AD_LANE_OP(a.v[i] != 0.0f || b.v[i] != 0.0f ? 1.0f : 0.0f) }
+
+    inline AdLaneF LaneSelect(AdLaneF mask, AdLaneF a, AdLaneF b) { AD_LANE_OP(mask.v[i] != 0.0f ? a.v[i] : b.v[i]) }
+
+    inline uint32_t LaneMask(AdLaneF mask) {
+        uint32_t result = 0;
+        for (uint32_t i = 0; i < AD_SIMD_LANE_COUNT; i++) {
+            result |= (mask.v[i] != 0.0f ? 1u : 0u) << i;
+        }
+        return result;
+    }
+
+#undef AD_LANE_OP
+#endif
+}
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef AD_FRUSTUM_CULLER_H
+#define AD_FRUSTUM_CULLER_H
+
+#include "Culling/AdBounds.h"
+
+namespace ade {
+
+    // 平面 xyz 为单位法线, 朝向视锥内部: dot(n, p) + w >= 0 在内侧
+    struct AdFrustum {
+        float planes[6][4];
+    };
+
+    // viewProj 列主序, 深度范围 [0, 1]
+    void ExtractFrustumPlanes(const float viewProj[16], AdFrustum &outFrustum);
+
+    /**
+     * 实例包围体按 SoA 存储(中心 xyz、半长 xyz、半径各一个数组), 每次用 SIMD 测试 AD_LANE_COUNT 个实例
+     * 包围盒存中心和半长, 半径为 0; 包围球(与 GPU 剔除 AdCulling.glsl 一致)存中心和半径, 半长为 0
+     * 每个平面: dot(n, c) + w >= -(r + dot(|n|, e)) 时不在外侧, 包围盒的结果与逐个 AABB 测试完全一致
+     * 结果是紧凑的可见下标列表
+     *
+     * Cull / CullViews 只读, 不同的 [begin, end) 可以在多个线程上同时执行, 最后按顺序拼接各段结果
+     * (任务系统版本见 Core 的 Render/AdParallelCulling.h)
+     * 多个视图(主相机和各级阴影级联)用 CullViews 一次遍历, 包围球数据只读一遍
+     */
+    class AdFrustumCuller {
+    public:
+        // 一次遍历同时测试的视图上限, 超出时分批
+        static constexpr uint32_t MAX_VIEW_COUNT = 8;
+
+        AdFrustumCuller() = default;
+
+        AdFrustumCuller(const AdFrustumCuller &) = delete;
+
+        AdFrustumCuller &operator=(const AdFrustumCuller &) = delete;
+
+        uint32_t GetCount() const { return mCount; }
+
+        // 新增的实例为空, 总是被剔除
+        void Resize(uint32_t count);
+
+        void SetBounds(uint32_t index, const AdBoundingBox &box);
+
+        void SetBounds(uint32_t index, const AdBoundingSphere &sphere);
+
+        /**
+         * @param outIndices 至少 end - begin 个元素
+         * @return 可见数量
+         */
+        uint32_t Cull(const AdFrustum &frustum, uint32_t begin, uint32_t end, uint32_t *outIndices) const;
+
+        uint32_t Cull(const AdFrustum &frustum, uint32_t *outIndices) const {
+            return Cull(frustum, 0, mCount, outIndices);
+        }
+
+        /**
+         * 每个视图一份输出, outIndices[view] 至少 end - begin 个元素, 数量写入 outCounts[view]
+         */
+        void CullViews(const AdFrustum *frustums, uint32_t viewCount, uint32_t begin, uint32_t end,
+                       uint32_t *const *outIndices, uint32_t *outCounts) const;
+
+    private:
+        void SetEmpty(size_t index);
+
+    private:
+        uint32_t mCount = 0;
+        // 长度多出一组 SIMD 宽度, 最后一批可以整组读取
+        std::vector<float> mCenterX;
+        std::vector<float> mCenterY;
+        std::vector<float> mCenterZ;
+        std::vector<float> mExtentX;
+        std::vector<float> mExtentY;
+        std::vector<float> mExtentZ;
+        std::vector<float> mRadius;
+    };
+}
+
+#endif
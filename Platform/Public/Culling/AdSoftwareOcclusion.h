@@ -0,0 +1,129 @@
+#ifndef AD_SOFTWARE_OCCLUSION_H
+#define AD_SOFTWARE_OCCLUSION_H
+
+#include "Culling/AdBounds.h"
+
+namespace ade {
+    class AdMesh;
+
+    struct AdSoftwareOcclusionSettings {
+        uint32_t width = 320;           // 向上取整到分块大小
+        uint32_t height = 192;
+    };
+
+    /**
+     * CPU 软件遮挡剔除: 把少量遮挡体三角形光栅化到低分辨率深度缓冲, 再用实例包围盒测试
+     * 不依赖 GPU, 用于没有 GPU 剔除的平台或通道, 也可以单独做性能测试
+     *
+     * 每帧:
+     *   Begin -> AddOccluder(单线程, 变换和分块) -> RasterizeTiles(各分块互不相关, 可以分给多个线程)
+     *   -> IsVisible / CullBoxes(只读, 可以多线程)
+     * 任务系统版本见 Core 的 Render/AdParallelCulling.h
+     *
+     * 深度范围 [0, 1], 越小越近, 与 Vulkan 默认一致; 与近平面相交的遮挡三角形直接丢弃(保守)
+     * 遮挡体按像素中心覆盖写入, 不区分正反面
+     * 编译时开启 AVX2 时每次处理 8 个像素, 否则 SSE 4 个, 非 x86 平台为标量实现
+     */
+    class AdSoftwareOcclusion {
+    public:
+        static constexpr uint32_t TILE_WIDTH = 32;
+        static constexpr uint32_t TILE_HEIGHT = 16;
+        // 测试时先比较每块的最远深度, 整块都更近时跳过逐像素比较
+        static constexpr uint32_t BLOCK_SIZE = 8;
+
+        explicit AdSoftwareOcclusion(const AdSoftwareOcclusionSettings &settings = {});
+
+        AdSoftwareOcclusion(const AdSoftwareOcclusion &) = delete;
+
+        AdSoftwareOcclusion &operator=(const AdSoftwareOcclusion &) = delete;
+
+        uint32_t GetWidth() const { return mWidth; }
+
+        uint32_t GetHeight() const { return mHeight; }
+
+        uint32_t GetTileCount() const { return mTileCountX * mTileCountY; }
+
+        uint32_t GetTriangleCount() const { return static_cast<uint32_t>(mTriangles.size()); }
+
+        const float *GetDepth() const { return mDepth.data(); }
+
+        // viewProj 列主序
+        void Begin(const float viewProj[16]);
+
+        /**
+         * @param positions     物体空间位置, 每个顶点前 3 个 float 为 xyz
+         * @param stride        顶点间隔, 字节
+         * @param model         列主序, 为空时为单位矩阵
+         */
+        void AddOccluder(const float *positions, uint32_t vertexCount, uint32_t stride, const uint32_t *indices,
+                         uint32_t indexCount, const float model[16] = nullptr);
+
+        // 默认使用最粗的一级 LOD
+        void AddOccluder(const AdMesh &mesh, const float model[16], uint32_t lod = UINT32_MAX);
+
+        // 清空并光栅化 [beginTile, endTile) 的分块
+        void RasterizeTiles(uint32_t beginTile, uint32_t endTile);
+
+        void Rasterize() { RasterizeTiles(0, GetTileCount()); }
+
+        // 世界空间包围盒, 完全在屏幕外或被遮挡时返回 false; 与近平面相交时保守地返回 true
+        bool IsVisible(const AdBoundingBox &box) const;
+
+        /**
+         * 测试一组包围盒, 把可见的下标(加上 baseIndex)依次写入 outVisibleIndices
+         * @return 可见数量
+         */
+        uint32_t CullBoxes(const AdBoundingBox *boxes, uint32_t count, uint32_t *outVisibleIndices,
+                           uint32_t baseIndex = 0) const;
+
+    private:
+        // 三角形的边函数和深度平面, 在像素中心求值: value = a * x + b * y + c
+        struct Triangle {
+            float edgeA[3];
+            float edgeB[3];
+            float edgeC[3];
+            float depthA;
+            float depthB;
+            float depthC;
+            int32_t minX;
+            int32_t minY;
+            int32_t maxX;
+            int32_t maxY;
+        };
+
+        // 屏幕空间顶点, w 不大于 0 或在近平面之前时 bValid 为 false
+        struct ScreenVertex {
+            float x;
+            float y;
+            float z;
+            bool bValid;
+        };
+
+        void SetupTriangle(const ScreenVertex &v0, const ScreenVertex &v1, const ScreenVertex &v2);
+
+        void RasterizeTile(uint32_t tile);
+
+        // 像素空间矩形, minDepth 为包围盒最近点的深度
+        bool IsRectVisible(float minX, float maxX, float minY, float maxY, float minDepth) const;
+
+        // 块与矩形重叠的像素中是否有不比 nearest 更近的
+        bool IsBlockVisible(uint32_t blockX, uint32_t blockY, int32_t beginX, int32_t endX, int32_t beginY,
+                            int32_t endY, float nearest) const;
+
+    private:
+        uint32_t mWidth;
+        uint32_t mHeight;
+        uint32_t mTileCountX;
+        uint32_t mTileCountY;
+        float mViewProj[16]{};
+
+        std::vector<float> mDepth;
+        std::vector<float> mBlockMaxDepth;
+        uint32_t mBlockCountX;
+        std::vector<Triangle> mTriangles;
+        std::vector<std::vector<uint32_t>> mTileBins;
+        std::vector<ScreenVertex> mScreenVertices;
+    };
+}
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef AD_ARCHIVE_H
+#define AD_ARCHIVE_H
+
+#include "FileSystem/AdMappedFile.h"
+#include <unordered_set>
+
+namespace ade {
+    enum class AdCompression : uint32_t {
+        None = 0,
+        LZ4 = 1,
+        Zstd = 2,
+    };
+
+    /**
+     * 打包资源文件格式(.adpak), 小端:
+     * AdArchiveHeader | AdArchiveEntry[entryCount] (按 pathHash 排序) | 路径字符串表 | 按 alignment 对齐的数据块
+     */
+    constexpr uint32_t AD_ARCHIVE_MAGIC = 0x4b504441; // "ADPK"
+    constexpr uint32_t AD_ARCHIVE_VERSION = 1;
+    constexpr uint32_t AD_ARCHIVE_DEFAULT_ALIGNMENT = 64;
+
+    struct AdArchiveHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t alignment;
+        uint64_t entryOffset;
+        uint64_t stringTableOffset;
+        uint64_t stringTableSize;
+    };
+
+    struct AdArchiveEntry {
+        uint64_t pathHash;
+        uint64_t offset;            // 数据块相对文件头的偏移
+        uint64_t storedSize;        // 压缩后的大小
+        uint64_t size;              // 原始大小
+        uint32_t compression;       // AdCompression
+        uint32_t pathOffset;        // 在字符串表中的偏移
+        uint32_t pathLength;
+        uint32_t reserved;
+    };
+
+    /**
+     * 文件数据视图:
+     * 未压缩的打包条目直接指向映射内存(零拷贝), 解压或散文件的数据由 owner 持有
+     */
+    class AdFileView {
+    public:
+        AdFileView() = default;
+
+        AdFileView(const uint8_t *data, size_t size, std::shared_ptr<const void> owner)
+                : mData(data), mSize(size), mOwner(std::move(owner)) {}
+
+        const uint8_t *GetData() const { return mData; }
+
+        size_t GetSize() const { return mSize; }
+
+        bool IsValid() const { return mData != nullptr; }
+
+        explicit operator bool() const { return IsValid(); }
+
+    private:
+        const uint8_t *mData = nullptr;
+        size_t mSize = 0;
+        std::shared_ptr<const void> mOwner;
+    };
+
+    // 压缩/解压, 对应的库在编译时找不到时返回 false
+    bool IsCompressionSupported(AdCompression compression);
+
+    bool Compress(AdCompression compression, const uint8_t *src, size_t srcSize, std::vector<uint8_t> &outData);
+
+    bool Decompress(AdCompression compression, const uint8_t *src, size_t srcSize, uint8_t *dst, size_t dstSize);
+
+    // 统一资源路径: 使用 '/', 去掉开头的 "./" 和 '/'
+    std::string NormalizeResourcePath(const std::string &path);
+
+    class AdArchive : public std::enable_shared_from_this<AdArchive> {
+    public:
+        static std::shared_ptr<AdArchive> Open(const std::string &path);
+
+        AdArchive(const AdArchive &) = delete;
+
+        AdArchive &operator=(const AdArchive &) = delete;
+
+        const AdArchiveEntry *FindEntry(const std::string &path) const;
+
+        AdFileView Read(const AdArchiveEntry &entry) const;
+
+        std::string GetEntryPath(const AdArchiveEntry &entry) const;
+
+        uint32_t GetEntryCount() const { return mHeader ? mHeader->entryCount : 0; }
+
+        const AdArchiveEntry *GetEntries() const { return mEntries; }
+
+        const std::string &GetPath() const { return mPath; }
+
+    private:
+        AdArchive() = default;
+
+    private:
+        std::string mPath;
+        AdMappedFile mMappedFile;
+        const AdArchiveHeader *mHeader = nullptr;
+        const AdArchiveEntry *mEntries = nullptr;
+        const char *mStringTable = nullptr;
+    };
+
+    // 生成 .adpak, 由离线工具使用
+    class AdArchiveWriter {
+    public:
+        // alignment 必须是 2 的幂
+        explicit AdArchiveWriter(uint32_t alignment = AD_ARCHIVE_DEFAULT_ALIGNMENT) : mAlignment(alignment) {}
+
+        // 同一路径(规范化后)只能添加一次, 重复时返回 false 且不添加
+        bool AddFile(const std::string &path, std::vector<uint8_t> data, AdCompression compression = AdCompression::None);
+
+        bool Write(const std::string &outPath) const;
+
+    private:
+        struct PendingEntry {
+            std::string path;
+            std::vector<uint8_t> data;
+            uint64_t size;
+            AdCompression compression;
+        };
+
+        uint32_t mAlignment;
+        std::vector<PendingEntry> mEntries;
+        std::unordered_set<std::string> mPaths;
+    };
+}
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef AD_ASYNC_IO_H
+#define AD_ASYNC_IO_H
+
+#include "AdFileSystem.h"
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <thread>
+
+namespace ade {
+    enum class AdIOPriority : uint32_t {
+        High = 0,       // 当前可见, 需要尽快完成
+        Low = 1,        // 预取
+    };
+
+    enum class AdIOStatus : uint32_t {
+        Pending,
+        InFlight,
+        Completed,
+        Failed,
+        Cancelled,
+    };
+
+    class AdIORequestState;
+
+    using AdIOCallback = std::function<void(AdIOStatus status, const AdFileView &data)>;
+
+    struct AdIORequest {
+        std::string path;                   // 资源路径, 通过 AdFileSystem 解析到归档或散文件
+        AdIOPriority priority = AdIOPriority::High;
+        AdIOCallback callback;              // 在 IO 线程上调用, 需要尽快返回(例如投递到任务系统)
+    };
+
+    // 请求句柄: 可以查询状态、取消、等待结果
+    class AdIOHandle {
+    public:
+        AdIOHandle() = default;
+
+        explicit AdIOHandle(std::shared_ptr<AdIORequestState> state) : mState(std::move(state)) {}
+
+        bool IsValid() const { return mState != nullptr; }
+
+        AdIOStatus GetStatus() const;
+
+        // 排队中的请求会被直接丢弃; 已经提交给内核的请求完成后以 Cancelled 状态回调
+        void Cancel() const;
+
+        std::shared_future<AdFileView> GetFuture() const;
+
+    private:
+        std::shared_ptr<AdIORequestState> mState;
+    };
+
+    struct AdAsyncIOSettings {
+        uint32_t queueDepth = 256;          // 最大同时在途请求数
+        uint32_t fallbackThreadCount = 4;   // 不支持 io_uring 时 pread 线程数
+        bool bPreferIOUring = true;
+    };
+
+    /**
+     * 异步批量读取:
+     * Linux 上使用 io_uring(单个 IO 线程驱动数百个在途请求), 其他平台或不可用时退回 pread 线程池
+     * 请求按优先级出队, 压缩条目在完成后解压
+     */
+    class AdAsyncIO {
+    public:
+        explicit AdAsyncIO(const AdAsyncIOSettings &settings = {});
+
+        ~AdAsyncIO();
+
+        AdAsyncIO(const AdAsyncIO &) = delete;
+
+        AdAsyncIO &operator=(const AdAsyncIO &) = delete;
+
+        AdIOHandle Submit(AdIORequest request);
+
+        std::vector<AdIOHandle> SubmitBatch(std::vector<AdIORequest> requests);
+
+        bool IsUsingIOUring() const { return mIOUring != nullptr; }
+
+        uint32_t GetInFlightCount() const { return mInFlightCount.load(std::memory_order_relaxed); }
+
+    private:
+        class FileCache;
+
+        class IOUring;
+
+        std::shared_ptr<AdIORequestState> PopRequest();
+
+        bool PrepareRequest(const std::shared_ptr<AdIORequestState> &state);
+
+        void CompleteRequest(const std::shared_ptr<AdIORequestState> &state, bool bSuccess);
+
+        void IOUringThreadMain();
+
+        void FallbackThreadMain();
+
+        void WakeUp();
+
+    private:
+        AdAsyncIOSettings mSettings;
+
+        std::mutex mMutex;
+        std::condition_variable mCondition;
+        std::deque<std::shared_ptr<AdIORequestState>> mPendingRequests[2];
+        bool bStop = false;
+        std::atomic<uint32_t> mInFlightCount{0};
+
+        std::unique_ptr<FileCache> mFileCache;
+        std::unique_ptr<IOUring> mIOUring;
+        std::vector<std::thread> mThreads;
+    };
+}
+
+#endif
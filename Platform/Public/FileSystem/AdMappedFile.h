@@ -0,0 +1,40 @@
+#ifndef AD_MAPPED_FILE_H
+#define AD_MAPPED_FILE_H
+
+#include "AdEngine.h"
+
+namespace ade {
+    // 只读内存映射文件
+    class AdMappedFile {
+    public:
+        AdMappedFile() = default;
+
+        ~AdMappedFile();
+
+        AdMappedFile(const AdMappedFile &) = delete;
+
+        AdMappedFile &operator=(const AdMappedFile &) = delete;
+
+        bool Open(const std::string &path);
+
+        void Close();
+
+        bool IsOpen() const { return mData != nullptr; }
+
+        const uint8_t *GetData() const { return mData; }
+
+        size_t GetSize() const { return mSize; }
+
+    private:
+        const uint8_t *mData = nullptr;
+        size_t mSize = 0;
+#ifdef AD_ENGINE_PLATFORM_WIN32
+        void *mFileHandle = nullptr;
+        void *mMappingHandle = nullptr;
+#else
+        int mFd = -1;
+#endif
+    };
+}
+
+#endif
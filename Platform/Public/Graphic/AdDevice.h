@@ -13,7 +13,71 @@ namespace ade {
     class AdVKQueue;
 
     struct AdVkSettings {
+        // 尽可能把 cull/depth/topology/blend 等状态交给动态状态，减少管线排列组合
+        bool bEnableExtendedDynamicState = true;
+        // 设备支持时使用 task/mesh shader 按 meshlet 剔除和绘制, 否则回退到计算着色器剔除 + 间接绘制
+        bool bEnableMeshShader = true;
+        // 每个队列一个提交线程, vkQueueSubmit / vkQueuePresentKHR 在驱动中阻塞时不卡住渲染线程
+        bool bEnableSubmitThread = false;
+    };
+
+    /**
+     * 扩展动态状态(VK_EXT_extended_dynamic_state 1/2/3)支持情况
+     * 1.3 设备上 1/2 为核心功能，函数指针统一通过 vkGetDeviceProcAddr 加载
+     */
+    struct AdVKDynamicStateSupport {
+        // extended dynamic state 1: cull mode, front face, topology, depth/stencil test
+        bool bExtendedDynamicState = false;
+        // extended dynamic state 2: rasterizer discard, depth bias, primitive restart
+        bool bExtendedDynamicState2 = false;
+        bool bDynamicPrimitiveTopologyUnrestricted = false;
+
+        // extended dynamic state 3
+        bool bDepthClampEnable = false;
+        bool bPolygonMode = false;
+        bool bRasterizationSamples = false;
+        bool bAlphaToCoverageEnable = false;
+        bool bLogicOpEnable = false;
+        bool bColorBlendEnable = false;
+        bool bColorBlendEquation = false;
+        bool bColorWriteMask = false;
+
+        PFN_vkCmdSetCullMode vkCmdSetCullMode = nullptr;
+        PFN_vkCmdSetFrontFace vkCmdSetFrontFace = nullptr;
+        PFN_vkCmdSetPrimitiveTopology vkCmdSetPrimitiveTopology = nullptr;
+        PFN_vkCmdSetDepthTestEnable vkCmdSetDepthTestEnable = nullptr;
+        PFN_vkCmdSetDepthWriteEnable vkCmdSetDepthWriteEnable = nullptr;
+        PFN_vkCmdSetDepthCompareOp vkCmdSetDepthCompareOp = nullptr;
+        PFN_vkCmdSetStencilTestEnable vkCmdSetStencilTestEnable = nullptr;
 
+        PFN_vkCmdSetRasterizerDiscardEnable vkCmdSetRasterizerDiscardEnable = nullptr;
+        PFN_vkCmdSetDepthBiasEnable vkCmdSetDepthBiasEnable = nullptr;
+        PFN_vkCmdSetPrimitiveRestartEnable vkCmdSetPrimitiveRestartEnable = nullptr;
+
+        PFN_vkCmdSetDepthClampEnableEXT vkCmdSetDepthClampEnableEXT = nullptr;
+        PFN_vkCmdSetPolygonModeEXT vkCmdSetPolygonModeEXT = nullptr;
+        PFN_vkCmdSetRasterizationSamplesEXT vkCmdSetRasterizationSamplesEXT = nullptr;
+        PFN_vkCmdSetAlphaToCoverageEnableEXT vkCmdSetAlphaToCoverageEnableEXT = nullptr;
+        PFN_vkCmdSetLogicOpEnableEXT vkCmdSetLogicOpEnableEXT = nullptr;
+        PFN_vkCmdSetColorBlendEnableEXT vkCmdSetColorBlendEnableEXT = nullptr;
+        PFN_vkCmdSetColorBlendEquationEXT vkCmdSetColorBlendEquationEXT = nullptr;
+        PFN_vkCmdSetColorWriteMaskEXT vkCmdSetColorWriteMaskEXT = nullptr;
+    };
+
+    // VK_EXT_mesh_shader 支持情况, 只开启 task/mesh shader 本身, 不开启 multiview / shading rate 等附加特性
+    struct AdVKMeshShaderSupport {
+        bool bTaskShader = false;
+        bool bMeshShader = false;
+
+        uint32_t maxMeshOutputVertices = 0;
+        uint32_t maxMeshOutputPrimitives = 0;
+        uint32_t maxTaskWorkGroupInvocations = 0;
+        uint32_t maxPreferredTaskWorkGroupInvocations = 0;
+        uint32_t maxPreferredMeshWorkGroupInvocations = 0;
+
+        PFN_vkCmdDrawMeshTasksEXT vkCmdDrawMeshTasksEXT = nullptr;
+        PFN_vkCmdDrawMeshTasksIndirectEXT vkCmdDrawMeshTasksIndirectEXT = nullptr;
+        PFN_vkCmdDrawMeshTasksIndirectCountEXT vkCmdDrawMeshTasksIndirectCountEXT = nullptr;
     };
 
     class AdVKDevice {
@@ -23,8 +87,51 @@ namespace ade {
 
         ~AdVKDevice();
 
+        VkDevice GetHandle() const { return mDevice; }
+
+        AdVKGraphicContext *GetContext() const { return mContext; }
+
+        const AdVkSettings &GetSettings() const { return mSettings; }
+
+        const AdVKDynamicStateSupport &GetDynamicStateSupport() const { return mDynamicStateSupport; }
+
+        const AdVKMeshShaderSupport &GetMeshShaderSupport() const { return mMeshShaderSupport; }
+
+        bool IsDynamicRenderingEnabled() const { return bDynamicRendering; }
+
+        bool IsMultiDrawIndirectEnabled() const { return bMultiDrawIndirect; }
+
+        bool IsDrawIndirectFirstInstanceEnabled() const { return bDrawIndirectFirstInstance; }
+
+        bool IsDrawIndirectCountEnabled() const { return bDrawIndirectCount; }
+
+        bool IsTimelineSemaphoreEnabled() const { return bTimelineSemaphore; }
+
+        AdVKQueue *GetGraphicQueue(uint32_t index) const {
+            return index < mGraphicQueues.size() ? mGraphicQueues[index].get() : nullptr;
+        }
+
+        AdVKQueue *GetPresentQueue(uint32_t index) const {
+            return index < mPresentQueues.size() ? mPresentQueues[index].get() : nullptr;
+        }
+
+    private:
+        void LoadDynamicStateFunctions();
+
+        void LoadMeshShaderFunctions();
+
     private:
-        VkDevice mDevice;
+        AdVKGraphicContext *mContext = nullptr;
+        AdVkSettings mSettings;
+        VkDevice mDevice = VK_NULL_HANDLE;
+
+        AdVKDynamicStateSupport mDynamicStateSupport{};
+        AdVKMeshShaderSupport mMeshShaderSupport{};
+        bool bDynamicRendering = false;
+        bool bMultiDrawIndirect = false;
+        bool bDrawIndirectFirstInstance = false;
+        bool bDrawIndirectCount = false;
+        bool bTimelineSemaphore = false;
 
         std::vector<std::shared_ptr<AdVKQueue>> mGraphicQueues;
         std::vector<std::shared_ptr<AdVKQueue>> mPresentQueues;
@@ -0,0 +1,41 @@
+#ifndef AD_VK_ALLOCATOR_H
+#define AD_VK_ALLOCATOR_H
+
+#include "AdVKCommon.h"
+
+namespace ade {
+    // 对应 VkSystemAllocationScope: command, object, cache, device, instance
+    static constexpr uint32_t AD_VK_ALLOCATION_SCOPE_COUNT = VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE + 1;
+
+    struct AdVKAllocationStats {
+        uint64_t allocCount = 0;        // 累计, 包括 realloc
+        uint64_t pooledCount = 0;       // 累计, 走小块池的次数
+        uint64_t liveCount = 0;
+        uint64_t liveBytes = 0;
+        uint64_t peakBytes = 0;
+        uint64_t internalBytes = 0;     // 驱动通过 pfnInternalAllocation 通知的, 不经过我们的分配
+    };
+
+    /**
+     * 驱动 host 内存分配回调, 所有 vkCreate* / vkDestroy* / vkAllocateMemory / vkFreeMemory 都传 GetCallbacks():
+     * 1. 按 VkSystemAllocationScope 统计次数、存活字节和峰值
+     * 2. object scope 的小块(生命周期和 Vulkan 对象一致, 数量多)走按大小分级的池, 其他走对齐的 operator new
+     * 3. 回调内的分配归到 AdMemoryTag::Renderer
+     * 同一个对象创建和销毁必须传相同的回调, 因此这里是全局的, 不提供开关
+     */
+    class AdVKAllocator {
+    public:
+        AdVKAllocator() = delete;
+
+        static const VkAllocationCallbacks *GetCallbacks();
+
+        static AdVKAllocationStats GetStats(VkSystemAllocationScope scope);
+
+        static const char *GetScopeName(VkSystemAllocationScope scope);
+
+        // 输出所有 scope 的汇总, 销毁 instance 后调用可以检查驱动内存是否全部归还
+        static void Report();
+    };
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef AD_VK_BUFFER_H
+#define AD_VK_BUFFER_H
+
+#include "Graphic/AdVkCommon.h"
+
+namespace ade {
+    class AdVKDevice;
+
+    /**
+     * 主机可见的缓冲, 创建后一直保持映射
+     * 优先选择 DEVICE_LOCAL | HOST_VISIBLE 内存(ReBAR / 集成显卡), 没有时退回普通的 HOST_VISIBLE 内存
+     */
+    class AdVKBuffer {
+    public:
+        AdVKBuffer(AdVKDevice *device, VkBufferUsageFlags usage, VkDeviceSize size, const void *data = nullptr);
+
+        ~AdVKBuffer();
+
+        AdVKBuffer(const AdVKBuffer &) = delete;
+
+        AdVKBuffer &operator=(const AdVKBuffer &) = delete;
+
+        VkBuffer GetHandle() const { return mBuffer; }
+
+        VkDeviceSize GetSize() const { return mSize; }
+
+        void *GetMappedData() const { return mMappedData; }
+
+        bool IsDeviceLocal() const { return bDeviceLocal; }
+
+        void WriteData(const void *data, VkDeviceSize size, VkDeviceSize offset = 0);
+
+        VkDescriptorBufferInfo GetDescriptorInfo() const { return {mBuffer, 0, mSize}; }
+
+    private:
+        AdVKDevice *mDevice;
+        VkBuffer mBuffer = VK_NULL_HANDLE;
+        VkDeviceMemory mMemory = VK_NULL_HANDLE;
+        VkDeviceSize mSize = 0;
+        void *mMappedData = nullptr;
+        bool bDeviceLocal = false;
+        bool bCoherent = false;
+    };
+
+    // 找不到时返回 UINT32_MAX
+    uint32_t FindMemoryType(const VkPhysicalDeviceMemoryProperties &properties, uint32_t typeBits,
+                            VkMemoryPropertyFlags flags);
+
+    // 数据随命令缓冲一起提交, 不需要暂存缓冲; vkCmdUpdateBuffer 单次最多 65536 字节, 超过时拆成多次
+    // offset 和 size 必须是 4 的倍数, 目标缓冲需要 TRANSFER_DST 用途, 必须在渲染过程之外录制
+    void CmdUpdateBufferChunked(VkCommandBuffer cmdBuffer, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size,
+                                const void *data);
+}
+
+#endif
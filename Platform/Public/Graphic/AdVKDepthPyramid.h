@@ -0,0 +1,83 @@
+#ifndef AD_VK_DEPTH_PYRAMID_H
+#define AD_VK_DEPTH_PYRAMID_H
+
+#include "Graphic/AdVKBuffer.h"
+#include "Graphic/AdVKPipelineCache.h"
+
+namespace ade {
+
+    /**
+     * 层级深度缓冲(Hi-Z): 每个 texel 保存覆盖区域内最远的深度(深度范围 [0, 1], 越小越近)
+     * 第 0 层取不大于深度缓冲的 2 的幂尺寸, 最大 4096, 用于 AdVKGpuScene 的遮挡剔除
+     *
+     * 一次派发生成所有层级: 每个工作组在共享内存中把 64x64 的区域归约到 1 个 texel(第 0 到 6 层),
+     * 最后完成的工作组(原子计数)再把第 6 层归约出剩余的层级
+     *
+     * 金字塔图像始终处于 VK_IMAGE_LAYOUT_GENERAL
+     * 深度缓冲需要带 VK_IMAGE_USAGE_SAMPLED_BIT, CmdBuild 之前由调用者转换到 DEPTH_STENCIL_READ_ONLY_OPTIMAL
+     *
+     * 管线归 AdVKPipelineCache 所有, 重新创建金字塔时复用同一个管线
+     */
+    class AdVKDepthPyramid {
+    public:
+        static constexpr uint32_t MAX_MIP_LEVELS = 13;
+
+        /**
+         * 深度缓冲尺寸变化时重新创建
+         * @param depthView     深度缓冲的视图, 只包含深度 aspect
+         */
+        AdVKDepthPyramid(AdVKDevice *device, AdVKPipelineCache *pipelineCache, VkImageView depthView,
+                         uint32_t depthWidth, uint32_t depthHeight);
+
+        ~AdVKDepthPyramid();
+
+        AdVKDepthPyramid(const AdVKDepthPyramid &) = delete;
+
+        AdVKDepthPyramid &operator=(const AdVKDepthPyramid &) = delete;
+
+        uint32_t GetWidth() const { return mWidth; }
+
+        uint32_t GetHeight() const { return mHeight; }
+
+        uint32_t GetMipLevels() const { return mMipLevels; }
+
+        // 包含所有层级的视图和最近点采样器, 着色器用 textureLod 读取指定层级
+        VkImageView GetImageView() const { return mImageView; }
+
+        VkSampler GetSampler() const { return mSampler; }
+
+        // 录制在深度写完之后, 结束时插入屏障, 之后的计算着色器可以直接读取
+        void CmdBuild(VkCommandBuffer cmdBuffer) const;
+
+    private:
+        bool CreateImage();
+
+        void CreateDescriptorSet(VkImageView depthView);
+
+    private:
+        AdVKDevice *mDevice;
+        AdVKPipelineCache *mPipelineCache;
+        uint32_t mDepthWidth;
+        uint32_t mDepthHeight;
+        uint32_t mWidth = 0;
+        uint32_t mHeight = 0;
+        uint32_t mMipLevels = 0;
+
+        VkImage mImage = VK_NULL_HANDLE;
+        VkDeviceMemory mMemory = VK_NULL_HANDLE;
+        VkImageView mImageView = VK_NULL_HANDLE;
+        std::vector<VkImageView> mMipViews;
+        VkSampler mSampler = VK_NULL_HANDLE;
+
+        // 工作组完成计数, 最后一个工作组读到 groupCount - 1 后把它清零
+        std::unique_ptr<AdVKBuffer> mCounterBuffer;
+
+        VkDescriptorSetLayout mDescriptorSetLayout = VK_NULL_HANDLE;
+        VkDescriptorPool mDescriptorPool = VK_NULL_HANDLE;
+        VkDescriptorSet mDescriptorSet = VK_NULL_HANDLE;
+        VkPipelineLayout mPipelineLayout = VK_NULL_HANDLE;
+        AdVKComputePipeline *mPipeline = nullptr;
+    };
+}
+
+#endif
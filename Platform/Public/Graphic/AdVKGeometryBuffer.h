@@ -0,0 +1,145 @@
+#ifndef AD_VK_GEOMETRY_BUFFER_H
+#define AD_VK_GEOMETRY_BUFFER_H
+
+#include "Graphic/AdVKBuffer.h"
+#include "Memory/AdRangeAllocator.h"
+#include "Asset/AdMeshFormat.h"
+
+namespace ade {
+    class AdMesh;
+
+    struct AdGeometryBufferSettings {
+        uint32_t vertexCapacity = 4 * 1024 * 1024;
+        uint32_t indexCapacity = 16 * 1024 * 1024;
+        uint32_t maxMeshCount = 4096;
+    };
+
+    // 网格在大缓冲中的位置, 索引范围都是相对整个索引缓冲的
+    struct AdGeometryMesh {
+        uint32_t firstVertex;
+        uint32_t vertexCount;
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        uint32_t lodCount;
+        AdMeshLod lods[AD_MESH_MAX_LOD_COUNT];
+        float boundingSphere[4];    // 物体空间, xyz 球心, w 半径
+    };
+
+    struct AdGeometryLodInfo {
+        uint32_t firstIndex;        // 相对整个索引缓冲
+        uint32_t indexCount;
+        float error;
+        uint32_t reserved;
+    };
+
+    // 与 Asset/Shader/Include/AdGeometry.glsl 中的 AdGeometryMesh 一致, GPU 剔除时据此生成绘制命令
+    struct AdGeometryMeshInfo {
+        float positionScale[4];
+        float positionOffset[4];
+        float uvScaleOffset[4];
+        float boundingSphere[4];
+        uint32_t firstVertex;
+        uint32_t lodCount;
+        uint32_t reserved[2];
+        AdGeometryLodInfo lods[AD_MESH_MAX_LOD_COUNT];
+    };
+
+    // 与 AdGeometry.glsl 中的 AdGeometryInstance 一致, 绘制时通过 firstInstance 索引
+    struct AdGeometryInstance {
+        float model[16];            // 列主序
+        uint32_t meshId;            // INVALID_MESH_ID 表示空槽位
+        uint32_t materialId;
+        uint32_t bucket;            // 管线分桶, 见 AdVKGpuScene
+        uint32_t reserved;
+    };
+
+    /**
+     * 所有静态网格共用的几何大缓冲: 位置、属性、索引各一个, 按网格子分配
+     * 着色器通过 gl_VertexIndex 从存储缓冲中读取顶点(vertex pulling), 不再绑定顶点缓冲
+     * 绘制循环里只绑定一次描述符集和索引缓冲, 任意网格都可以放进同一次多重间接绘制
+     *
+     * 索引统一转成 32 位; 网格 id 同时是 AdGeometryMeshInfo 数组的下标
+     *
+     * 网格的增删先记在 CPU 中, 下一次 CmdUpload 时在屏障之后用 vkCmdUpdateBuffer 写入(AdVKGpuScene::CmdCull 会调用),
+     * 之前提交、仍在执行的剔除和绘制读到的总是自己那一帧的数据
+     */
+    class AdVKGeometryBuffer {
+    public:
+        static constexpr uint32_t INVALID_MESH_ID = UINT32_MAX;
+
+        AdVKGeometryBuffer(AdVKDevice *device, const AdGeometryBufferSettings &settings = {});
+
+        ~AdVKGeometryBuffer();
+
+        AdVKGeometryBuffer(const AdVKGeometryBuffer &) = delete;
+
+        AdVKGeometryBuffer &operator=(const AdVKGeometryBuffer &) = delete;
+
+        // 空间不足返回 INVALID_MESH_ID; 数据在下一次 CmdUpload 时写入 GPU
+        uint32_t AddMesh(const AdMesh &mesh);
+
+        // 调用者需要保证 GPU 已经不再使用这个网格, 还没有上传的数据直接丢弃
+        void RemoveMesh(uint32_t meshId);
+
+        // 在渲染过程之外录制, 写入之前的网格增删; 没有修改时什么都不做
+        void CmdUpload(VkCommandBuffer cmdBuffer);
+
+        bool IsValidMesh(uint32_t meshId) const { return meshId < mMeshes.size() && mMeshes[meshId].indexCount > 0; }
+
+        const AdGeometryMesh &GetMesh(uint32_t meshId) const { return mMeshes[meshId]; }
+
+        // 设备不支持 drawIndirectFirstInstance 时, 放进间接绘制的命令 firstInstance 必须为 0
+        VkDrawIndexedIndirectCommand GetDrawCommand(uint32_t meshId, uint32_t lod, uint32_t instanceCount,
+                                                    uint32_t firstInstance) const;
+
+        // 描述符集: binding 0 网格信息, 1 位置, 2 属性
+        VkDescriptorSetLayout GetDescriptorSetLayout() const { return mDescriptorSetLayout; }
+
+        VkDescriptorSet GetDescriptorSet() const { return mDescriptorSet; }
+
+        VkBuffer GetMeshInfoBuffer() const { return mMeshInfoBuffer->GetHandle(); }
+
+        void CmdBind(VkCommandBuffer cmdBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout,
+                     uint32_t set) const;
+
+        // 设备不支持 multiDrawIndirect 时退化为逐个绘制
+        void CmdDrawIndirect(VkCommandBuffer cmdBuffer, VkBuffer commandBuffer, VkDeviceSize offset,
+                             uint32_t drawCount) const;
+
+    private:
+        void MarkMeshInfoDirty(uint32_t meshId);
+
+    private:
+        // 等待上传的网格数据, 位置相对 mMeshes[meshId]
+        struct PendingMesh {
+            uint32_t meshId;
+            std::vector<AdMeshPosition> positions;
+            std::vector<AdMeshAttribute> attributes;
+            std::vector<uint32_t> indices;
+        };
+
+        AdVKDevice *mDevice;
+        AdGeometryBufferSettings mSettings;
+
+        std::unique_ptr<AdVKBuffer> mPositionBuffer;
+        std::unique_ptr<AdVKBuffer> mAttributeBuffer;
+        std::unique_ptr<AdVKBuffer> mIndexBuffer;
+        std::unique_ptr<AdVKBuffer> mMeshInfoBuffer;
+        AdRangeAllocator mVertexAllocator;
+        AdRangeAllocator mIndexAllocator;
+
+        std::vector<AdGeometryMesh> mMeshes;
+        std::vector<uint32_t> mFreeMeshIds;
+        // 网格信息的 CPU 副本, 长度与 mMeshes 一致; 修改过的下标在下一次 CmdUpload 时写入 GPU
+        std::vector<AdGeometryMeshInfo> mMeshInfos;
+        std::vector<uint32_t> mDirtyMeshIds;
+        std::vector<bool> mMeshDirtyFlags;
+        std::vector<PendingMesh> mPendingMeshes;
+
+        VkDescriptorSetLayout mDescriptorSetLayout = VK_NULL_HANDLE;
+        VkDescriptorPool mDescriptorPool = VK_NULL_HANDLE;
+        VkDescriptorSet mDescriptorSet = VK_NULL_HANDLE;
+    };
+}
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef AD_VK_GPU_SCENE_H
+#define AD_VK_GPU_SCENE_H
+
+#include "Graphic/AdVKGeometryBuffer.h"
+#include "Graphic/AdVKPipelineCache.h"
+
+namespace ade {
+    class AdVKDepthPyramid;
+
+    struct AdGpuSceneSettings {
+        uint32_t maxInstanceCount = 256 * 1024;
+        uint32_t maxBucketCount = 64;
+    };
+
+    // 一次剔除的视图参数
+    struct AdGpuCullView {
+        float viewProj[16];             // 列主序, Vulkan 深度范围 [0, 1]
+        float cameraPosition[3];
+        float projectionScale = 0.0f;   // AdMesh::GetProjectionScale, 为 0 时不选择 LOD, 总是使用 LOD0
+        float maxPixelError = 1.0f;
+    };
+
+    /**
+     * 两阶段遮挡剔除, 每帧:
+     *   CmdCull(EARLY) -> 绘制所有桶(清除深度) -> 深度金字塔 CmdBuild -> CmdCull(LATE) -> 绘制所有桶(保留深度)
+     * 第一阶段只画上一帧可见的实例, 用它们的深度做本帧的遮挡测试, 第二阶段只补画新变为可见的实例
+     */
+    enum AdGpuCullPass {
+        AD_GPU_CULL_PASS_SINGLE = 0,    // 只做视锥剔除
+        AD_GPU_CULL_PASS_EARLY,
+        AD_GPU_CULL_PASS_LATE           // 需要先 SetDepthPyramid
+    };
+
+    // 与 Asset/Shader/Include/AdGpuSceneCull.glsl 的 push constant 一致
+    struct AdGpuCullPushConstants {
+        float viewProj[16];
+        float cameraPosition[3];
+        float projectionScale;
+        uint32_t instanceCount;
+        float maxPixelError;
+        uint32_t bucketCount;
+        uint32_t flags;
+    };
+
+    /**
+     * 常驻 GPU 的场景: 实例的变换、网格、材质和管线分桶放在存储缓冲中, 只在变化时由 CPU 更新
+     * 每帧一次计算着色器完成视锥剔除和 LOD 选择, 把可见实例的绘制命令按桶压缩写出,
+     * 每个桶(同一管线)只需要一次 vkCmdDrawIndexedIndirectCount, CPU 提交开销与实例数量无关
+     *
+     * 设备不支持 drawIndirectCount 时, 命令缓冲先清零, 再按桶容量用 vkCmdDrawIndexedIndirect 绘制,
+     * 多出来的命令 instanceCount 为 0, 不产生任何图元
+     *
+     * 描述符集(set 1): binding 0 实例, 1 绘制命令, 2 每个桶的绘制数量, 3 每个桶在命令缓冲中的起始位置,
+     * 4 每个实例上一帧的可见性
+     * 实例和桶区间的修改先记在 CPU 副本中, 下一次 CmdCull 时在屏障之后用 vkCmdUpdateBuffer 写入,
+     * 之前提交、仍在执行的剔除和绘制读到的总是自己那一帧的数据
+     *
+     * 绘制命令的 firstInstance 是实例槽位, 设备不支持 drawIndirectFirstInstance 时不创建场景, 剔除和绘制什么都不做
+     * 剔除管线通过 AdVKPipelineCache 创建和记录, pipelineCache 需要比场景活得更久
+     */
+    class AdVKGpuScene {
+    public:
+        static constexpr uint32_t INVALID_INSTANCE_ID = UINT32_MAX;
+
+        AdVKGpuScene(AdVKDevice *device, AdVKPipelineCache *pipelineCache, AdVKGeometryBuffer *geometry,
+                     const AdGpuSceneSettings &settings = {});
+
+        ~AdVKGpuScene();
+
+        AdVKGpuScene(const AdVKGpuScene &) = delete;
+
+        AdVKGpuScene &operator=(const AdVKGpuScene &) = delete;
+
+        // 场景已满或参数非法时返回 INVALID_INSTANCE_ID
+        uint32_t AddInstance(uint32_t meshId, uint32_t bucket, const float model[16], uint32_t materialId = 0);
+
+        void UpdateInstance(uint32_t instanceId, const float model[16]);
+
+        void RemoveInstance(uint32_t instanceId);
+
+        uint32_t GetInstanceCount() const { return mInstanceCount; }
+
+        uint32_t GetBucketInstanceCount(uint32_t bucket) const { return mBucketInstanceCounts[bucket]; }
+
+        VkDescriptorSetLayout GetDescriptorSetLayout() const { return mDescriptorSetLayout; }
+
+        VkDescriptorSet GetDescriptorSet() const { return mDescriptorSet; }
+
+        VkBuffer GetDrawCommandBuffer() const { return mDrawCommandBuffer->GetHandle(); }
+
+        VkBuffer GetDrawCountBuffer() const { return mDrawCountBuffer->GetHandle(); }
+
+        // 深度缓冲重建后重新设置, 调用时 GPU 不能正在使用场景
+        void SetDepthPyramid(const AdVKDepthPyramid *depthPyramid);
+
+        // 在渲染开始之前录制; 每次都会重写绘制命令, 上一阶段的绘制需要已经录制; 同时写入之前的实例和几何修改
+        void CmdCull(VkCommandBuffer cmdBuffer, const AdGpuCullView &view,
+                     AdGpuCullPass pass = AD_GPU_CULL_PASS_SINGLE);
+
+        /**
+         * 绘制一个桶中所有可见实例, 需要先绑定这个桶的管线
+         * @param pipelineLayout    set 0 为几何大缓冲, set 1 为场景
+         */
+        void CmdDrawBucket(VkCommandBuffer cmdBuffer, uint32_t bucket, VkPipelineLayout pipelineLayout) const;
+
+    private:
+        void CreateDescriptorSet();
+
+        void CreateOcclusionPipeline();
+
+        void MarkInstanceDirty(uint32_t instanceId);
+
+        // 录制待写入的实例和桶区间, 桶区间在实例增删后重新计算
+        void CmdUploadPending(VkCommandBuffer cmdBuffer);
+
+    private:
+        AdVKDevice *mDevice;
+        AdVKPipelineCache *mPipelineCache;
+        AdVKGeometryBuffer *mGeometry;
+        AdGpuSceneSettings mSettings;
+
+        std::unique_ptr<AdVKBuffer> mInstanceBuffer;
+        std::unique_ptr<AdVKBuffer> mDrawCommandBuffer;
+        std::unique_ptr<AdVKBuffer> mDrawCountBuffer;
+        std::unique_ptr<AdVKBuffer> mBucketOffsetBuffer;
+        std::unique_ptr<AdVKBuffer> mVisibilityBuffer;
+
+        // 槽位最高水位, 剔除时按这个数量派发
+        uint32_t mInstanceCount = 0;
+        std::vector<uint32_t> mFreeInstanceIds;
+        // 实例数据的 CPU 副本, 长度与 mInstanceCount 一致; 修改过的槽位在下一次 CmdCull 时写入 GPU
+        std::vector<AdGeometryInstance> mInstances;
+        std::vector<uint32_t> mDirtyInstanceIds;
+        std::vector<bool> mInstanceDirtyFlags;
+        // 每个槽位所在的桶, 空槽位为 INVALID_INSTANCE_ID
+        std::vector<uint32_t> mInstanceBuckets;
+        std::vector<uint32_t> mBucketInstanceCounts;
+        std::vector<uint32_t> mBucketOffsets;
+        // 与 mBucketOffsets 同时写入 GPU 的每桶实例数, 绘制时作为最大绘制数量
+        std::vector<uint32_t> mCulledBucketInstanceCounts;
+        bool bBucketOffsetsDirty = false;
+
+        VkDescriptorSetLayout mDescriptorSetLayout = VK_NULL_HANDLE;
+        VkDescriptorPool mDescriptorPool = VK_NULL_HANDLE;
+        VkDescriptorSet mDescriptorSet = VK_NULL_HANDLE;
+        // 管线归 mPipelineCache 所有
+        VkPipelineLayout mCullPipelineLayout = VK_NULL_HANDLE;
+        AdVKComputePipeline *mCullPipeline = nullptr;
+
+        // 第二阶段: set 2 为深度金字塔
+        VkDescriptorSetLayout mPyramidSetLayout = VK_NULL_HANDLE;
+        VkDescriptorPool mPyramidDescriptorPool = VK_NULL_HANDLE;
+        VkDescriptorSet mPyramidDescriptorSet = VK_NULL_HANDLE;
+        bool bHasDepthPyramid = false;
+        VkPipelineLayout mOcclusionPipelineLayout = VK_NULL_HANDLE;
+        AdVKComputePipeline *mOcclusionPipeline = nullptr;
+    };
+}
+
+#endif
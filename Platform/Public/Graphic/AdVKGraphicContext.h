@@ -23,6 +23,10 @@ namespace ade {
 
         VkPhysicalDevice GetPhysicalDevice() const { return mPhysicalDevice; }
 
+        const VkPhysicalDeviceMemoryProperties &GetPhysicalDeviceMemoryProperties() const {
+            return mPhysicalDeviceMemoryProperties;
+        }
+
         const QueueFamilyInfo &GetGraphicFamilyInfo() const { return mGraphicQueueFamily; };
 
         const QueueFamilyInfo &GetPresentFamilyInfo() const { return mPresentQueueFamily; };
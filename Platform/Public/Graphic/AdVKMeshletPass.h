@@ -0,0 +1,129 @@
+#ifndef AD_VK_MESHLET_PASS_H
+#define AD_VK_MESHLET_PASS_H
+
+#include "Graphic/AdVKBuffer.h"
+#include "Graphic/AdVKPipelineCache.h"
+#include "Asset/AdMeshFormat.h"
+
+namespace ade {
+    class AdMesh;
+
+    // 与 Asset/Shader/Include/AdMeshlet.glsl 中的 push constant 一致
+    struct AdMeshletPushConstants {
+        float modelViewProj[16];    // 列主序
+        float cameraPosition[4];    // 物体空间相机位置, 用于法线锥剔除
+        uint32_t meshletOffset;
+        uint32_t meshletCount;
+    };
+
+    // 上传到 GPU 的 meshlet 网格, 由 AdVKMeshletPass::CreateMesh 创建
+    class AdVKMeshletMesh {
+    public:
+        ~AdVKMeshletMesh();
+
+        AdVKMeshletMesh(const AdVKMeshletMesh &) = delete;
+
+        AdVKMeshletMesh &operator=(const AdVKMeshletMesh &) = delete;
+
+        uint32_t GetLodCount() const { return mLodCount; }
+
+        const AdMeshLod &GetLod(uint32_t lod) const { return mLods[lod]; }
+
+        uint32_t GetDrawSlotCount() const { return mDrawSlotCount; }
+
+    private:
+        friend class AdVKMeshletPass;
+
+        explicit AdVKMeshletMesh(AdVKDevice *device) : mDevice(device) {}
+
+        AdVKDevice *mDevice;
+        uint32_t mLodCount = 0;
+        AdMeshLod mLods[AD_MESH_MAX_LOD_COUNT]{};
+
+        std::unique_ptr<AdVKBuffer> mMeshInfoBuffer;
+        std::unique_ptr<AdVKBuffer> mPositionBuffer;
+        std::unique_ptr<AdVKBuffer> mAttributeBuffer;
+        std::unique_ptr<AdVKBuffer> mMeshletBuffer;
+        std::unique_ptr<AdVKBuffer> mMeshletVertexBuffer;
+        std::unique_ptr<AdVKBuffer> mMeshletTriangleBuffer;
+        // 回退路径: 计算着色器输出的可见三角形索引和间接绘制参数, 每个绘制槽位一段, 通过动态偏移绑定
+        uint32_t mDrawSlotCount = 1;
+        uint32_t mCulledIndexSlotSize = 0;
+        uint32_t mDrawCommandSlotSize = 0;
+        std::unique_ptr<AdVKBuffer> mCulledIndexBuffer;
+        std::unique_ptr<AdVKBuffer> mDrawCommandBuffer;
+
+        VkDescriptorPool mDescriptorPool = VK_NULL_HANDLE;
+        VkDescriptorSet mDescriptorSet = VK_NULL_HANDLE;
+    };
+
+    /**
+     * 按 meshlet 剔除和绘制网格, 剔除包括视锥(包围球)和背面(法线锥)
+     * 设备支持 VK_EXT_mesh_shader 时: task shader 剔除, mesh shader 直接输出可见 meshlet 的三角形
+     * 否则回退: 计算着色器把可见 meshlet 的三角形压缩到索引缓冲, 再用量化顶点输入间接绘制
+     *
+     * 使用 dynamic rendering, 管线通过 AdVKPipelineCache 创建和记录, pipelineCache 需要比 pass 活得更久
+     *
+     * 回退路径的录制顺序: 在 vkCmdBeginRendering 之前对这一帧的每次绘制调用 CmdCull, 再在渲染过程中调用 CmdDraw
+     * (CmdCull 包含计算派发和管线屏障, 不能在渲染过程中录制); 剔除结果按绘制槽位存放,
+     * 同一个网格在一帧内绘制多次(多个实例或多个视图)时, 每次使用不同的 drawSlot
+     */
+    class AdVKMeshletPass {
+    public:
+        AdVKMeshletPass(AdVKDevice *device, AdVKPipelineCache *pipelineCache, VkFormat colorFormat,
+                        VkFormat depthFormat);
+
+        ~AdVKMeshletPass();
+
+        AdVKMeshletPass(const AdVKMeshletPass &) = delete;
+
+        AdVKMeshletPass &operator=(const AdVKMeshletPass &) = delete;
+
+        bool IsUsingMeshShader() const { return bUseMeshShader; }
+
+        /**
+         * 顶点和 meshlet 数据原样拷贝进主机可见缓冲
+         * @param drawSlotCount     回退路径下这个网格每帧最多绘制的次数
+         */
+        std::unique_ptr<AdVKMeshletMesh> CreateMesh(const AdMesh &mesh, uint32_t drawSlotCount = 1) const;
+
+        /**
+         * 回退路径的剔除, 必须在渲染过程之外、对应的 CmdDraw 之前录制; mesh shader 路径下什么都不做
+         * @param drawSlot          [0, mesh.GetDrawSlotCount()), 同一帧内每次绘制使用不同的槽位
+         * @param modelViewProj     列主序, Vulkan 深度范围 [0, 1]
+         * @param cameraPosition    物体空间相机位置
+         */
+        void CmdCull(VkCommandBuffer cmdBuffer, const AdVKMeshletMesh &mesh, uint32_t drawSlot, uint32_t lod,
+                     const float modelViewProj[16], const float cameraPosition[3]) const;
+
+        // 在渲染过程中录制, drawSlot 和其他参数需要与 CmdCull 一致; state 中不能动态设置的部分使用缓存中对应的管线
+        void CmdDraw(VkCommandBuffer cmdBuffer, const AdVKMeshletMesh &mesh, uint32_t drawSlot, uint32_t lod,
+                     const float modelViewProj[16], const float cameraPosition[3],
+                     const AdVKPipelineState &state = {}) const;
+
+    private:
+        void CreateLayout();
+
+        // 返回 false 表示槽位越界
+        bool GetDrawSlotOffsets(const AdVKMeshletMesh &mesh, uint32_t drawSlot, uint32_t outOffsets[2]) const;
+
+        AdMeshletPushConstants GetPushConstants(const AdVKMeshletMesh &mesh, uint32_t lod,
+                                                const float modelViewProj[16], const float cameraPosition[3]) const;
+
+    private:
+        AdVKDevice *mDevice;
+        AdVKPipelineCache *mPipelineCache = nullptr;
+        bool bUseMeshShader = false;
+        VkShaderStageFlags mStageFlags = 0;
+        VkDeviceSize mStorageOffsetAlignment = 1;
+
+        VkDescriptorSetLayout mDescriptorSetLayout = VK_NULL_HANDLE;
+        VkPipelineLayout mPipelineLayout = VK_NULL_HANDLE;
+        // 管线归 mPipelineCache 所有; mPipelineKey 是默认状态的 key, 其他状态在它的基础上查找
+        AdVKPipelineKey mPipelineKey;
+        AdVKPipeline *mPipeline = nullptr;
+        AdVKComputePipeline *mCullPipeline = nullptr;
+    };
+}
+
+#endif
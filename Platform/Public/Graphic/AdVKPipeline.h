@@ -0,0 +1,141 @@
+#ifndef AD_VK_PIPELINE_H
+#define AD_VK_PIPELINE_H
+
+#include "AdVKCommon.h"
+
+namespace ade {
+    class AdVKDevice;
+
+    struct AdVKDynamicStateSupport;
+
+    /**
+     * 管线固定功能状态描述(单颜色附件)
+     * 成员全部为 4 字节类型, 没有填充, 可以直接按字节哈希和序列化
+     * 设备支持扩展动态状态时, 对应字段在录制命令时设置, 不参与管线哈希
+     */
+    struct AdVKPipelineState {
+        // input assembly
+        VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        VkBool32 primitiveRestartEnable = VK_FALSE;
+
+        // rasterization
+        VkBool32 depthClampEnable = VK_FALSE;
+        VkBool32 rasterizerDiscardEnable = VK_FALSE;
+        VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL;
+        VkCullModeFlags cullMode = VK_CULL_MODE_BACK_BIT;
+        VkFrontFace frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        VkBool32 depthBiasEnable = VK_FALSE;
+
+        // multisample
+        VkSampleCountFlagBits rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+        VkBool32 alphaToCoverageEnable = VK_FALSE;
+
+        // depth stencil
+        VkBool32 depthTestEnable = VK_FALSE;
+        VkBool32 depthWriteEnable = VK_FALSE;
+        VkCompareOp depthCompareOp = VK_COMPARE_OP_LESS;
+        VkBool32 stencilTestEnable = VK_FALSE;
+
+        // color blend
+        VkBool32 logicOpEnable = VK_FALSE;
+        VkLogicOp logicOp = VK_LOGIC_OP_COPY;
+        VkBool32 blendEnable = VK_FALSE;
+        VkBlendFactor srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        VkBlendFactor dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        VkBlendOp colorBlendOp = VK_BLEND_OP_ADD;
+        VkBlendFactor srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        VkBlendFactor dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+        VkBlendOp alphaBlendOp = VK_BLEND_OP_ADD;
+        VkColorComponentFlags colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                                               VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+        /**
+         * 返回需要烘焙进管线的状态: 动态字段被重置为默认值
+         * topology 在不支持 unrestricted 时只能动态切换同一类图元, 因此保留图元类别
+         */
+        AdVKPipelineState GetBakedState(const AdVKDynamicStateSupport &support) const;
+
+        // 管线哈希, 不包含动态字段
+        uint64_t GetHash(const AdVKDynamicStateSupport &support) const;
+
+        static void GetDynamicStates(const AdVKDynamicStateSupport &support, std::vector<VkDynamicState> &outStates);
+
+        // 录制动态字段, 需要在绑定管线之后、绘制之前调用; mesh 管线没有图元装配阶段, bInputAssembly 传 false
+        void CmdSetDynamicState(VkCommandBuffer cmdBuffer, const AdVKDynamicStateSupport &support,
+                                bool bInputAssembly = true) const;
+
+        bool operator==(const AdVKPipelineState &other) const {
+            return memcmp(this, &other, sizeof(AdVKPipelineState)) == 0;
+        }
+    };
+
+    struct AdVKPipelineDesc {
+        VkShaderModule vertexShader = VK_NULL_HANDLE;
+        VkShaderModule fragmentShader = VK_NULL_HANDLE;
+        // 设置 meshShader 时使用 task/mesh 管线, 忽略 vertexShader 和顶点输入
+        VkShaderModule taskShader = VK_NULL_HANDLE;
+        VkShaderModule meshShader = VK_NULL_HANDLE;
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+
+        std::vector<VkVertexInputBindingDescription> vertexBindings;
+        std::vector<VkVertexInputAttributeDescription> vertexAttributes;
+
+        // renderPass 为空时使用 dynamic rendering
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        uint32_t subpass = 0;
+        VkFormat colorFormat = VK_FORMAT_B8G8R8A8_UNORM;
+        VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+
+        AdVKPipelineState state;
+    };
+
+    class AdVKPipeline {
+    public:
+        AdVKPipeline(AdVKDevice *device, const AdVKPipelineDesc &desc, VkPipelineCache pipelineCache = VK_NULL_HANDLE);
+
+        ~AdVKPipeline();
+
+        AdVKPipeline(const AdVKPipeline &) = delete;
+
+        AdVKPipeline &operator=(const AdVKPipeline &) = delete;
+
+        VkPipeline GetHandle() const { return mPipeline; }
+
+        uint64_t GetStateHash() const { return mStateHash; }
+
+        void Bind(VkCommandBuffer cmdBuffer, const AdVKPipelineState &state) const;
+
+    private:
+        AdVKDevice *mDevice;
+        VkPipeline mPipeline = VK_NULL_HANDLE;
+        uint64_t mStateHash = 0;
+        bool bMeshPipeline = false;
+    };
+
+    class AdVKComputePipeline {
+    public:
+        AdVKComputePipeline(AdVKDevice *device, VkShaderModule computeShader, VkPipelineLayout pipelineLayout,
+                            VkPipelineCache pipelineCache = VK_NULL_HANDLE);
+
+        ~AdVKComputePipeline();
+
+        AdVKComputePipeline(const AdVKComputePipeline &) = delete;
+
+        AdVKComputePipeline &operator=(const AdVKComputePipeline &) = delete;
+
+        VkPipeline GetHandle() const { return mPipeline; }
+
+        void Bind(VkCommandBuffer cmdBuffer) const {
+            vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mPipeline);
+        }
+
+    private:
+        AdVKDevice *mDevice;
+        VkPipeline mPipeline = VK_NULL_HANDLE;
+    };
+
+    // 从资源目录读取 SPIR-V 创建 shader module, 失败返回 VK_NULL_HANDLE
+    VkShaderModule CreateShaderModule(AdVKDevice *device, const std::string &path);
+}
+
+#endif
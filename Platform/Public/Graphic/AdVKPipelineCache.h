@@ -0,0 +1,159 @@
+#ifndef AD_VK_PIPELINE_CACHE_H
+#define AD_VK_PIPELINE_CACHE_H
+
+#include "Graphic/AdVKPipeline.h"
+#include <mutex>
+#include <future>
+
+namespace ade {
+    class AdVKDevice;
+
+    /**
+     * 可序列化的管线 key: shader 用资源相对路径, layout 用注册名字标识
+     * 只支持 dynamic rendering, render pass 无法跨进程记录
+     */
+    struct AdVKPipelineKey {
+        std::string vertexShader;       // 例如 Shader/00_hello_triangle.vert.spv
+        std::string fragmentShader;
+        // 设置 meshShader 时为 task/mesh 管线, 忽略 vertexShader 和顶点输入; taskShader 可以为空
+        std::string taskShader;
+        std::string meshShader;
+        // 设置 computeShader 时为计算管线, 只使用 computeShader 和 pipelineLayout
+        std::string computeShader;
+        std::string pipelineLayout;     // RegisterPipelineLayout 注册的名字, 相同名字的 layout 定义必须相同
+
+        std::vector<VkVertexInputBindingDescription> vertexBindings;
+        std::vector<VkVertexInputAttributeDescription> vertexAttributes;
+        VkFormat colorFormat = VK_FORMAT_B8G8R8A8_UNORM;
+        VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+
+        AdVKPipelineState state;
+
+        bool IsCompute() const { return !computeShader.empty(); }
+
+        uint64_t GetHash(const AdVKPipelineState &bakedState) const;
+
+        uint64_t GetHash() const { return GetHash(state); }
+    };
+
+    // 并行执行器: 执行 count 个任务, 返回时全部完成; 为空时使用内部线程
+    using AdParallelExecutor = std::function<void(uint32_t count, const std::function<void(uint32_t)> &task)>;
+
+    // 管线使用记录文件的读写, 与设备无关; 文件损坏或版本不一致时返回 false 且 outKeys 为空
+    bool LoadPipelineUsage(const std::string &path, std::vector<AdVKPipelineKey> &outKeys);
+
+    bool SavePipelineUsage(const std::string &path, const std::vector<AdVKPipelineKey> &keys);
+
+    /**
+     * 并行地对每个 key 调用一次 create, 返回全部完成后 create 成功的数量
+     * @param threadCount   内部线程数量, 0 表示硬件线程数; executor 不为空时忽略
+     */
+    uint32_t PrewarmPipelineKeys(const std::vector<AdVKPipelineKey> &keys, uint32_t threadCount,
+                                 const AdParallelExecutor &executor,
+                                 const std::function<bool(const AdVKPipelineKey &key)> &create);
+
+    /**
+     * 管线缓存:
+     * 1. VkPipelineCache 持久化到磁盘
+     * 2. 按烘焙后的状态去重创建管线
+     * 3. 记录本次运行用到的所有管线 key(图形、mesh 和计算管线), 下次启动时可以并行预创建(pre-warm)
+     *
+     * 管线和 shader module 归缓存所有, 缓存需要比使用它的 pass 活得更久
+     */
+    class AdVKPipelineCache {
+    public:
+        explicit AdVKPipelineCache(AdVKDevice *device,
+                                   const std::string &cacheDir = AD_DEFINE_SAVED_ROOT_DIR);
+
+        ~AdVKPipelineCache();
+
+        AdVKPipelineCache(const AdVKPipelineCache &) = delete;
+
+        AdVKPipelineCache &operator=(const AdVKPipelineCache &) = delete;
+
+        // 调用过 Prewarm 之后注册时, 在当前线程等待这个 layout 下记录的管线预创建完成
+        void RegisterPipelineLayout(const std::string &name, VkPipelineLayout layout);
+
+        // 只有当前注册的还是 layout 时才移除, 同名的 layout 可能已经被另一个 pass 实例重新注册
+        void UnregisterPipelineLayout(const std::string &name, VkPipelineLayout layout);
+
+        /**
+         * 线程安全
+         * @param pipelineLayout    为空时使用 key.pipelineLayout 注册的 layout
+         */
+        AdVKPipeline *GetOrCreatePipeline(const AdVKPipelineKey &key,
+                                          VkPipelineLayout pipelineLayout = VK_NULL_HANDLE);
+
+        AdVKComputePipeline *GetOrCreateComputePipeline(const AdVKPipelineKey &key,
+                                                        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE);
+
+        /**
+         * 预创建上次运行记录的管线: 立即创建 layout 已经注册的 key,
+         * 其余的在之后 RegisterPipelineLayout 时用同样的参数创建(例如 pass 构造时注册 layout)
+         * @param threadCount   内部线程数量, 0 表示硬件线程数
+         * @param executor      外部并行执行器(例如 job system), 需要在之后的注册中保持有效
+         * @return              这一次预创建的管线数量
+         */
+        uint32_t Prewarm(uint32_t threadCount = 0, const AdParallelExecutor &executor = {});
+
+        // 在后台线程预创建, 可以配合加载界面使用
+        std::future<uint32_t> PrewarmAsync(uint32_t threadCount = 0, const AdParallelExecutor &executor = {});
+
+        // 保存 VkPipelineCache 和管线使用记录, 析构时也会自动保存
+        void Save();
+
+        VkPipelineCache GetHandle() const { return mPipelineCache; }
+
+        uint32_t GetPipelineCount();
+
+    private:
+        VkShaderModule GetShaderModule(const std::string &path);
+
+        struct PipelineEntry;
+
+        // 查找或创建管线, create 在锁外执行; 创建成功时记录使用
+        template<typename CreateFunc>
+        PipelineEntry *GetOrCreateEntry(const AdVKPipelineKey &key, uint64_t hash, VkPipelineLayout pipelineLayout,
+                                        const CreateFunc &create);
+
+        // 预创建 layout 已经注册、还没有创建的记录
+        uint32_t PrewarmRegistered(const std::string *layoutName);
+
+        bool LoadUsage(std::vector<AdVKPipelineKey> &outKeys) const;
+
+        void SaveUsage();
+
+        void LoadPipelineCache();
+
+        void SavePipelineCache();
+
+    private:
+        // 图形和计算管线按 key 哈希放在同一个表中, 只有一个指针不为空
+        struct PipelineEntry {
+            AdVKPipelineKey key;
+            std::unique_ptr<AdVKPipeline> pipeline;
+            std::unique_ptr<AdVKComputePipeline> computePipeline;
+        };
+
+        AdVKDevice *mDevice;
+        std::string mCacheDir;
+        VkPipelineCache mPipelineCache = VK_NULL_HANDLE;
+
+        std::mutex mMutex;
+        std::unordered_map<std::string, VkShaderModule> mShaderModules;
+        std::unordered_map<std::string, VkPipelineLayout> mPipelineLayouts;
+        std::unordered_map<uint64_t, PipelineEntry> mPipelines;
+
+        // 使用记录按完整 key 去重, 换到不支持动态状态的设备上仍然能还原所有排列
+        std::unordered_set<uint64_t> mRecordedKeyHashes;
+        std::vector<AdVKPipelineKey> mRecordedKeys;
+        bool bUsageDirty = false;
+
+        // Prewarm 的参数, 之后注册 layout 时继续预创建
+        bool bPrewarmRequested = false;
+        uint32_t mPrewarmThreadCount = 0;
+        AdParallelExecutor mPrewarmExecutor;
+    };
+}
+
+#endif
@@ -6,19 +6,112 @@
 #define AD_VK_QUEUE_H
 
 #include "AdVKCommon.h"
+#include "Concurrency/AdSpscQueue.h"
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 namespace ade{
+    class AdVKQueue;
+
+    struct AdVKSubmitRequest {
+        std::vector<VkCommandBuffer> commandBuffers;
+        std::vector<VkSemaphore> waitSemaphores;
+        std::vector<VkPipelineStageFlags> waitStages;
+        std::vector<uint64_t> waitValues;               // 为空时全部是二值信号量, 否则与 waitSemaphores 一一对应
+        std::vector<VkSemaphore> signalSemaphores;      // 二值信号量, 队列自己的时间线信号量会自动追加
+        VkFence fence = VK_NULL_HANDLE;
+    };
+
+    struct AdVKPresentRequest {
+        VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+        uint32_t imageIndex = 0;
+        std::vector<VkSemaphore> waitSemaphores;
+        // 等待的信号量由另一个队列的提交发出时填写, 保证那次提交先交给驱动
+        const AdVKQueue *signalQueue = nullptr;
+        uint64_t signalValue = 0;
+    };
+
+    /**
+     * vkQueueSubmit / vkQueuePresentKHR 可能在驱动里阻塞几毫秒(合成器、交换链满等)
+     * 开启提交线程后, Submit / Present 只把请求放入无锁队列就返回, 由提交线程按顺序交给驱动
+     * 每次 Submit 返回一个时间线值, 队列自己的时间线信号量到达该值即表示这次提交执行完毕
+     *
+     * 与 VkQueue 本身的要求一样, Submit / Present / WaitIdle 需要调用方串行调用(通常在渲染线程)
+     */
     class AdVKQueue{
     public:
-        AdVKQueue(uint32_t familyIndex, uint32_t index, VkQueue queue, bool canPresent);
-        ~AdVKQueue() = default;
+        AdVKQueue(VkDevice device, uint32_t familyIndex, uint32_t index, VkQueue queue, bool canPresent,
+                  bool bTimelineSemaphore, bool bSubmitThread);
+        ~AdVKQueue();
+
+        AdVKQueue(const AdVKQueue &) = delete;
+
+        AdVKQueue &operator=(const AdVKQueue &) = delete;
+
+        // 返回这次提交的序号, 执行完毕时时间线信号量到达该值; 设备不支持时间线信号量时只能用 fence 判断完成
+        uint64_t Submit(AdVKSubmitRequest request);
+
+        void Present(AdVKPresentRequest request);
+
+        // 最近一次呈现的结果, VK_ERROR_OUT_OF_DATE_KHR / VK_SUBOPTIMAL_KHR 时需要重建交换链
+        VkResult GetLastPresentResult() const { return mLastPresentResult.load(std::memory_order_acquire); }
+
+        // 已经交给驱动的最大时间线值
+        uint64_t GetSubmittedValue() const { return mSubmittedValue.load(std::memory_order_acquire); }
+
+        uint64_t GetCompletedValue() const;
+
+        // 超时或不支持时间线信号量时返回 false
+        bool WaitForValue(uint64_t value, uint64_t timeout = UINT64_MAX) const;
+
+        // 等待提交线程把已有请求都交给驱动
+        void Flush();
+
+        void WaitIdle();
+
+        VkQueue GetHandle() const { return mQueue; }
+
+        VkSemaphore GetTimelineSemaphore() const { return mTimelineSemaphore; }
+
+        bool IsSubmitThreadEnabled() const { return mSubmitThread.joinable(); }
 
-        void WaitIdle() const;
     private:
+        static constexpr uint32_t MAX_PENDING_REQUESTS = 64;
+
+        struct Request {
+            bool bPresent = false;
+            uint64_t value = 0;
+            AdVKSubmitRequest submit;
+            AdVKPresentRequest present;
+        };
+
+        void Enqueue(Request &&request);
+
+        void Process(Request &request);
+
+        void WaitSubmitted(uint64_t value) const;
+
+        void SubmitThreadMain();
+
+        VkDevice mDevice;
         uint32_t mFamilyIndex;
         uint32_t mIndex;
         VkQueue mQueue;
         bool canPresent;
+
+        VkSemaphore mTimelineSemaphore = VK_NULL_HANDLE;
+        uint64_t mNextValue = 0;
+        std::atomic<uint64_t> mSubmittedValue{0};
+        std::atomic<VkResult> mLastPresentResult{VK_SUCCESS};
+
+        std::unique_ptr<AdSpscQueue<Request, MAX_PENDING_REQUESTS>> mRequests;
+        std::atomic<uint32_t> mPendingCount{0};
+        mutable std::mutex mMutex;
+        mutable std::condition_variable mRequestCondition;
+        mutable std::condition_variable mSubmittedCondition;
+        bool bStop = false;
+        std::thread mSubmitThread;
     };
 }
 
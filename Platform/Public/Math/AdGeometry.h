@@ -0,0 +1,131 @@
+#ifndef AD_GEOMETRY_H
+#define AD_GEOMETRY_H
+
+#include "Math/AdMatrix.h"
+#include "Culling/AdBounds.h"
+
+namespace ade {
+
+    // 平面 dot(normal, p) + distance = 0, 法线一侧为正(与 AdFrustum 的平面约定一致)
+    struct AdPlane {
+        AdVec3 normal{0.0f, 1.0f, 0.0f};
+        float distance = 0.0f;
+
+        constexpr AdPlane() = default;
+
+        constexpr AdPlane(const AdVec3 &normal, float distance) : normal(normal), distance(distance) {}
+
+        // normal 需为单位向量
+        static constexpr AdPlane FromPointNormal(const AdVec3 &point, const AdVec3 &normal) {
+            return {normal, -Dot(normal, point)};
+        }
+
+        // 逆时针 a b c 的一侧为正
+        static AdPlane FromPoints(const AdVec3 &a, const AdVec3 &b, const AdVec3 &c) {
+            return FromPointNormal(a, Normalize(Cross(b - a, c - a)));
+        }
+
+        // 从 AdFrustum::planes 等 xyzw 数组构造
+        explicit AdPlane(const float plane[4]) : normal(plane), distance(plane[3]) {}
+
+        // 有符号距离, 法线非单位时按法线长度缩放
+        constexpr float SignedDistance(const AdVec3 &point) const { return Dot(normal, point) + distance; }
+    };
+
+    inline AdPlane Normalize(const AdPlane &plane) {
+        float length = Length(plane.normal);
+        if (length <= 0.0f) {
+            return plane;
+        }
+        float s = 1.0f / length;
+        return {plane.normal * s, plane.distance * s};
+    }
+
+    enum class AdPlaneSide : uint32_t {
+        Front,          // 完全在正侧
+        Back,           // 完全在负侧
+        Intersect,
+    };
+
+    inline AdVec3 GetCenter(const AdBoundingBox &box) {
+        return (AdVec3(box.min) + AdVec3(box.max)) * 0.5f;
+    }
+
+    inline AdVec3 GetExtent(const AdBoundingBox &box) {
+        return (AdVec3(box.max) - AdVec3(box.min)) * 0.5f;
+    }
+
+    inline AdBoundingBox MakeBoundingBox(const AdVec3 &min, const AdVec3 &max) {
+        AdBoundingBox box;
+        for (int i = 0; i < 3; i++) {
+            box.min[i] = min[i];
+            box.max[i] = max[i];
+        }
+        return box;
+    }
+
+    // 外接球
+    inline AdBoundingSphere MakeBoundingSphere(const AdBoundingBox &box) {
+        AdVec3 center = GetCenter(box);
+        return {{center.x, center.y, center.z}, Length(GetExtent(box))};
+    }
+
+    inline bool Contains(const AdBoundingBox &box, const AdVec3 &point) {
+        return point.x >= box.min[0] && point.x <= box.max[0] && point.y >= box.min[1] && point.y <= box.max[1] &&
+               point.z >= box.min[2] && point.z <= box.max[2];
+    }
+
+    inline bool Intersects(const AdBoundingBox &a, const AdBoundingBox &b) {
+        return a.min[0] <= b.max[0] && a.max[0] >= b.min[0] && a.min[1] <= b.max[1] && a.max[1] >= b.min[1] &&
+               a.min[2] <= b.max[2] && a.max[2] >= b.min[2];
+    }
+
+    inline bool Intersects(const AdBoundingSphere &a, const AdBoundingSphere &b) {
+        float radius = a.radius + b.radius;
+        return LengthSquared(AdVec3(a.center) - AdVec3(b.center)) <= radius * radius;
+    }
+
+    inline bool Intersects(const AdBoundingBox &box, const AdBoundingSphere &sphere) {
+        AdVec3 center(sphere.center);
+        AdVec3 closest = Min(Max(center, AdVec3(box.min)), AdVec3(box.max));
+        return LengthSquared(closest - center) <= sphere.radius * sphere.radius;
+    }
+
+    inline AdPlaneSide Classify(const AdPlane &plane, const AdBoundingBox &box) {
+        float distance = plane.SignedDistance(GetCenter(box));
+        float radius = Dot(Abs(plane.normal), GetExtent(box));
+        if (distance > radius) {
+            return AdPlaneSide::Front;
+        }
+        return distance < -radius ? AdPlaneSide::Back : AdPlaneSide::Intersect;
+    }
+
+    inline AdPlaneSide Classify(const AdPlane &plane, const AdBoundingSphere &sphere) {
+        float distance = plane.SignedDistance(AdVec3(sphere.center));
+        if (distance > sphere.radius) {
+            return AdPlaneSide::Front;
+        }
+        return distance < -sphere.radius ? AdPlaneSide::Back : AdPlaneSide::Intersect;
+    }
+
+    // 变换后的包围盒仍轴对齐: 中心直接变换, 半长乘以矩阵 3x3 部分的绝对值
+    inline AdBoundingBox TransformBox(const AdMat4 &m, const AdBoundingBox &box) {
+        if (!box.IsValid()) {
+            return box;
+        }
+        AdVec4 center = m * AdVec4(GetCenter(box), 1.0f);
+        AdVec3 extent = GetExtent(box);
+        AdVec4 newExtent = Abs(m.columns[0]) * extent.x + Abs(m.columns[1]) * extent.y + Abs(m.columns[2]) * extent.z;
+        return MakeBoundingBox(center.XYZ() - newExtent.XYZ(), center.XYZ() + newExtent.XYZ());
+    }
+
+    // 半径按最大的轴缩放
+    inline AdBoundingSphere TransformSphere(const AdMat4 &m, const AdBoundingSphere &sphere) {
+        AdVec3 center = TransformPoint(m, AdVec3(sphere.center));
+        float scale = std::max({LengthSquared(m.columns[0].XYZ()), LengthSquared(m.columns[1].XYZ()),
+                                LengthSquared(m.columns[2].XYZ())});
+        return {{center.x, center.y, center.z}, sphere.radius * std::sqrt(scale)};
+    }
+}
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef AD_MATH_H
+#define AD_MATH_H
+
+#include "Math/AdGeometry.h"
+
+namespace ade {
+    static constexpr float AD_PI = 3.14159265358979323846f;
+
+    constexpr float Radians(float degrees) { return degrees * (AD_PI / 180.0f); }
+
+    constexpr float Degrees(float radians) { return radians * (180.0f / AD_PI); }
+
+    template<typename T>
+    constexpr T Clamp(T value, T low, T high) { return value < low ? low : (value > high ? high : value); }
+}
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef AD_MATH_KERNELS_H
+#define AD_MATH_KERNELS_H
+
+#include "Math/AdGeometry.h"
+
+namespace ade {
+    /**
+     * 批量变换内核, 用于每帧更新大量实例(世界矩阵、MVP、包围盒)
+     * 开启 AVX 时矩阵乘法一次算两列, SoA 的点变换一次 AD_LANE_COUNT 个点; 输出可以与输入相同
+     */
+
+    // out[i] = a * b[i]
+    void MultiplyMatrices(const AdMat4 &a, const AdMat4 *b, AdMat4 *out, uint32_t count);
+
+    // out[i] = a[i] * b[i]
+    void MultiplyMatrices(const AdMat4 *a, const AdMat4 *b, AdMat4 *out, uint32_t count);
+
+    // w = 1, 不做透视除法
+    void TransformPoints(const AdMat4 &m, const AdVec3 *points, AdVec3 *out, uint32_t count);
+
+    // 坐标按 SoA 存储
+    void TransformPoints(const AdMat4 &m, const float *x, const float *y, const float *z,
+                         float *outX, float *outY, float *outZ, uint32_t count);
+
+    // out[i] = TransformBox(matrices[i], boxes[i])
+    void TransformBoxes(const AdMat4 *matrices, const AdBoundingBox *boxes, AdBoundingBox *out, uint32_t count);
+}
+
+#endif
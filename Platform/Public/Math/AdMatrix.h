@@ -0,0 +1,148 @@
+#ifndef AD_MATRIX_H
+#define AD_MATRIX_H
+
+#include "Math/AdQuaternion.h"
+
+namespace ade {
+
+    /**
+     * 4x4 矩阵, 列主序(与着色器和 GPU 数据一致), 按列向量右乘: p' = M * p
+     * 投影矩阵为右手坐标系、相机看向 -Z、深度范围 [0, 1](Vulkan), 不翻转 y
+     * 默认构造为单位矩阵
+     */
+    struct alignas(16) AdMat4 {
+        AdVec4 columns[4] = {
+            {1.0f, 0.0f, 0.0f, 0.0f},
+            {0.0f, 1.0f, 0.0f, 0.0f},
+            {0.0f, 0.0f, 1.0f, 0.0f},
+            {0.0f, 0.0f, 0.0f, 1.0f}
+        };
+
+        constexpr AdMat4() = default;
+
+        constexpr AdMat4(const AdVec4 &c0, const AdVec4 &c1, const AdVec4 &c2, const AdVec4 &c3)
+            : columns{c0, c1, c2, c3} {}
+
+        // data 为列主序的 16 个 float
+        explicit AdMat4(const float data[16])
+            : columns{AdVec4(data), AdVec4(data + 4), AdVec4(data + 8), AdVec4(data + 12)} {}
+
+        static constexpr AdMat4 Identity() { return {}; }
+
+        static constexpr AdMat4 Translation(const AdVec3 &t) {
+            return {{1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f, 0.0f}, {t, 1.0f}};
+        }
+
+        static constexpr AdMat4 Scale(const AdVec3 &s) {
+            return {{s.x, 0.0f, 0.0f, 0.0f}, {0.0f, s.y, 0.0f, 0.0f}, {0.0f, 0.0f, s.z, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f}};
+        }
+
+        // q 需为单位四元数
+        static constexpr AdMat4 Rotation(const AdQuat &q) {
+            return TRS({}, q, AdVec3(1.0f));
+        }
+
+        // 等价于 Translation(t) * Rotation(r) * Scale(s)
+        static constexpr AdMat4 TRS(const AdVec3 &t, const AdQuat &r, const AdVec3 &s) {
+            float xx = r.x * r.x, yy = r.y * r.y, zz = r.z * r.z;
+            float xy = r.x * r.y, xz = r.x * r.z, yz = r.y * r.z;
+            float wx = r.w * r.x, wy = r.w * r.y, wz = r.w * r.z;
+            return {
+                {(1.0f - 2.0f * (yy + zz)) * s.x, 2.0f * (xy + wz) * s.x, 2.0f * (xz - wy) * s.x, 0.0f},
+                {2.0f * (xy - wz) * s.y, (1.0f - 2.0f * (xx + zz)) * s.y, 2.0f * (yz + wx) * s.y, 0.0f},
+                {2.0f * (xz + wy) * s.z, 2.0f * (yz - wx) * s.z, (1.0f - 2.0f * (xx + yy)) * s.z, 0.0f},
+                {t, 1.0f}
+            };
+        }
+
+        // 观察矩阵, 相机看向 target, up 不能与视线平行
+        static AdMat4 LookAt(const AdVec3 &eye, const AdVec3 &target, const AdVec3 &up);
+
+        /**
+         * @param fovY      垂直视角, 弧度
+         * @param zFar      为 0 时为无限远平面
+         */
+        static AdMat4 Perspective(float fovY, float aspect, float zNear, float zFar);
+
+        static AdMat4 Orthographic(float left, float right, float bottom, float top, float zNear, float zFar);
+
+        const float *Data() const { return columns[0].Data(); }
+
+        float *Data() { return columns[0].Data(); }
+
+        // m(row, column)
+        float operator()(int row, int column) const { return columns[column][row]; }
+
+        float &operator()(int row, int column) { return columns[column][row]; }
+    };
+
+#ifdef AD_MATH_SSE
+    // 一列: a 的 4 列按 v 的 4 个分量加权求和
+    inline __m128 MultiplyColumn(const AdMat4 &a, __m128 v) {
+        __m128 result = _mm_mul_ps(a.columns[0].Load(), _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+        result = _mm_add_ps(result, _mm_mul_ps(a.columns[1].Load(), _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+        result = _mm_add_ps(result, _mm_mul_ps(a.columns[2].Load(), _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+        return _mm_add_ps(result, _mm_mul_ps(a.columns[3].Load(), _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+    }
+
+    inline AdVec4 operator*(const AdMat4 &m, const AdVec4 &v) { return AdVec4(MultiplyColumn(m, v.Load())); }
+
+    inline AdMat4 operator*(const AdMat4 &a, const AdMat4 &b) {
+        AdMat4 result;
+        for (int i = 0; i < 4; i++) {
+            result.columns[i] = AdVec4(MultiplyColumn(a, b.columns[i].Load()));
+        }
+        return result;
+    }
+
+    inline AdMat4 Transpose(const AdMat4 &m) {
+        __m128 c0 = m.columns[0].Load(), c1 = m.columns[1].Load(), c2 = m.columns[2].Load(), c3 = m.columns[3].Load();
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        return {AdVec4(c0), AdVec4(c1), AdVec4(c2), AdVec4(c3)};
+    }
+#else
+    inline AdVec4 operator*(const AdMat4 &m, const AdVec4 &v) {
+        return m.columns[0] * v.x + m.columns[1] * v.y + m.columns[2] * v.z + m.columns[3] * v.w;
+    }
+
+    inline AdMat4 operator*(const AdMat4 &a, const AdMat4 &b) {
+        AdMat4 result;
+        for (int i = 0; i < 4; i++) {
+            result.columns[i] = a * b.columns[i];
+        }
+        return result;
+    }
+
+    inline AdMat4 Transpose(const AdMat4 &m) {
+        AdMat4 result;
+        for (int c = 0; c < 4; c++) {
+            for (int r = 0; r < 4; r++) {
+                result.columns[c][r] = m.columns[r][c];
+            }
+        }
+        return result;
+    }
+#endif
+
+    inline AdMat4 &operator*=(AdMat4 &a, const AdMat4 &b) { return a = a * b; }
+
+    // w = 1, 不做透视除法
+    inline AdVec3 TransformPoint(const AdMat4 &m, const AdVec3 &p) { return (m * AdVec4(p, 1.0f)).XYZ(); }
+
+    // w = 0, 只受旋转和缩放影响
+    inline AdVec3 TransformVector(const AdMat4 &m, const AdVec3 &v) { return (m * AdVec4(v, 0.0f)).XYZ(); }
+
+    // 变换到裁剪空间后做透视除法
+    inline AdVec3 ProjectPoint(const AdMat4 &m, const AdVec3 &p) {
+        AdVec4 clip = m * AdVec4(p, 1.0f);
+        return clip.XYZ() / clip.w;
+    }
+
+    // 一般矩阵求逆, 不可逆时返回单位矩阵
+    AdMat4 Inverse(const AdMat4 &m);
+
+    // 仿射矩阵(最后一行为 0 0 0 1)求逆, 比 Inverse 快
+    AdMat4 InverseAffine(const AdMat4 &m);
+}
+
+#endif
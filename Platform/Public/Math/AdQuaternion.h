@@ -0,0 +1,121 @@
+#ifndef AD_QUATERNION_H
+#define AD_QUATERNION_H
+
+#include "Math/AdVector.h"
+
+namespace ade {
+
+    // 单位四元数表示旋转, 存储顺序 xyzw(与 AdLocalTransform 一致), 默认为单位旋转
+    struct alignas(16) AdQuat {
+        float x = 0.0f;
+        float y = 0.0f;
+        float z = 0.0f;
+        float w = 1.0f;
+
+        constexpr AdQuat() = default;
+
+        constexpr AdQuat(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+
+        explicit AdQuat(const float data[4]) : x(data[0]), y(data[1]), z(data[2]), w(data[3]) {}
+
+        // axis 需为单位向量, angle 为弧度
+        static AdQuat FromAxisAngle(const AdVec3 &axis, float angle) {
+            float s = std::sin(angle * 0.5f);
+            return {axis.x * s, axis.y * s, axis.z * s, std::cos(angle * 0.5f)};
+        }
+
+        const float *Data() const { return &x; }
+
+        float *Data() { return &x; }
+
+#ifdef AD_MATH_SSE
+        explicit AdQuat(__m128 value) { _mm_store_ps(&x, value); }
+
+        __m128 Load() const { return _mm_load_ps(&x); }
+#endif
+    };
+
+    constexpr AdQuat Conjugate(const AdQuat &q) { return {-q.x, -q.y, -q.z, q.w}; }
+
+    constexpr float Dot(const AdQuat &a, const AdQuat &b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+
+    // a * b: 先做 b 的旋转, 再做 a 的旋转
+#ifdef AD_MATH_SSE
+    inline AdQuat operator*(const AdQuat &a, const AdQuat &b) {
+        __m128 qa = a.Load();
+        __m128 qb = b.Load();
+        __m128 result = _mm_mul_ps(_mm_shuffle_ps(qa, qa, _MM_SHUFFLE(3, 3, 3, 3)), qb);
+        // 按 a 的 x/y/z 分量展开, 每项为 b 的一个重排加上符号
+        __m128 termX = _mm_mul_ps(_mm_shuffle_ps(qa, qa, _MM_SHUFFLE(0, 0, 0, 0)),
+                                  _mm_shuffle_ps(qb, qb, _MM_SHUFFLE(0, 1, 2, 3)));
+        __m128 termY = _mm_mul_ps(_mm_shuffle_ps(qa, qa, _MM_SHUFFLE(1, 1, 1, 1)),
+                                  _mm_shuffle_ps(qb, qb, _MM_SHUFFLE(1, 0, 3, 2)));
+        __m128 termZ = _mm_mul_ps(_mm_shuffle_ps(qa, qa, _MM_SHUFFLE(2, 2, 2, 2)),
+                                  _mm_shuffle_ps(qb, qb, _MM_SHUFFLE(2, 3, 0, 1)));
+        result = _mm_add_ps(result, _mm_xor_ps(termX, _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f)));
+        result = _mm_add_ps(result, _mm_xor_ps(termY, _mm_setr_ps(0.0f, 0.0f, -0.0f, -0.0f)));
+        result = _mm_add_ps(result, _mm_xor_ps(termZ, _mm_setr_ps(-0.0f, 0.0f, 0.0f, -0.0f)));
+        return AdQuat(result);
+    }
+#else
+    inline AdQuat operator*(const AdQuat &a, const AdQuat &b) {
+        return {
+            a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+            a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+            a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+            a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z
+        };
+    }
+#endif
+
+    inline AdQuat &operator*=(AdQuat &a, const AdQuat &b) { return a = a * b; }
+
+    inline AdQuat Normalize(const AdQuat &q) {
+        float length = std::sqrt(Dot(q, q));
+        if (length <= 0.0f) {
+            return {};
+        }
+        float s = 1.0f / length;
+        return {q.x * s, q.y * s, q.z * s, q.w * s};
+    }
+
+    inline AdQuat Inverse(const AdQuat &q) {
+        float lengthSquared = Dot(q, q);
+        if (lengthSquared <= 0.0f) {
+            return {};
+        }
+        float s = 1.0f / lengthSquared;
+        return {-q.x * s, -q.y * s, -q.z * s, q.w * s};
+    }
+
+    // q 需为单位四元数: v + 2w(u x v) + 2u x (u x v)
+    inline AdVec3 Rotate(const AdQuat &q, const AdVec3 &v) {
+        AdVec3 u(q.x, q.y, q.z);
+        AdVec3 t = Cross(u, v) * 2.0f;
+        return v + t * q.w + Cross(u, t);
+    }
+
+    // 球面插值, 走较短的一侧; 夹角很小时退化为归一化的线性插值
+    inline AdQuat Slerp(const AdQuat &a, const AdQuat &b, float t) {
+        float cosTheta = Dot(a, b);
+        AdQuat target = b;
+        if (cosTheta < 0.0f) {
+            cosTheta = -cosTheta;
+            target = {-b.x, -b.y, -b.z, -b.w};
+        }
+        float wa, wb;
+        if (cosTheta > 0.9995f) {
+            wa = 1.0f - t;
+            wb = t;
+        } else {
+            float theta = std::acos(cosTheta);
+            float invSin = 1.0f / std::sin(theta);
+            wa = std::sin((1.0f - t) * theta) * invSin;
+            wb = std::sin(t * theta) * invSin;
+        }
+        return Normalize(AdQuat(a.x * wa + target.x * wb, a.y * wa + target.y * wb, a.z * wa + target.z * wb,
+                                a.w * wa + target.w * wb));
+    }
+}
+
+#endif
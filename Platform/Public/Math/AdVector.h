@@ -0,0 +1,209 @@
+#ifndef AD_VECTOR_H
+#define AD_VECTOR_H
+
+#include "AdEngine.h"
+#include <cmath>
+
+// AdVec4 / AdMat4 / AdQuat 的 SSE 实现, 其他平台用标量实现
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AD_MATH_SSE
+#endif
+
+namespace ade {
+
+    /**
+     * 三维向量, 紧凑存放(12 字节), 用于顶点、包围盒等存储; 运算为标量
+     * 需要 SIMD 的批量运算见 AdMathKernels.h
+     */
+    struct AdVec3 {
+        float x = 0.0f;
+        float y = 0.0f;
+        float z = 0.0f;
+
+        constexpr AdVec3() = default;
+
+        constexpr explicit AdVec3(float value) : x(value), y(value), z(value) {}
+
+        constexpr AdVec3(float x, float y, float z) : x(x), y(y), z(z) {}
+
+        explicit AdVec3(const float data[3]) : x(data[0]), y(data[1]), z(data[2]) {}
+
+        const float *Data() const { return &x; }
+
+        float *Data() { return &x; }
+
+        float operator[](int i) const { return (&x)[i]; }
+
+        float &operator[](int i) { return (&x)[i]; }
+    };
+
+    constexpr AdVec3 operator+(const AdVec3 &a, const AdVec3 &b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+
+    constexpr AdVec3 operator-(const AdVec3 &a, const AdVec3 &b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+
+    constexpr AdVec3 operator-(const AdVec3 &a) { return {-a.x, -a.y, -a.z}; }
+
+    constexpr AdVec3 operator*(const AdVec3 &a, const AdVec3 &b) { return {a.x * b.x, a.y * b.y, a.z * b.z}; }
+
+    constexpr AdVec3 operator*(const AdVec3 &a, float s) { return {a.x * s, a.y * s, a.z * s}; }
+
+    constexpr AdVec3 operator*(float s, const AdVec3 &a) { return {a.x * s, a.y * s, a.z * s}; }
+
+    constexpr AdVec3 operator/(const AdVec3 &a, float s) { return {a.x / s, a.y / s, a.z / s}; }
+
+    inline AdVec3 &operator+=(AdVec3 &a, const AdVec3 &b) { return a = a + b; }
+
+    inline AdVec3 &operator-=(AdVec3 &a, const AdVec3 &b) { return a = a - b; }
+
+    inline AdVec3 &operator*=(AdVec3 &a, float s) { return a = a * s; }
+
+    constexpr bool operator==(const AdVec3 &a, const AdVec3 &b) { return a.x == b.x && a.y == b.y && a.z == b.z; }
+
+    constexpr bool operator!=(const AdVec3 &a, const AdVec3 &b) { return !(a == b); }
+
+    constexpr float Dot(const AdVec3 &a, const AdVec3 &b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+    constexpr AdVec3 Cross(const AdVec3 &a, const AdVec3 &b) {
+        return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+    }
+
+    constexpr float LengthSquared(const AdVec3 &a) { return Dot(a, a); }
+
+    inline float Length(const AdVec3 &a) { return std::sqrt(Dot(a, a)); }
+
+    // 长度为 0 时返回零向量
+    inline AdVec3 Normalize(const AdVec3 &a) {
+        float length = Length(a);
+        return length > 0.0f ? a * (1.0f / length) : AdVec3();
+    }
+
+    inline AdVec3 Min(const AdVec3 &a, const AdVec3 &b) {
+        return {std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z)};
+    }
+
+    inline AdVec3 Max(const AdVec3 &a, const AdVec3 &b) {
+        return {std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z)};
+    }
+
+    inline AdVec3 Abs(const AdVec3 &a) { return {std::fabs(a.x), std::fabs(a.y), std::fabs(a.z)}; }
+
+    constexpr AdVec3 Lerp(const AdVec3 &a, const AdVec3 &b, float t) { return a + (b - a) * t; }
+
+    /**
+     * 四维向量, 16 字节对齐, 运算用 SSE
+     * 成员保持普通的 float, 构造可以是 constexpr; 运算时按对齐地址整体读写, 内联后编译器会留在寄存器中
+     */
+    struct alignas(16) AdVec4 {
+        float x = 0.0f;
+        float y = 0.0f;
+        float z = 0.0f;
+        float w = 0.0f;
+
+        constexpr AdVec4() = default;
+
+        constexpr explicit AdVec4(float value) : x(value), y(value), z(value), w(value) {}
+
+        constexpr AdVec4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+
+        constexpr AdVec4(const AdVec3 &v, float w) : x(v.x), y(v.y), z(v.z), w(w) {}
+
+        explicit AdVec4(const float data[4]) : x(data[0]), y(data[1]), z(data[2]), w(data[3]) {}
+
+        constexpr AdVec3 XYZ() const { return {x, y, z}; }
+
+        const float *Data() const { return &x; }
+
+        float *Data() { return &x; }
+
+        float operator[](int i) const { return (&x)[i]; }
+
+        float &operator[](int i) { return (&x)[i]; }
+
+#ifdef AD_MATH_SSE
+        explicit AdVec4(__m128 value) { _mm_store_ps(&x, value); }
+
+        __m128 Load() const { return _mm_load_ps(&x); }
+#endif
+    };
+
+#ifdef AD_MATH_SSE
+    inline AdVec4 operator+(const AdVec4 &a, const AdVec4 &b) { return AdVec4(_mm_add_ps(a.Load(), b.Load())); }
+
+    inline AdVec4 operator-(const AdVec4 &a, const AdVec4 &b) { return AdVec4(_mm_sub_ps(a.Load(), b.Load())); }
+
+    inline AdVec4 operator-(const AdVec4 &a) { return AdVec4(_mm_sub_ps(_mm_setzero_ps(), a.Load())); }
+
+    inline AdVec4 operator*(const AdVec4 &a, const AdVec4 &b) { return AdVec4(_mm_mul_ps(a.Load(), b.Load())); }
+
+    inline AdVec4 operator*(const AdVec4 &a, float s) { return AdVec4(_mm_mul_ps(a.Load(), _mm_set1_ps(s))); }
+
+    inline AdVec4 operator/(const AdVec4 &a, float s) { return AdVec4(_mm_div_ps(a.Load(), _mm_set1_ps(s))); }
+
+    inline AdVec4 Min(const AdVec4 &a, const AdVec4 &b) { return AdVec4(_mm_min_ps(a.Load(), b.Load())); }
+
+    inline AdVec4 Max(const AdVec4 &a, const AdVec4 &b) { return AdVec4(_mm_max_ps(a.Load(), b.Load())); }
+
+    inline AdVec4 Abs(const AdVec4 &a) {
+        return AdVec4(_mm_andnot_ps(_mm_set1_ps(-0.0f), a.Load()));
+    }
+
+    // 结果广播到 4 路, 只用 SSE2 的洗牌
+    inline __m128 Dot4(__m128 a, __m128 b) {
+        __m128 product = _mm_mul_ps(a, b);
+        __m128 sum = _mm_add_ps(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_add_ps(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    }
+
+    inline float Dot(const AdVec4 &a, const AdVec4 &b) { return _mm_cvtss_f32(Dot4(a.Load(), b.Load())); }
+#else
+    inline AdVec4 operator+(const AdVec4 &a, const AdVec4 &b) { return {a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w}; }
+
+    inline AdVec4 operator-(const AdVec4 &a, const AdVec4 &b) { return {a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w}; }
+
+    inline AdVec4 operator-(const AdVec4 &a) { return {-a.x, -a.y, -a.z, -a.w}; }
+
+    inline AdVec4 operator*(const AdVec4 &a, const AdVec4 &b) { return {a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w}; }
+
+    inline AdVec4 operator*(const AdVec4 &a, float s) { return {a.x * s, a.y * s, a.z * s, a.w * s}; }
+
+    inline AdVec4 operator/(const AdVec4 &a, float s) { return {a.x / s, a.y / s, a.z / s, a.w / s}; }
+
+    inline AdVec4 Min(const AdVec4 &a, const AdVec4 &b) {
+        return {std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z), std::min(a.w, b.w)};
+    }
+
+    inline AdVec4 Max(const AdVec4 &a, const AdVec4 &b) {
+        return {std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z), std::max(a.w, b.w)};
+    }
+
+    inline AdVec4 Abs(const AdVec4 &a) { return {std::fabs(a.x), std::fabs(a.y), std::fabs(a.z), std::fabs(a.w)}; }
+
+    inline float Dot(const AdVec4 &a, const AdVec4 &b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+#endif
+
+    inline AdVec4 operator*(float s, const AdVec4 &a) { return a * s; }
+
+    inline AdVec4 &operator+=(AdVec4 &a, const AdVec4 &b) { return a = a + b; }
+
+    inline AdVec4 &operator-=(AdVec4 &a, const AdVec4 &b) { return a = a - b; }
+
+    inline AdVec4 &operator*=(AdVec4 &a, float s) { return a = a * s; }
+
+    constexpr bool operator==(const AdVec4 &a, const AdVec4 &b) {
+        return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
+    }
+
+    constexpr bool operator!=(const AdVec4 &a, const AdVec4 &b) { return !(a == b); }
+
+    inline float Length(const AdVec4 &a) { return std::sqrt(Dot(a, a)); }
+
+    inline AdVec4 Normalize(const AdVec4 &a) {
+        float length = Length(a);
+        return length > 0.0f ? a * (1.0f / length) : AdVec4();
+    }
+
+    inline AdVec4 Lerp(const AdVec4 &a, const AdVec4 &b, float t) { return a + (b - a) * t; }
+}
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef AD_ALIGN_H
+#define AD_ALIGN_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace ade {
+    // alignment 必须是 2 的幂
+    constexpr bool IsPowerOfTwo(size_t value) {
+        return value != 0 && (value & (value - 1)) == 0;
+    }
+
+    // 向上取整到 alignment 的倍数, 用于地址和偏移
+    inline uintptr_t AlignUp(uintptr_t value, size_t alignment) {
+        assert(IsPowerOfTwo(alignment));
+        return (value + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    }
+}
+
+#endif
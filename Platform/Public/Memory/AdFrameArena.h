@@ -0,0 +1,56 @@
+#ifndef AD_FRAME_ARENA_H
+#define AD_FRAME_ARENA_H
+
+#include "Memory/AdLinearAllocator.h"
+#include <atomic>
+#include <mutex>
+
+namespace ade {
+    /**
+     * 一帧内多个线程共用的线性内存, 每个在途帧一个, 该帧用完后 Reset
+     * Allocate 用 CAS 移动偏移, 无锁; 超出容量时退回加锁的溢出块, 下次 Reset 把容量扩大到峰值,
+     * 稳定运行后每帧不再向堆申请
+     */
+    class AdFrameArena {
+    public:
+        explicit AdFrameArena(size_t capacity = 1024 * 1024);
+
+        ~AdFrameArena();
+
+        AdFrameArena(const AdFrameArena &) = delete;
+
+        AdFrameArena &operator=(const AdFrameArena &) = delete;
+
+        // 线程安全, alignment 需为 2 的幂
+        void *Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+        template<typename T>
+        T *AllocateArray(size_t count) {
+            return static_cast<T *>(Allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        // 不能与 Allocate 并发
+        void Reset();
+
+        size_t GetCapacity() const { return mCapacity; }
+
+        size_t GetUsedSize() const {
+            return std::min(mOffset.load(std::memory_order_relaxed), mCapacity) + mOverflowSize;
+        }
+
+        // 最近一次 Reset 前的使用量
+        size_t GetLastFrameSize() const { return mLastFrameSize; }
+
+    private:
+        uint8_t *mData = nullptr;
+        size_t mCapacity;
+        std::atomic<size_t> mOffset{0};
+        size_t mLastFrameSize = 0;
+
+        std::mutex mOverflowMutex;
+        AdLinearAllocator mOverflow;
+        size_t mOverflowSize = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef AD_LINEAR_ALLOCATOR_H
+#define AD_LINEAR_ALLOCATOR_H
+
+#include "AdEngine.h"
+#include <cstddef>
+
+namespace ade {
+    /**
+     * 线性(栈式)分配器: 只移动偏移, 不单独释放, Reset / Rewind 一次性回收
+     * 内存按块申请, 当前块放不下时换到下一块; Reset 后保留所有块, 达到峰值后不再向堆申请
+     * 不是线程安全的, 多线程共享的每帧内存用 AdFrameArena
+     */
+    class AdLinearAllocator {
+    public:
+        static constexpr size_t BLOCK_ALIGNMENT = 64;
+
+        struct Marker {
+            uint32_t block;
+            size_t offset;
+        };
+
+        explicit AdLinearAllocator(size_t blockSize = 64 * 1024);
+
+        ~AdLinearAllocator();
+
+        AdLinearAllocator(const AdLinearAllocator &) = delete;
+
+        AdLinearAllocator &operator=(const AdLinearAllocator &) = delete;
+
+        // alignment 需为 2 的幂
+        void *Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+        template<typename T>
+        T *AllocateArray(size_t count) {
+            return static_cast<T *>(Allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        // 不会调用析构函数, 只用于可平凡析构的类型
+        template<typename T, typename... Args>
+        T *New(Args &&... args) {
+            static_assert(std::is_trivially_destructible<T>::value, "Linear allocator never runs destructors");
+            return new(Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+
+        Marker GetMarker() const { return {mCurrentBlock, mOffset}; }
+
+        // 回收 marker 之后的所有分配
+        void Rewind(const Marker &marker);
+
+        void Reset() { Rewind({0, 0}); }
+
+        // 回收并把所有块还给堆
+        void Release();
+
+        // 包含对齐和换块浪费的部分
+        size_t GetUsedSize() const;
+
+        size_t GetCapacity() const;
+
+        // 当前线程的临时内存, 配合 AdScratchScope 使用
+        static AdLinearAllocator &GetThreadScratch();
+
+    private:
+        struct Block {
+            uint8_t *data;
+            size_t size;
+        };
+
+        size_t mBlockSize;
+        std::vector<Block> mBlocks;
+        uint32_t mCurrentBlock = 0;
+        size_t mOffset = 0;
+    };
+
+    /**
+     * 作用域内从线程临时内存分配, 离开作用域时全部回收; 可以嵌套
+     * 分配出的内存不能离开作用域, 也不能交给其他线程长期持有
+     */
+    class AdScratchScope {
+    public:
+        AdScratchScope() : mAllocator(AdLinearAllocator::GetThreadScratch()), mMarker(mAllocator.GetMarker()) {}
+
+        ~AdScratchScope() { mAllocator.Rewind(mMarker); }
+
+        AdScratchScope(const AdScratchScope &) = delete;
+
+        AdScratchScope &operator=(const AdScratchScope &) = delete;
+
+        AdLinearAllocator &GetAllocator() { return mAllocator; }
+
+        void *Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+            return mAllocator.Allocate(size, alignment);
+        }
+
+        template<typename T>
+        T *AllocateArray(size_t count) { return mAllocator.AllocateArray<T>(count); }
+
+    private:
+        AdLinearAllocator &mAllocator;
+        AdLinearAllocator::Marker mMarker;
+    };
+}
+
+#endif
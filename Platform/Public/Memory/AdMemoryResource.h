@@ -0,0 +1,82 @@
+#ifndef AD_MEMORY_RESOURCE_H
+#define AD_MEMORY_RESOURCE_H
+
+#include "Memory/AdLinearAllocator.h"
+#include "Memory/AdFrameArena.h"
+#include "Memory/AdPoolAllocator.h"
+
+// 较旧的 libc++(Xcode 14 及以前)没有 <memory_resource>
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define AD_ENGINE_HAS_PMR 1
+#endif
+
+#ifdef AD_ENGINE_HAS_PMR
+namespace ade {
+    /**
+     * 把引擎的分配器接到 std::pmr, STL 容器可以直接使用:
+     *   AdFrameResource resource(frame.GetArena());
+     *   std::pmr::vector<uint32_t> visible(&resource);
+     * 线性分配器和每帧内存不单独释放, 容器析构或扩容时旧内存要等 Reset 才回收
+     */
+    class AdLinearResource : public std::pmr::memory_resource {
+    public:
+        explicit AdLinearResource(AdLinearAllocator &allocator) : mAllocator(allocator) {}
+
+    private:
+        void *do_allocate(size_t bytes, size_t alignment) override { return mAllocator.Allocate(bytes, alignment); }
+
+        void do_deallocate(void *, size_t, size_t) override {}
+
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+        AdLinearAllocator &mAllocator;
+    };
+
+    class AdFrameResource : public std::pmr::memory_resource {
+    public:
+        explicit AdFrameResource(AdFrameArena &arena) : mArena(arena) {}
+
+    private:
+        void *do_allocate(size_t bytes, size_t alignment) override { return mArena.Allocate(bytes, alignment); }
+
+        void do_deallocate(void *, size_t, size_t) override {}
+
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+        AdFrameArena &mArena;
+    };
+
+    // 不超过块大小的分配走池, 其他交给 upstream; 适合 std::pmr::list / map 等按节点分配的容器
+    class AdPoolResource : public std::pmr::memory_resource {
+    public:
+        explicit AdPoolResource(AdPoolAllocator &pool,
+                                std::pmr::memory_resource *upstream = std::pmr::get_default_resource())
+                : mPool(pool), mUpstream(upstream) {}
+
+    private:
+        bool IsPooled(size_t bytes, size_t alignment) const {
+            return bytes <= mPool.GetBlockSize() && alignment <= mPool.GetAlignment();
+        }
+
+        void *do_allocate(size_t bytes, size_t alignment) override {
+            return IsPooled(bytes, alignment) ? mPool.Allocate() : mUpstream->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *ptr, size_t bytes, size_t alignment) override {
+            if (IsPooled(bytes, alignment)) {
+                mPool.Free(ptr);
+            } else {
+                mUpstream->deallocate(ptr, bytes, alignment);
+            }
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+        AdPoolAllocator &mPool;
+        std::pmr::memory_resource *mUpstream;
+    };
+}
+#endif
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef AD_MEMORY_TRACKER_H
+#define AD_MEMORY_TRACKER_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace ade {
+    // 堆分配归属的子系统, 由当前线程的 AdMemoryTagScope 决定
+    enum class AdMemoryTag : uint8_t {
+        General,
+        Renderer,
+        Assets,
+        Scene,
+        Logging,
+        Count,
+    };
+
+    struct AdMemoryTagStats {
+        uint64_t allocCount = 0;        // 累计
+        uint64_t allocBytes = 0;        // 累计
+        uint64_t liveCount = 0;
+        uint64_t liveBytes = 0;
+        uint64_t peakBytes = 0;
+        uint64_t frameAllocCount = 0;   // 最近一次 EndFrame 统计的一帧
+        uint64_t frameAllocBytes = 0;
+    };
+
+    struct AdMemoryBudget {
+        uint64_t maxAllocsPerFrame = UINT64_MAX;
+        uint64_t maxBytesPerFrame = UINT64_MAX;
+    };
+
+    struct AdMemoryTrackerSettings {
+        uint32_t reportInterval = 0;    // 每隔多少帧输出一次汇总, 0 不输出
+        bool bAbortOnViolation = false; // 超出预算或在 AdNoAllocScope 中分配时 std::abort, Release 下同样生效, 用于让测试失败
+        AdMemoryBudget budgets[static_cast<uint32_t>(AdMemoryTag::Count)];
+    };
+
+    /**
+     * 堆分配统计, 只在定义 AD_ENGINE_MEMORY_TRACKING(CMake 选项)时生效:
+     * 替换全局 operator new / delete, 每块前面放一个小头部记录大小和标签, 计数全部是原子操作, 统计本身不分配
+     * 未开启时所有接口都是空实现, 标签作用域也没有开销
+     *
+     * EndFrame 由 AdApplication 在每帧末尾调用, 统计这一帧的分配次数和字节数并检查预算
+     * 超出预算和 AdNoAllocScope 中的分配都计为一次违规, 可以用 GetViolationCount 检查
+     */
+    class AdMemoryTracker {
+    public:
+        AdMemoryTracker() = delete;
+
+#ifdef AD_ENGINE_MEMORY_TRACKING
+        static constexpr bool ENABLED = true;
+
+        static void Configure(const AdMemoryTrackerSettings &settings);
+
+        static void EndFrame(uint64_t frameIndex);
+
+        static AdMemoryTagStats GetStats(AdMemoryTag tag);
+
+        static const char *GetTagName(AdMemoryTag tag);
+
+        // 累计的违规次数
+        static uint64_t GetViolationCount();
+
+        // 输出所有标签的汇总
+        static void Report();
+
+        // 供 operator new / delete 调用
+        static void OnAllocate(size_t size, AdMemoryTag tag);
+
+        static void OnFree(size_t size, AdMemoryTag tag);
+#else
+        static constexpr bool ENABLED = false;
+
+        static void Configure(const AdMemoryTrackerSettings &) {}
+
+        static void EndFrame(uint64_t) {}
+
+        static AdMemoryTagStats GetStats(AdMemoryTag) { return {}; }
+
+        static const char *GetTagName(AdMemoryTag) { return ""; }
+
+        static uint64_t GetViolationCount() { return 0; }
+
+        static void Report() {}
+#endif
+    };
+
+#ifdef AD_ENGINE_MEMORY_TRACKING
+    // 作用域内当前线程的分配归属到 tag, 可以嵌套
+    class AdMemoryTagScope {
+    public:
+        explicit AdMemoryTagScope(AdMemoryTag tag);
+
+        ~AdMemoryTagScope();
+
+        AdMemoryTagScope(const AdMemoryTagScope &) = delete;
+
+        AdMemoryTagScope &operator=(const AdMemoryTagScope &) = delete;
+
+        static AdMemoryTag GetCurrent();
+
+    private:
+        AdMemoryTag mPrevious;
+    };
+
+    // 作用域内当前线程不应该有堆分配(稳定状态的帧路径), 违反时报错
+    class AdNoAllocScope {
+    public:
+        explicit AdNoAllocScope(const char *name);
+
+        ~AdNoAllocScope();
+
+        AdNoAllocScope(const AdNoAllocScope &) = delete;
+
+        AdNoAllocScope &operator=(const AdNoAllocScope &) = delete;
+
+    private:
+        const char *mName;
+        uint64_t mStartCount;
+    };
+#else
+    class AdMemoryTagScope {
+    public:
+        explicit AdMemoryTagScope(AdMemoryTag) {}
+
+        static AdMemoryTag GetCurrent() { return AdMemoryTag::General; }
+    };
+
+    class AdNoAllocScope {
+    public:
+        explicit AdNoAllocScope(const char *) {}
+    };
+#endif
+}
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef AD_POOL_ALLOCATOR_H
+#define AD_POOL_ALLOCATOR_H
+
+#include "AdEngine.h"
+#include <cstddef>
+
+namespace ade {
+    /**
+     * 固定大小块的池: 按页申请, 空闲块串成侵入式链表, 分配和释放都是 O(1)
+     * 页只在析构时归还, 达到峰值后不再向堆申请; 不是线程安全的, 多线程共享用 AdConcurrentHandlePool
+     */
+    class AdPoolAllocator {
+    public:
+        AdPoolAllocator(size_t blockSize, size_t alignment = alignof(std::max_align_t), uint32_t blocksPerPage = 256);
+
+        ~AdPoolAllocator();
+
+        AdPoolAllocator(const AdPoolAllocator &) = delete;
+
+        AdPoolAllocator &operator=(const AdPoolAllocator &) = delete;
+
+        // 需要新页而堆内存不足时抛出 std::bad_alloc, 池保持原状
+        void *Allocate();
+
+        // ptr 必须来自这个池
+        void Free(void *ptr);
+
+        size_t GetBlockSize() const { return mBlockSize; }
+
+        size_t GetAlignment() const { return mAlignment; }
+
+        uint32_t GetAllocatedCount() const { return mAllocatedCount; }
+
+        uint32_t GetCapacity() const { return static_cast<uint32_t>(mPages.size()) * mBlocksPerPage; }
+
+    private:
+        void AllocatePage();
+
+        size_t mBlockSize;
+        size_t mAlignment;
+        uint32_t mBlocksPerPage;
+        std::vector<uint8_t *> mPages;
+        void *mFreeList = nullptr;
+        uint32_t mAllocatedCount = 0;
+    };
+
+    // 引擎对象的类型化池, 调用方负责每个对象都 Delete
+    template<typename T>
+    class AdObjectPool {
+    public:
+        explicit AdObjectPool(uint32_t objectsPerPage = 256) : mAllocator(sizeof(T), alignof(T), objectsPerPage) {}
+
+        AdObjectPool(const AdObjectPool &) = delete;
+
+        AdObjectPool &operator=(const AdObjectPool &) = delete;
+
+        template<typename... Args>
+        T *New(Args &&... args) {
+            return new(mAllocator.Allocate()) T(std::forward<Args>(args)...);
+        }
+
+        void Delete(T *object) {
+            if (object) {
+                object->~T();
+                mAllocator.Free(object);
+            }
+        }
+
+        uint32_t GetCount() const { return mAllocator.GetAllocatedCount(); }
+
+    private:
+        AdPoolAllocator mAllocator;
+    };
+}
+
+#endif
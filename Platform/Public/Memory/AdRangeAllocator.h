@@ -0,0 +1,39 @@
+#ifndef AD_RANGE_ALLOCATOR_H
+#define AD_RANGE_ALLOCATOR_H
+
+#include "AdEngine.h"
+#include <map>
+
+namespace ade {
+    /**
+     * 在一段连续区间上做子分配(只记录偏移, 不持有内存), 用于把大缓冲切给多个网格
+     * 空闲块按偏移排序, 首次适配, 释放时与相邻空闲块合并
+     */
+    class AdRangeAllocator {
+    public:
+        static constexpr uint64_t INVALID_OFFSET = UINT64_MAX;
+
+        explicit AdRangeAllocator(uint64_t capacity = 0) { Reset(capacity); }
+
+        void Reset(uint64_t capacity);
+
+        // 失败返回 INVALID_OFFSET
+        uint64_t Allocate(uint64_t size, uint64_t alignment = 1);
+
+        void Free(uint64_t offset, uint64_t size);
+
+        uint64_t GetCapacity() const { return mCapacity; }
+
+        uint64_t GetUsedSize() const { return mUsedSize; }
+
+        // 最大的连续空闲块, 用来判断碎片程度
+        uint64_t GetLargestFreeSize() const;
+
+    private:
+        uint64_t mCapacity = 0;
+        uint64_t mUsedSize = 0;
+        std::map<uint64_t, uint64_t> mFreeRanges;    // offset -> size
+    };
+}
+
+#endif
@@ -1,15 +1,20 @@
 #include <iostream>
 #include "AdLog.h"
+#include "AdFileSystem.h"
 #include "AdWindow.h"
 #include "AdGraphicContext.h"
 #include "Graphic/AdDevice.h"
 #include "Graphic/AdVKGraphicContext.h"
+#include "Graphic/AdVKPipelineCache.h"
+#include "Graphic/AdVKMeshletPass.h"
+#include "AdApplication.h"
 
 int main() {
 
     std::cout << "Hello adiosy engine." << std::endl;
 
     ade::AdLog::Init();
+    ade::AdFileSystem::Init();
     LOG_T("Hello spdlog: {0}, {1}, {3}", __FUNCTION__, 1, 0.14f, true);
     LOG_D("Hello spdlog: {0}, {1}, {3}", __FUNCTION__, 1, 0.14f, true);
     LOG_I("Hello spdlog: {0}, {1}, {3}", __FUNCTION__, 1, 0.14f, true);
@@ -20,9 +25,27 @@ int main() {
     std::unique_ptr<ade::AdGraphicContext> graphicContext = ade::AdGraphicContext::Create(window.get());
     std::shared_ptr<ade::AdVKDevice> device = std::make_shared<ade::AdVKDevice>(dynamic_cast<ade::AdVKGraphicContext*>(graphicContext.get()), 1, 1);
 
+    // 窗口事件在主线程(游戏线程)处理, 呈现放到渲染线程的 Submit 阶段
+    ade::AdApplication application;
+    application.AddFrameTask(ade::AdFrameStage::Submit, "Present", [&window]() { window->SwapBuffer(); });
+
+    // 上次运行记录的管线在第一帧之前用任务系统并行预创建; 这时还没有 pass 注册 layout,
+    // 记录的管线在 pass 构造、注册 layout 时用同一个执行器创建
+    ade::AdVKPipelineCache pipelineCache(device.get());
+    pipelineCache.Prewarm(0, [&application](uint32_t count, const std::function<void(uint32_t)> &task) {
+        application.GetJobSystem().ParallelFor(count, 1, [&task](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                task(i);
+            }
+        });
+    });
+    // pass 的管线都通过缓存创建, 退出时写入使用记录; pass 需要在缓存之前析构
+    ade::AdVKMeshletPass meshletPass(device.get(), &pipelineCache, VK_FORMAT_B8G8R8A8_UNORM, VK_FORMAT_D32_SFLOAT);
+
     while (!window->ShouldClose()) {
         window->PollEvents();
-        window->SwapBuffer();
+        application.RunFrame();
     }
+    application.Flush();
     return EXIT_SUCCESS;
 }
\ No newline at end of file
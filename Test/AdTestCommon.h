@@ -0,0 +1,24 @@
+#ifndef AD_TEST_COMMON_H
+#define AD_TEST_COMMON_H
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace ade {
+    inline int gTestFailedCount = 0;
+}
+
+// 失败时记录并继续, main 最后返回 AD_TEST_RESULT()
+#define AD_CHECK(expr)                                                                  \
+    do {                                                                                \
+        if (!(expr)) {                                                                  \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+            ade::gTestFailedCount++;                                                    \
+        }                                                                               \
+    } while (0)
+
+#define AD_CHECK_EQ(a, b) AD_CHECK((a) == (b))
+
+#define AD_TEST_RESULT() (ade::gTestFailedCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE)
+
+#endif
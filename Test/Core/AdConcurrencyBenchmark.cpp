@@ -0,0 +1,198 @@
+#include "AdTestCommon.h"
+#include "Concurrency/AdSpscQueue.h"
+#include "Concurrency/AdMpmcQueue.h"
+#include "Concurrency/AdConcurrentHashMap.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+using namespace ade;
+
+// 无锁容器与加锁的标准容器的吞吐对比; 只有 Release 且不开 sanitizer 时数字有意义
+static constexpr uint32_t AD_BENCH_ITEM_COUNT = 1000000;
+static constexpr uint32_t AD_BENCH_THREAD_COUNT = 4;
+
+// 加锁的有界队列, 作为对比基准
+template<typename T>
+class AdMutexQueue {
+public:
+    explicit AdMutexQueue(uint32_t capacity) : mCapacity(capacity) {}
+
+    bool TryPush(T item) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mItems.size() == mCapacity) {
+            return false;
+        }
+        mItems.push(item);
+        return true;
+    }
+
+    bool TryPop(T &outItem) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mItems.empty()) {
+            return false;
+        }
+        outItem = mItems.front();
+        mItems.pop();
+        return true;
+    }
+
+private:
+    std::mutex mMutex;
+    std::queue<T> mItems;
+    uint32_t mCapacity;
+};
+
+template<typename Func>
+static double MeasureMilliseconds(Func &&func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<typename Func>
+static void RunThreads(uint32_t count, Func &&func) {
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < count; i++) {
+        threads.emplace_back(func, i);
+    }
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+}
+
+// 一个生产者一个消费者, 返回消费者收到的元素之和
+template<typename Queue>
+static uint64_t RunSingleProducer(Queue &queue) {
+    uint64_t sum = 0;
+    std::thread consumer([&] {
+        for (uint32_t received = 0; received < AD_BENCH_ITEM_COUNT;) {
+            uint64_t value = 0;
+            if (queue.TryPop(value)) {
+                sum += value;
+                received++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    for (uint64_t i = 0; i < AD_BENCH_ITEM_COUNT; i++) {
+        while (!queue.TryPush(i)) {
+            std::this_thread::yield();
+        }
+    }
+    consumer.join();
+    return sum;
+}
+
+// 多个生产者和消费者, 总共传递 AD_BENCH_ITEM_COUNT 个元素
+template<typename Queue>
+static uint64_t RunMultiProducer(Queue &queue) {
+    static constexpr uint32_t ITEMS_PER_PRODUCER = AD_BENCH_ITEM_COUNT / AD_BENCH_THREAD_COUNT;
+    std::atomic<uint32_t> received{0};
+    std::atomic<uint64_t> sum{0};
+    std::thread producers([&] {
+        RunThreads(AD_BENCH_THREAD_COUNT, [&](uint32_t) {
+            for (uint64_t i = 0; i < ITEMS_PER_PRODUCER; i++) {
+                while (!queue.TryPush(i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    });
+    RunThreads(AD_BENCH_THREAD_COUNT, [&](uint32_t) {
+        uint64_t localSum = 0;
+        while (received.load(std::memory_order_relaxed) < ITEMS_PER_PRODUCER * AD_BENCH_THREAD_COUNT) {
+            uint64_t value = 0;
+            if (queue.TryPop(value)) {
+                localSum += value;
+                received.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        sum.fetch_add(localSum, std::memory_order_relaxed);
+    });
+    producers.join();
+    return sum.load();
+}
+
+static void BenchQueues() {
+    const uint64_t expectedSum = uint64_t(AD_BENCH_ITEM_COUNT) * (AD_BENCH_ITEM_COUNT - 1) / 2;
+    uint64_t sum = 0;
+    {
+        AdSpscQueue<uint64_t, 1024> queue;
+        double lockFree = MeasureMilliseconds([&] { sum = RunSingleProducer(queue); });
+        AD_CHECK_EQ(sum, expectedSum);
+        AdMutexQueue<uint64_t> mutexQueue(1024);
+        double locked = MeasureMilliseconds([&] { sum = RunSingleProducer(mutexQueue); });
+        AD_CHECK_EQ(sum, expectedSum);
+        std::printf("%-24s lock-free %8.1f ms   mutex %8.1f ms\n", "spsc 1x1", lockFree, locked);
+    }
+    {
+        static constexpr uint64_t ITEMS_PER_PRODUCER = AD_BENCH_ITEM_COUNT / AD_BENCH_THREAD_COUNT;
+        const uint64_t expectedMultiSum = AD_BENCH_THREAD_COUNT * ITEMS_PER_PRODUCER * (ITEMS_PER_PRODUCER - 1) / 2;
+        AdMpmcQueue<uint64_t> queue(1024);
+        double lockFree = MeasureMilliseconds([&] { sum = RunMultiProducer(queue); });
+        AD_CHECK_EQ(sum, expectedMultiSum);
+        AdMutexQueue<uint64_t> mutexQueue(1024);
+        double locked = MeasureMilliseconds([&] { sum = RunMultiProducer(mutexQueue); });
+        AD_CHECK_EQ(sum, expectedMultiSum);
+        std::printf("%-24s lock-free %8.1f ms   mutex %8.1f ms\n", "mpmc 4x4", lockFree, locked);
+    }
+}
+
+// 每个线程插入自己的键后反复查找全部键, 查找占绝大多数
+static void BenchHashMap() {
+    static constexpr uint32_t KEY_COUNT = 65536;
+    static constexpr uint32_t FIND_ROUNDS = 16;
+    std::atomic<uint64_t> foundCount{0};
+
+    AdConcurrentHashMap<uint32_t, uint64_t> map(KEY_COUNT);
+    double lockFree = MeasureMilliseconds([&] {
+        RunThreads(AD_BENCH_THREAD_COUNT, [&](uint32_t thread) {
+            for (uint32_t key = thread; key < KEY_COUNT; key += AD_BENCH_THREAD_COUNT) {
+                map.Insert(key, key);
+            }
+            uint64_t found = 0;
+            for (uint32_t round = 0; round < FIND_ROUNDS; round++) {
+                for (uint32_t key = 0; key < KEY_COUNT; key++) {
+                    found += map.Contains(key);
+                }
+            }
+            foundCount.fetch_add(found, std::memory_order_relaxed);
+        });
+    });
+    uint64_t lockFreeFound = foundCount.exchange(0);
+
+    std::mutex mutex;
+    std::unordered_map<uint32_t, uint64_t> mutexMap;
+    double locked = MeasureMilliseconds([&] {
+        RunThreads(AD_BENCH_THREAD_COUNT, [&](uint32_t thread) {
+            for (uint32_t key = thread; key < KEY_COUNT; key += AD_BENCH_THREAD_COUNT) {
+                std::lock_guard<std::mutex> lock(mutex);
+                mutexMap[key] = key;
+            }
+            uint64_t found = 0;
+            for (uint32_t round = 0; round < FIND_ROUNDS; round++) {
+                for (uint32_t key = 0; key < KEY_COUNT; key++) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    found += mutexMap.count(key);
+                }
+            }
+            foundCount.fetch_add(found, std::memory_order_relaxed);
+        });
+    });
+    // 查找与插入并发, 找到的数量不确定, 只检查上限
+    AD_CHECK(lockFreeFound <= uint64_t(AD_BENCH_THREAD_COUNT) * FIND_ROUNDS * KEY_COUNT);
+    AD_CHECK(foundCount.load() <= uint64_t(AD_BENCH_THREAD_COUNT) * FIND_ROUNDS * KEY_COUNT);
+    std::printf("%-24s lock-free %8.1f ms   mutex %8.1f ms\n", "hash map 4 threads", lockFree, locked);
+}
+
+int main() {
+    std::printf("%u hardware threads\n", std::thread::hardware_concurrency());
+    BenchQueues();
+    BenchHashMap();
+    return AD_TEST_RESULT();
+}
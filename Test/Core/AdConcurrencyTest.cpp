@@ -0,0 +1,217 @@
+#include "AdTestCommon.h"
+#include "Concurrency/AdSpscQueue.h"
+#include "Concurrency/AdMpmcQueue.h"
+#include "Concurrency/AdConcurrentHandlePool.h"
+#include "Concurrency/AdConcurrentHashMap.h"
+#include <atomic>
+#include <thread>
+
+using namespace ade;
+
+// 多生产者/多消费者压力测试; 打开 AD_ENGINE_TEST_TSAN 后在 ThreadSanitizer 下运行
+static constexpr uint32_t AD_TEST_THREAD_COUNT = 4;
+static constexpr uint32_t AD_TEST_ITEM_COUNT = 100000;
+
+template<typename Func>
+static void RunThreads(uint32_t count, Func &&func) {
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < count; i++) {
+        threads.emplace_back(func, i);
+    }
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+}
+
+// 单生产者单消费者: 按顺序收到全部元素
+static void TestSpscQueue() {
+    AdSpscQueue<uint64_t, 256> queue;
+    std::atomic<bool> bOrdered{true};
+    std::thread consumer([&] {
+        for (uint64_t expected = 0; expected < AD_TEST_ITEM_COUNT;) {
+            uint64_t value = 0;
+            if (!queue.TryPop(value)) {
+                std::this_thread::yield();
+                continue;
+            }
+            if (value != expected) {
+                bOrdered = false;
+            }
+            expected++;
+        }
+    });
+    for (uint64_t i = 0; i < AD_TEST_ITEM_COUNT; i++) {
+        while (!queue.TryPush(i)) {
+            std::this_thread::yield();
+        }
+    }
+    consumer.join();
+    AD_CHECK(bOrdered);
+    AD_CHECK(queue.IsEmpty());
+}
+
+// 多生产者多消费者: 每个元素恰好收到一次, 同一生产者的元素在每个消费者看来保持顺序
+static void TestMpmcQueue() {
+    AdMpmcQueue<uint64_t> queue(1024);
+    std::vector<std::atomic<uint8_t>> received(AD_TEST_THREAD_COUNT * AD_TEST_ITEM_COUNT);
+    std::atomic<uint32_t> poppedCount{0};
+    std::atomic<bool> bOrdered{true};
+
+    std::thread producers([&] {
+        RunThreads(AD_TEST_THREAD_COUNT, [&](uint32_t producer) {
+            for (uint32_t i = 0; i < AD_TEST_ITEM_COUNT; i++) {
+                uint64_t value = (uint64_t(producer) << 32) | i;
+                while (!queue.TryPush(value)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    });
+    RunThreads(AD_TEST_THREAD_COUNT, [&](uint32_t) {
+        std::vector<int64_t> lastIndex(AD_TEST_THREAD_COUNT, -1);
+        while (poppedCount.load(std::memory_order_relaxed) < AD_TEST_THREAD_COUNT * AD_TEST_ITEM_COUNT) {
+            uint64_t value = 0;
+            if (!queue.TryPop(value)) {
+                std::this_thread::yield();
+                continue;
+            }
+            poppedCount.fetch_add(1, std::memory_order_relaxed);
+            uint32_t producer = static_cast<uint32_t>(value >> 32);
+            uint32_t index = static_cast<uint32_t>(value);
+            if (int64_t(index) <= lastIndex[producer]) {
+                bOrdered = false;
+            }
+            lastIndex[producer] = index;
+            received[producer * AD_TEST_ITEM_COUNT + index].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    producers.join();
+
+    bool bExactlyOnce = true;
+    for (const std::atomic<uint8_t> &count: received) {
+        bExactlyOnce = bExactlyOnce && count.load() == 1;
+    }
+    AD_CHECK(bExactlyOnce);
+    AD_CHECK(bOrdered);
+    uint64_t value = 0;
+    AD_CHECK(!queue.TryPop(value));
+}
+
+// 多线程同时创建和销毁, 句柄在一个 MPMC 队列里交给别的线程销毁
+static void TestHandlePool() {
+    struct Item {
+        uint32_t owner;
+        uint32_t index;
+    };
+    static constexpr uint32_t CAPACITY = 512;
+    AdConcurrentHandlePool<Item> pool(CAPACITY);
+    AdMpmcQueue<AdPoolHandle> handles(CAPACITY);
+    std::atomic<bool> bValid{true};
+    std::atomic<uint32_t> destroyedCount{0};
+    std::atomic<uint32_t> createdCount{0};
+
+    RunThreads(AD_TEST_THREAD_COUNT, [&](uint32_t thread) {
+        uint32_t created = 0;
+        while (destroyedCount.load(std::memory_order_relaxed) < AD_TEST_THREAD_COUNT * AD_TEST_ITEM_COUNT / 10) {
+            // 一半时间创建, 一半时间销毁别的线程创建的对象
+            AdPoolHandle handle;
+            if (created < AD_TEST_ITEM_COUNT / 10) {
+                handle = pool.Create(Item{thread, created});
+            }
+            if (handle.IsValid()) {
+                Item *item = pool.Get(handle);
+                if (!item || item->owner != thread || item->index != created) {
+                    bValid = false;
+                }
+                created++;
+                createdCount.fetch_add(1, std::memory_order_relaxed);
+                while (!handles.TryPush(handle)) {
+                    std::this_thread::yield();
+                }
+            }
+            AdPoolHandle stale;
+            if (handles.TryPop(stale)) {
+                if (!pool.Get(stale) || !pool.Destroy(stale) || pool.Destroy(stale) || pool.Get(stale)) {
+                    bValid = false;
+                }
+                destroyedCount.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    AD_CHECK(bValid);
+    AD_CHECK_EQ(createdCount.load(), destroyedCount.load());
+    AD_CHECK_EQ(pool.GetCount(), 0u);
+
+    // 池满时返回无效句柄
+    std::vector<AdPoolHandle> all;
+    for (uint32_t i = 0; i < CAPACITY; i++) {
+        all.push_back(pool.Create(Item{0, i}));
+    }
+    AD_CHECK(!pool.Create(Item{0, CAPACITY}).IsValid());
+    for (AdPoolHandle handle: all) {
+        AD_CHECK(pool.Destroy(handle));
+    }
+}
+
+// 写线程插入、覆盖、删除各自的键, 读线程同时查找所有键: 找到的值必须是某次写入的值
+static void TestHashMap() {
+    static constexpr uint32_t KEYS_PER_THREAD = 2048;
+    AdConcurrentHashMap<uint32_t, uint64_t> map(AD_TEST_THREAD_COUNT * KEYS_PER_THREAD);
+    std::atomic<bool> bWritersDone{false};
+    std::atomic<bool> bValid{true};
+
+    std::thread readers([&] {
+        RunThreads(AD_TEST_THREAD_COUNT, [&](uint32_t thread) {
+            uint32_t key = thread;
+            while (!bWritersDone.load(std::memory_order_acquire)) {
+                key = (key + 7919) % (AD_TEST_THREAD_COUNT * KEYS_PER_THREAD);
+                uint64_t value = 0;
+                if (map.Find(key, value) && value % (AD_TEST_THREAD_COUNT * KEYS_PER_THREAD) != key) {
+                    bValid = false;
+                }
+            }
+        });
+    });
+    RunThreads(AD_TEST_THREAD_COUNT, [&](uint32_t thread) {
+        for (uint32_t round = 0; round < 8; round++) {
+            for (uint32_t i = 0; i < KEYS_PER_THREAD; i++) {
+                uint32_t key = i * AD_TEST_THREAD_COUNT + thread;
+                if (!map.Insert(key, uint64_t(round) * AD_TEST_THREAD_COUNT * KEYS_PER_THREAD + key)) {
+                    bValid = false;
+                }
+            }
+            // 最后一轮只删除奇数键
+            for (uint32_t i = round == 7 ? 1 : 0; i < KEYS_PER_THREAD; i += round == 7 ? 2 : 1) {
+                uint32_t key = i * AD_TEST_THREAD_COUNT + thread;
+                if (!map.Erase(key) || map.Erase(key)) {
+                    bValid = false;
+                }
+            }
+        }
+    });
+    bWritersDone.store(true, std::memory_order_release);
+    readers.join();
+
+    AD_CHECK(bValid);
+    bool bFinalState = true;
+    for (uint32_t key = 0; key < AD_TEST_THREAD_COUNT * KEYS_PER_THREAD; key++) {
+        uint64_t value = 0;
+        bool bEven = (key / AD_TEST_THREAD_COUNT) % 2 == 0;
+        if (map.Find(key, value) != bEven ||
+            (bEven && value != uint64_t(7) * AD_TEST_THREAD_COUNT * KEYS_PER_THREAD + key)) {
+            bFinalState = false;
+        }
+    }
+    AD_CHECK(bFinalState);
+}
+
+int main() {
+    TestSpscQueue();
+    TestMpmcQueue();
+    TestHandlePool();
+    TestHashMap();
+    return AD_TEST_RESULT();
+}
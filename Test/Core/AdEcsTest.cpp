@@ -0,0 +1,192 @@
+#include "AdTestCommon.h"
+#include "AdLog.h"
+#include "ECS/AdWorld.h"
+#include <utility>
+
+using namespace ade;
+
+struct AdTestPosition {
+    float x, y, z;
+};
+
+struct AdTestVelocity {
+    float x, y, z;
+};
+
+// 带堆内存的组件, 检查原型之间移动时用的是移动构造且没有泄漏或重复析构
+struct AdTestName {
+    std::string value;
+    static inline int sAliveCount = 0;
+
+    AdTestName() { sAliveCount++; }
+
+    explicit AdTestName(std::string name) : value(std::move(name)) { sAliveCount++; }
+
+    AdTestName(const AdTestName &other) : value(other.value) { sAliveCount++; }
+
+    AdTestName(AdTestName &&other) noexcept: value(std::move(other.value)) { sAliveCount++; }
+
+    AdTestName &operator=(const AdTestName &) = default;
+
+    AdTestName &operator=(AdTestName &&) = default;
+
+    ~AdTestName() { sAliveCount--; }
+};
+
+static void TestCreateDestroy() {
+    AdWorld world;
+    AdEntity empty = world.CreateEntity();
+    AdEntity entity = world.CreateEntity(AdTestPosition{1, 2, 3}, AdTestName("a"));
+    AD_CHECK(world.IsAlive(empty));
+    AD_CHECK(world.IsAlive(entity));
+    AD_CHECK_EQ(world.GetEntityCount(), 2u);
+    AD_CHECK(world.GetComponent<AdTestPosition>(entity) && world.GetComponent<AdTestPosition>(entity)->y == 2);
+    AD_CHECK(world.GetComponent<AdTestName>(entity) && world.GetComponent<AdTestName>(entity)->value == "a");
+    AD_CHECK(!world.HasComponent<AdTestVelocity>(entity));
+    AD_CHECK(!world.HasComponent<AdTestPosition>(empty));
+
+    // 销毁后旧句柄失效, 复用的槽位有新的 generation
+    world.DestroyEntity(entity);
+    AD_CHECK(!world.IsAlive(entity));
+    AD_CHECK(world.GetComponent<AdTestPosition>(entity) == nullptr);
+    AD_CHECK_EQ(world.GetEntityCount(), 1u);
+    AdEntity reused = world.CreateEntity(AdTestPosition{4, 5, 6});
+    AD_CHECK_EQ(reused.index, entity.index);
+    AD_CHECK(reused != entity);
+    AD_CHECK(!world.IsAlive(entity));
+    world.DestroyEntity(entity);
+    AD_CHECK(world.IsAlive(reused));
+    AD_CHECK_EQ(world.GetEntityCount(), 2u);
+}
+
+static void TestMoveBetweenArchetypes() {
+    AdWorld world;
+    // 多于一个块, 删除和移动时会用最后一行填补
+    static constexpr uint32_t ENTITY_COUNT = 3000;
+    std::vector<AdEntity> entities;
+    for (uint32_t i = 0; i < ENTITY_COUNT; i++) {
+        entities.push_back(world.CreateEntity(AdTestPosition{float(i), 0, 0}, AdTestName(std::to_string(i))));
+    }
+
+    // 偶数实体增加速度, 移动到新原型; 组件值保持不变
+    for (uint32_t i = 0; i < ENTITY_COUNT; i += 2) {
+        world.AddComponent(entities[i], AdTestVelocity{1, 0, float(i)});
+    }
+    // 3 的倍数去掉名字
+    for (uint32_t i = 0; i < ENTITY_COUNT; i += 3) {
+        world.RemoveComponent<AdTestName>(entities[i]);
+    }
+
+    bool bSame = true;
+    for (uint32_t i = 0; i < ENTITY_COUNT; i++) {
+        const auto *position = world.GetComponent<AdTestPosition>(entities[i]);
+        const auto *velocity = world.GetComponent<AdTestVelocity>(entities[i]);
+        const auto *name = world.GetComponent<AdTestName>(entities[i]);
+        bSame = bSame && position && position->x == float(i);
+        bSame = bSame && (i % 2 == 0 ? velocity && velocity->z == float(i) : velocity == nullptr);
+        bSame = bSame && (i % 3 == 0 ? name == nullptr : name && name->value == std::to_string(i));
+    }
+    AD_CHECK(bSame);
+
+    // 已有组件时 AddComponent 直接赋值, 不改变原型
+    uint32_t archetypeCount = world.GetArchetypeCount();
+    world.AddComponent(entities[0], AdTestVelocity{2, 0, 0});
+    AD_CHECK_EQ(world.GetComponent<AdTestVelocity>(entities[0])->x, 2.0f);
+    AD_CHECK_EQ(world.GetArchetypeCount(), archetypeCount);
+
+    // 去掉全部组件再加回来
+    world.RemoveComponent<AdTestPosition>(entities[1]);
+    world.RemoveComponent<AdTestName>(entities[1]);
+    AD_CHECK(world.IsAlive(entities[1]));
+    AD_CHECK(!world.HasComponent<AdTestPosition>(entities[1]));
+    world.AddComponent(entities[1], AdTestName("back"));
+    AD_CHECK(world.GetComponent<AdTestName>(entities[1])->value == "back");
+
+    for (uint32_t i = 0; i < ENTITY_COUNT; i += 5) {
+        world.DestroyEntity(entities[i]);
+    }
+    AD_CHECK_EQ(world.GetEntityCount(), ENTITY_COUNT - ENTITY_COUNT / 5);
+}
+
+static void TestQuery() {
+    AdWorld world;
+    static constexpr uint32_t ENTITY_COUNT = 5000;
+    for (uint32_t i = 0; i < ENTITY_COUNT; i++) {
+        AdEntity entity = world.CreateEntity(AdTestPosition{0, 0, 0});
+        if (i % 2 == 0) {
+            world.AddComponent(entity, AdTestVelocity{1, float(i), 0});
+        }
+        if (i % 4 == 0) {
+            world.AddComponent(entity, AdTestName("moving"));
+        }
+    }
+
+    // 查询覆盖所有包含这些组件的原型
+    AdQuery<AdTestPosition, const AdTestVelocity> query(world);
+    uint32_t visitCount = 0;
+    query.ForEach([&visitCount](AdEntity, AdTestPosition &position, const AdTestVelocity &velocity) {
+        position.x += velocity.x;
+        position.y = velocity.y;
+        visitCount++;
+    });
+    AD_CHECK_EQ(visitCount, ENTITY_COUNT / 2);
+
+    uint32_t movedCount = 0;
+    bool bSame = true;
+    AdQuery<const AdTestPosition>(world).ForEach([&](AdEntity entity, const AdTestPosition &position) {
+        bool bHasVelocity = world.HasComponent<AdTestVelocity>(entity);
+        movedCount += position.x == 1.0f ? 1 : 0;
+        bSame = bSame && (bHasVelocity ? position.x == 1.0f : position.x == 0.0f);
+    });
+    AD_CHECK_EQ(movedCount, ENTITY_COUNT / 2);
+    AD_CHECK(bSame);
+
+    // 结构改变后重新收集块
+    world.CreateEntity(AdTestPosition{}, AdTestVelocity{});
+    visitCount = 0;
+    query.ForEachChunk([&visitCount](uint32_t count, const AdEntity *, AdTestPosition *, const AdTestVelocity *) {
+        visitCount += count;
+    });
+    AD_CHECK_EQ(visitCount, ENTITY_COUNT / 2 + 1);
+
+    AdJobSystem jobSystem;
+    std::atomic<uint32_t> parallelCount{0};
+    query.ForEach(jobSystem, [&parallelCount](AdEntity, AdTestPosition &position, const AdTestVelocity &) {
+        position.z = 1.0f;
+        parallelCount++;
+    });
+    AD_CHECK_EQ(parallelCount.load(), ENTITY_COUNT / 2 + 1);
+}
+
+template<size_t N>
+struct AdTestTag {
+    uint32_t value;
+};
+
+template<size_t... Is>
+static void RegisterTags(std::index_sequence<Is...>) {
+    (static_cast<void>(GetComponentTypeId<AdTestTag<Is>>()), ...);
+}
+
+// 超出组件类型上限时创建失败, 不写入组件
+static void TestComponentTypeLimit() {
+    RegisterTags(std::make_index_sequence<AD_MAX_COMPONENT_TYPES>());
+    AD_CHECK_EQ(GetComponentTypeId<AdTestTag<AD_MAX_COMPONENT_TYPES>>(), UINT32_MAX);
+
+    AdWorld world;
+    AdEntity entity = world.CreateEntity(AdTestPosition{}, AdTestTag<AD_MAX_COMPONENT_TYPES>{1});
+    AD_CHECK(!entity.IsValid());
+    AD_CHECK_EQ(world.GetEntityCount(), 0u);
+}
+
+int main() {
+    AdLog::Init();
+
+    TestCreateDestroy();
+    TestMoveBetweenArchetypes();
+    TestQuery();
+    AD_CHECK_EQ(AdTestName::sAliveCount, 0);
+    // 会注册满所有组件类型, 放在最后
+    TestComponentTypeLimit();
+    return AD_TEST_RESULT();
+}
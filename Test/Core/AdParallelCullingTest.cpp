@@ -0,0 +1,149 @@
+#include "AdTestCommon.h"
+#include "AdLog.h"
+#include "ECS/AdWorld.h"
+#include "Math/AdMatrix.h"
+#include "Render/AdParallelCulling.h"
+#include <cstring>
+#include <random>
+
+using namespace ade;
+
+// 任务系统版本的剔除和 ECS 遍历与单线程调用结果一致
+static constexpr uint32_t AD_TEST_INSTANCE_COUNT = 20000;
+
+struct AdTestPosition {
+    float value[3];
+};
+
+struct AdTestVisited {
+    uint32_t count;
+};
+
+static std::vector<AdBoundingBox> MakeBoxes(std::mt19937 &random, uint32_t count) {
+    std::uniform_real_distribution<float> position(-200.0f, 200.0f);
+    std::uniform_real_distribution<float> size(0.5f, 20.0f);
+    std::vector<AdBoundingBox> boxes(count);
+    for (AdBoundingBox &box: boxes) {
+        for (int c = 0; c < 3; c++) {
+            box.min[c] = position(random);
+            box.max[c] = box.min[c] + size(random);
+        }
+    }
+    return boxes;
+}
+
+static void TestFrustumCulling(AdJobSystem &jobSystem, const std::vector<AdBoundingBox> &boxes) {
+    AdFrustumCuller culler;
+    culler.Resize(static_cast<uint32_t>(boxes.size()));
+    for (uint32_t i = 0; i < boxes.size(); i++) {
+        culler.SetBounds(i, boxes[i]);
+    }
+
+    // 多于 MAX_VIEW_COUNT 个视图, 覆盖分组
+    static constexpr uint32_t VIEW_COUNT = AdFrustumCuller::MAX_VIEW_COUNT + 2;
+    std::vector<AdFrustum> frustums(VIEW_COUNT);
+    for (uint32_t view = 0; view < VIEW_COUNT; view++) {
+        float angle = static_cast<float>(view) * 0.6f;
+        AdMat4 viewProj = AdMat4::Perspective(1.0f, 16.0f / 9.0f, 0.1f, 300.0f) *
+                          AdMat4::LookAt({0.0f, 0.0f, 0.0f}, {std::cos(angle), 0.1f, std::sin(angle)},
+                                         {0.0f, 1.0f, 0.0f});
+        ExtractFrustumPlanes(viewProj.Data(), frustums[view]);
+    }
+
+    std::vector<std::vector<uint32_t>> expected(VIEW_COUNT, std::vector<uint32_t>(boxes.size()));
+    std::vector<std::vector<uint32_t>> actual(VIEW_COUNT, std::vector<uint32_t>(boxes.size()));
+    std::vector<uint32_t *> expectedPointers, actualPointers;
+    for (uint32_t view = 0; view < VIEW_COUNT; view++) {
+        expectedPointers.push_back(expected[view].data());
+        actualPointers.push_back(actual[view].data());
+    }
+    std::vector<uint32_t> expectedCounts(VIEW_COUNT), actualCounts(VIEW_COUNT);
+    culler.CullViews(frustums.data(), VIEW_COUNT, 0, culler.GetCount(), expectedPointers.data(),
+                     expectedCounts.data());
+    ParallelCullViews(jobSystem, culler, frustums.data(), VIEW_COUNT, actualPointers.data(), actualCounts.data(),
+                      1000);
+
+    bool bSame = true;
+    uint32_t visibleCount = 0;
+    for (uint32_t view = 0; view < VIEW_COUNT; view++) {
+        visibleCount += expectedCounts[view];
+        bSame = bSame && actualCounts[view] == expectedCounts[view] &&
+                std::equal(expected[view].begin(), expected[view].begin() + expectedCounts[view],
+                           actual[view].begin());
+    }
+    AD_CHECK(bSame);
+    AD_CHECK(visibleCount > 0);
+
+    std::vector<uint32_t> single(boxes.size());
+    AD_CHECK_EQ(ParallelCull(jobSystem, culler, frustums[0], single.data(), 1000), expectedCounts[0]);
+    AD_CHECK(std::equal(single.begin(), single.begin() + expectedCounts[0], expected[0].begin()));
+}
+
+static void TestSoftwareOcclusion(AdJobSystem &jobSystem, const std::vector<AdBoundingBox> &boxes) {
+    AdMat4 viewProj = AdMat4::Perspective(1.0f, 16.0f / 9.0f, 0.1f, 500.0f) *
+                      AdMat4::LookAt({0.0f, 0.0f, -250.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f});
+    // 屏幕中间一面墙
+    const float wall[] = {-60.0f, -40.0f, -150.0f, 60.0f, -40.0f, -150.0f, 60.0f, 40.0f, -150.0f, -60.0f, 40.0f, -150.0f};
+    const uint32_t indices[] = {0, 1, 2, 0, 2, 3};
+
+    AdSoftwareOcclusion serial;
+    serial.Begin(viewProj.Data());
+    serial.AddOccluder(wall, 4, sizeof(float) * 3, indices, 6);
+    serial.Rasterize();
+
+    AdSoftwareOcclusion parallel;
+    parallel.Begin(viewProj.Data());
+    parallel.AddOccluder(wall, 4, sizeof(float) * 3, indices, 6);
+    ParallelRasterize(jobSystem, parallel, 2);
+    AD_CHECK(memcmp(serial.GetDepth(), parallel.GetDepth(),
+                    size_t(serial.GetWidth()) * serial.GetHeight() * sizeof(float)) == 0);
+
+    uint32_t count = static_cast<uint32_t>(boxes.size());
+    std::vector<uint32_t> expected(count), actual(count);
+    uint32_t expectedCount = serial.CullBoxes(boxes.data(), count, expected.data(), 7);
+    uint32_t actualCount = ParallelCullBoxes(jobSystem, parallel, boxes.data(), count, actual.data(), 7, 1000);
+    AD_CHECK_EQ(actualCount, expectedCount);
+    AD_CHECK(expectedCount < count);
+    AD_CHECK(std::equal(expected.begin(), expected.begin() + expectedCount, actual.begin()));
+}
+
+static void TestQueryForEach(AdJobSystem &jobSystem) {
+    AdWorld world;
+    for (uint32_t i = 0; i < AD_TEST_INSTANCE_COUNT; i++) {
+        AdTestPosition position = {{static_cast<float>(i), 0.0f, 0.0f}};
+        if (i % 3 == 0) {
+            world.CreateEntity(position, AdTestVisited{0});
+        } else {
+            world.CreateEntity(position);
+        }
+    }
+
+    AdQuery<AdTestPosition, AdTestVisited> query(world);
+    std::atomic<uint32_t> visitedCount{0};
+    query.ForEach(jobSystem, [&visitedCount](AdEntity, AdTestPosition &position, AdTestVisited &visited) {
+        position.value[1] = position.value[0] * 2.0f;
+        visited.count++;
+        visitedCount.fetch_add(1, std::memory_order_relaxed);
+    });
+    AD_CHECK_EQ(visitedCount.load(), (AD_TEST_INSTANCE_COUNT + 2) / 3);
+
+    bool bVisitedOnce = true;
+    query.ForEach([&bVisitedOnce](AdEntity, const AdTestPosition &position, const AdTestVisited &visited) {
+        bVisitedOnce = bVisitedOnce && visited.count == 1 && position.value[1] == position.value[0] * 2.0f;
+    });
+    AD_CHECK(bVisitedOnce);
+}
+
+int main() {
+    AdLog::Init();
+    AdJobSystemSettings settings;
+    settings.workerCount = 3;
+    AdJobSystem jobSystem(settings);
+
+    std::mt19937 random(42);
+    std::vector<AdBoundingBox> boxes = MakeBoxes(random, AD_TEST_INSTANCE_COUNT);
+    TestFrustumCulling(jobSystem, boxes);
+    TestSoftwareOcclusion(jobSystem, boxes);
+    TestQueryForEach(jobSystem);
+    return AD_TEST_RESULT();
+}
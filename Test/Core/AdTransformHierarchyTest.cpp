@@ -0,0 +1,236 @@
+#include "AdTestCommon.h"
+#include "AdLog.h"
+#include "Scene/AdTransformHierarchy.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+using namespace ade;
+
+// 世界矩阵与按父节点递归计算的结果逐位一致; 单线程和任务系统并行更新结果相同
+static constexpr uint32_t AD_TEST_NODE_COUNT = 5000;
+static constexpr uint32_t AD_TEST_FRAME_COUNT = 8;
+
+// 测试自己维护的层级, 按句柄索引
+struct AdTestNode {
+    uint32_t parent = AdTransformHierarchy::INVALID;
+    AdLocalTransform local;
+    bool bAlive = false;
+};
+
+static AdLocalTransform MakeLocal(std::mt19937 &random) {
+    std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> scale(0.5f, 1.5f);
+    AdLocalTransform local;
+    float axis[3] = {unit(random), unit(random), unit(random)};
+    float length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]) + 1e-6f;
+    float halfAngle = unit(random) * 1.5f;
+    for (int i = 0; i < 3; i++) {
+        local.position[i] = position(random);
+        local.rotation[i] = axis[i] / length * std::sin(halfAngle);
+        local.scale[i] = scale(random);
+    }
+    local.rotation[3] = std::cos(halfAngle);
+    return local;
+}
+
+// 朴素的递归: 父节点世界矩阵 * 自身局部矩阵, 与 AdTransformHierarchy 的运算顺序相同
+static AdMat4 ComputeWorld(const std::vector<AdTestNode> &nodes, uint32_t node) {
+    const AdLocalTransform &local = nodes[node].local;
+    AdMat4 matrix = AdMat4::TRS(AdVec3(local.position), AdQuat(local.rotation), AdVec3(local.scale));
+    uint32_t parent = nodes[node].parent;
+    return parent == AdTransformHierarchy::INVALID ? matrix : ComputeWorld(nodes, parent) * matrix;
+}
+
+static bool IsAncestor(const std::vector<AdTestNode> &nodes, uint32_t ancestor, uint32_t node) {
+    for (uint32_t current = node; current != AdTransformHierarchy::INVALID; current = nodes[current].parent) {
+        if (current == ancestor) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 两个层级的所有存活节点与参考结果逐位一致, 返回不一致的节点数
+static uint32_t Compare(const std::vector<AdTestNode> &nodes, const AdTransformHierarchy &serial,
+                        const AdTransformHierarchy &parallel) {
+    uint32_t mismatchCount = 0, aliveCount = 0;
+    for (uint32_t node = 0; node < nodes.size(); node++) {
+        bool bAlive = nodes[node].bAlive;
+        if (serial.IsValid(node) != bAlive || parallel.IsValid(node) != bAlive) {
+            mismatchCount++;
+            continue;
+        }
+        if (!bAlive) {
+            continue;
+        }
+        aliveCount++;
+        AdMat4 expected = ComputeWorld(nodes, node);
+        mismatchCount += memcmp(serial.GetWorldMatrix(node), expected.Data(), sizeof(AdMat4)) != 0 ? 1 : 0;
+        mismatchCount += memcmp(parallel.GetWorldMatrix(node), expected.Data(), sizeof(AdMat4)) != 0 ? 1 : 0;
+        mismatchCount += serial.GetParent(node) != nodes[node].parent ? 1 : 0;
+        mismatchCount += serial.IsWorldChanged(node) != parallel.IsWorldChanged(node) ? 1 : 0;
+    }
+    mismatchCount += serial.GetNodeCount() != aliveCount || parallel.GetNodeCount() != aliveCount ? 1 : 0;
+    return mismatchCount;
+}
+
+// 同样的操作同时作用在参考层级和两个被测层级上
+struct AdTestScene {
+    std::vector<AdTestNode> nodes;
+    AdTransformHierarchy serial;
+    AdTransformHierarchy parallel;
+
+    uint32_t Create(uint32_t parent, const AdLocalTransform &local) {
+        uint32_t node = serial.CreateNode(parent, local);
+        AD_CHECK_EQ(parallel.CreateNode(parent, local), node);
+        if (node >= nodes.size()) {
+            nodes.resize(node + 1);
+        }
+        nodes[node] = {parent, local, true};
+        return node;
+    }
+
+    void SetLocal(uint32_t node, const AdLocalTransform &local) {
+        serial.SetLocalTransform(node, local);
+        parallel.SetLocalTransform(node, local);
+        nodes[node].local = local;
+    }
+
+    void SetParent(uint32_t node, uint32_t parent) {
+        serial.SetParent(node, parent);
+        parallel.SetParent(node, parent);
+        nodes[node].parent = parent;
+    }
+
+    void Destroy(uint32_t node) {
+        serial.DestroyNode(node);
+        parallel.DestroyNode(node);
+        for (uint32_t i = 0; i < nodes.size(); i++) {
+            if (nodes[i].bAlive && IsAncestor(nodes, node, i)) {
+                nodes[i].bAlive = false;
+            }
+        }
+        // 在全部标记完之后再断开, 否则后面的子孙找不到 node
+        for (AdTestNode &n: nodes) {
+            n.parent = n.bAlive ? n.parent : AdTransformHierarchy::INVALID;
+        }
+    }
+
+    uint32_t PickAlive(std::mt19937 &random) const {
+        while (true) {
+            uint32_t node = static_cast<uint32_t>(random() % nodes.size());
+            if (nodes[node].bAlive) {
+                return node;
+            }
+        }
+    }
+};
+
+static void TestRandomEdits(AdJobSystem &jobSystem) {
+    std::mt19937 random(2024);
+    AdTestScene scene;
+    // 父节点随机选已有节点, 形成深浅不一的多棵树; 小的批次让每层分给多个任务
+    for (uint32_t i = 0; i < AD_TEST_NODE_COUNT; i++) {
+        uint32_t parent = i < 4 || random() % 8 == 0 ? AdTransformHierarchy::INVALID : scene.PickAlive(random);
+        scene.Create(parent, MakeLocal(random));
+    }
+    scene.serial.Update();
+    scene.parallel.Update(jobSystem, 64);
+    AD_CHECK(scene.serial.GetLevelCount() > 5);
+    AD_CHECK_EQ(Compare(scene.nodes, scene.serial, scene.parallel), 0u);
+
+    for (uint32_t frame = 0; frame < AD_TEST_FRAME_COUNT; frame++) {
+        for (uint32_t i = 0; i < 200; i++) {
+            scene.SetLocal(scene.PickAlive(random), MakeLocal(random));
+        }
+        // 改变父节点, 包括挂到根和挂到别的树下; 挂到自己子树下的请求被拒绝
+        for (uint32_t i = 0; i < 50; i++) {
+            uint32_t node = scene.PickAlive(random);
+            uint32_t parent = i % 5 == 0 ? AdTransformHierarchy::INVALID : scene.PickAlive(random);
+            if (parent != AdTransformHierarchy::INVALID && IsAncestor(scene.nodes, node, parent)) {
+                scene.serial.SetParent(node, parent);
+                AD_CHECK(scene.serial.GetParent(node) == scene.nodes[node].parent);
+                continue;
+            }
+            scene.SetParent(node, parent);
+        }
+        for (uint32_t i = 0; i < 10; i++) {
+            scene.Destroy(scene.PickAlive(random));
+        }
+        // 删除后新建的节点复用句柄
+        for (uint32_t i = 0; i < 30; i++) {
+            uint32_t parent = i % 3 == 0 ? AdTransformHierarchy::INVALID : scene.PickAlive(random);
+            scene.Create(parent, MakeLocal(random));
+        }
+        scene.serial.Update();
+        scene.parallel.Update(jobSystem, 64);
+        AD_CHECK_EQ(Compare(scene.nodes, scene.serial, scene.parallel), 0u);
+    }
+
+    // 没有修改时所有节点都不变
+    scene.serial.Update();
+    scene.parallel.Update(jobSystem, 64);
+    std::vector<uint32_t> changed;
+    scene.serial.GetChangedNodes(changed);
+    AD_CHECK(changed.empty());
+    AD_CHECK_EQ(Compare(scene.nodes, scene.serial, scene.parallel), 0u);
+}
+
+// 只有修改过的节点和它的子树被重新计算
+static void TestIncrementalUpdate(AdJobSystem &jobSystem) {
+    std::mt19937 random(7);
+    AdTestScene scene;
+    uint32_t root = scene.Create(AdTransformHierarchy::INVALID, MakeLocal(random));
+    uint32_t child = scene.Create(root, MakeLocal(random));
+    uint32_t grandChild = scene.Create(child, MakeLocal(random));
+    uint32_t sibling = scene.Create(root, MakeLocal(random));
+    uint32_t other = scene.Create(AdTransformHierarchy::INVALID, MakeLocal(random));
+    scene.serial.Update();
+    scene.parallel.Update(jobSystem);
+
+    scene.SetLocal(child, MakeLocal(random));
+    scene.serial.Update();
+    scene.parallel.Update(jobSystem);
+    std::vector<uint32_t> changed;
+    scene.serial.GetChangedNodes(changed);
+    std::sort(changed.begin(), changed.end());
+    AD_CHECK(changed == (std::vector<uint32_t>{child, grandChild}));
+    AD_CHECK(!scene.serial.IsWorldChanged(sibling));
+    AD_CHECK_EQ(Compare(scene.nodes, scene.serial, scene.parallel), 0u);
+
+    // 把子树挂到另一个根下, 子树的世界矩阵都跟着变化
+    scene.SetParent(child, other);
+    scene.serial.Update();
+    scene.parallel.Update(jobSystem);
+    AD_CHECK(scene.serial.IsWorldChanged(child) && scene.serial.IsWorldChanged(grandChild));
+    AD_CHECK(!scene.serial.IsWorldChanged(root));
+    AD_CHECK_EQ(Compare(scene.nodes, scene.serial, scene.parallel), 0u);
+
+    // 不能挂到自己的子孙下, 无效父节点被拒绝
+    scene.serial.SetParent(other, grandChild);
+    AD_CHECK_EQ(scene.serial.GetParent(other), AdTransformHierarchy::INVALID);
+    AD_CHECK_EQ(scene.serial.CreateNode(1000), AdTransformHierarchy::INVALID);
+
+    // 删除整个子树
+    scene.Destroy(child);
+    AD_CHECK(!scene.serial.IsValid(grandChild));
+    scene.serial.Update();
+    scene.parallel.Update(jobSystem);
+    AD_CHECK_EQ(scene.serial.GetNodeCount(), 3u);
+    AD_CHECK_EQ(scene.serial.GetLevelCount(), 2u);
+    AD_CHECK_EQ(Compare(scene.nodes, scene.serial, scene.parallel), 0u);
+}
+
+int main() {
+    AdLog::Init();
+    AdJobSystemSettings settings;
+    settings.workerCount = 3;
+    AdJobSystem jobSystem(settings);
+
+    TestRandomEdits(jobSystem);
+    TestIncrementalUpdate(jobSystem);
+    return AD_TEST_RESULT();
+}
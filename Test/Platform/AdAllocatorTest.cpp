@@ -0,0 +1,230 @@
+#include "AdTestCommon.h"
+#include "AdLog.h"
+#include "Memory/AdMemoryResource.h"
+#include <cstring>
+#include <list>
+#include <thread>
+
+using namespace ade;
+
+static bool IsAligned(const void *ptr, size_t alignment) {
+    return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+static void TestLinearAllocator() {
+    AdLinearAllocator allocator(1024);
+    void *a = allocator.Allocate(3, 1);
+    void *b = allocator.Allocate(16, 16);
+    void *c = allocator.Allocate(8, 64);
+    AD_CHECK(IsAligned(b, 16));
+    AD_CHECK(IsAligned(c, 64));
+    AD_CHECK(static_cast<uint8_t *>(b) >= static_cast<uint8_t *>(a) + 3);
+    AD_CHECK(static_cast<uint8_t *>(c) >= static_cast<uint8_t *>(b) + 16);
+    AD_CHECK_EQ(allocator.GetCapacity(), 1024u);
+
+    // Rewind 之后从 marker 处继续分配
+    AdLinearAllocator::Marker marker = allocator.GetMarker();
+    void *d = allocator.Allocate(100);
+    allocator.Allocate(100);
+    allocator.Rewind(marker);
+    AD_CHECK_EQ(allocator.Allocate(100), d);
+
+    // 放不下时换块, 超过块大小的分配单独一块
+    void *big = allocator.Allocate(4096, 64);
+    AD_CHECK(IsAligned(big, 64));
+    AD_CHECK(allocator.GetCapacity() >= 1024u + 4096u);
+    std::memset(big, 0xcd, 4096);
+
+    // Reset 后保留所有块, 同样的分配序列不再向堆申请
+    size_t capacity = allocator.GetCapacity();
+    allocator.Reset();
+    AD_CHECK_EQ(allocator.GetUsedSize(), 0u);
+    AD_CHECK_EQ(allocator.Allocate(3, 1), a);
+    allocator.Allocate(16, 16);
+    allocator.Allocate(8, 64);
+    allocator.Allocate(200);
+    allocator.Allocate(4096, 64);
+    AD_CHECK_EQ(allocator.GetCapacity(), capacity);
+
+    allocator.Release();
+    AD_CHECK_EQ(allocator.GetCapacity(), 0u);
+    AD_CHECK_EQ(allocator.GetUsedSize(), 0u);
+}
+
+static void TestScratchScope() {
+    AdLinearAllocator &scratch = AdLinearAllocator::GetThreadScratch();
+    size_t usedSize = scratch.GetUsedSize();
+    {
+        AdScratchScope outer;
+        uint32_t *values = outer.AllocateArray<uint32_t>(256);
+        AD_CHECK(IsAligned(values, alignof(uint32_t)));
+        {
+            AdScratchScope inner;
+            inner.Allocate(1024);
+            AD_CHECK(scratch.GetUsedSize() >= usedSize + 256 * sizeof(uint32_t) + 1024);
+        }
+        AD_CHECK(scratch.GetUsedSize() < usedSize + 256 * sizeof(uint32_t) + 1024);
+    }
+    AD_CHECK_EQ(scratch.GetUsedSize(), usedSize);
+
+    // 每个线程有自己的临时内存
+    AdLinearAllocator *otherScratch = nullptr;
+    std::thread([&otherScratch]() { otherScratch = &AdLinearAllocator::GetThreadScratch(); }).join();
+    AD_CHECK(otherScratch != &scratch);
+}
+
+struct AdTestObject {
+    static inline int sAliveCount = 0;
+    uint64_t value;
+
+    explicit AdTestObject(uint64_t v) : value(v) { sAliveCount++; }
+
+    ~AdTestObject() { sAliveCount--; }
+};
+
+static void TestPoolAllocator() {
+    // 块大小向上对齐, 至少能放下一个指针
+    AD_CHECK_EQ(AdPoolAllocator(1, 16).GetBlockSize(), 16u);
+    AD_CHECK_EQ(AdPoolAllocator(40, 32).GetBlockSize(), 64u);
+    AD_CHECK_EQ(AdPoolAllocator(1, 1).GetBlockSize(), sizeof(void *));
+
+    AdPoolAllocator pool(24, 32, 4);
+    std::vector<void *> blocks;
+    for (int i = 0; i < 10; i++) {
+        blocks.push_back(pool.Allocate());
+        AD_CHECK(IsAligned(blocks.back(), 32));
+        std::memset(blocks.back(), i, pool.GetBlockSize());
+    }
+    AD_CHECK_EQ(pool.GetAllocatedCount(), 10u);
+    AD_CHECK_EQ(pool.GetCapacity(), 12u);
+    std::sort(blocks.begin(), blocks.end());
+    AD_CHECK(std::adjacent_find(blocks.begin(), blocks.end()) == blocks.end());
+
+    // 释放的块最先被复用, 不申请新页
+    pool.Free(blocks[3]);
+    AD_CHECK_EQ(pool.Allocate(), blocks[3]);
+    for (void *block: blocks) {
+        pool.Free(block);
+    }
+    pool.Free(nullptr);
+    AD_CHECK_EQ(pool.GetAllocatedCount(), 0u);
+    blocks.clear();
+    for (int i = 0; i < 12; i++) {
+        blocks.push_back(pool.Allocate());
+    }
+    AD_CHECK_EQ(pool.GetCapacity(), 12u);
+    blocks.push_back(pool.Allocate());
+    AD_CHECK_EQ(pool.GetCapacity(), 16u);
+    for (void *block: blocks) {
+        pool.Free(block);
+    }
+
+    AdObjectPool<AdTestObject> objects(8);
+    std::vector<AdTestObject *> created;
+    for (uint64_t i = 0; i < 20; i++) {
+        created.push_back(objects.New(i));
+    }
+    AD_CHECK_EQ(AdTestObject::sAliveCount, 20);
+    AD_CHECK_EQ(created[19]->value, 19u);
+    for (AdTestObject *object: created) {
+        objects.Delete(object);
+    }
+    AD_CHECK_EQ(AdTestObject::sAliveCount, 0);
+    AD_CHECK_EQ(objects.GetCount(), 0u);
+}
+
+static void TestFrameArena() {
+    static constexpr uint32_t THREAD_COUNT = 4;
+    static constexpr uint32_t ALLOCATION_COUNT = 1000;
+    AdFrameArena arena(64 * 1024);
+
+    // 多线程同时分配, 每个分配写入自己的标记, 结束后检查没有重叠
+    for (int frame = 0; frame < 3; frame++) {
+        std::vector<std::vector<uint32_t *>> allocations(THREAD_COUNT);
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < THREAD_COUNT; t++) {
+            threads.emplace_back([&arena, &allocations, t]() {
+                for (uint32_t i = 0; i < ALLOCATION_COUNT; i++) {
+                    uint32_t *value = arena.AllocateArray<uint32_t>(4);
+                    value[0] = value[1] = value[2] = value[3] = t * ALLOCATION_COUNT + i;
+                    allocations[t].push_back(value);
+                }
+            });
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+        bool bIntact = true;
+        for (uint32_t t = 0; t < THREAD_COUNT; t++) {
+            for (uint32_t i = 0; i < ALLOCATION_COUNT; i++) {
+                const uint32_t *value = allocations[t][i];
+                uint32_t expected = t * ALLOCATION_COUNT + i;
+                bIntact = bIntact && IsAligned(value, alignof(uint32_t)) && value[0] == expected
+                          && value[3] == expected;
+            }
+        }
+        AD_CHECK(bIntact);
+        AD_CHECK(arena.GetUsedSize() >= THREAD_COUNT * ALLOCATION_COUNT * 4 * sizeof(uint32_t));
+        arena.Reset();
+        AD_CHECK_EQ(arena.GetUsedSize(), 0u);
+    }
+
+    // 第一帧溢出, Reset 时扩容到峰值, 之后同样的用量不再溢出
+    AD_CHECK(arena.GetCapacity() >= THREAD_COUNT * ALLOCATION_COUNT * 4 * sizeof(uint32_t));
+    size_t capacity = arena.GetCapacity();
+    AD_CHECK(IsAligned(arena.Allocate(capacity / 2, 64), 64));
+    AD_CHECK(IsAligned(arena.Allocate(capacity, 64), 64));
+    arena.Reset();
+    AD_CHECK(arena.GetLastFrameSize() >= capacity + capacity / 2);
+    AD_CHECK(arena.GetCapacity() >= arena.GetLastFrameSize());
+    capacity = arena.GetCapacity();
+    arena.Allocate(capacity / 2, 64);
+    arena.Allocate(capacity / 2 - 64, 64);
+    arena.Reset();
+    AD_CHECK_EQ(arena.GetCapacity(), capacity);
+}
+
+#ifdef AD_ENGINE_HAS_PMR
+static void TestMemoryResources() {
+    AdLinearAllocator allocator;
+    AdLinearResource linearResource(allocator);
+    std::pmr::vector<uint32_t> values(&linearResource);
+    for (uint32_t i = 0; i < 1000; i++) {
+        values.push_back(i);
+    }
+    AD_CHECK_EQ(values[999], 999u);
+    AD_CHECK(allocator.GetUsedSize() >= 1000 * sizeof(uint32_t));
+
+    AdFrameArena arena(4096);
+    AdFrameResource frameResource(arena);
+    std::pmr::vector<uint64_t> frameValues(1000, 7, &frameResource);
+    AD_CHECK_EQ(frameValues[500], 7u);
+
+    // 节点分配走池, 超过块大小的交给 upstream
+    AdPoolAllocator pool(64);
+    AdPoolResource poolResource(pool);
+    {
+        std::pmr::list<uint32_t> list(&poolResource);
+        for (uint32_t i = 0; i < 100; i++) {
+            list.push_back(i);
+        }
+        AD_CHECK_EQ(pool.GetAllocatedCount(), 100u);
+        std::pmr::vector<uint8_t> large(1024, 0, &poolResource);
+        AD_CHECK_EQ(pool.GetAllocatedCount(), 100u);
+    }
+    AD_CHECK_EQ(pool.GetAllocatedCount(), 0u);
+}
+#endif
+
+int main() {
+    AdLog::Init();
+
+    TestLinearAllocator();
+    TestScratchScope();
+    TestPoolAllocator();
+    TestFrameArena();
+#ifdef AD_ENGINE_HAS_PMR
+    TestMemoryResources();
+#endif
+    return AD_TEST_RESULT();
+}
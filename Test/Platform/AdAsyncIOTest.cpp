@@ -0,0 +1,100 @@
+#include "AdTestCommon.h"
+#include "AdLog.h"
+#include "FileSystem/AdAsyncIO.h"
+#include <cstring>
+#include <filesystem>
+
+using namespace ade;
+
+static void WriteText(const std::string &path, const std::string &text) {
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path());
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << text;
+}
+
+static std::vector<uint8_t> ToBytes(const std::string &text) {
+    return {text.begin(), text.end()};
+}
+
+static bool Equals(const AdFileView &view, const std::string &text) {
+    return view.GetSize() == text.size() && (text.empty() || std::memcmp(view.GetData(), text.data(), text.size()) == 0);
+}
+
+static AdIORequest MakeRequest(const std::string &path) {
+    AdIORequest request;
+    request.path = path;
+    return request;
+}
+
+// 异步读取的结果和状态应与同步的 AdFileSystem::Read 一致
+static void TestRead(AdAsyncIO &asyncIO, const std::string &path, const std::string &expected) {
+    AdIOHandle handle = asyncIO.Submit(MakeRequest(path));
+    AdFileView view = handle.GetFuture().get();
+    AD_CHECK(handle.GetStatus() == AdIOStatus::Completed);
+    AD_CHECK(Equals(view, expected));
+    AD_CHECK(Equals(AdFileSystem::Read(path), expected));
+}
+
+static void TestBackend(bool bPreferIOUring) {
+    AdAsyncIOSettings settings;
+    settings.bPreferIOUring = bPreferIOUring;
+    settings.fallbackThreadCount = 2;
+    AdAsyncIO asyncIO(settings);
+
+    // 打包条目: 空条目不能被当成散文件, 也不能越界
+    TestRead(asyncIO, "Packed/empty.bin", "");
+    TestRead(asyncIO, "Packed/data.bin", "packed data");
+    TestRead(asyncIO, "Packed/after_empty.bin", "after empty");
+
+    // 散文件读取整个文件
+    TestRead(asyncIO, "Loose/data.txt", "loose data");
+    TestRead(asyncIO, "Loose/empty.txt", "");
+
+    AdIOHandle missing = asyncIO.Submit(MakeRequest("Loose/missing.txt"));
+    missing.GetFuture().wait();
+    AD_CHECK(missing.GetStatus() == AdIOStatus::Failed);
+
+    std::vector<AdIORequest> requests;
+    for (int i = 0; i < 64; i++) {
+        requests.push_back(MakeRequest(i % 2 == 0 ? "Packed/empty.bin" : "Loose/data.txt"));
+    }
+    uint32_t completedCount = 0;
+    for (const AdIOHandle &handle: asyncIO.SubmitBatch(std::move(requests))) {
+        handle.GetFuture().wait();
+        completedCount += handle.GetStatus() == AdIOStatus::Completed ? 1 : 0;
+    }
+    AD_CHECK_EQ(completedCount, 64u);
+}
+
+int main() {
+    AdLog::Init();
+
+    std::string root = (std::filesystem::temp_directory_path() / "AdAsyncIOTest/").generic_string();
+    std::filesystem::remove_all(root);
+    WriteText(root + "Loose/data.txt", "loose data");
+    WriteText(root + "Loose/empty.txt", "");
+
+    AdArchiveWriter writer;
+    AD_CHECK(writer.AddFile("Packed/empty.bin", {}));
+    AD_CHECK(writer.AddFile("Packed/data.bin", ToBytes("packed data")));
+    AD_CHECK(writer.AddFile("Packed/after_empty.bin", ToBytes("after empty")));
+    // 规范化后相同的路径会让目录有歧义
+    AD_CHECK(!writer.AddFile("./Packed/data.bin", ToBytes("duplicate")));
+    AD_CHECK(writer.Write(root + "Test.adpak"));
+
+    AdFileSystem::Init(root);
+    AD_CHECK(AdFileSystem::Mount(root + "Test.adpak"));
+
+    AdFileLocation location;
+    AD_CHECK(AdFileSystem::Resolve("Packed/empty.bin", location));
+    AD_CHECK(!location.bLooseFile);
+    AD_CHECK_EQ(location.storedSize, 0u);
+    AD_CHECK(AdFileSystem::Resolve("Loose/empty.txt", location));
+    AD_CHECK(location.bLooseFile);
+
+    TestBackend(true);
+    TestBackend(false);
+
+    AdFileSystem::UnmountAll();
+    std::filesystem::remove_all(root);
+    return AD_TEST_RESULT();
+}
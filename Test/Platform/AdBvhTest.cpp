@@ -0,0 +1,340 @@
+#include "AdTestCommon.h"
+#include "AdLog.h"
+#include "Culling/AdBvh.h"
+#include "Math/AdMatrix.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace ade;
+
+// 查询结果与逐个叶子包围盒的暴力测试一致; 叶子包围盒对 Build 是原始包围盒, 对 Insert / Update 是扩大后的包围盒
+static constexpr uint32_t AD_TEST_PROXY_COUNT = 3000;
+static constexpr float AD_TEST_FAT_MARGIN = 0.5f;
+
+struct AdTestLeaf {
+    AdBoundingBox box;
+    uint32_t userData;
+};
+
+static AdBoundingBox MakeBox(std::mt19937 &random) {
+    std::uniform_real_distribution<float> position(-200.0f, 200.0f);
+    std::uniform_real_distribution<float> size(0.1f, 8.0f);
+    AdBoundingBox box;
+    for (int c = 0; c < 3; c++) {
+        box.min[c] = position(random);
+        box.max[c] = box.min[c] + size(random);
+    }
+    return box;
+}
+
+// 与 AdBvh 的节点测试相同: 中心和半边长投影到平面法线上
+static bool IsInFrustum(const AdFrustum &frustum, const AdBoundingBox &box) {
+    float center[3], extent[3];
+    for (int i = 0; i < 3; i++) {
+        center[i] = (box.min[i] + box.max[i]) * 0.5f;
+        extent[i] = (box.max[i] - box.min[i]) * 0.5f;
+    }
+    for (const float *plane: frustum.planes) {
+        float distance = plane[0] * center[0] + plane[1] * center[1] + plane[2] * center[2] + plane[3];
+        float radius = std::fabs(plane[0]) * extent[0] + std::fabs(plane[1]) * extent[1]
+                       + std::fabs(plane[2]) * extent[2];
+        if (distance + radius < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool IsOverlapping(const AdBoundingBox &a, const AdBoundingBox &b) {
+    for (int i = 0; i < 3; i++) {
+        if (a.max[i] < b.min[i] || a.min[i] > b.max[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool IsInSphere(const AdBoundingSphere &sphere, const AdBoundingBox &box) {
+    float nearest = 0.0f;
+    for (int i = 0; i < 3; i++) {
+        float c = sphere.center[i];
+        float d = c < box.min[i] ? box.min[i] - c : (c > box.max[i] ? c - box.max[i] : 0.0f);
+        nearest += d * d;
+    }
+    return nearest <= sphere.radius * sphere.radius;
+}
+
+// 射线进入包围盒的距离, 不相交时返回负数
+static float IntersectRay(const AdRay &ray, const AdBoundingBox &box) {
+    float tMin = 0.0f;
+    float tMax = ray.maxDistance;
+    for (int i = 0; i < 3; i++) {
+        float invDirection = 1.0f / ray.direction[i];
+        float t0 = (box.min[i] - ray.origin[i]) * invDirection;
+        float t1 = (box.max[i] - ray.origin[i]) * invDirection;
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+        tMin = t0 > tMin ? t0 : tMin;
+        tMax = t1 < tMax ? t1 : tMax;
+        if (tMin > tMax) {
+            return -1.0f;
+        }
+    }
+    return tMin;
+}
+
+template<typename Predicate>
+static std::vector<uint32_t> BruteForce(const std::vector<AdTestLeaf> &leaves, Predicate predicate) {
+    std::vector<uint32_t> result;
+    for (const AdTestLeaf &leaf: leaves) {
+        if (predicate(leaf.box)) {
+            result.push_back(leaf.userData);
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+static std::vector<uint32_t> Sorted(std::vector<uint32_t> values) {
+    std::sort(values.begin(), values.end());
+    return values;
+}
+
+static std::vector<AdFrustum> MakeFrustums() {
+    std::vector<AdFrustum> frustums(6);
+    for (uint32_t view = 0; view < frustums.size(); view++) {
+        float angle = static_cast<float>(view) * 1.1f;
+        AdMat4 viewProj = AdMat4::Perspective(0.5f + 0.2f * static_cast<float>(view), 16.0f / 9.0f, 0.1f, 250.0f) *
+                          AdMat4::LookAt({0.0f, 5.0f, 0.0f}, {std::cos(angle), 0.1f, std::sin(angle)},
+                                         {0.0f, 1.0f, 0.0f});
+        ExtractFrustumPlanes(viewProj.Data(), frustums[view]);
+    }
+    // 把所有物体都包含在内, 覆盖整棵子树都在内侧的路径
+    ExtractFrustumPlanes(AdMat4::Orthographic(-500.0f, 500.0f, -500.0f, 500.0f, -500.0f, 500.0f).Data(),
+                         frustums.emplace_back());
+    return frustums;
+}
+
+// 所有查询都与暴力结果相同, 返回不一致的次数
+static uint32_t CompareQueries(const AdBvh &bvh, const std::vector<AdTestLeaf> &leaves, std::mt19937 &random) {
+    uint32_t mismatchCount = 0;
+    std::vector<uint32_t> result;
+    for (const AdFrustum &frustum: MakeFrustums()) {
+        result.clear();
+        bvh.QueryFrustum(frustum, result);
+        mismatchCount += Sorted(result) != BruteForce(leaves, [&](const AdBoundingBox &box) {
+            return IsInFrustum(frustum, box);
+        }) ? 1 : 0;
+    }
+
+    std::uniform_real_distribution<float> position(-220.0f, 220.0f);
+    std::uniform_real_distribution<float> size(1.0f, 80.0f);
+    for (uint32_t i = 0; i < 50; i++) {
+        AdBoundingBox query = MakeBox(random);
+        for (int c = 0; c < 3; c++) {
+            query.max[c] += size(random);
+        }
+        result.clear();
+        bvh.QueryBox(query, result);
+        mismatchCount += Sorted(result) != BruteForce(leaves, [&](const AdBoundingBox &box) {
+            return IsOverlapping(query, box);
+        }) ? 1 : 0;
+
+        AdBoundingSphere sphere{{position(random), position(random), position(random)}, size(random)};
+        result.clear();
+        bvh.QuerySphere(sphere, result);
+        mismatchCount += Sorted(result) != BruteForce(leaves, [&](const AdBoundingBox &box) {
+            return IsInSphere(sphere, box);
+        }) ? 1 : 0;
+    }
+
+    // 最近命中的距离与暴力结果相同, 命中的物体确实在这个距离上
+    std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+    for (uint32_t i = 0; i < 500; i++) {
+        AdRay ray{{position(random), position(random), position(random)},
+                  {direction(random), direction(random), direction(random)}};
+        if (i % 4 == 0) {
+            ray.maxDistance = 100.0f;
+        }
+        float closest = FLT_MAX;
+        for (const AdTestLeaf &leaf: leaves) {
+            float distance = IntersectRay(ray, leaf.box);
+            if (distance >= 0.0f && distance < closest) {
+                closest = distance;
+            }
+        }
+        AdRayHit hit;
+        bool bHit = bvh.RayCast(ray, hit);
+        if (bHit != (closest != FLT_MAX)) {
+            mismatchCount++;
+        } else if (bHit) {
+            auto leaf = std::find_if(leaves.begin(), leaves.end(), [&](const AdTestLeaf &l) {
+                return l.userData == hit.userData;
+            });
+            mismatchCount += hit.distance != closest || IntersectRay(ray, leaf->box) != closest ? 1 : 0;
+        }
+    }
+    return mismatchCount;
+}
+
+static void TestBuild() {
+    std::mt19937 random(12345);
+    std::vector<AdBoundingBox> boxes(AD_TEST_PROXY_COUNT);
+    std::vector<uint32_t> userData(AD_TEST_PROXY_COUNT);
+    std::vector<AdTestLeaf> leaves(AD_TEST_PROXY_COUNT);
+    for (uint32_t i = 0; i < AD_TEST_PROXY_COUNT; i++) {
+        boxes[i] = MakeBox(random);
+        userData[i] = 1000 + i * 7;
+        leaves[i] = {boxes[i], userData[i]};
+    }
+    AdBvh bvh;
+    std::vector<uint32_t> proxies(AD_TEST_PROXY_COUNT);
+    bvh.Build(boxes.data(), userData.data(), AD_TEST_PROXY_COUNT, proxies.data());
+    AD_CHECK_EQ(bvh.GetProxyCount(), AD_TEST_PROXY_COUNT);
+    AD_CHECK_EQ(bvh.GetUserData(proxies[17]), userData[17]);
+    AD_CHECK(bvh.GetHeight() < 40);
+    AD_CHECK_EQ(CompareQueries(bvh, leaves, random), 0u);
+}
+
+// 动态插入后移动、删除, 再重建内部节点, 每一步查询都与当前的叶子包围盒一致
+static void TestDynamic() {
+    std::mt19937 random(777);
+    AdBvh bvh(AD_TEST_FAT_MARGIN);
+    std::vector<AdBoundingBox> boxes(AD_TEST_PROXY_COUNT);
+    std::vector<uint32_t> proxies(AD_TEST_PROXY_COUNT);
+    for (uint32_t i = 0; i < AD_TEST_PROXY_COUNT; i++) {
+        boxes[i] = MakeBox(random);
+        proxies[i] = bvh.Insert(boxes[i], i);
+    }
+    auto collectLeaves = [&] {
+        std::vector<AdTestLeaf> leaves;
+        for (uint32_t i = 0; i < AD_TEST_PROXY_COUNT; i++) {
+            if (proxies[i] != AdBvh::INVALID) {
+                leaves.push_back({bvh.GetFatBounds(proxies[i]), i});
+            }
+        }
+        return leaves;
+    };
+    AD_CHECK_EQ(CompareQueries(bvh, collectLeaves(), random), 0u);
+
+    // 小的移动留在扩大的范围内不改动树, 大的移动重新插入; 扩大的包围盒总是包含实际包围盒
+    std::uniform_real_distribution<float> smallMove(-0.2f, 0.2f);
+    std::uniform_real_distribution<float> largeMove(-50.0f, 50.0f);
+    uint32_t containedCount = 0, smallChangedCount = 0;
+    for (uint32_t frame = 0; frame < 4; frame++) {
+        for (uint32_t i = 0; i < AD_TEST_PROXY_COUNT; i++) {
+            bool bLarge = (i + frame) % 3 == 0;
+            for (int c = 0; c < 3; c++) {
+                float delta = bLarge ? largeMove(random) : smallMove(random) * 0.5f;
+                boxes[i].min[c] += delta;
+                boxes[i].max[c] += delta;
+            }
+            AdBoundingBox before = bvh.GetFatBounds(proxies[i]);
+            bool bChanged = bvh.Update(proxies[i], boxes[i]);
+            smallChangedCount += !bLarge && frame == 0 && bChanged ? 1 : 0;
+            const AdBoundingBox &fat = bvh.GetFatBounds(proxies[i]);
+            bool bContained = true;
+            for (int c = 0; c < 3; c++) {
+                bContained = bContained && fat.min[c] <= boxes[i].min[c] && fat.max[c] >= boxes[i].max[c];
+                bContained = bContained && (bChanged || (fat.min[c] == before.min[c] && fat.max[c] == before.max[c]));
+            }
+            containedCount += bContained ? 1 : 0;
+        }
+        AD_CHECK_EQ(CompareQueries(bvh, collectLeaves(), random), 0u);
+    }
+    AD_CHECK_EQ(containedCount, 4 * AD_TEST_PROXY_COUNT);
+    AD_CHECK_EQ(smallChangedCount, 0u);
+
+    for (uint32_t i = 0; i < AD_TEST_PROXY_COUNT; i += 3) {
+        bvh.Remove(proxies[i]);
+        proxies[i] = AdBvh::INVALID;
+    }
+    AD_CHECK_EQ(bvh.GetProxyCount(), AD_TEST_PROXY_COUNT - (AD_TEST_PROXY_COUNT + 2) / 3);
+    AD_CHECK(bvh.GetHeight() < 40);
+    AD_CHECK_EQ(CompareQueries(bvh, collectLeaves(), random), 0u);
+
+    // 重建后代理 id 和叶子包围盒不变; 删除的代理的节点会被之后的插入复用
+    bvh.Rebuild();
+    AD_CHECK_EQ(CompareQueries(bvh, collectLeaves(), random), 0u);
+    proxies[0] = bvh.Insert(boxes[0], 0);
+    AD_CHECK_EQ(bvh.GetUserData(proxies[0]), 0u);
+    AD_CHECK_EQ(CompareQueries(bvh, collectLeaves(), random), 0u);
+}
+
+static void TestDegenerate() {
+    AdFrustum frustum;
+    ExtractFrustumPlanes(AdMat4::Orthographic(-10.0f, 10.0f, -10.0f, 10.0f, -10.0f, 10.0f).Data(), frustum);
+    AdRay ray{{0.0f, 0.0f, -20.0f}, {0.0f, 0.0f, 1.0f}};
+    std::vector<uint32_t> result;
+    AdRayHit hit;
+
+    // 空树
+    AdBvh bvh;
+    bvh.Build(nullptr, nullptr, 0, nullptr);
+    AD_CHECK_EQ(bvh.GetProxyCount(), 0u);
+    AD_CHECK_EQ(bvh.GetHeight(), 0);
+    bvh.QueryFrustum(frustum, result);
+    AD_CHECK(result.empty());
+    AD_CHECK(!bvh.RayCast(ray, hit));
+    AD_CHECK_EQ(hit.userData, AdBvh::INVALID);
+    bvh.Rebuild();
+    AD_CHECK(!bvh.RayCast(ray, hit));
+
+    // 一个物体: 根节点就是叶子
+    AdBoundingBox box{{-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}};
+    uint32_t userData = 42, proxy;
+    bvh.Build(&box, &userData, 1, &proxy);
+    AD_CHECK_EQ(bvh.GetHeight(), 0);
+    bvh.QueryFrustum(frustum, result);
+    AD_CHECK(result == std::vector<uint32_t>{42});
+    AD_CHECK(bvh.RayCast(ray, hit));
+    AD_CHECK_EQ(hit.userData, 42u);
+    AD_CHECK_EQ(hit.distance, 19.0f);
+    bvh.Remove(proxy);
+    AD_CHECK_EQ(bvh.GetProxyCount(), 0u);
+    AD_CHECK(!bvh.RayCast(ray, hit));
+
+    // 包围盒完全重合: 构建按数量对半分, 动态插入也保持平衡, 查询返回所有物体
+    const uint32_t count = 1000;
+    std::vector<AdBoundingBox> boxes(count, box);
+    bvh.Build(boxes.data(), nullptr, count, nullptr);
+    AD_CHECK(bvh.GetHeight() <= 12);
+    result.clear();
+    bvh.QueryFrustum(frustum, result);
+    std::vector<uint32_t> all(count);
+    for (uint32_t i = 0; i < count; i++) {
+        all[i] = i;
+    }
+    AD_CHECK(Sorted(result) == all);
+    AD_CHECK(bvh.RayCast(ray, hit));
+    AD_CHECK_EQ(hit.distance, 19.0f);
+
+    AdBvh dynamicBvh(0.0f);
+    for (uint32_t i = 0; i < count; i++) {
+        dynamicBvh.Insert(box, i);
+    }
+    AD_CHECK(dynamicBvh.GetHeight() <= 24);
+    result.clear();
+    dynamicBvh.QuerySphere({{0.0f, 0.0f, 0.0f}, 0.5f}, result);
+    AD_CHECK(Sorted(result) == all);
+
+    // 退化成点的包围盒
+    AdBoundingBox point{{3.0f, 3.0f, 3.0f}, {3.0f, 3.0f, 3.0f}};
+    bvh.Build(&point, nullptr, 1, nullptr);
+    result.clear();
+    bvh.QueryBox(box, result);
+    AD_CHECK(result.empty());
+    bvh.QueryBox({{2.0f, 2.0f, 2.0f}, {4.0f, 4.0f, 4.0f}}, result);
+    AD_CHECK(result == std::vector<uint32_t>{0});
+}
+
+int main() {
+    AdLog::Init();
+
+    TestBuild();
+    TestDynamic();
+    TestDegenerate();
+    return AD_TEST_RESULT();
+}
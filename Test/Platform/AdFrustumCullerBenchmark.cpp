@@ -0,0 +1,121 @@
+#include "AdTestCommon.h"
+#include "Culling/AdFrustumCuller.h"
+#include "Culling/AdCullingSimd.h"
+#include "Math/AdMatrix.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace ade;
+
+// 50 万个实例对一个视图、以及主视图加 4 级阴影级联的单线程剔除耗时, 对比逐个实例的标量 AABB 测试
+// 目标是每个视图远低于 1 ms; 计时只在 Release 下有意义, 每项取多次运行中最快的一次
+static constexpr uint32_t AD_BENCH_INSTANCE_COUNT = 500000;
+static constexpr uint32_t AD_BENCH_RUNS = 20;
+static constexpr uint32_t AD_BENCH_CASCADE_COUNT = 4;
+
+static volatile uint32_t gSink = 0;
+
+template<typename Func>
+static double MeasureMicroseconds(Func &&func) {
+    double best = 1e30;
+    for (uint32_t run = 0; run < AD_BENCH_RUNS; run++) {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+// 常见的 AoS 写法: 逐个包围盒, 对每个平面取最靠内的角点
+static uint32_t CullScalar(const AdFrustum &frustum, const std::vector<AdBoundingBox> &boxes, uint32_t *outIndices) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < boxes.size(); i++) {
+        const AdBoundingBox &box = boxes[i];
+        bool bVisible = true;
+        for (const float *plane: frustum.planes) {
+            float x = plane[0] >= 0.0f ? box.max[0] : box.min[0];
+            float y = plane[1] >= 0.0f ? box.max[1] : box.min[1];
+            float z = plane[2] >= 0.0f ? box.max[2] : box.min[2];
+            if (plane[0] * x + plane[1] * y + plane[2] * z + plane[3] < 0.0f) {
+                bVisible = false;
+                break;
+            }
+        }
+        outIndices[count] = i;
+        count += bVisible ? 1 : 0;
+    }
+    return count;
+}
+
+int main() {
+    std::printf("AdFrustumCuller: %u lanes, %u instances\n", AD_LANE_COUNT, AD_BENCH_INSTANCE_COUNT);
+    std::mt19937 random(12345);
+    std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+    std::uniform_real_distribution<float> size(0.5f, 10.0f);
+    std::vector<AdBoundingBox> boxes(AD_BENCH_INSTANCE_COUNT);
+    AdFrustumCuller culler;
+    culler.Resize(AD_BENCH_INSTANCE_COUNT);
+    for (uint32_t i = 0; i < AD_BENCH_INSTANCE_COUNT; i++) {
+        for (int c = 0; c < 3; c++) {
+            boxes[i].min[c] = position(random);
+            boxes[i].max[c] = boxes[i].min[c] + size(random);
+        }
+        culler.SetBounds(i, boxes[i]);
+    }
+
+    // 主视图和按距离分段的阴影级联(正交)
+    AdFrustum frustums[1 + AD_BENCH_CASCADE_COUNT];
+    AdMat4 view = AdMat4::LookAt({0.0f, 20.0f, 0.0f}, {1.0f, 19.8f, 0.3f}, {0.0f, 1.0f, 0.0f});
+    ExtractFrustumPlanes((AdMat4::Perspective(1.0f, 16.0f / 9.0f, 0.1f, 1000.0f) * view).Data(), frustums[0]);
+    AdMat4 lightView = AdMat4::LookAt({0.0f, 500.0f, 0.0f}, {0.3f, 0.0f, 0.2f}, {0.0f, 0.0f, 1.0f});
+    for (uint32_t cascade = 0; cascade < AD_BENCH_CASCADE_COUNT; cascade++) {
+        float halfSize = 50.0f * static_cast<float>(1u << (2 * cascade));
+        ExtractFrustumPlanes((AdMat4::Orthographic(-halfSize, halfSize, -halfSize, halfSize, 0.1f, 1000.0f) *
+                              lightView).Data(), frustums[1 + cascade]);
+    }
+
+    std::vector<uint32_t> scalarIndices(AD_BENCH_INSTANCE_COUNT);
+    std::vector<std::vector<uint32_t>> indices(1 + AD_BENCH_CASCADE_COUNT,
+                                               std::vector<uint32_t>(AD_BENCH_INSTANCE_COUNT));
+    uint32_t scalarCount = 0, simdCount = 0;
+    double scalarUs = MeasureMicroseconds([&] {
+        scalarCount = CullScalar(frustums[0], boxes, scalarIndices.data());
+        gSink = gSink + scalarCount;
+    });
+    double simdUs = MeasureMicroseconds([&] {
+        simdCount = culler.Cull(frustums[0], indices[0].data());
+        gSink = gSink + simdCount;
+    });
+    std::printf("%-24s scalar %9.1f us   simd %9.1f us   x%.2f   visible %u\n", "one view", scalarUs, simdUs,
+                scalarUs / simdUs, simdCount);
+
+    uint32_t *outIndices[1 + AD_BENCH_CASCADE_COUNT];
+    uint32_t outCounts[1 + AD_BENCH_CASCADE_COUNT];
+    for (uint32_t i = 0; i <= AD_BENCH_CASCADE_COUNT; i++) {
+        outIndices[i] = indices[i].data();
+    }
+    double viewsUs = MeasureMicroseconds([&] {
+        culler.CullViews(frustums, 1 + AD_BENCH_CASCADE_COUNT, 0, AD_BENCH_INSTANCE_COUNT, outIndices, outCounts);
+        gSink = gSink + outCounts[0];
+    });
+    std::printf("%-24s simd %9.1f us   %.1f us per view\n", "view + 4 cascades", viewsUs,
+                viewsUs / (1 + AD_BENCH_CASCADE_COUNT));
+
+    // 与标量版本的可见集合相同; 两者的舍入不同, 允许个别恰好贴着平面的实例不一致(精确比较见 AdFrustumCullerTest)
+    uint32_t mismatchCount = 0;
+    std::vector<bool> bVisible(AD_BENCH_INSTANCE_COUNT, false);
+    for (uint32_t i = 0; i < simdCount; i++) {
+        bVisible[indices[0][i]] = true;
+    }
+    for (uint32_t i = 0; i < scalarCount; i++) {
+        mismatchCount += bVisible[scalarIndices[i]] ? 0 : 1;
+    }
+    mismatchCount += simdCount > scalarCount ? simdCount - scalarCount : scalarCount - simdCount;
+    AD_CHECK(mismatchCount <= 2);
+    AD_CHECK_EQ(outCounts[0], simdCount);
+    return AD_TEST_RESULT();
+}
@@ -0,0 +1,166 @@
+#include "AdTestCommon.h"
+#include "AdLog.h"
+#include "Culling/AdFrustumCuller.h"
+#include "Math/AdMatrix.h"
+#include <cmath>
+#include <random>
+
+using namespace ade;
+
+// SoA / SIMD 剔除与逐个实例的标量 AABB / 包围球测试结果完全一致
+// 数量不是 SIMD 宽度的整数倍, 覆盖最后不满的一批
+static constexpr uint32_t AD_TEST_INSTANCE_COUNT = 20003;
+
+// 与 AdCullingSimd.h 的 LaneMulAdd 相同: 只有 AVX2 + FMA 时是融合乘加
+static float MulAdd(float a, float b, float c) {
+#if defined(__AVX2__) && defined(__FMA__)
+    return std::fma(a, b, c);
+#else
+    return a * b + c;
+#endif
+}
+
+struct AdTestBounds {
+    float center[3];
+    float extent[3];
+    float radius;
+};
+
+// 标量参考: 包围体完全在任何一个平面外侧时剔除, 运算顺序与 SIMD 版本相同
+static bool IsVisibleScalar(const AdFrustum &frustum, const AdTestBounds &bounds) {
+    for (const float *plane: frustum.planes) {
+        float distance = MulAdd(plane[0], bounds.center[0],
+                                MulAdd(plane[1], bounds.center[1], MulAdd(plane[2], bounds.center[2], plane[3])));
+        float reach = MulAdd(std::fabs(plane[0]), bounds.extent[0],
+                             MulAdd(std::fabs(plane[1]), bounds.extent[1],
+                                    MulAdd(std::fabs(plane[2]), bounds.extent[2], bounds.radius)));
+        if (distance < -reach) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::vector<uint32_t> CullScalar(const AdFrustum &frustum, const std::vector<AdTestBounds> &bounds) {
+    std::vector<uint32_t> visible;
+    for (uint32_t i = 0; i < bounds.size(); i++) {
+        if (IsVisibleScalar(frustum, bounds[i])) {
+            visible.push_back(i);
+        }
+    }
+    return visible;
+}
+
+// 一半包围盒、一半包围球
+static std::vector<AdTestBounds> MakeBounds(std::mt19937 &random, AdFrustumCuller &culler) {
+    std::uniform_real_distribution<float> position(-300.0f, 300.0f);
+    std::uniform_real_distribution<float> size(0.1f, 30.0f);
+    std::vector<AdTestBounds> bounds(AD_TEST_INSTANCE_COUNT);
+    culler.Resize(AD_TEST_INSTANCE_COUNT);
+    for (uint32_t i = 0; i < AD_TEST_INSTANCE_COUNT; i++) {
+        AdTestBounds &b = bounds[i];
+        if (i % 2 == 0) {
+            AdBoundingBox box;
+            for (int c = 0; c < 3; c++) {
+                box.min[c] = position(random);
+                box.max[c] = box.min[c] + size(random);
+                b.center[c] = (box.min[c] + box.max[c]) * 0.5f;
+                b.extent[c] = (box.max[c] - box.min[c]) * 0.5f;
+            }
+            b.radius = 0.0f;
+            culler.SetBounds(i, box);
+        } else {
+            AdBoundingSphere sphere{{position(random), position(random), position(random)}, size(random)};
+            for (int c = 0; c < 3; c++) {
+                b.center[c] = sphere.center[c];
+                b.extent[c] = 0.0f;
+            }
+            b.radius = sphere.radius;
+            culler.SetBounds(i, sphere);
+        }
+    }
+    return bounds;
+}
+
+static std::vector<AdFrustum> MakeFrustums(uint32_t count) {
+    std::vector<AdFrustum> frustums(count);
+    for (uint32_t view = 0; view < count; view++) {
+        float angle = static_cast<float>(view) * 0.8f;
+        AdMat4 viewProj = AdMat4::Perspective(0.6f + 0.1f * static_cast<float>(view), 16.0f / 9.0f, 0.1f, 400.0f) *
+                          AdMat4::LookAt({0.0f, 10.0f, 0.0f}, {std::cos(angle), 0.2f, std::sin(angle)},
+                                         {0.0f, 1.0f, 0.0f});
+        ExtractFrustumPlanes(viewProj.Data(), frustums[view]);
+    }
+    return frustums;
+}
+
+static std::vector<uint32_t> ToVector(const std::vector<uint32_t> &indices, uint32_t count) {
+    return {indices.begin(), indices.begin() + count};
+}
+
+static void TestMatchesScalar(const AdFrustumCuller &culler, const std::vector<AdTestBounds> &bounds,
+                              const std::vector<AdFrustum> &frustums) {
+    std::vector<uint32_t> indices(AD_TEST_INSTANCE_COUNT);
+    for (const AdFrustum &frustum: frustums) {
+        std::vector<uint32_t> expected = CullScalar(frustum, bounds);
+        AD_CHECK(!expected.empty() && expected.size() < bounds.size());
+        AD_CHECK(ToVector(indices, culler.Cull(frustum, indices.data())) == expected);
+
+        // 分段剔除后按顺序拼接, 段边界不对齐 SIMD 宽度
+        std::vector<uint32_t> joined;
+        for (uint32_t begin = 0; begin < AD_TEST_INSTANCE_COUNT; begin += 1001) {
+            uint32_t count = culler.Cull(frustum, begin, std::min(begin + 1001, AD_TEST_INSTANCE_COUNT), indices.data());
+            joined.insert(joined.end(), indices.begin(), indices.begin() + count);
+        }
+        AD_CHECK(joined == expected);
+    }
+
+    // 多视图一次遍历, 超过 MAX_VIEW_COUNT 时分批
+    uint32_t viewCount = static_cast<uint32_t>(frustums.size());
+    std::vector<std::vector<uint32_t>> viewIndices(viewCount, std::vector<uint32_t>(AD_TEST_INSTANCE_COUNT));
+    std::vector<uint32_t *> viewPointers;
+    for (auto &view: viewIndices) {
+        viewPointers.push_back(view.data());
+    }
+    std::vector<uint32_t> viewCounts(viewCount);
+    culler.CullViews(frustums.data(), viewCount, 0, AD_TEST_INSTANCE_COUNT, viewPointers.data(), viewCounts.data());
+    bool bSame = true;
+    for (uint32_t view = 0; view < viewCount; view++) {
+        bSame = bSame && ToVector(viewIndices[view], viewCounts[view]) == CullScalar(frustums[view], bounds);
+    }
+    AD_CHECK(bSame);
+}
+
+// 包围盒按 AABB 测试, 而不是外接球: 细长的盒子在平面外侧, 外接球却与平面相交
+static void TestBoxIsNotSphere() {
+    AdFrustum frustum;
+    ExtractFrustumPlanes(AdMat4::Orthographic(-10.0f, 10.0f, -10.0f, 10.0f, 0.1f, 100.0f).Data(), frustum);
+    AdFrustumCuller culler;
+    culler.Resize(3);
+    culler.SetBounds(0, AdBoundingBox{{10.5f, -5.0f, -10.0f}, {11.5f, 5.0f, -5.0f}});
+    culler.SetBounds(1, AdBoundingBox{{9.5f, -5.0f, -10.0f}, {10.5f, 5.0f, -5.0f}});
+    culler.SetBounds(2, AdBoundingSphere{{11.0f, 0.0f, -7.5f}, 2.0f});
+    uint32_t indices[3];
+    uint32_t count = culler.Cull(frustum, indices);
+    AD_CHECK_EQ(count, 2u);
+    AD_CHECK_EQ(indices[0], 1u);
+    AD_CHECK_EQ(indices[1], 2u);
+
+    // 无效包围盒和扩大后新增的实例总是被剔除
+    culler.SetBounds(1, AdBoundingBox{});
+    culler.Resize(5);
+    count = culler.Cull(frustum, indices);
+    AD_CHECK_EQ(count, 1u);
+    AD_CHECK_EQ(indices[0], 2u);
+}
+
+int main() {
+    AdLog::Init();
+
+    std::mt19937 random(12345);
+    AdFrustumCuller culler;
+    std::vector<AdTestBounds> bounds = MakeBounds(random, culler);
+    TestMatchesScalar(culler, bounds, MakeFrustums(AdFrustumCuller::MAX_VIEW_COUNT + 3));
+    TestBoxIsNotSphere();
+    return AD_TEST_RESULT();
+}
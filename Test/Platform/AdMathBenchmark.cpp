@@ -0,0 +1,187 @@
+#include "AdTestCommon.h"
+#include "Math/AdMathKernels.h"
+#include "Culling/AdCullingSimd.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace ade;
+
+// 对比 SSE/AVX 实现和同样算法的标量循环, 同时检查两者结果一致
+// 计时只在 Release 下有意义; 每项取多次运行中最快的一次
+static constexpr uint32_t AD_BENCH_COUNT = 10000;
+static constexpr uint32_t AD_BENCH_RUNS = 20;
+
+// 防止结果被优化掉
+static volatile float gSink = 0.0f;
+
+template<typename Func>
+static double MeasureMicroseconds(Func &&func) {
+    double best = 1e30;
+    for (uint32_t run = 0; run < AD_BENCH_RUNS; run++) {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+static void Report(const char *name, double scalarUs, double simdUs) {
+    std::printf("%-32s scalar %9.1f us   simd %9.1f us   x%.2f\n", name, scalarUs, simdUs, scalarUs / simdUs);
+}
+
+static bool NearlyEqual(const float *a, const float *b, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        if (std::fabs(a[i] - b[i]) > 1e-3f * std::max(1.0f, std::fabs(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ------------------------- 标量参考实现, 列主序 -------------------------
+
+static void ScalarMultiply(const float *a, const float *b, float *out) {
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++) {
+            out[c * 4 + r] = a[r] * b[c * 4] + a[4 + r] * b[c * 4 + 1] + a[8 + r] * b[c * 4 + 2] +
+                             a[12 + r] * b[c * 4 + 3];
+        }
+    }
+}
+
+static void ScalarTransformPoint(const float *m, const AdVec3 &p, AdVec3 &out) {
+    out.x = m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12];
+    out.y = m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13];
+    out.z = m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14];
+}
+
+// ------------------------- 测试数据 -------------------------
+
+static std::vector<AdMat4> MakeMatrices(std::mt19937 &random, uint32_t count) {
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+    std::vector<AdMat4> matrices(count);
+    for (AdMat4 &m: matrices) {
+        AdQuat rotation = Normalize(AdQuat(value(random), value(random), value(random), value(random)));
+        m = AdMat4::TRS({value(random) * 100.0f, value(random) * 100.0f, value(random) * 100.0f}, rotation,
+                        {scale(random), scale(random), scale(random)});
+    }
+    return matrices;
+}
+
+static void BenchMultiply(const std::vector<AdMat4> &a, const std::vector<AdMat4> &b) {
+    std::vector<AdMat4> scalar(AD_BENCH_COUNT), simd(AD_BENCH_COUNT), kernel(AD_BENCH_COUNT);
+    double scalarUs = MeasureMicroseconds([&] {
+        for (uint32_t i = 0; i < AD_BENCH_COUNT; i++) {
+            ScalarMultiply(a[i].Data(), b[i].Data(), scalar[i].Data());
+        }
+        gSink = gSink + scalar[AD_BENCH_COUNT - 1].Data()[0];
+    });
+    double simdUs = MeasureMicroseconds([&] {
+        for (uint32_t i = 0; i < AD_BENCH_COUNT; i++) {
+            simd[i] = a[i] * b[i];
+        }
+        gSink = gSink + simd[AD_BENCH_COUNT - 1].Data()[0];
+    });
+    double kernelUs = MeasureMicroseconds([&] {
+        MultiplyMatrices(a.data(), b.data(), kernel.data(), AD_BENCH_COUNT);
+        gSink = gSink + kernel[AD_BENCH_COUNT - 1].Data()[0];
+    });
+    Report("mat4 * mat4 (operator*)", scalarUs, simdUs);
+    Report("mat4 * mat4 (MultiplyMatrices)", scalarUs, kernelUs);
+    AD_CHECK(NearlyEqual(simd[0].Data(), scalar[0].Data(), 16 * AD_BENCH_COUNT));
+    AD_CHECK(NearlyEqual(kernel[0].Data(), scalar[0].Data(), 16 * AD_BENCH_COUNT));
+}
+
+static void BenchTransform(std::mt19937 &random, const AdMat4 &m) {
+    std::uniform_real_distribution<float> value(-100.0f, 100.0f);
+    std::vector<AdVec3> points(AD_BENCH_COUNT);
+    std::vector<float> x(AD_BENCH_COUNT), y(AD_BENCH_COUNT), z(AD_BENCH_COUNT);
+    for (uint32_t i = 0; i < AD_BENCH_COUNT; i++) {
+        points[i] = {value(random), value(random), value(random)};
+        x[i] = points[i].x;
+        y[i] = points[i].y;
+        z[i] = points[i].z;
+    }
+
+    std::vector<AdVec3> scalar(AD_BENCH_COUNT), aos(AD_BENCH_COUNT);
+    std::vector<float> outX(AD_BENCH_COUNT), outY(AD_BENCH_COUNT), outZ(AD_BENCH_COUNT);
+    double scalarUs = MeasureMicroseconds([&] {
+        for (uint32_t i = 0; i < AD_BENCH_COUNT; i++) {
+            ScalarTransformPoint(m.Data(), points[i], scalar[i]);
+        }
+        gSink = gSink + scalar[AD_BENCH_COUNT - 1].x;
+    });
+    double aosUs = MeasureMicroseconds([&] {
+        TransformPoints(m, points.data(), aos.data(), AD_BENCH_COUNT);
+        gSink = gSink + aos[AD_BENCH_COUNT - 1].x;
+    });
+    double soaUs = MeasureMicroseconds([&] {
+        TransformPoints(m, x.data(), y.data(), z.data(), outX.data(), outY.data(), outZ.data(), AD_BENCH_COUNT);
+        gSink = gSink + outX[AD_BENCH_COUNT - 1];
+    });
+    Report("transform point (AoS)", scalarUs, aosUs);
+    Report("transform point (SoA)", scalarUs, soaUs);
+
+    bool bSame = true;
+    for (uint32_t i = 0; i < AD_BENCH_COUNT; i++) {
+        const float expected[3] = {scalar[i].x, scalar[i].y, scalar[i].z};
+        const float fromAos[3] = {aos[i].x, aos[i].y, aos[i].z};
+        const float fromSoa[3] = {outX[i], outY[i], outZ[i]};
+        bSame = bSame && NearlyEqual(fromAos, expected, 3) && NearlyEqual(fromSoa, expected, 3);
+    }
+    AD_CHECK(bSame);
+}
+
+// 两种求逆都是标量代码, 这里对比一般矩阵和仿射矩阵的版本, 并检查 M * M^-1 = I
+static void BenchInverse(const std::vector<AdMat4> &matrices) {
+    std::vector<AdMat4> general(AD_BENCH_COUNT), affine(AD_BENCH_COUNT);
+    double generalUs = MeasureMicroseconds([&] {
+        for (uint32_t i = 0; i < AD_BENCH_COUNT; i++) {
+            general[i] = Inverse(matrices[i]);
+        }
+        gSink = gSink + general[AD_BENCH_COUNT - 1].Data()[0];
+    });
+    double affineUs = MeasureMicroseconds([&] {
+        for (uint32_t i = 0; i < AD_BENCH_COUNT; i++) {
+            affine[i] = InverseAffine(matrices[i]);
+        }
+        gSink = gSink + affine[AD_BENCH_COUNT - 1].Data()[0];
+    });
+    std::printf("%-32s general %8.1f us   affine %8.1f us   x%.2f\n", "mat4 inverse", generalUs, affineUs,
+                generalUs / affineUs);
+
+    const AdMat4 identity;
+    bool bSame = true;
+    for (uint32_t i = 0; i < AD_BENCH_COUNT; i++) {
+        bSame = bSame && NearlyEqual((matrices[i] * general[i]).Data(), identity.Data(), 16) &&
+                NearlyEqual((matrices[i] * affine[i]).Data(), identity.Data(), 16);
+    }
+    AD_CHECK(bSame);
+}
+
+int main() {
+#ifdef AD_MATH_SSE
+    std::printf("AdMath: SSE%s, %u lanes for SoA kernels\n",
+#if defined(__AVX__)
+                " + AVX",
+#else
+                "",
+#endif
+                AD_LANE_COUNT);
+#else
+    std::printf("AdMath: scalar fallback, simd columns below use the same code path\n");
+#endif
+    std::mt19937 random(12345);
+    std::vector<AdMat4> a = MakeMatrices(random, AD_BENCH_COUNT);
+    std::vector<AdMat4> b = MakeMatrices(random, AD_BENCH_COUNT);
+
+    BenchMultiply(a, b);
+    BenchTransform(random, a[0]);
+    BenchInverse(a);
+    return AD_TEST_RESULT();
+}
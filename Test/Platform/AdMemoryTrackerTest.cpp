@@ -0,0 +1,83 @@
+#include "AdTestCommon.h"
+#include "AdLog.h"
+#include "Memory/AdMemoryTracker.h"
+#include <cstdint>
+#include <new>
+
+using namespace ade;
+
+// 防止编译器把成对的 new / delete 优化掉
+static void *volatile sSink = nullptr;
+
+static void AllocateOnce(size_t size) {
+    sSink = ::operator new(size);
+    ::operator delete(sSink);
+}
+
+static void TestFrameBudget() {
+    AdMemoryTrackerSettings settings;
+    settings.budgets[static_cast<uint32_t>(AdMemoryTag::Scene)].maxAllocsPerFrame = 2;
+    AdMemoryTracker::Configure(settings);
+    AdMemoryTracker::EndFrame(0);
+
+    // 预算之内不算违规
+    uint64_t violationCount = AdMemoryTracker::GetViolationCount();
+    {
+        AdMemoryTagScope scope(AdMemoryTag::Scene);
+        AllocateOnce(64);
+        AllocateOnce(64);
+    }
+    AdMemoryTracker::EndFrame(1);
+    AD_CHECK_EQ(AdMemoryTracker::GetStats(AdMemoryTag::Scene).frameAllocCount, 2u);
+    AD_CHECK_EQ(AdMemoryTracker::GetStats(AdMemoryTag::Scene).liveCount, 0u);
+    AD_CHECK_EQ(AdMemoryTracker::GetViolationCount(), violationCount);
+
+    {
+        AdMemoryTagScope scope(AdMemoryTag::Scene);
+        for (int i = 0; i < 3; i++) {
+            AllocateOnce(64);
+        }
+    }
+    AdMemoryTracker::EndFrame(2);
+    AD_CHECK_EQ(AdMemoryTracker::GetStats(AdMemoryTag::Scene).frameAllocCount, 3u);
+    AD_CHECK_EQ(AdMemoryTracker::GetViolationCount(), violationCount + 1);
+
+    AdMemoryTracker::Configure({});
+}
+
+static void TestNoAllocScope() {
+    uint64_t violationCount = AdMemoryTracker::GetViolationCount();
+    {
+        AdNoAllocScope scope("TestNoAllocScope.Clean");
+    }
+    AD_CHECK_EQ(AdMemoryTracker::GetViolationCount(), violationCount);
+    {
+        AdNoAllocScope scope("TestNoAllocScope.Dirty");
+        AllocateOnce(16);
+    }
+    AD_CHECK_EQ(AdMemoryTracker::GetViolationCount(), violationCount + 1);
+}
+
+// 加上头部会溢出的大小直接失败, 不能分配出一块过小的内存
+static void TestSizeGuard() {
+    volatile size_t hugeSize = SIZE_MAX - 8;
+    bool bThrown = false;
+    try {
+        sSink = ::operator new(hugeSize);
+    } catch (const std::bad_alloc &) {
+        bThrown = true;
+    }
+    AD_CHECK(bThrown);
+    AD_CHECK(::operator new(hugeSize, std::nothrow) == nullptr);
+    AD_CHECK(::operator new(hugeSize, std::align_val_t(64), std::nothrow) == nullptr);
+}
+
+int main() {
+    AdLog::Init();
+
+    AD_CHECK(AdMemoryTracker::ENABLED);
+    TestFrameBudget();
+    TestNoAllocScope();
+    TestSizeGuard();
+    return AD_TEST_RESULT();
+}
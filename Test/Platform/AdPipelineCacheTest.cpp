@@ -0,0 +1,154 @@
+#include "AdTestCommon.h"
+#include "AdLog.h"
+#include "Graphic/AdVKPipelineCache.h"
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+using namespace ade;
+
+// 管线使用记录: 图形、mesh 和计算管线的 key 写入后原样读回, 读回的 key 每个都被预创建一次
+// 只测试与设备无关的部分, AdVKPipelineCache::Prewarm 用同样的 PrewarmPipelineKeys 创建管线
+
+static std::string GetTestPath(const char *name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static std::vector<AdVKPipelineKey> MakeKeys() {
+    std::vector<AdVKPipelineKey> keys;
+
+    AdVKPipelineKey graphics;
+    graphics.vertexShader = "Shader/GeometryPull.vert.spv";
+    graphics.fragmentShader = "Shader/GeometryPull.frag.spv";
+    graphics.pipelineLayout = "GeometryPull";
+    graphics.vertexBindings.push_back({0, 32, VK_VERTEX_INPUT_RATE_VERTEX});
+    graphics.vertexAttributes.push_back({0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0});
+    graphics.vertexAttributes.push_back({1, 0, VK_FORMAT_R32G32_SFLOAT, 24});
+    graphics.depthFormat = VK_FORMAT_D32_SFLOAT;
+    keys.push_back(graphics);
+
+    // 同一个 key 只改状态也是不同的记录
+    graphics.state.cullMode = VK_CULL_MODE_NONE;
+    graphics.state.blendEnable = VK_TRUE;
+    keys.push_back(graphics);
+
+    AdVKPipelineKey mesh;
+    mesh.taskShader = "Shader/Meshlet.task.spv";
+    mesh.meshShader = "Shader/Meshlet.mesh.spv";
+    mesh.fragmentShader = "Shader/Meshlet.frag.spv";
+    mesh.pipelineLayout = "MeshletPass";
+    mesh.depthFormat = VK_FORMAT_D32_SFLOAT;
+    keys.push_back(mesh);
+
+    AdVKPipelineKey compute;
+    compute.computeShader = "Shader/DepthPyramid.comp.spv";
+    compute.pipelineLayout = "DepthPyramid";
+    keys.push_back(compute);
+    return keys;
+}
+
+static bool IsSameKey(const AdVKPipelineKey &a, const AdVKPipelineKey &b) {
+    return a.GetHash() == b.GetHash() && a.vertexShader == b.vertexShader && a.fragmentShader == b.fragmentShader
+           && a.taskShader == b.taskShader && a.meshShader == b.meshShader && a.computeShader == b.computeShader
+           && a.pipelineLayout == b.pipelineLayout && a.vertexBindings.size() == b.vertexBindings.size()
+           && a.vertexAttributes.size() == b.vertexAttributes.size() && a.state == b.state;
+}
+
+static void TestKeyHash(const std::vector<AdVKPipelineKey> &keys) {
+    for (uint32_t i = 0; i < keys.size(); i++) {
+        for (uint32_t j = i + 1; j < keys.size(); j++) {
+            AD_CHECK(keys[i].GetHash() != keys[j].GetHash());
+        }
+    }
+    // 计算管线不受图形状态影响
+    AdVKPipelineKey compute = keys.back();
+    compute.state.cullMode = VK_CULL_MODE_FRONT_BIT;
+    AD_CHECK(compute.IsCompute());
+    AD_CHECK_EQ(compute.GetHash(), keys.back().GetHash());
+}
+
+static void TestRoundTrip(const std::vector<AdVKPipelineKey> &keys) {
+    std::string path = GetTestPath("AdPipelineCacheTest.bin");
+    AD_CHECK(SavePipelineUsage(path, keys));
+
+    std::vector<AdVKPipelineKey> loadedKeys;
+    AD_CHECK(LoadPipelineUsage(path, loadedKeys));
+    AD_CHECK_EQ(loadedKeys.size(), keys.size());
+    for (uint32_t i = 0; i < keys.size() && i < loadedKeys.size(); i++) {
+        AD_CHECK(IsSameKey(loadedKeys[i], keys[i]));
+    }
+
+    // 读回的记录每个都被预创建一次, 内部线程和外部执行器结果相同; 返回值只统计创建成功的
+    std::vector<std::atomic<uint32_t>> createCounts(loadedKeys.size());
+    auto create = [&](const AdVKPipelineKey &key) {
+        for (uint32_t i = 0; i < loadedKeys.size(); i++) {
+            if (&loadedKeys[i] == &key) {
+                createCounts[i]++;
+            }
+        }
+        return !key.IsCompute();
+    };
+    AD_CHECK_EQ(PrewarmPipelineKeys(loadedKeys, 3, {}, create), static_cast<uint32_t>(keys.size() - 1));
+    AdParallelExecutor executor = [](uint32_t count, const std::function<void(uint32_t)> &task) {
+        for (uint32_t i = 0; i < count; i++) {
+            task(i);
+        }
+    };
+    AD_CHECK_EQ(PrewarmPipelineKeys(loadedKeys, 0, executor, create), static_cast<uint32_t>(keys.size() - 1));
+    for (const auto &count: createCounts) {
+        AD_CHECK_EQ(count.load(), 2u);
+    }
+    AD_CHECK_EQ(PrewarmPipelineKeys({}, 0, {}, create), 0u);
+    std::filesystem::remove(path);
+}
+
+// 损坏的文件被拒绝, 不会按文件中的数量分配
+static void TestBrokenFile(const std::vector<AdVKPipelineKey> &keys) {
+    std::string path = GetTestPath("AdPipelineCacheTest.bin");
+    AD_CHECK(SavePipelineUsage(path, keys));
+    std::vector<char> data;
+    {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        data.resize(in.tellg());
+        in.seekg(0);
+        in.read(data.data(), data.size());
+    }
+    auto writeFile = [&path](const std::vector<char> &bytes) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), bytes.size());
+    };
+
+    std::vector<AdVKPipelineKey> loadedKeys(1);
+    std::vector<char> broken = data;
+    uint32_t hugeCount = 0xFFFFFFF0u;
+    std::memcpy(broken.data() + 3 * sizeof(uint32_t), &hugeCount, sizeof(hugeCount));
+    writeFile(broken);
+    AD_CHECK(!LoadPipelineUsage(path, loadedKeys));
+    AD_CHECK(loadedKeys.empty());
+
+    // 数量放得下, 但最后一个 key 被截断
+    loadedKeys.resize(1);
+    writeFile(std::vector<char>(data.begin(), data.end() - 8));
+    AD_CHECK(!LoadPipelineUsage(path, loadedKeys));
+    AD_CHECK(loadedKeys.empty());
+
+    // 版本不一致
+    broken = data;
+    broken[sizeof(uint32_t)]++;
+    writeFile(broken);
+    AD_CHECK(!LoadPipelineUsage(path, loadedKeys));
+
+    std::filesystem::remove(path);
+    AD_CHECK(!LoadPipelineUsage(path, loadedKeys));
+}
+
+int main() {
+    AdLog::Init();
+
+    std::vector<AdVKPipelineKey> keys = MakeKeys();
+    TestKeyHash(keys);
+    TestRoundTrip(keys);
+    TestBrokenFile(keys);
+    return AD_TEST_RESULT();
+}
@@ -0,0 +1,170 @@
+#include "AdTestCommon.h"
+#include "Graphic/AdVKPipeline.h"
+#include "Graphic/AdDevice.h"
+#include <vector>
+
+using namespace ade;
+
+// 管线状态的烘焙和哈希: 只依赖 AdVKPipelineState 和支持情况, 不需要创建设备
+// 每个字段修改后, 不是动态状态时哈希必须变化, 是动态状态时哈希和烘焙结果都不变
+
+using AdTestMutate = void (*)(AdVKPipelineState &state);
+using AdTestSupportFlag = bool AdVKDynamicStateSupport::*;
+
+struct AdTestField {
+    const char *name;
+    AdTestMutate mutate;
+    // 为空表示这个字段总是烘焙进管线
+    AdTestSupportFlag dynamicFlag;
+};
+
+#define AD_TEST_FIELD(field, value, flag) {#field, [](AdVKPipelineState &s) { s.field = value; }, flag}
+
+static const AdTestField gFields[] = {
+        // topology 在受限的动态 topology 下保留图元类别, 这里换成另一类图元; 同类切换在 TestTopologyClass 中测试
+        AD_TEST_FIELD(topology, VK_PRIMITIVE_TOPOLOGY_LINE_LIST,
+                      &AdVKDynamicStateSupport::bDynamicPrimitiveTopologyUnrestricted),
+        AD_TEST_FIELD(primitiveRestartEnable, VK_TRUE, &AdVKDynamicStateSupport::bExtendedDynamicState2),
+        AD_TEST_FIELD(depthClampEnable, VK_TRUE, &AdVKDynamicStateSupport::bDepthClampEnable),
+        AD_TEST_FIELD(rasterizerDiscardEnable, VK_TRUE, &AdVKDynamicStateSupport::bExtendedDynamicState2),
+        AD_TEST_FIELD(polygonMode, VK_POLYGON_MODE_LINE, &AdVKDynamicStateSupport::bPolygonMode),
+        AD_TEST_FIELD(cullMode, VK_CULL_MODE_NONE, &AdVKDynamicStateSupport::bExtendedDynamicState),
+        AD_TEST_FIELD(frontFace, VK_FRONT_FACE_CLOCKWISE, &AdVKDynamicStateSupport::bExtendedDynamicState),
+        AD_TEST_FIELD(depthBiasEnable, VK_TRUE, &AdVKDynamicStateSupport::bExtendedDynamicState2),
+        AD_TEST_FIELD(rasterizationSamples, VK_SAMPLE_COUNT_4_BIT,
+                      &AdVKDynamicStateSupport::bRasterizationSamples),
+        AD_TEST_FIELD(alphaToCoverageEnable, VK_TRUE, &AdVKDynamicStateSupport::bAlphaToCoverageEnable),
+        AD_TEST_FIELD(depthTestEnable, VK_TRUE, &AdVKDynamicStateSupport::bExtendedDynamicState),
+        AD_TEST_FIELD(depthWriteEnable, VK_TRUE, &AdVKDynamicStateSupport::bExtendedDynamicState),
+        AD_TEST_FIELD(depthCompareOp, VK_COMPARE_OP_GREATER_OR_EQUAL,
+                      &AdVKDynamicStateSupport::bExtendedDynamicState),
+        AD_TEST_FIELD(stencilTestEnable, VK_TRUE, &AdVKDynamicStateSupport::bExtendedDynamicState),
+        AD_TEST_FIELD(logicOpEnable, VK_TRUE, &AdVKDynamicStateSupport::bLogicOpEnable),
+        AD_TEST_FIELD(logicOp, VK_LOGIC_OP_XOR, nullptr),
+        AD_TEST_FIELD(blendEnable, VK_TRUE, &AdVKDynamicStateSupport::bColorBlendEnable),
+        AD_TEST_FIELD(srcColorBlendFactor, VK_BLEND_FACTOR_ONE, &AdVKDynamicStateSupport::bColorBlendEquation),
+        AD_TEST_FIELD(dstColorBlendFactor, VK_BLEND_FACTOR_ONE, &AdVKDynamicStateSupport::bColorBlendEquation),
+        AD_TEST_FIELD(colorBlendOp, VK_BLEND_OP_MAX, &AdVKDynamicStateSupport::bColorBlendEquation),
+        AD_TEST_FIELD(srcAlphaBlendFactor, VK_BLEND_FACTOR_SRC_ALPHA,
+                      &AdVKDynamicStateSupport::bColorBlendEquation),
+        AD_TEST_FIELD(dstAlphaBlendFactor, VK_BLEND_FACTOR_ONE, &AdVKDynamicStateSupport::bColorBlendEquation),
+        AD_TEST_FIELD(alphaBlendOp, VK_BLEND_OP_SUBTRACT, &AdVKDynamicStateSupport::bColorBlendEquation),
+        AD_TEST_FIELD(colorWriteMask, VK_COLOR_COMPONENT_R_BIT, &AdVKDynamicStateSupport::bColorWriteMask),
+};
+
+// 新增字段时必须同时加到上面的表中
+static_assert(sizeof(AdVKPipelineState) == sizeof(gFields) / sizeof(gFields[0]) * 4,
+              "AdPipelineStateTest does not cover every AdVKPipelineState field.");
+
+static AdVKDynamicStateSupport MakeFullSupport() {
+    AdVKDynamicStateSupport support;
+    support.bExtendedDynamicState = true;
+    support.bExtendedDynamicState2 = true;
+    support.bDynamicPrimitiveTopologyUnrestricted = true;
+    support.bDepthClampEnable = true;
+    support.bPolygonMode = true;
+    support.bRasterizationSamples = true;
+    support.bAlphaToCoverageEnable = true;
+    support.bLogicOpEnable = true;
+    support.bColorBlendEnable = true;
+    support.bColorBlendEquation = true;
+    support.bColorWriteMask = true;
+    return support;
+}
+
+// 只支持这个字段对应的动态状态; unrestricted topology 需要同时支持 extended dynamic state
+static AdVKDynamicStateSupport MakeSingleSupport(AdTestSupportFlag flag) {
+    AdVKDynamicStateSupport support;
+    support.*flag = true;
+    if (flag == &AdVKDynamicStateSupport::bDynamicPrimitiveTopologyUnrestricted) {
+        support.bExtendedDynamicState = true;
+    }
+    return support;
+}
+
+static void TestEqualStates() {
+    const AdVKDynamicStateSupport supports[] = {{}, MakeFullSupport()};
+    for (const AdVKDynamicStateSupport &support: supports) {
+        AdVKPipelineState a, b;
+        AD_CHECK(a == b);
+        AD_CHECK_EQ(a.GetHash(support), b.GetHash(support));
+
+        a.cullMode = b.cullMode = VK_CULL_MODE_FRONT_BIT;
+        a.logicOp = b.logicOp = VK_LOGIC_OP_AND;
+        AD_CHECK(a == b);
+        AD_CHECK_EQ(a.GetHash(support), b.GetHash(support));
+
+        // 烘焙是幂等的, 哈希就是烘焙结果的哈希
+        AdVKPipelineState baked = a.GetBakedState(support);
+        AD_CHECK(baked.GetBakedState(support) == baked);
+        AD_CHECK_EQ(baked.GetHash(support), a.GetHash(support));
+    }
+}
+
+// 字段在这种支持情况下是否为动态状态; 表中 topology 的修改换了图元类别, 只有 unrestricted 时才是动态的
+static bool IsDynamic(const AdTestField &field, const AdVKDynamicStateSupport &support) {
+    if (field.dynamicFlag == &AdVKDynamicStateSupport::bDynamicPrimitiveTopologyUnrestricted) {
+        return support.bExtendedDynamicState && support.bDynamicPrimitiveTopologyUnrestricted;
+    }
+    return field.dynamicFlag != nullptr && support.*field.dynamicFlag;
+}
+
+static void TestEachField() {
+    // 不支持、全部支持、以及每一项单独支持
+    std::vector<AdVKDynamicStateSupport> supports = {{}, MakeFullSupport()};
+    for (const AdTestField &field: gFields) {
+        if (field.dynamicFlag != nullptr) {
+            supports.push_back(MakeSingleSupport(field.dynamicFlag));
+        }
+    }
+
+    const AdVKPipelineState base;
+    for (const AdTestField &field: gFields) {
+        AdVKPipelineState changed = base;
+        field.mutate(changed);
+        if (changed == base) {
+            std::fprintf(stderr, "field %s: test value equals the default\n", field.name);
+            gTestFailedCount++;
+            continue;
+        }
+        uint32_t wrongCount = 0;
+        for (const AdVKDynamicStateSupport &support: supports) {
+            bool bDynamic = IsDynamic(field, support);
+            bool bHashChanged = changed.GetHash(support) != base.GetHash(support);
+            bool bBakedChanged = !(changed.GetBakedState(support) == base.GetBakedState(support));
+            wrongCount += bHashChanged == bDynamic || bBakedChanged == bDynamic ? 1 : 0;
+        }
+        if (wrongCount > 0) {
+            std::fprintf(stderr, "field %s: hash is wrong under %u dynamic state supports\n", field.name,
+                         wrongCount);
+            gTestFailedCount++;
+        }
+    }
+}
+
+// 不支持 unrestricted 时 topology 只能在同一类图元之间动态切换
+static void TestTopologyClass() {
+    AdVKDynamicStateSupport restricted;
+    restricted.bExtendedDynamicState = true;
+    AdVKPipelineState list, strip, lines;
+    strip.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+    lines.topology = VK_PRIMITIVE_TOPOLOGY_LINE_STRIP;
+    AD_CHECK_EQ(list.GetHash(restricted), strip.GetHash(restricted));
+    AD_CHECK(list.GetHash(restricted) != lines.GetHash(restricted));
+
+    AdVKDynamicStateSupport unrestricted = restricted;
+    unrestricted.bDynamicPrimitiveTopologyUnrestricted = true;
+    AD_CHECK_EQ(list.GetHash(unrestricted), lines.GetHash(unrestricted));
+
+    // 只有 unrestricted 标记而没有 extended dynamic state 时 topology 仍然是静态的
+    AdVKDynamicStateSupport flagOnly;
+    flagOnly.bDynamicPrimitiveTopologyUnrestricted = true;
+    AD_CHECK(list.GetHash(flagOnly) != strip.GetHash(flagOnly));
+}
+
+int main() {
+    TestEqualStates();
+    TestEachField();
+    TestTopologyClass();
+    return AD_TEST_RESULT();
+}
@@ -0,0 +1,169 @@
+#include "AdTestCommon.h"
+#include "Culling/AdSoftwareOcclusion.h"
+#include "Math/AdMatrix.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace ade;
+
+// 软件遮挡剔除的计时, 不需要 GPU; 同时检查被墙完全挡住的盒子被剔除、没有被挡住的盒子可见
+// 计时只在 Release 下有意义; 每项取多次运行中最快的一次
+static constexpr uint32_t AD_BENCH_RUNS = 20;
+static constexpr uint32_t AD_BENCH_BOX_COUNT = 10000;
+
+// 遮挡墙: z = WALL_Z 平面上 [-WALL_HALF, WALL_HALF] 的正方形, 切成 WALL_GRID x WALL_GRID 个四边形
+static constexpr float AD_WALL_Z = -20.0f;
+static constexpr float AD_WALL_HALF = 8.0f;
+static constexpr uint32_t AD_WALL_GRID = 30;
+
+// 相机在原点看向 -z, 墙边缘在屏幕上的斜率 x / -z
+static constexpr float AD_WALL_SLOPE = AD_WALL_HALF / -AD_WALL_Z;
+
+enum class AdBoxKind {
+    Hidden,     // 在墙后且投影完全落在墙内
+    Front,      // 在墙前
+    Beside,     // 在墙后但投影在墙外, 仍在视锥内
+};
+
+static volatile uint32_t gSink = 0;
+
+template<typename Func>
+static double MeasureMicroseconds(Func &&func) {
+    double best = 1e30;
+    for (uint32_t run = 0; run < AD_BENCH_RUNS; run++) {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+static void MakeWall(std::vector<float> &outPositions, std::vector<uint32_t> &outIndices) {
+    for (uint32_t y = 0; y <= AD_WALL_GRID; y++) {
+        for (uint32_t x = 0; x <= AD_WALL_GRID; x++) {
+            outPositions.push_back(-AD_WALL_HALF + 2.0f * AD_WALL_HALF * static_cast<float>(x) / AD_WALL_GRID);
+            outPositions.push_back(-AD_WALL_HALF + 2.0f * AD_WALL_HALF * static_cast<float>(y) / AD_WALL_GRID);
+            outPositions.push_back(AD_WALL_Z);
+        }
+    }
+    for (uint32_t y = 0; y < AD_WALL_GRID; y++) {
+        for (uint32_t x = 0; x < AD_WALL_GRID; x++) {
+            uint32_t i0 = y * (AD_WALL_GRID + 1) + x;
+            uint32_t i1 = i0 + 1;
+            uint32_t i2 = i0 + AD_WALL_GRID + 1;
+            uint32_t i3 = i2 + 1;
+            outIndices.insert(outIndices.end(), {i0, i1, i3, i0, i3, i2});
+        }
+    }
+}
+
+// 角点在屏幕上的斜率 |v| / -z 的最大值(最近的一面)和最小值(最远的一面), 盒子必须完全在相机前方
+static float GetMaxSlope(const AdBoundingBox &box, int axis) {
+    return std::max(std::fabs(box.min[axis]), std::fabs(box.max[axis])) / -box.max[2];
+}
+
+static float GetMinSlope(const AdBoundingBox &box, int axis) {
+    if (box.min[axis] <= 0.0f && box.max[axis] >= 0.0f) {
+        return 0.0f;
+    }
+    return std::min(std::fabs(box.min[axis]), std::fabs(box.max[axis])) / -box.min[2];
+}
+
+static AdBoxKind MakeBox(std::mt19937 &random, AdBoundingBox &outBox) {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_real_distribution<float> size(0.2f, 2.0f);
+    AdBoxKind kind = static_cast<AdBoxKind>(random() % 3);
+    while (true) {
+        float depth = kind == AdBoxKind::Front ? 3.0f + 14.0f * unit(random) : 25.0f + 35.0f * unit(random);
+        for (int axis = 0; axis < 2; axis++) {
+            outBox.min[axis] = (unit(random) * 2.0f - 1.0f) * depth * 0.9f;
+            outBox.max[axis] = outBox.min[axis] + size(random);
+        }
+        outBox.max[2] = -depth;
+        outBox.min[2] = outBox.max[2] - size(random);
+
+        // 完全在视锥内: 水平半宽斜率约 0.91, 垂直约 0.55
+        if (GetMaxSlope(outBox, 0) > 0.85f || GetMaxSlope(outBox, 1) > 0.5f) {
+            continue;
+        }
+        // 离墙边缘留 10% 的余量, 避开像素中心覆盖带来的边界误差
+        switch (kind) {
+            case AdBoxKind::Hidden:
+                if (GetMaxSlope(outBox, 0) < AD_WALL_SLOPE * 0.9f && GetMaxSlope(outBox, 1) < AD_WALL_SLOPE * 0.9f) {
+                    return kind;
+                }
+                break;
+            case AdBoxKind::Front:
+                return kind;
+            case AdBoxKind::Beside:
+                if (GetMinSlope(outBox, 0) > AD_WALL_SLOPE * 1.1f) {
+                    return kind;
+                }
+                break;
+        }
+    }
+}
+
+int main() {
+    AdSoftwareOcclusion occlusion;
+    AdMat4 viewProj = AdMat4::Perspective(1.0f, static_cast<float>(occlusion.GetWidth()) / occlusion.GetHeight(), 0.1f,
+                                          500.0f) *
+                      AdMat4::LookAt({0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 1.0f, 0.0f});
+
+    std::vector<float> positions;
+    std::vector<uint32_t> indices;
+    MakeWall(positions, indices);
+
+    std::mt19937 random(12345);
+    std::vector<AdBoundingBox> boxes(AD_BENCH_BOX_COUNT);
+    std::vector<AdBoxKind> kinds(AD_BENCH_BOX_COUNT);
+    for (uint32_t i = 0; i < AD_BENCH_BOX_COUNT; i++) {
+        kinds[i] = MakeBox(random, boxes[i]);
+    }
+
+    double setupUs = MeasureMicroseconds([&] {
+        occlusion.Begin(viewProj.Data());
+        occlusion.AddOccluder(positions.data(), static_cast<uint32_t>(positions.size() / 3), 3 * sizeof(float),
+                              indices.data(), static_cast<uint32_t>(indices.size()));
+    });
+    double rasterUs = MeasureMicroseconds([&] { occlusion.Rasterize(); });
+    std::vector<uint32_t> visibleIndices(AD_BENCH_BOX_COUNT);
+    uint32_t visibleCount = 0;
+    double cullUs = MeasureMicroseconds([&] {
+        visibleCount = occlusion.CullBoxes(boxes.data(), AD_BENCH_BOX_COUNT, visibleIndices.data());
+        gSink = gSink + visibleCount;
+    });
+    std::printf("AdSoftwareOcclusion %ux%u, %u occluder triangles, %u boxes\n", occlusion.GetWidth(),
+                occlusion.GetHeight(), occlusion.GetTriangleCount(), AD_BENCH_BOX_COUNT);
+    std::printf("%-16s %9.1f us\n%-16s %9.1f us\n%-16s %9.1f us\n", "setup", setupUs, "rasterize", rasterUs,
+                "cull boxes", cullUs);
+    std::printf("visible %u / %u\n", visibleCount, AD_BENCH_BOX_COUNT);
+
+    AD_CHECK_EQ(occlusion.GetTriangleCount(), AD_WALL_GRID * AD_WALL_GRID * 2);
+
+    // CullBoxes 与逐个 IsVisible 一致, 完全挡住的盒子被剔除, 其他盒子可见
+    std::vector<bool> bCulledVisible(AD_BENCH_BOX_COUNT, false);
+    for (uint32_t i = 0; i < visibleCount; i++) {
+        bCulledVisible[visibleIndices[i]] = true;
+    }
+    uint32_t mismatchCount = 0, wrongHiddenCount = 0, wrongVisibleCount = 0;
+    for (uint32_t i = 0; i < AD_BENCH_BOX_COUNT; i++) {
+        bool bVisible = occlusion.IsVisible(boxes[i]);
+        mismatchCount += bVisible != bCulledVisible[i] ? 1 : 0;
+        wrongVisibleCount += kinds[i] == AdBoxKind::Hidden && bVisible ? 1 : 0;
+        wrongHiddenCount += kinds[i] != AdBoxKind::Hidden && !bVisible ? 1 : 0;
+    }
+    AD_CHECK_EQ(mismatchCount, 0u);
+    AD_CHECK_EQ(wrongVisibleCount, 0u);
+    AD_CHECK_EQ(wrongHiddenCount, 0u);
+
+    AdBoundingBox hidden{{-1.0f, -1.0f, -32.0f}, {1.0f, 1.0f, -30.0f}};
+    AD_CHECK(!occlusion.IsVisible(hidden));
+    AdBoundingBox inFront{{-1.0f, -1.0f, -12.0f}, {1.0f, 1.0f, -10.0f}};
+    AD_CHECK(occlusion.IsVisible(inFront));
+    return AD_TEST_RESULT();
+}
@@ -0,0 +1,140 @@
+#include "AdTestCommon.h"
+#include "AdLog.h"
+#include "AdCooker.h"
+#include "Cooker/AdMeshCooker.h"
+#include <atomic>
+#include <filesystem>
+
+using namespace ade;
+
+// 把源文件原样输出; 第一行 "#include <path>" 声明一个依赖
+class AdTestCooker : public AdAssetCooker {
+public:
+    AdTestCooker(std::atomic<uint32_t> &cookCount, uint32_t version) : mCookCount(cookCount), mVersion(version) {}
+
+    const char *GetName() const override { return "Test"; }
+
+    uint32_t GetVersion() const override { return mVersion; }
+
+    bool CanCook(const std::string &extension) const override { return extension == ".txt"; }
+
+    std::string GetOutputPath(const std::string &sourcePath) const override {
+        return ReplaceFileExtension(sourcePath, ".out");
+    }
+
+    bool Cook(const AdCookJob &job, AdCookResult &outResult) const override {
+        if (!ReadFileBytes(job.GetSourceFullPath(), outResult.data)) {
+            return false;
+        }
+        std::string text(outResult.data.begin(), outResult.data.end());
+        const std::string include = "#include ";
+        if (text.rfind(include, 0) == 0) {
+            outResult.dependencies.push_back(text.substr(include.size(), text.find('\n') - include.size()));
+        }
+        mCookCount++;
+        return true;
+    }
+
+private:
+    std::atomic<uint32_t> &mCookCount;
+    uint32_t mVersion;
+};
+
+static void WriteText(const std::string &path, const std::string &text) {
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path());
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << text;
+}
+
+// 执行一次增量烘焙, 返回实际烘焙的文件数
+static uint32_t Cook(const std::string &root, uint32_t version, bool bForce = false, bool bPack = false) {
+    AdCookerSettings settings;
+    settings.sourceDir = root + "Source";
+    settings.outputDir = root + "Output";
+    settings.threadCount = 2;
+    settings.bForce = bForce;
+    settings.bPack = bPack;
+
+    std::atomic<uint32_t> cookCount{0};
+    AdCooker cooker(settings);
+    cooker.RegisterCooker(std::make_unique<AdTestCooker>(cookCount, version));
+    AD_CHECK(cooker.Run());
+    return cookCount.load();
+}
+
+// 每个影响输出的网格烘焙设置都要使版本变化
+static void TestMeshCookerVersion() {
+    const uint32_t baseVersion = AdMeshCooker().GetVersion();
+    AdMeshCookSettings settings;
+    AD_CHECK_EQ(AdMeshCooker(settings).GetVersion(), baseVersion);
+
+    settings = {};
+    settings.bOptimizeVertexCache = false;
+    AD_CHECK(AdMeshCooker(settings).GetVersion() != baseVersion);
+    settings = {};
+    settings.bOptimizeOverdraw = false;
+    AD_CHECK(AdMeshCooker(settings).GetVersion() != baseVersion);
+    settings = {};
+    settings.overdrawThreshold = 1.1f;
+    AD_CHECK(AdMeshCooker(settings).GetVersion() != baseVersion);
+    settings = {};
+    settings.maxLodCount = 1;
+    AD_CHECK(AdMeshCooker(settings).GetVersion() != baseVersion);
+    settings = {};
+    settings.lodReduction = 0.25f;
+    AD_CHECK(AdMeshCooker(settings).GetVersion() != baseVersion);
+    settings = {};
+    settings.minLodTriangleCount = 128;
+    AD_CHECK(AdMeshCooker(settings).GetVersion() != baseVersion);
+}
+
+int main() {
+    AdLog::Init();
+
+    TestMeshCookerVersion();
+
+    std::string root = (std::filesystem::temp_directory_path() / "AdCookerTest/").generic_string();
+    std::filesystem::remove_all(root);
+    WriteText(root + "Source/a.txt", "a");
+    WriteText(root + "Source/Sub/b.txt", "#include Sub/common.inc\nb");
+    WriteText(root + "Source/Sub/common.inc", "common");
+
+    // 首次全部烘焙, 没有变化时全部跳过
+    AD_CHECK_EQ(Cook(root, 1), 2u);
+    AD_CHECK(std::filesystem::exists(root + "Output/Sub/b.out"));
+    AD_CHECK_EQ(Cook(root, 1), 0u);
+
+    // 内容变化(大小也变化, 不依赖修改时间的精度)只重新烘焙对应的输出
+    WriteText(root + "Source/a.txt", "a changed");
+    AD_CHECK_EQ(Cook(root, 1), 1u);
+    AD_CHECK_EQ(Cook(root, 1), 0u);
+
+    // 依赖变化使引用它的输出失效
+    WriteText(root + "Source/Sub/common.inc", "common changed");
+    AD_CHECK_EQ(Cook(root, 1), 1u);
+
+    // 输出被删除
+    std::filesystem::remove(root + "Output/a.out");
+    AD_CHECK_EQ(Cook(root, 1), 1u);
+
+    // 烘焙器版本变化使全部输出失效
+    AD_CHECK_EQ(Cook(root, 2), 2u);
+    AD_CHECK_EQ(Cook(root, 2), 0u);
+
+    AD_CHECK_EQ(Cook(root, 2, true), 2u);
+
+    // 源文件被删除后输出和记录一起删除, 不会被打包; 不是烘焙产生的文件照常打包
+    WriteText(root + "Output/loose.out", "loose");
+    std::filesystem::remove(root + "Source/a.txt");
+    AD_CHECK_EQ(Cook(root, 2, false, true), 0u);
+    AD_CHECK(!std::filesystem::exists(root + "Output/a.out"));
+    std::shared_ptr<AdArchive> archive = AdArchive::Open(root + "Output/Resource.adpak");
+    AD_CHECK(archive != nullptr);
+    if (archive) {
+        AD_CHECK(archive->FindEntry("Sub/b.out") != nullptr);
+        AD_CHECK(archive->FindEntry("a.out") == nullptr);
+        AD_CHECK(archive->FindEntry("loose.out") != nullptr);
+    }
+
+    std::filesystem::remove_all(root);
+    return AD_TEST_RESULT();
+}
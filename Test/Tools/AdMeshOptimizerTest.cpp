@@ -0,0 +1,67 @@
+#include "AdTestCommon.h"
+#include "Cooker/AdMeshOptimizer.h"
+#include <array>
+
+using namespace ade;
+
+// 三角形按顶点排序后比较, 检查重排前后是同一组三角形(允许顶点旋转)
+static std::vector<std::array<uint32_t, 3>> GetSortedTriangles(const std::vector<uint32_t> &indices) {
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        std::array<uint32_t, 3> triangle = {indices[i], indices[i + 1], indices[i + 2]};
+        std::sort(triangle.begin(), triangle.end());
+        triangles.push_back(triangle);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+static void CheckOverdraw(std::vector<uint32_t> indices, const std::vector<float> &positions) {
+    std::vector<uint32_t> original = indices;
+    OptimizeOverdraw(indices, positions);
+    AD_CHECK_EQ(indices.size(), original.size());
+    AD_CHECK(GetSortedTriangles(indices) == GetSortedTriangles(original));
+}
+
+// 顶点在 xy 平面上排成 width x height 的网格
+static std::vector<float> MakeGridPositions(uint32_t width, uint32_t height) {
+    std::vector<float> positions;
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            positions.insert(positions.end(), {float(x), float(y), float((x * 7 + y * 3) % 5) * 0.1f});
+        }
+    }
+    return positions;
+}
+
+int main() {
+    // 没有一个三角形有 3 次缓存未命中
+    CheckOverdraw({0, 0, 1, 1, 1, 2}, MakeGridPositions(3, 1));
+
+    // 开头是退化三角形, 后面是三角形带
+    {
+        std::vector<uint32_t> indices = {0, 0, 1};
+        for (uint32_t i = 0; i < 30; i++) {
+            indices.insert(indices.end(), {i, i + 1, i + 2});
+        }
+        CheckOverdraw(indices, MakeGridPositions(32, 1));
+    }
+
+    // 顶点缓存优化后的网格, 开头插入一个退化三角形
+    {
+        const uint32_t width = 20, height = 20;
+        std::vector<uint32_t> indices;
+        for (uint32_t y = 0; y + 1 < height; y++) {
+            for (uint32_t x = 0; x + 1 < width; x++) {
+                uint32_t v = y * width + x;
+                indices.insert(indices.end(), {v, v + 1, v + width, v + 1, v + width + 1, v + width});
+            }
+        }
+        OptimizeVertexCache(indices, width * height);
+        indices.insert(indices.begin(), {5, 5, 6});
+        CheckOverdraw(indices, MakeGridPositions(width, height));
+    }
+
+    CheckOverdraw({}, {});
+    return AD_TEST_RESULT();
+}
@@ -0,0 +1,152 @@
+#include "AdCookDatabase.h"
+#include "AdHash.h"
+#include "AdLog.h"
+#include <filesystem>
+
+namespace ade {
+
+    static const char *AD_COOK_DATABASE_HEADER = "ADCOOKDB 1";
+
+    bool AdCookDatabase::Load(const std::string &path) {
+        std::ifstream in(path);
+        if (!in.is_open()) {
+            return false;
+        }
+        std::string line;
+        if (!std::getline(in, line) || line != AD_COOK_DATABASE_HEADER) {
+            LOG_W("Cook database {0} is out of date, cook all assets.", path);
+            return false;
+        }
+
+        // S <size> <modifyTime> <hash> <path>
+        // R <cooker> <version> <inputCount> <outputPath>
+        // I <hash> <path>
+        std::lock_guard<std::mutex> lock(mMutex);
+        AdCookRecord *record = nullptr;
+        while (std::getline(in, line)) {
+            std::istringstream stream(line);
+            std::string type;
+            stream >> type;
+            if (type == "S") {
+                FileStamp stamp{};
+                std::string filePath;
+                stream >> stamp.size >> stamp.modifyTime >> std::hex >> stamp.hash >> std::dec;
+                stream.get();
+                std::getline(stream, filePath);
+                mFileStamps[filePath] = stamp;
+            } else if (type == "R") {
+                AdCookRecord newRecord;
+                uint32_t inputCount = 0;
+                std::string outputPath;
+                stream >> newRecord.cooker >> newRecord.version >> inputCount;
+                stream.get();
+                std::getline(stream, outputPath);
+                record = &(mRecords[outputPath] = std::move(newRecord));
+            } else if (type == "I" && record) {
+                AdCookInput input{};
+                stream >> std::hex >> input.hash >> std::dec;
+                stream.get();
+                std::getline(stream, input.path);
+                record->inputs.push_back(std::move(input));
+            }
+        }
+        LOG_D("Load cook database: {0} records, {1} files", mRecords.size(), mFileStamps.size());
+        return true;
+    }
+
+    bool AdCookDatabase::Save(const std::string &path) {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out.is_open()) {
+            LOG_E("Could not write cook database: {0}", path);
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(mMutex);
+        out << AD_COOK_DATABASE_HEADER << "\n";
+        for (const auto &item: mFileStamps) {
+            out << "S " << item.second.size << " " << item.second.modifyTime << " " << std::hex << item.second.hash
+                << std::dec << " " << item.first << "\n";
+        }
+        for (const auto &item: mRecords) {
+            const AdCookRecord &record = item.second;
+            out << "R " << record.cooker << " " << record.version << " " << record.inputs.size() << " " << item.first
+                << "\n";
+            for (const auto &input: record.inputs) {
+                out << "I " << std::hex << input.hash << std::dec << " " << input.path << "\n";
+            }
+        }
+        return static_cast<bool>(out);
+    }
+
+    bool AdCookDatabase::GetFileHash(const std::string &sourceDir, const std::string &path, uint64_t &outHash) {
+        std::error_code ec;
+        std::filesystem::path fullPath = sourceDir + path;
+        uint64_t size = std::filesystem::file_size(fullPath, ec);
+        if (ec) {
+            return false;
+        }
+        int64_t modifyTime = std::filesystem::last_write_time(fullPath, ec).time_since_epoch().count();
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto it = mFileStamps.find(path);
+            if (it != mFileStamps.end() && it->second.size == size && it->second.modifyTime == modifyTime) {
+                outHash = it->second.hash;
+                return true;
+            }
+        }
+
+        std::vector<uint8_t> data;
+        if (!ReadFileBytes(fullPath.string(), data)) {
+            return false;
+        }
+        outHash = HashBytes(data.data(), data.size());
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mFileStamps[path] = {size, modifyTime, outHash};
+        return true;
+    }
+
+    bool AdCookDatabase::IsUpToDate(const AdCookJob &job, const std::string &outputFullPath) {
+        AdCookRecord record;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto it = mRecords.find(job.outputPath);
+            if (it == mRecords.end()) {
+                return false;
+            }
+            record = it->second;
+        }
+        if (record.cooker != job.cooker->GetName() || record.version != job.cooker->GetVersion()
+            || record.inputs.empty() || record.inputs[0].path != job.sourcePath) {
+            return false;
+        }
+        if (!std::ifstream(outputFullPath).good()) {
+            return false;
+        }
+        for (const auto &input: record.inputs) {
+            uint64_t hash;
+            if (!GetFileHash(job.sourceDir, input.path, hash) || hash != input.hash) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void AdCookDatabase::UpdateRecord(const std::string &outputPath, AdCookRecord record) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mRecords[outputPath] = std::move(record);
+    }
+
+    std::vector<std::string> AdCookDatabase::RemoveStaleRecords(const std::unordered_set<std::string> &outputPaths) {
+        std::vector<std::string> removedPaths;
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (auto it = mRecords.begin(); it != mRecords.end();) {
+            if (outputPaths.find(it->first) == outputPaths.end()) {
+                removedPaths.push_back(it->first);
+                it = mRecords.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return removedPaths;
+    }
+}
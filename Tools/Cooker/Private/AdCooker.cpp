@@ -0,0 +1,231 @@
+#include "AdCooker.h"
+#include "AdHash.h"
+#include "AdLog.h"
+#include <atomic>
+#include <thread>
+#include <filesystem>
+
+namespace ade {
+
+    static const char *AD_COOK_DATABASE_FILE = ".cookdb";
+    static const char *AD_COOK_TEMP_DIR = ".cooktmp/";
+    static const char *AD_COOK_ARCHIVE_FILE = "Resource.adpak";
+
+    bool ReadFileBytes(const std::string &path, std::vector<uint8_t> &outData) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            return false;
+        }
+        outData.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        return static_cast<bool>(file.read(reinterpret_cast<char *>(outData.data()), outData.size()));
+    }
+
+    std::string GetFileExtension(const std::string &path) {
+        size_t dot = path.find_last_of('.');
+        size_t slash = path.find_last_of('/');
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+            return "";
+        }
+        std::string extension = path.substr(dot);
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        return extension;
+    }
+
+    std::string ReplaceFileExtension(const std::string &path, const std::string &extension) {
+        size_t dot = path.find_last_of('.');
+        size_t slash = path.find_last_of('/');
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+            return path + extension;
+        }
+        return path.substr(0, dot) + extension;
+    }
+
+    static std::string NormalizeDir(const std::string &dir) {
+        std::string result = dir;
+        std::replace(result.begin(), result.end(), '\\', '/');
+        if (!result.empty() && result.back() != '/') {
+            result += '/';
+        }
+        return result;
+    }
+
+    AdCooker::AdCooker(const AdCookerSettings &settings) : mSettings(settings) {
+        mSettings.sourceDir = NormalizeDir(settings.sourceDir);
+        mSettings.outputDir = NormalizeDir(settings.outputDir);
+        if (mSettings.threadCount == 0) {
+            mSettings.threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+    }
+
+    void AdCooker::RegisterCooker(std::unique_ptr<AdAssetCooker> cooker) {
+        mCookers.push_back(std::move(cooker));
+    }
+
+    bool AdCooker::Run() {
+        std::error_code ec;
+        std::filesystem::create_directories(mSettings.outputDir + AD_COOK_TEMP_DIR, ec);
+        // 强制烘焙也加载数据库, 用于清理源文件已被删除的输出
+        mDatabase.Load(mSettings.outputDir + AD_COOK_DATABASE_FILE);
+
+        std::vector<AdCookJob> jobs;
+        CollectJobs(jobs);
+        uint32_t prunedCount = PruneStaleOutputs(jobs);
+        LOG_I("Cook {0} assets: {1} -> {2}, {3} threads", jobs.size(), mSettings.sourceDir, mSettings.outputDir,
+              mSettings.threadCount);
+
+        // 所有烘焙任务相互独立, 并行执行
+        std::atomic<uint32_t> nextIndex{0};
+        std::atomic<uint32_t> cookedCount{0};
+        std::atomic<uint32_t> skippedCount{0};
+        std::atomic<uint32_t> failedCount{0};
+        std::vector<std::thread> workers;
+        uint32_t threadCount = std::min<uint32_t>(mSettings.threadCount, std::max<size_t>(jobs.size(), 1));
+        for (uint32_t i = 0; i < threadCount; i++) {
+            workers.emplace_back([&]() {
+                for (uint32_t index = nextIndex++; index < jobs.size(); index = nextIndex++) {
+                    int result = RunJob(jobs[index]);
+                    (result < 0 ? failedCount : result > 0 ? cookedCount : skippedCount)++;
+                }
+            });
+        }
+        for (auto &worker: workers) {
+            worker.join();
+        }
+
+        mDatabase.Save(mSettings.outputDir + AD_COOK_DATABASE_FILE);
+        std::filesystem::remove_all(mSettings.outputDir + AD_COOK_TEMP_DIR, ec);
+        LOG_I("Cook finished: {0} cooked, {1} up to date, {2} failed", cookedCount.load(), skippedCount.load(),
+              failedCount.load());
+
+        if (mSettings.bPack && (cookedCount > 0 || prunedCount > 0 || !std::ifstream(mSettings.outputDir + AD_COOK_ARCHIVE_FILE).good())) {
+            if (!Pack()) {
+                return false;
+            }
+        }
+        return failedCount == 0;
+    }
+
+    void AdCooker::CollectJobs(std::vector<AdCookJob> &outJobs) const {
+        std::error_code ec;
+        if (!std::filesystem::is_directory(mSettings.sourceDir, ec)) {
+            LOG_W("Source dir {0} does not exist.", mSettings.sourceDir);
+            return;
+        }
+        for (const auto &entry: std::filesystem::recursive_directory_iterator(mSettings.sourceDir, ec)) {
+            if (!entry.is_regular_file()) {
+                continue;
+            }
+            std::string sourcePath = std::filesystem::relative(entry.path(), mSettings.sourceDir).generic_string();
+            std::string extension = GetFileExtension(sourcePath);
+            for (const auto &cooker: mCookers) {
+                if (cooker->CanCook(extension)) {
+                    AdCookJob job;
+                    job.sourcePath = sourcePath;
+                    job.outputPath = cooker->GetOutputPath(sourcePath);
+                    job.sourceDir = mSettings.sourceDir;
+                    job.tempDir = mSettings.outputDir + AD_COOK_TEMP_DIR;
+                    job.cooker = cooker.get();
+                    outJobs.push_back(std::move(job));
+                    break;
+                }
+            }
+        }
+    }
+
+    uint32_t AdCooker::PruneStaleOutputs(const std::vector<AdCookJob> &jobs) {
+        std::unordered_set<std::string> outputPaths;
+        for (const auto &job: jobs) {
+            outputPaths.insert(job.outputPath);
+        }
+        std::vector<std::string> stalePaths = mDatabase.RemoveStaleRecords(outputPaths);
+        for (const auto &path: stalePaths) {
+            std::error_code ec;
+            std::filesystem::remove(mSettings.outputDir + path, ec);
+            LOG_D("Remove stale output {0}", path);
+        }
+        return static_cast<uint32_t>(stalePaths.size());
+    }
+
+    int AdCooker::RunJob(const AdCookJob &job) {
+        std::string outputFullPath = mSettings.outputDir + job.outputPath;
+        if (!mSettings.bForce && mDatabase.IsUpToDate(job, outputFullPath)) {
+            return 0;
+        }
+
+        AdCookResult result;
+        if (!job.cooker->Cook(job, result)) {
+            LOG_E("[{0}] cook {1} failed.", job.cooker->GetName(), job.sourcePath);
+            return -1;
+        }
+
+        AdCookRecord record;
+        record.cooker = job.cooker->GetName();
+        record.version = job.cooker->GetVersion();
+        std::vector<std::string> inputs = {job.sourcePath};
+        inputs.insert(inputs.end(), result.dependencies.begin(), result.dependencies.end());
+        for (const auto &input: inputs) {
+            uint64_t hash = 0;
+            if (!mDatabase.GetFileHash(job.sourceDir, input, hash)) {
+                LOG_W("[{0}] dependency {1} of {2} is missing.", job.cooker->GetName(), input, job.sourcePath);
+            }
+            record.inputs.push_back({input, hash});
+        }
+
+        // 先写临时文件再重命名, 中断时不会留下不完整的输出
+        std::error_code ec;
+        std::filesystem::create_directories(std::filesystem::path(outputFullPath).parent_path(), ec);
+        std::string tempPath = outputFullPath + ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            if (!out.is_open() || !out.write(reinterpret_cast<const char *>(result.data.data()), result.data.size())) {
+                LOG_E("Could not write {0}", outputFullPath);
+                return -1;
+            }
+        }
+        std::filesystem::rename(tempPath, outputFullPath, ec);
+        if (ec) {
+            LOG_E("Could not write {0}: {1}", outputFullPath, ec.message());
+            return -1;
+        }
+
+        mDatabase.UpdateRecord(job.outputPath, std::move(record));
+        LOG_D("[{0}] {1} -> {2} ({3} bytes)", job.cooker->GetName(), job.sourcePath, job.outputPath,
+              result.data.size());
+        return 1;
+    }
+
+    bool AdCooker::Pack() const {
+        AdArchiveWriter writer;
+        uint32_t fileCount = 0;
+        std::error_code ec;
+        for (const auto &entry: std::filesystem::recursive_directory_iterator(mSettings.outputDir, ec)) {
+            if (!entry.is_regular_file()) {
+                continue;
+            }
+            std::string path = std::filesystem::relative(entry.path(), mSettings.outputDir).generic_string();
+            if (path == AD_COOK_ARCHIVE_FILE || path == AD_COOK_DATABASE_FILE || path.rfind(AD_COOK_TEMP_DIR, 0) == 0
+                || GetFileExtension(path) == ".tmp") {
+                continue;
+            }
+
+            std::vector<uint8_t> data;
+            if (!ReadFileBytes(entry.path().string(), data)) {
+                LOG_E("Could not read {0}", path);
+                return false;
+            }
+            if (!writer.AddFile(path, std::move(data), mSettings.compression)) {
+                return false;
+            }
+            fileCount++;
+        }
+
+        std::string archivePath = mSettings.outputDir + AD_COOK_ARCHIVE_FILE;
+        if (!writer.Write(archivePath + ".tmp")) {
+            return false;
+        }
+        std::filesystem::rename(archivePath + ".tmp", archivePath, ec);
+        LOG_I("Pack {0} files into {1}", fileCount, archivePath);
+        return !ec;
+    }
+}
@@ -0,0 +1,355 @@
+#include "Cooker/AdMeshCooker.h"
+#include "Cooker/AdMeshOptimizer.h"
+#include "Cooker/AdMeshSimplifier.h"
+#include "Cooker/AdMeshletBuilder.h"
+#include "Asset/AdMeshFormat.h"
+#include "AdLog.h"
+#include "AdHash.h"
+#include <array>
+#include <cmath>
+#include <filesystem>
+
+namespace ade {
+
+    struct AdObjVertexKey {
+        int position;
+        int uv;
+        int normal;
+
+        bool operator==(const AdObjVertexKey &other) const {
+            return position == other.position && uv == other.uv && normal == other.normal;
+        }
+    };
+
+    struct AdObjVertexKeyHash {
+        size_t operator()(const AdObjVertexKey &key) const {
+            return (static_cast<size_t>(key.position) * 73856093) ^ (static_cast<size_t>(key.uv) * 19349663)
+                   ^ (static_cast<size_t>(key.normal) * 83492791);
+        }
+    };
+
+    // 输出格式或转换逻辑变化时递增
+    static constexpr uint32_t AD_MESH_COOKER_VERSION = 7;
+
+    uint32_t AdMeshCooker::GetVersion() const {
+        uint64_t hash = HashPod(AD_MESH_COOKER_VERSION);
+        hash = HashPod(mSettings.bOptimizeVertexCache, hash);
+        hash = HashPod(mSettings.bOptimizeOverdraw, hash);
+        hash = HashPod(mSettings.overdrawThreshold, hash);
+        hash = HashPod(std::min(mSettings.maxLodCount, AD_MESH_MAX_LOD_COUNT), hash);
+        hash = HashPod(mSettings.lodReduction, hash);
+        hash = HashPod(mSettings.minLodTriangleCount, hash);
+        return static_cast<uint32_t>(hash ^ (hash >> 32));
+    }
+
+    bool AdMeshCooker::CanCook(const std::string &extension) const {
+        return extension == ".obj";
+    }
+
+    std::string AdMeshCooker::GetOutputPath(const std::string &sourcePath) const {
+        return ReplaceFileExtension(sourcePath, ".mesh");
+    }
+
+    // OBJ 索引从 1 开始, 负数表示相对末尾; 返回 -1 表示不存在
+    static int ResolveObjIndex(const std::string &token, size_t count) {
+        if (token.empty()) {
+            return -1;
+        }
+        int index = std::atoi(token.c_str());
+        if (index < 0) {
+            index += static_cast<int>(count);
+        } else {
+            index -= 1;
+        }
+        return index >= 0 && index < static_cast<int>(count) ? index : -2;
+    }
+
+    static bool LoadObj(const AdCookJob &job, AdCookMesh &outMesh, std::vector<std::string> &outDependencies) {
+        std::ifstream in(job.GetSourceFullPath());
+        if (!in.is_open()) {
+            return false;
+        }
+
+        std::vector<std::array<float, 3>> positions;
+        std::vector<std::array<float, 3>> normals;
+        std::vector<std::array<float, 2>> uvs;
+        std::unordered_map<AdObjVertexKey, uint32_t, AdObjVertexKeyHash> vertexMap;
+        std::vector<AdObjVertexKey> vertices;
+        std::vector<uint32_t> &indices = outMesh.indices;
+        std::string sourceFolder = std::filesystem::path(job.sourcePath).parent_path().generic_string();
+
+        std::string line;
+        uint32_t lineNumber = 0;
+        while (std::getline(in, line)) {
+            lineNumber++;
+            std::istringstream stream(line);
+            std::string type;
+            stream >> type;
+            if (type == "v") {
+                std::array<float, 3> p{};
+                stream >> p[0] >> p[1] >> p[2];
+                positions.push_back(p);
+            } else if (type == "vn") {
+                std::array<float, 3> n{};
+                stream >> n[0] >> n[1] >> n[2];
+                normals.push_back(n);
+            } else if (type == "vt") {
+                std::array<float, 2> t{};
+                stream >> t[0] >> t[1];
+                // OBJ 的纹理坐标原点在左下角, Vulkan 在左上角
+                t[1] = 1.0f - t[1];
+                uvs.push_back(t);
+            } else if (type == "f") {
+                std::vector<uint32_t> face;
+                std::string token;
+                while (stream >> token) {
+                    std::string parts[3];
+                    size_t start = 0;
+                    for (int i = 0; i < 3; i++) {
+                        size_t slash = token.find('/', start);
+                        parts[i] = token.substr(start, slash == std::string::npos ? std::string::npos : slash - start);
+                        if (slash == std::string::npos) {
+                            break;
+                        }
+                        start = slash + 1;
+                    }
+                    AdObjVertexKey key{
+                            ResolveObjIndex(parts[0], positions.size()),
+                            ResolveObjIndex(parts[1], uvs.size()),
+                            ResolveObjIndex(parts[2], normals.size())
+                    };
+                    if (key.position < 0 || key.uv < -1 || key.normal < -1) {
+                        LOG_E("{0}:{1}: invalid face index '{2}'", job.sourcePath, lineNumber, token);
+                        return false;
+                    }
+                    auto it = vertexMap.find(key);
+                    if (it == vertexMap.end()) {
+                        it = vertexMap.emplace(key, static_cast<uint32_t>(vertices.size())).first;
+                        vertices.push_back(key);
+                    }
+                    face.push_back(it->second);
+                }
+                // 多边形按扇形三角化
+                for (size_t i = 2; i < face.size(); i++) {
+                    indices.insert(indices.end(), {face[0], face[i - 1], face[i]});
+                }
+            } else if (type == "mtllib") {
+                std::string mtlPath;
+                std::getline(stream >> std::ws, mtlPath);
+                outDependencies.push_back(sourceFolder.empty() ? mtlPath : sourceFolder + "/" + mtlPath);
+            }
+        }
+        if (indices.empty()) {
+            LOG_E("{0} has no faces.", job.sourcePath);
+            return false;
+        }
+
+        uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+        std::vector<float> &positionData = outMesh.positions;
+        std::vector<float> &normalData = outMesh.normals;
+        std::vector<float> &uvData = outMesh.uvs;
+        positionData.resize(vertexCount * 3);
+        normalData.assign(vertexCount * 3, 0.0f);
+        uvData.assign(vertexCount * 2, 0.0f);
+        bool bMissingNormal = false;
+        for (uint32_t i = 0; i < vertexCount; i++) {
+            const AdObjVertexKey &key = vertices[i];
+            memcpy(&positionData[i * 3], positions[key.position].data(), sizeof(float) * 3);
+            if (key.uv >= 0) {
+                memcpy(&uvData[i * 2], uvs[key.uv].data(), sizeof(float) * 2);
+            }
+            if (key.normal >= 0) {
+                memcpy(&normalData[i * 3], normals[key.normal].data(), sizeof(float) * 3);
+            } else {
+                bMissingNormal = true;
+            }
+        }
+
+        // 没有法线时用面积加权的面法线生成平滑法线
+        if (bMissingNormal) {
+            std::fill(normalData.begin(), normalData.end(), 0.0f);
+            for (size_t i = 0; i < indices.size(); i += 3) {
+                const float *p0 = &positionData[indices[i] * 3];
+                const float *p1 = &positionData[indices[i + 1] * 3];
+                const float *p2 = &positionData[indices[i + 2] * 3];
+                float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+                float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+                float n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+                for (int k = 0; k < 3; k++) {
+                    for (int c = 0; c < 3; c++) {
+                        normalData[indices[i + k] * 3 + c] += n[c];
+                    }
+                }
+            }
+        }
+        // 量化前统一归一化
+        for (uint32_t i = 0; i < vertexCount; i++) {
+            float *n = &normalData[i * 3];
+            float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            if (length > 0.0f) {
+                n[0] /= length;
+                n[1] /= length;
+                n[2] /= length;
+            } else {
+                n[0] = n[1] = 0.0f;
+                n[2] = 1.0f;
+            }
+        }
+        return true;
+    }
+
+    static void WriteMesh(const AdCookMesh &mesh, std::vector<uint8_t> &outData) {
+        uint32_t vertexCount = mesh.GetVertexCount();
+
+        AdMeshHeader header{};
+        header.magic = AD_MESH_MAGIC;
+        header.version = AD_MESH_VERSION;
+        header.vertexCount = vertexCount;
+        header.indexCount = static_cast<uint32_t>(mesh.indices.size());
+        header.indexSize = vertexCount <= 65536 ? sizeof(uint16_t) : sizeof(uint32_t);
+        if (mesh.lods.empty()) {
+            header.lodCount = 1;
+            header.lods[0] = {0, header.indexCount, 0, static_cast<uint32_t>(mesh.meshlets.size()), 0.0f, {}};
+        } else {
+            header.lodCount = static_cast<uint32_t>(mesh.lods.size());
+            std::copy(mesh.lods.begin(), mesh.lods.end(), header.lods);
+        }
+
+        float uvMin[2] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+        float uvMax[2] = {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()};
+        for (int c = 0; c < 3; c++) {
+            header.boundsMin[c] = std::numeric_limits<float>::max();
+            header.boundsMax[c] = std::numeric_limits<float>::lowest();
+        }
+        for (uint32_t i = 0; i < vertexCount; i++) {
+            for (int c = 0; c < 3; c++) {
+                header.boundsMin[c] = std::min(header.boundsMin[c], mesh.positions[i * 3 + c]);
+                header.boundsMax[c] = std::max(header.boundsMax[c], mesh.positions[i * 3 + c]);
+            }
+            for (int c = 0; c < 2; c++) {
+                uvMin[c] = std::min(uvMin[c], mesh.uvs[i * 2 + c]);
+                uvMax[c] = std::max(uvMax[c], mesh.uvs[i * 2 + c]);
+            }
+        }
+        // 位置和 uv 都在包围范围内量化, 精度为范围的 1/65535
+        for (int c = 0; c < 3; c++) {
+            header.positionOffset[c] = header.boundsMin[c];
+            header.positionScale[c] = header.boundsMax[c] - header.boundsMin[c];
+        }
+        for (int c = 0; c < 2; c++) {
+            header.uvOffset[c] = uvMin[c];
+            header.uvScale[c] = uvMax[c] - uvMin[c];
+        }
+        auto normalize = [](float value, float offset, float scale) {
+            return scale > 0.0f ? (value - offset) / scale : 0.0f;
+        };
+
+        std::vector<AdMeshPosition> positions(vertexCount);
+        std::vector<AdMeshAttribute> attributes(vertexCount);
+        for (uint32_t i = 0; i < vertexCount; i++) {
+            const float *p = &mesh.positions[i * 3];
+            positions[i] = {
+                    QuantizeUnorm16(normalize(p[0], header.positionOffset[0], header.positionScale[0])),
+                    QuantizeUnorm16(normalize(p[1], header.positionOffset[1], header.positionScale[1])),
+                    QuantizeUnorm16(normalize(p[2], header.positionOffset[2], header.positionScale[2])),
+                    0
+            };
+            EncodeOctahedral(&mesh.normals[i * 3], attributes[i].normal);
+            for (int c = 0; c < 2; c++) {
+                attributes[i].uv[c] = QuantizeUnorm16(normalize(mesh.uvs[i * 2 + c], header.uvOffset[c], header.uvScale[c]));
+            }
+        }
+
+        uint64_t offset = sizeof(AdMeshHeader);
+        auto layoutStream = [&offset](AdMeshStream &stream, uint64_t size) {
+            offset = (offset + AD_MESH_STREAM_ALIGNMENT - 1) & ~(AD_MESH_STREAM_ALIGNMENT - 1);
+            stream = {offset, size};
+            offset += size;
+        };
+        layoutStream(header.position, positions.size() * sizeof(AdMeshPosition));
+        layoutStream(header.attribute, attributes.size() * sizeof(AdMeshAttribute));
+        layoutStream(header.index, mesh.indices.size() * header.indexSize);
+        layoutStream(header.meshlet, mesh.meshlets.size() * sizeof(AdMeshlet));
+        layoutStream(header.meshletVertex, mesh.meshletVertices.size() * sizeof(uint32_t));
+        layoutStream(header.meshletTriangle, mesh.meshletTriangles.size() * sizeof(uint32_t));
+
+        outData.assign(offset, 0);
+        uint8_t *out = outData.data();
+        memcpy(out, &header, sizeof(header));
+        memcpy(out + header.position.offset, positions.data(), header.position.size);
+        memcpy(out + header.attribute.offset, attributes.data(), header.attribute.size);
+        if (header.indexSize == sizeof(uint16_t)) {
+            auto *indices = reinterpret_cast<uint16_t *>(out + header.index.offset);
+            for (size_t i = 0; i < mesh.indices.size(); i++) {
+                indices[i] = static_cast<uint16_t>(mesh.indices[i]);
+            }
+        } else {
+            memcpy(out + header.index.offset, mesh.indices.data(), header.index.size);
+        }
+        memcpy(out + header.meshlet.offset, mesh.meshlets.data(), header.meshlet.size);
+        memcpy(out + header.meshletVertex.offset, mesh.meshletVertices.data(), header.meshletVertex.size);
+        memcpy(out + header.meshletTriangle.offset, mesh.meshletTriangles.data(), header.meshletTriangle.size);
+    }
+
+    bool AdMeshCooker::Cook(const AdCookJob &job, AdCookResult &outResult) const {
+        AdCookMesh mesh;
+        if (!LoadObj(job, mesh, outResult.dependencies)) {
+            return false;
+        }
+
+        // 每一级从上一级简化, 误差累加
+        std::vector<std::vector<uint32_t>> lodIndices = {std::move(mesh.indices)};
+        std::vector<float> lodErrors = {0.0f};
+        uint32_t maxLodCount = std::min(mSettings.maxLodCount, AD_MESH_MAX_LOD_COUNT);
+        while (lodIndices.size() < maxLodCount && lodIndices.back().size() / 3 > mSettings.minLodTriangleCount) {
+            const std::vector<uint32_t> &source = lodIndices.back();
+            size_t targetIndexCount = static_cast<size_t>(source.size() / 3 * mSettings.lodReduction) * 3;
+            std::vector<uint32_t> simplified;
+            float error;
+            SimplifyMesh(mesh, source, targetIndexCount, std::numeric_limits<float>::max(), simplified, error);
+            // 简化不动了(例如大部分顶点在属性接缝上)就停止
+            if (simplified.empty() || simplified.size() > source.size() * 0.9f) {
+                break;
+            }
+            lodErrors.push_back(lodErrors.back() + error);
+            lodIndices.push_back(std::move(simplified));
+        }
+
+        // 先按顶点缓存重排三角形, 再在此基础上按簇排序减少过度绘制, 最后按新的三角形顺序重排顶点
+        AdVertexCacheStats before = AnalyzeVertexCache(lodIndices[0], mesh.GetVertexCount());
+        for (auto &indices: lodIndices) {
+            if (mSettings.bOptimizeVertexCache) {
+                OptimizeVertexCache(indices, mesh.GetVertexCount());
+            }
+            if (mSettings.bOptimizeOverdraw) {
+                OptimizeOverdraw(indices, mesh.positions, mSettings.overdrawThreshold);
+            }
+        }
+        mesh.indices.clear();
+        for (size_t i = 0; i < lodIndices.size(); i++) {
+            mesh.lods.push_back({static_cast<uint32_t>(mesh.indices.size()), static_cast<uint32_t>(lodIndices[i].size()),
+                                 0, 0, lodErrors[i], {}});
+            mesh.indices.insert(mesh.indices.end(), lodIndices[i].begin(), lodIndices[i].end());
+        }
+        // LOD0 的索引在最前面, 顶点按它的首次使用顺序排列
+        OptimizeVertexFetch(mesh);
+        std::vector<uint32_t> lod0(mesh.indices.begin(), mesh.indices.begin() + mesh.lods[0].indexCount);
+        AdVertexCacheStats after = AnalyzeVertexCache(lod0, mesh.GetVertexCount());
+        LOG_I("[Mesh] {0}: {1} vertices, {2} triangles, ACMR {3:.3f} -> {4:.3f}, ATVR {5:.3f} -> {6:.3f}",
+              job.sourcePath, mesh.GetVertexCount(), lod0.size() / 3, before.acmr, after.acmr,
+              before.atvr, after.atvr);
+
+        // meshlet 按重排后的三角形顺序切分, 要在顶点重排之后生成
+        for (AdMeshLod &lod: mesh.lods) {
+            lod.meshletOffset = static_cast<uint32_t>(mesh.meshlets.size());
+            lod.meshletCount = BuildMeshlets(mesh, &mesh.indices[lod.indexOffset], lod.indexCount);
+        }
+        for (size_t i = 0; i < mesh.lods.size(); i++) {
+            LOG_I("[Mesh] {0}: LOD{1} {2} triangles, {3} meshlets, error {4:.6f}", job.sourcePath, i,
+                  mesh.lods[i].indexCount / 3, mesh.lods[i].meshletCount, mesh.lods[i].error);
+        }
+
+        WriteMesh(mesh, outResult.data);
+        return true;
+    }
+}
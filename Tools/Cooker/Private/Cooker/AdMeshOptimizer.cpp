@@ -0,0 +1,316 @@
+#include "Cooker/AdMeshOptimizer.h"
+#include "Cooker/AdMeshCooker.h"
+#include <cmath>
+#include <cstring>
+
+namespace ade {
+
+    static constexpr uint32_t AD_VERTEX_CACHE_SIZE = 32;
+    static constexpr float AD_CACHE_DECAY_POWER = 1.5f;
+    static constexpr float AD_LAST_TRIANGLE_SCORE = 0.75f;
+    static constexpr float AD_VALENCE_BOOST_SCALE = 2.0f;
+    static constexpr float AD_VALENCE_BOOST_POWER = 0.5f;
+
+    AdVertexCacheStats AnalyzeVertexCache(const std::vector<uint32_t> &indices, uint32_t vertexCount, uint32_t cacheSize) {
+        // 记录每个顶点进入缓存时的时间戳, 时间戳落后 cacheSize 以上即已被挤出
+        std::vector<uint32_t> timestamps(vertexCount, 0);
+        uint32_t time = cacheSize + 1;
+        uint32_t transforms = 0;
+        for (uint32_t index: indices) {
+            if (time - timestamps[index] > cacheSize) {
+                timestamps[index] = time++;
+                transforms++;
+            }
+        }
+        size_t triangleCount = indices.size() / 3;
+        return {
+                transforms,
+                triangleCount > 0 ? float(transforms) / float(triangleCount) : 0.0f,
+                vertexCount > 0 ? float(transforms) / float(vertexCount) : 0.0f
+        };
+    }
+
+    static float GetVertexScore(int cachePosition, uint32_t remainingTriangles) {
+        if (remainingTriangles == 0) {
+            return -1.0f;
+        }
+        float score = 0.0f;
+        if (cachePosition >= 0) {
+            // 刚用过的三个顶点分数固定, 避免总是沿同一条边继续
+            score = cachePosition < 3 ? AD_LAST_TRIANGLE_SCORE
+                                      : std::pow(1.0f - float(cachePosition - 3) / (AD_VERTEX_CACHE_SIZE - 3),
+                                                 AD_CACHE_DECAY_POWER);
+        }
+        // 剩余三角形少的顶点优先处理完, 减少以后再次加载
+        return score + AD_VALENCE_BOOST_SCALE * std::pow(float(remainingTriangles), -AD_VALENCE_BOOST_POWER);
+    }
+
+    void OptimizeVertexCache(std::vector<uint32_t> &indices, uint32_t vertexCount) {
+        uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+        if (triangleCount == 0) {
+            return;
+        }
+
+        // 顶点 -> 相邻三角形
+        std::vector<uint32_t> remaining(vertexCount, 0);
+        for (uint32_t index: indices) {
+            remaining[index]++;
+        }
+        std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            adjacencyOffsets[v + 1] = adjacencyOffsets[v] + remaining[v];
+        }
+        std::vector<uint32_t> adjacency(indices.size());
+        {
+            std::vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (uint32_t t = 0; t < triangleCount; t++) {
+                for (int k = 0; k < 3; k++) {
+                    adjacency[cursor[indices[t * 3 + k]]++] = t;
+                }
+            }
+        }
+
+        std::vector<float> vertexScores(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            vertexScores[v] = GetVertexScore(-1, remaining[v]);
+        }
+        std::vector<float> triangleScores(triangleCount);
+        std::vector<bool> emitted(triangleCount, false);
+        for (uint32_t t = 0; t < triangleCount; t++) {
+            triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]]
+                                + vertexScores[indices[t * 3 + 2]];
+        }
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+        std::vector<uint32_t> cache;
+        std::vector<uint32_t> newCache;
+        cache.reserve(AD_VERTEX_CACHE_SIZE + 3);
+        newCache.reserve(AD_VERTEX_CACHE_SIZE + 3);
+
+        int bestTriangle = static_cast<int>(std::max_element(triangleScores.begin(), triangleScores.end())
+                                            - triangleScores.begin());
+        uint32_t scanCursor = 0;
+        for (uint32_t emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+            if (bestTriangle < 0) {
+                // 缓存中的顶点都没有剩余三角形了, 顺序找下一个未输出的三角形
+                while (emitted[scanCursor]) {
+                    scanCursor++;
+                }
+                bestTriangle = static_cast<int>(scanCursor);
+            }
+
+            const uint32_t *triangle = &indices[bestTriangle * 3];
+            result.insert(result.end(), triangle, triangle + 3);
+            emitted[bestTriangle] = true;
+
+            // 从顶点的相邻列表中移除已输出的三角形
+            for (int k = 0; k < 3; k++) {
+                uint32_t v = triangle[k];
+                uint32_t *begin = &adjacency[adjacencyOffsets[v]];
+                uint32_t *end = begin + remaining[v];
+                uint32_t *it = std::find(begin, end, static_cast<uint32_t>(bestTriangle));
+                std::swap(*it, *(end - 1));
+                remaining[v]--;
+            }
+
+            // 新三角形的顶点放到 LRU 缓存最前面
+            newCache.assign(triangle, triangle + 3);
+            for (uint32_t v: cache) {
+                if (v != triangle[0] && v != triangle[1] && v != triangle[2]) {
+                    newCache.push_back(v);
+                }
+            }
+            for (size_t i = AD_VERTEX_CACHE_SIZE; i < newCache.size(); i++) {
+                vertexScores[newCache[i]] = GetVertexScore(-1, remaining[newCache[i]]);
+            }
+            newCache.resize(std::min<size_t>(newCache.size(), AD_VERTEX_CACHE_SIZE));
+            std::swap(cache, newCache);
+
+            for (size_t i = 0; i < cache.size(); i++) {
+                vertexScores[cache[i]] = GetVertexScore(static_cast<int>(i), remaining[cache[i]]);
+            }
+
+            // 只有缓存中顶点的相邻三角形分数会变化, 从中选出下一个
+            bestTriangle = -1;
+            float bestScore = -1.0f;
+            for (uint32_t v: cache) {
+                for (uint32_t i = 0; i < remaining[v]; i++) {
+                    uint32_t t = adjacency[adjacencyOffsets[v] + i];
+                    float score = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]]
+                                  + vertexScores[indices[t * 3 + 2]];
+                    triangleScores[t] = score;
+                    if (score > bestScore) {
+                        bestScore = score;
+                        bestTriangle = static_cast<int>(t);
+                    }
+                }
+            }
+        }
+        indices.swap(result);
+    }
+
+    void OptimizeOverdraw(std::vector<uint32_t> &indices, const std::vector<float> &positions, float threshold) {
+        uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+        uint32_t vertexCount = static_cast<uint32_t>(positions.size() / 3);
+        if (triangleCount == 0) {
+            return;
+        }
+
+        // 顺序模拟 FIFO 缓存, 返回每个三角形的未命中数
+        constexpr uint32_t cacheSize = 16;
+        std::vector<uint32_t> timestamps(vertexCount, 0);
+        uint32_t time = cacheSize + 1;
+        auto simulate = [&](uint32_t t) {
+            uint32_t misses = 0;
+            for (int k = 0; k < 3; k++) {
+                uint32_t v = indices[t * 3 + k];
+                if (time - timestamps[v] > cacheSize) {
+                    timestamps[v] = time++;
+                    misses++;
+                }
+            }
+            return misses;
+        };
+        auto resetCache = [&]() {
+            time += cacheSize + 1;
+        };
+
+        // 硬边界: 三个顶点都未命中的地方, 前后两段的缓存状态本来就没有关系
+        // 第一个簇总是从 0 开始, 即使开头的三角形(例如退化三角形)没有 3 次未命中
+        std::vector<uint32_t> hardBoundaries = {0};
+        for (uint32_t t = 0; t < triangleCount; t++) {
+            if (simulate(t) == 3 && t > 0) {
+                hardBoundaries.push_back(t);
+            }
+        }
+        hardBoundaries.push_back(triangleCount);
+
+        // 软边界: 从边界处重置缓存后, 簇的 ACMR 不超过硬簇 ACMR * threshold 时就可以再切开
+        std::vector<uint32_t> clusters;
+        for (size_t h = 0; h + 1 < hardBoundaries.size(); h++) {
+            uint32_t start = hardBoundaries[h];
+            uint32_t end = hardBoundaries[h + 1];
+            resetCache();
+            uint32_t hardMisses = 0;
+            for (uint32_t t = start; t < end; t++) {
+                hardMisses += simulate(t);
+            }
+            float clusterThreshold = threshold * float(hardMisses) / float(end - start);
+
+            clusters.push_back(start);
+            resetCache();
+            uint32_t clusterStart = start;
+            uint32_t clusterMisses = 0;
+            for (uint32_t t = start; t < end; t++) {
+                clusterMisses += simulate(t);
+                if (t + 1 < end && float(clusterMisses) / float(t + 1 - clusterStart) <= clusterThreshold) {
+                    clusters.push_back(t + 1);
+                    resetCache();
+                    clusterStart = t + 1;
+                    clusterMisses = 0;
+                }
+            }
+        }
+        clusters.push_back(triangleCount);
+
+        // 网格中心: 面积加权的三角形重心
+        auto getTriangle = [&](uint32_t t, float outCentroid[3], float outNormal[3]) {
+            const float *p0 = &positions[indices[t * 3] * 3];
+            const float *p1 = &positions[indices[t * 3 + 1] * 3];
+            const float *p2 = &positions[indices[t * 3 + 2] * 3];
+            float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+            float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+            outNormal[0] = e1[1] * e2[2] - e1[2] * e2[1];
+            outNormal[1] = e1[2] * e2[0] - e1[0] * e2[2];
+            outNormal[2] = e1[0] * e2[1] - e1[1] * e2[0];
+            for (int c = 0; c < 3; c++) {
+                outCentroid[c] = (p0[c] + p1[c] + p2[c]) / 3.0f;
+            }
+            return std::sqrt(outNormal[0] * outNormal[0] + outNormal[1] * outNormal[1] + outNormal[2] * outNormal[2]);
+        };
+        float meshCenter[3] = {0, 0, 0};
+        float meshArea = 0.0f;
+        for (uint32_t t = 0; t < triangleCount; t++) {
+            float centroid[3], normal[3];
+            float area = getTriangle(t, centroid, normal);
+            for (int c = 0; c < 3; c++) {
+                meshCenter[c] += centroid[c] * area;
+            }
+            meshArea += area;
+        }
+        for (float &c: meshCenter) {
+            c = meshArea > 0.0f ? c / meshArea : 0.0f;
+        }
+
+        // 簇排序 key: 簇中心相对网格中心在簇法线方向上的距离, 越靠外越先绘制
+        uint32_t clusterCount = static_cast<uint32_t>(clusters.size() - 1);
+        std::vector<float> sortKeys(clusterCount);
+        for (uint32_t i = 0; i < clusterCount; i++) {
+            float center[3] = {0, 0, 0};
+            float normal[3] = {0, 0, 0};
+            float area = 0.0f;
+            for (uint32_t t = clusters[i]; t < clusters[i + 1]; t++) {
+                float triangleCentroid[3], triangleNormal[3];
+                float triangleArea = getTriangle(t, triangleCentroid, triangleNormal);
+                for (int c = 0; c < 3; c++) {
+                    center[c] += triangleCentroid[c] * triangleArea;
+                    normal[c] += triangleNormal[c];
+                }
+                area += triangleArea;
+            }
+            float normalLength = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+            float key = 0.0f;
+            for (int c = 0; c < 3; c++) {
+                float clusterCenter = area > 0.0f ? center[c] / area : 0.0f;
+                key += (clusterCenter - meshCenter[c]) * (normalLength > 0.0f ? normal[c] / normalLength : 0.0f);
+            }
+            sortKeys[i] = key;
+        }
+
+        std::vector<uint32_t> order(clusterCount);
+        for (uint32_t i = 0; i < clusterCount; i++) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&sortKeys](uint32_t a, uint32_t b) {
+            return sortKeys[a] > sortKeys[b];
+        });
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+        for (uint32_t i: order) {
+            result.insert(result.end(), indices.begin() + clusters[i] * 3, indices.begin() + clusters[i + 1] * 3);
+        }
+        assert(result.size() == size_t(triangleCount) * 3);
+        indices.swap(result);
+    }
+
+    void OptimizeVertexFetch(AdCookMesh &mesh) {
+        uint32_t vertexCount = mesh.GetVertexCount();
+        std::vector<uint32_t> remap(vertexCount, UINT32_MAX);
+        uint32_t newVertexCount = 0;
+        for (uint32_t &index: mesh.indices) {
+            if (remap[index] == UINT32_MAX) {
+                remap[index] = newVertexCount++;
+            }
+            index = remap[index];
+        }
+
+        AdCookMesh result;
+        result.positions.resize(newVertexCount * 3);
+        result.normals.resize(newVertexCount * 3);
+        result.uvs.resize(newVertexCount * 2);
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            uint32_t newIndex = remap[v];
+            if (newIndex == UINT32_MAX) {
+                continue;
+            }
+            memcpy(&result.positions[newIndex * 3], &mesh.positions[v * 3], sizeof(float) * 3);
+            memcpy(&result.normals[newIndex * 3], &mesh.normals[v * 3], sizeof(float) * 3);
+            memcpy(&result.uvs[newIndex * 2], &mesh.uvs[v * 2], sizeof(float) * 2);
+        }
+        mesh.positions.swap(result.positions);
+        mesh.normals.swap(result.normals);
+        mesh.uvs.swap(result.uvs);
+    }
+}
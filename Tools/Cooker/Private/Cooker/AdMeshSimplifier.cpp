@@ -0,0 +1,337 @@
+#include "Cooker/AdMeshSimplifier.h"
+#include "Cooker/AdMeshCooker.h"
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace ade {
+
+    static constexpr double AD_BORDER_WEIGHT = 10.0;
+    static constexpr float AD_NORMAL_WEIGHT = 0.25f;
+    static constexpr float AD_UV_WEIGHT = 1.0f;
+    static constexpr float AD_FLIP_THRESHOLD = 0.25f;  // 折叠后三角形法线偏转超过约 75 度视为翻转
+
+    // 对称 4x4 矩阵的上三角部分, Evaluate 返回到所有累加平面的加权平方距离之和
+    struct AdQuadric {
+        double a00 = 0, a11 = 0, a22 = 0, a01 = 0, a02 = 0, a12 = 0;
+        double b0 = 0, b1 = 0, b2 = 0, c = 0;
+        double weight = 0;
+
+        void AddPlane(const double n[3], double d, double w) {
+            a00 += w * n[0] * n[0];
+            a11 += w * n[1] * n[1];
+            a22 += w * n[2] * n[2];
+            a01 += w * n[0] * n[1];
+            a02 += w * n[0] * n[2];
+            a12 += w * n[1] * n[2];
+            b0 += w * n[0] * d;
+            b1 += w * n[1] * d;
+            b2 += w * n[2] * d;
+            c += w * d * d;
+            weight += w;
+        }
+
+        void Add(const AdQuadric &other) {
+            a00 += other.a00;
+            a11 += other.a11;
+            a22 += other.a22;
+            a01 += other.a01;
+            a02 += other.a02;
+            a12 += other.a12;
+            b0 += other.b0;
+            b1 += other.b1;
+            b2 += other.b2;
+            c += other.c;
+            weight += other.weight;
+        }
+
+        double Evaluate(const float p[3]) const {
+            double x = p[0], y = p[1], z = p[2];
+            double result = a00 * x * x + a11 * y * y + a22 * z * z
+                            + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z)
+                            + 2.0 * (b0 * x + b1 * y + b2 * z) + c;
+            return std::max(result, 0.0);
+        }
+    };
+
+    enum AdVertexKind : uint8_t {
+        AD_VERTEX_KIND_MANIFOLD = 0,
+        AD_VERTEX_KIND_BORDER,      // 只能沿开放边界折叠
+        AD_VERTEX_KIND_LOCKED       // 属性接缝或非流形, 不移动
+    };
+
+    struct AdCollapse {
+        uint32_t vertex;            // 被移除的顶点
+        uint32_t target;
+        float cost;
+        float error;                // 平方几何误差
+    };
+
+    static uint64_t MakeEdgeKey(uint32_t a, uint32_t b) {
+        return (uint64_t(a) << 32) | b;
+    }
+
+    static void Cross(const float *p0, const float *p1, const float *p2, double outNormal[3]) {
+        double e1[3] = {double(p1[0]) - p0[0], double(p1[1]) - p0[1], double(p1[2]) - p0[2]};
+        double e2[3] = {double(p2[0]) - p0[0], double(p2[1]) - p0[1], double(p2[2]) - p0[2]};
+        outNormal[0] = e1[1] * e2[2] - e1[2] * e2[1];
+        outNormal[1] = e1[2] * e2[0] - e1[0] * e2[2];
+        outNormal[2] = e1[0] * e2[1] - e1[1] * e2[0];
+    }
+
+    // 位置相同的顶点焊接到同一个 id, 用于识别真正的拓扑边界和属性接缝
+    static void BuildWeldMap(const AdCookMesh &mesh, std::vector<uint32_t> &outWeld) {
+        struct PositionHash {
+            size_t operator()(const std::array<uint32_t, 3> &p) const {
+                return (p[0] * 73856093u) ^ (p[1] * 19349663u) ^ (p[2] * 83492791u);
+            }
+        };
+        uint32_t vertexCount = mesh.GetVertexCount();
+        std::unordered_map<std::array<uint32_t, 3>, uint32_t, PositionHash> positionMap;
+        outWeld.resize(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            std::array<uint32_t, 3> key{};
+            memcpy(key.data(), &mesh.positions[v * 3], sizeof(float) * 3);
+            outWeld[v] = positionMap.emplace(key, v).first->second;
+        }
+    }
+
+    void SimplifyMesh(const AdCookMesh &mesh, const std::vector<uint32_t> &indices, size_t targetIndexCount,
+                      float targetError, std::vector<uint32_t> &outIndices, float &outError) {
+        uint32_t vertexCount = mesh.GetVertexCount();
+        const float *positions = mesh.positions.data();
+        outIndices = indices;
+        outError = 0.0f;
+
+        std::vector<uint32_t> weld;
+        BuildWeldMap(mesh, weld);
+
+        // 顶点分类
+        std::vector<uint32_t> weldGroupSize(vertexCount, 0);
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            weldGroupSize[weld[v]]++;
+        }
+        std::unordered_map<uint64_t, uint32_t> edgeCounts;
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            for (int k = 0; k < 3; k++) {
+                edgeCounts[MakeEdgeKey(weld[indices[i + k]], weld[indices[i + (k + 1) % 3]])]++;
+            }
+        }
+        std::vector<AdVertexKind> kinds(vertexCount, AD_VERTEX_KIND_MANIFOLD);
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            if (weldGroupSize[weld[v]] > 1) {
+                kinds[v] = AD_VERTEX_KIND_LOCKED;
+            }
+        }
+
+        // 二次误差: 相邻三角形平面按面积加权, 开放边界额外加上垂直于三角形的边界平面
+        std::vector<AdQuadric> quadrics(vertexCount);
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            const uint32_t tri[3] = {indices[i], indices[i + 1], indices[i + 2]};
+            double normal[3];
+            Cross(&positions[tri[0] * 3], &positions[tri[1] * 3], &positions[tri[2] * 3], normal);
+            double length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+            if (length <= 0.0) {
+                continue;
+            }
+            for (double &n: normal) {
+                n /= length;
+            }
+            const float *p0 = &positions[tri[0] * 3];
+            double d = -(normal[0] * p0[0] + normal[1] * p0[1] + normal[2] * p0[2]);
+            for (uint32_t v: tri) {
+                quadrics[v].AddPlane(normal, d, length * 0.5);
+            }
+
+            for (int k = 0; k < 3; k++) {
+                uint32_t a = tri[k];
+                uint32_t b = tri[(k + 1) % 3];
+                uint32_t forward = edgeCounts[MakeEdgeKey(weld[a], weld[b])];
+                auto backward = edgeCounts.find(MakeEdgeKey(weld[b], weld[a]));
+                if (forward > 1 || (backward != edgeCounts.end() && backward->second > 1)) {
+                    // 非流形边
+                    kinds[a] = kinds[b] = AD_VERTEX_KIND_LOCKED;
+                    continue;
+                }
+                if (backward != edgeCounts.end()) {
+                    continue;
+                }
+                for (uint32_t v: {a, b}) {
+                    if (kinds[v] == AD_VERTEX_KIND_MANIFOLD) {
+                        kinds[v] = AD_VERTEX_KIND_BORDER;
+                    }
+                }
+                const float *pa = &positions[a * 3];
+                const float *pb = &positions[b * 3];
+                double edge[3] = {double(pb[0]) - pa[0], double(pb[1]) - pa[1], double(pb[2]) - pa[2]};
+                double edgeLength2 = edge[0] * edge[0] + edge[1] * edge[1] + edge[2] * edge[2];
+                double borderNormal[3] = {
+                        edge[1] * normal[2] - edge[2] * normal[1],
+                        edge[2] * normal[0] - edge[0] * normal[2],
+                        edge[0] * normal[1] - edge[1] * normal[0]
+                };
+                double borderLength = std::sqrt(borderNormal[0] * borderNormal[0] + borderNormal[1] * borderNormal[1]
+                                                + borderNormal[2] * borderNormal[2]);
+                if (borderLength <= 0.0) {
+                    continue;
+                }
+                for (double &n: borderNormal) {
+                    n /= borderLength;
+                }
+                double borderD = -(borderNormal[0] * pa[0] + borderNormal[1] * pa[1] + borderNormal[2] * pa[2]);
+                quadrics[a].AddPlane(borderNormal, borderD, edgeLength2 * AD_BORDER_WEIGHT);
+                quadrics[b].AddPlane(borderNormal, borderD, edgeLength2 * AD_BORDER_WEIGHT);
+            }
+        }
+
+        auto getAttributeCost = [&mesh, positions](uint32_t v, uint32_t t) {
+            float cost = 0.0f;
+            float edgeLength2 = 0.0f;
+            for (int c = 0; c < 3; c++) {
+                float dp = positions[v * 3 + c] - positions[t * 3 + c];
+                float dn = mesh.normals[v * 3 + c] - mesh.normals[t * 3 + c];
+                edgeLength2 += dp * dp;
+                cost += AD_NORMAL_WEIGHT * dn * dn;
+            }
+            for (int c = 0; c < 2; c++) {
+                float duv = mesh.uvs[v * 2 + c] - mesh.uvs[t * 2 + c];
+                cost += AD_UV_WEIGHT * duv * duv;
+            }
+            // 属性差异按折叠距离缩放到和几何误差相同的量纲
+            return cost * edgeLength2;
+        };
+
+        double maxError = 0.0;
+        double targetError2 = double(targetError) * targetError;
+        std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+        std::vector<uint32_t> adjacency;
+        std::unordered_set<uint64_t> edges;
+        std::vector<AdCollapse> collapses;
+        std::vector<bool> touched(vertexCount);
+        std::vector<uint32_t> remap(vertexCount);
+
+        while (outIndices.size() > targetIndexCount) {
+            // 当前三角形的邻接关系和焊接后的有向边
+            std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+            for (uint32_t index: outIndices) {
+                adjacencyOffsets[index + 1]++;
+            }
+            for (uint32_t v = 0; v < vertexCount; v++) {
+                adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+            }
+            adjacency.resize(outIndices.size());
+            {
+                std::vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+                for (size_t i = 0; i < outIndices.size(); i++) {
+                    adjacency[cursor[outIndices[i]]++] = static_cast<uint32_t>(i / 3);
+                }
+            }
+            edges.clear();
+            for (size_t i = 0; i < outIndices.size(); i += 3) {
+                for (int k = 0; k < 3; k++) {
+                    edges.insert(MakeEdgeKey(weld[outIndices[i + k]], weld[outIndices[i + (k + 1) % 3]]));
+                }
+            }
+
+            // 收集所有合法的半边折叠
+            collapses.clear();
+            for (size_t i = 0; i < outIndices.size(); i += 3) {
+                for (int k = 0; k < 3; k++) {
+                    uint32_t a = outIndices[i + k];
+                    uint32_t b = outIndices[i + (k + 1) % 3];
+                    for (int direction = 0; direction < 2; direction++) {
+                        uint32_t v = direction == 0 ? a : b;
+                        uint32_t t = direction == 0 ? b : a;
+                        if (kinds[v] == AD_VERTEX_KIND_LOCKED) {
+                            continue;
+                        }
+                        if (kinds[v] == AD_VERTEX_KIND_BORDER
+                            && edges.count(MakeEdgeKey(weld[v], weld[t])) + edges.count(MakeEdgeKey(weld[t], weld[v])) != 1) {
+                            continue;
+                        }
+                        AdQuadric quadric = quadrics[v];
+                        quadric.Add(quadrics[t]);
+                        double error = quadric.weight > 0.0 ? quadric.Evaluate(&positions[t * 3]) / quadric.weight : 0.0;
+                        collapses.push_back({v, t, float(error) + getAttributeCost(v, t), float(error)});
+                    }
+                }
+            }
+            std::sort(collapses.begin(), collapses.end(), [](const AdCollapse &a, const AdCollapse &b) {
+                return a.cost < b.cost;
+            });
+
+            // 每一轮中每个顶点的一环邻域只参与一次折叠, 保证翻转检查使用的是最新的三角形
+            std::fill(touched.begin(), touched.end(), false);
+            for (uint32_t v = 0; v < vertexCount; v++) {
+                remap[v] = v;
+            }
+            size_t triangleBudget = (outIndices.size() - targetIndexCount) / 3;
+            size_t removedTriangles = 0;
+            uint32_t collapseCount = 0;
+            for (const AdCollapse &collapse: collapses) {
+                uint32_t v = collapse.vertex;
+                uint32_t t = collapse.target;
+                if (collapse.error > targetError2 || touched[v] || touched[t]) {
+                    continue;
+                }
+
+                bool bFlip = false;
+                for (uint32_t i = adjacencyOffsets[v]; i < adjacencyOffsets[v + 1] && !bFlip; i++) {
+                    const uint32_t *tri = &outIndices[adjacency[i] * 3];
+                    if (weld[tri[0]] == weld[t] || weld[tri[1]] == weld[t] || weld[tri[2]] == weld[t]) {
+                        continue;   // 折叠后退化, 会被移除
+                    }
+                    const float *p[3];
+                    const float *q[3];
+                    for (int k = 0; k < 3; k++) {
+                        p[k] = &positions[tri[k] * 3];
+                        q[k] = tri[k] == v ? &positions[t * 3] : p[k];
+                    }
+                    double n0[3], n1[3];
+                    Cross(p[0], p[1], p[2], n0);
+                    Cross(q[0], q[1], q[2], n1);
+                    double dot = n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2];
+                    double length0 = std::sqrt(n0[0] * n0[0] + n0[1] * n0[1] + n0[2] * n0[2]);
+                    double length1 = std::sqrt(n1[0] * n1[0] + n1[1] * n1[1] + n1[2] * n1[2]);
+                    bFlip = dot <= AD_FLIP_THRESHOLD * length0 * length1;
+                }
+                if (bFlip) {
+                    continue;
+                }
+
+                remap[v] = t;
+                quadrics[t].Add(quadrics[v]);
+                maxError = std::max(maxError, double(collapse.error));
+                touched[v] = touched[t] = true;
+                for (uint32_t i = adjacencyOffsets[v]; i < adjacencyOffsets[v + 1]; i++) {
+                    const uint32_t *tri = &outIndices[adjacency[i] * 3];
+                    touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = true;
+                }
+                collapseCount++;
+                removedTriangles += kinds[v] == AD_VERTEX_KIND_BORDER ? 1 : 2;
+                if (removedTriangles >= triangleBudget) {
+                    break;
+                }
+            }
+            if (collapseCount == 0) {
+                break;
+            }
+
+            // 应用折叠并移除退化三角形
+            size_t writeIndex = 0;
+            for (size_t i = 0; i < outIndices.size(); i += 3) {
+                uint32_t a = remap[outIndices[i]];
+                uint32_t b = remap[outIndices[i + 1]];
+                uint32_t c = remap[outIndices[i + 2]];
+                if (weld[a] == weld[b] || weld[b] == weld[c] || weld[a] == weld[c]) {
+                    continue;
+                }
+                outIndices[writeIndex++] = a;
+                outIndices[writeIndex++] = b;
+                outIndices[writeIndex++] = c;
+            }
+            outIndices.resize(writeIndex);
+        }
+        outError = static_cast<float>(std::sqrt(maxError));
+    }
+}
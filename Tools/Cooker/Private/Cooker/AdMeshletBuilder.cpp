@@ -0,0 +1,181 @@
+#include "Cooker/AdMeshletBuilder.h"
+#include "Cooker/AdMeshCooker.h"
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace ade {
+
+    using AdVec3 = std::array<float, 3>;
+
+    static AdVec3 Sub(const AdVec3 &a, const AdVec3 &b) { return {a[0] - b[0], a[1] - b[1], a[2] - b[2]}; }
+    static float Dot(const AdVec3 &a, const AdVec3 &b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+    static AdVec3 Cross(const AdVec3 &a, const AdVec3 &b) {
+        return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+    }
+
+    // Ritter 近似包围球: 先取三个轴向上相距最远的一对点作初始球, 再逐点扩张
+    static void ComputeBoundingSphere(const std::vector<AdVec3> &points, AdVec3 &outCenter, float &outRadius) {
+        size_t minIndex[3] = {0, 0, 0};
+        size_t maxIndex[3] = {0, 0, 0};
+        for (size_t i = 0; i < points.size(); i++) {
+            for (int c = 0; c < 3; c++) {
+                minIndex[c] = points[i][c] < points[minIndex[c]][c] ? i : minIndex[c];
+                maxIndex[c] = points[i][c] > points[maxIndex[c]][c] ? i : maxIndex[c];
+            }
+        }
+        int axis = 0;
+        float maxDistance = -1.0f;
+        for (int c = 0; c < 3; c++) {
+            AdVec3 d = Sub(points[maxIndex[c]], points[minIndex[c]]);
+            if (Dot(d, d) > maxDistance) {
+                maxDistance = Dot(d, d);
+                axis = c;
+            }
+        }
+        const AdVec3 &p0 = points[minIndex[axis]];
+        const AdVec3 &p1 = points[maxIndex[axis]];
+        AdVec3 center = {(p0[0] + p1[0]) * 0.5f, (p0[1] + p1[1]) * 0.5f, (p0[2] + p1[2]) * 0.5f};
+        float radius = std::sqrt(maxDistance) * 0.5f;
+        for (const AdVec3 &p: points) {
+            AdVec3 d = Sub(p, center);
+            float distance = std::sqrt(Dot(d, d));
+            if (distance > radius) {
+                float k = (distance - radius) * 0.5f / distance;
+                center = {center[0] + d[0] * k, center[1] + d[1] * k, center[2] + d[2] * k};
+                radius = (radius + distance) * 0.5f;
+            }
+        }
+        outCenter = center;
+        outRadius = radius;
+    }
+
+    /**
+     * 法线锥: 轴取三角形法线包围球的球心方向, 半角由法线与轴的最小夹角决定
+     * 锥顶放在所有三角形平面的背面, 这样从锥顶出发的剔除测试对簇内每个三角形都保守
+     */
+    static void ComputeMeshletBounds(const AdCookMesh &mesh, const AdMeshlet &meshlet,
+                                     const uint32_t *meshletVertices, const uint32_t *meshletTriangles,
+                                     AdMeshlet &outMeshlet) {
+        auto position = [&](uint32_t local) {
+            const float *p = &mesh.positions[meshletVertices[local] * 3];
+            return AdVec3{p[0], p[1], p[2]};
+        };
+
+        std::vector<AdVec3> points(meshlet.vertexCount);
+        for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+            points[i] = position(i);
+        }
+        AdVec3 center;
+        float radius;
+        ComputeBoundingSphere(points, center, radius);
+
+        std::vector<AdVec3> normals;
+        std::vector<AdVec3> corners;
+        for (uint32_t i = 0; i < meshlet.triangleCount; i++) {
+            uint32_t packed = meshletTriangles[i];
+            AdVec3 a = position(packed & 0xff);
+            AdVec3 b = position((packed >> 8) & 0xff);
+            AdVec3 c = position((packed >> 16) & 0xff);
+            AdVec3 n = Cross(Sub(b, a), Sub(c, a));
+            float length = std::sqrt(Dot(n, n));
+            if (length <= 0.0f) {
+                continue;
+            }
+            normals.push_back({n[0] / length, n[1] / length, n[2] / length});
+            corners.push_back(a);
+        }
+
+        memcpy(outMeshlet.center, center.data(), sizeof(outMeshlet.center));
+        outMeshlet.radius = radius;
+        memcpy(outMeshlet.coneApex, center.data(), sizeof(outMeshlet.coneApex));
+        outMeshlet.coneAxis[0] = outMeshlet.coneAxis[1] = 0.0f;
+        outMeshlet.coneAxis[2] = 1.0f;
+        outMeshlet.coneCutoff = 2.0f;
+        if (normals.empty()) {
+            return;
+        }
+
+        AdVec3 normalCenter;
+        float normalRadius;
+        ComputeBoundingSphere(normals, normalCenter, normalRadius);
+        float axisLength = std::sqrt(Dot(normalCenter, normalCenter));
+        if (axisLength <= 0.0f) {
+            return;
+        }
+        AdVec3 axis = {normalCenter[0] / axisLength, normalCenter[1] / axisLength, normalCenter[2] / axisLength};
+        float minDot = 1.0f;
+        for (const AdVec3 &n: normals) {
+            minDot = std::min(minDot, Dot(n, axis));
+        }
+        // 法线分布超过约 84 度时锥几乎不可能剔除, 同时锥顶会退化到无穷远
+        if (minDot <= 0.1f) {
+            return;
+        }
+        float maxT = 0.0f;
+        for (size_t i = 0; i < normals.size(); i++) {
+            float t = Dot(Sub(center, corners[i]), normals[i]) / Dot(axis, normals[i]);
+            maxT = std::max(maxT, t);
+        }
+        for (int c = 0; c < 3; c++) {
+            outMeshlet.coneApex[c] = center[c] - axis[c] * maxT;
+            outMeshlet.coneAxis[c] = axis[c];
+        }
+        // 观察方向与轴的夹角小于 90 - 半角时整簇背向: cos(90 - a) = sin(a)
+        outMeshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+
+    uint32_t BuildMeshlets(AdCookMesh &mesh, const uint32_t *indices, size_t indexCount, uint32_t maxVertices,
+                           uint32_t maxTriangles) {
+        maxVertices = std::min(maxVertices, 255u);
+        size_t firstMeshlet = mesh.meshlets.size();
+        // 顶点在当前 meshlet 中的局部索引, 0xff 表示不在
+        std::vector<uint8_t> localIndices(mesh.GetVertexCount(), 0xff);
+
+        AdMeshlet meshlet{};
+        meshlet.vertexOffset = static_cast<uint32_t>(mesh.meshletVertices.size());
+        meshlet.triangleOffset = static_cast<uint32_t>(mesh.meshletTriangles.size());
+        auto flush = [&]() {
+            if (meshlet.triangleCount == 0) {
+                return;
+            }
+            for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+                localIndices[mesh.meshletVertices[meshlet.vertexOffset + i]] = 0xff;
+            }
+            AdMeshlet result = meshlet;
+            ComputeMeshletBounds(mesh, meshlet, &mesh.meshletVertices[meshlet.vertexOffset],
+                                 &mesh.meshletTriangles[meshlet.triangleOffset], result);
+            mesh.meshlets.push_back(result);
+
+            meshlet = {};
+            meshlet.vertexOffset = static_cast<uint32_t>(mesh.meshletVertices.size());
+            meshlet.triangleOffset = static_cast<uint32_t>(mesh.meshletTriangles.size());
+        };
+
+        for (size_t i = 0; i + 2 < indexCount; i += 3) {
+            const uint32_t *triangle = &indices[i];
+            uint32_t newVertexCount = 0;
+            for (int k = 0; k < 3; k++) {
+                bool bDuplicate = (k > 0 && triangle[k] == triangle[0]) || (k > 1 && triangle[k] == triangle[1]);
+                newVertexCount += (localIndices[triangle[k]] == 0xff && !bDuplicate) ? 1 : 0;
+            }
+            if (meshlet.vertexCount + newVertexCount > maxVertices || meshlet.triangleCount + 1 > maxTriangles) {
+                flush();
+            }
+
+            uint32_t packed = 0;
+            for (int k = 0; k < 3; k++) {
+                uint8_t &local = localIndices[triangle[k]];
+                if (local == 0xff) {
+                    local = static_cast<uint8_t>(meshlet.vertexCount++);
+                    mesh.meshletVertices.push_back(triangle[k]);
+                }
+                packed |= static_cast<uint32_t>(local) << (k * 8);
+            }
+            mesh.meshletTriangles.push_back(packed);
+            meshlet.triangleCount++;
+        }
+        flush();
+        return static_cast<uint32_t>(mesh.meshlets.size() - firstMeshlet);
+    }
+}
@@ -0,0 +1,112 @@
+#include "Cooker/AdShaderCooker.h"
+#include "AdHash.h"
+#include "AdLog.h"
+#include <filesystem>
+
+namespace ade {
+
+    static const char *AD_SHADER_EXTENSIONS[] = {
+            ".vert", ".frag", ".comp", ".geom", ".tesc", ".tese", ".task", ".mesh", ".spv"
+    };
+    static constexpr uint32_t AD_SPIRV_MAGIC = 0x07230203;
+
+    bool AdShaderCooker::CanCook(const std::string &extension) const {
+        return std::find(std::begin(AD_SHADER_EXTENSIONS), std::end(AD_SHADER_EXTENSIONS), extension)
+               != std::end(AD_SHADER_EXTENSIONS);
+    }
+
+    std::string AdShaderCooker::GetOutputPath(const std::string &sourcePath) const {
+        // 00_hello_triangle.vert -> 00_hello_triangle.vert.spv, 和现有资源命名保持一致
+        return GetFileExtension(sourcePath) == ".spv" ? sourcePath : sourcePath + ".spv";
+    }
+
+    static bool IsSpirv(const std::vector<uint8_t> &data) {
+        if (data.size() < sizeof(uint32_t) || data.size() % sizeof(uint32_t) != 0) {
+            return false;
+        }
+        uint32_t magic;
+        memcpy(&magic, data.data(), sizeof(magic));
+        return magic == AD_SPIRV_MAGIC;
+    }
+
+#ifdef AD_DEFINE_GLSLC_PATH
+    // 解析 glslc -MD 生成的 make 依赖文件: "out.spv: src.vert inc/common.glsl \"
+    static void ParseDepFile(const std::string &depPath, const AdCookJob &job, std::vector<std::string> &outDependencies) {
+        std::ifstream in(depPath);
+        std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        size_t colon = content.find(": ");
+        if (colon == std::string::npos) {
+            return;
+        }
+
+        std::vector<std::string> paths;
+        std::string current;
+        for (size_t i = colon + 2; i <= content.size(); i++) {
+            char c = i < content.size() ? content[i] : ' ';
+            if (c == '\\' && i + 1 < content.size() && content[i + 1] != '\n' && content[i + 1] != '\r') {
+                current += content[++i];
+            } else if (c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\\') {
+                if (!current.empty()) {
+                    paths.push_back(std::move(current));
+                    current.clear();
+                }
+            } else {
+                current += c;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::path sourceDir = std::filesystem::weakly_canonical(job.sourceDir, ec);
+        for (const auto &path: paths) {
+            std::filesystem::path fullPath = std::filesystem::weakly_canonical(path, ec);
+            std::string relativePath = std::filesystem::relative(fullPath, sourceDir, ec).generic_string();
+            // 源目录以外的头文件(例如 SDK 自带的)不参与增量判断
+            if (ec || relativePath.empty() || relativePath.rfind("..", 0) == 0 || relativePath == job.sourcePath) {
+                continue;
+            }
+            if (std::find(outDependencies.begin(), outDependencies.end(), relativePath) == outDependencies.end()) {
+                outDependencies.push_back(relativePath);
+            }
+        }
+    }
+#endif
+
+    bool AdShaderCooker::Cook(const AdCookJob &job, AdCookResult &outResult) const {
+        if (GetFileExtension(job.sourcePath) == ".spv") {
+            if (!ReadFileBytes(job.GetSourceFullPath(), outResult.data) || !IsSpirv(outResult.data)) {
+                LOG_E("{0} is not a valid SPIR-V module.", job.sourcePath);
+                return false;
+            }
+            return true;
+        }
+
+#ifdef AD_DEFINE_GLSLC_PATH
+        std::string tempName = job.tempDir + std::to_string(HashString(job.outputPath));
+        std::string spvPath = tempName + ".spv";
+        std::string depPath = tempName + ".d";
+        std::string command = "\"" AD_DEFINE_GLSLC_PATH "\" -O --target-env=vulkan1.3"
+                              " -MD -MF \"" + depPath + "\" -o \"" + spvPath + "\" \"" + job.GetSourceFullPath() + "\"";
+#ifdef AD_ENGINE_PLATFORM_WIN32
+        // cmd /c 会去掉最外层的一对引号
+        command = "\"" + command + "\"";
+#endif
+        int exitCode = std::system(command.c_str());
+        if (exitCode != 0) {
+            LOG_E("glslc compile {0} failed, exit code: {1}", job.sourcePath, exitCode);
+            return false;
+        }
+
+        bool bSuccess = ReadFileBytes(spvPath, outResult.data) && IsSpirv(outResult.data);
+        if (bSuccess) {
+            ParseDepFile(depPath, job, outResult.dependencies);
+        }
+        std::error_code ec;
+        std::filesystem::remove(spvPath, ec);
+        std::filesystem::remove(depPath, ec);
+        return bSuccess;
+#else
+        LOG_E("Could not cook {0}: glslc was not found when configuring the cooker.", job.sourcePath);
+        return false;
+#endif
+    }
+}
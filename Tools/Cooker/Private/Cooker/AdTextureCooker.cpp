@@ -0,0 +1,243 @@
+#include "Cooker/AdTextureCooker.h"
+#include "Asset/AdTextureFormat.h"
+#include "AdLog.h"
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cmath>
+
+namespace ade {
+
+    static constexpr uint64_t AD_TEXTURE_MIP_ALIGNMENT = 16;
+
+    struct AdImage {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<uint8_t> pixels;    // RGBA8, 左上角为原点
+    };
+
+    bool AdTextureCooker::CanCook(const std::string &extension) const {
+        return extension == ".tga" || extension == ".ppm";
+    }
+
+    std::string AdTextureCooker::GetOutputPath(const std::string &sourcePath) const {
+        return ReplaceFileExtension(sourcePath, ".tex");
+    }
+
+    static bool LoadTGA(const std::vector<uint8_t> &data, AdImage &outImage) {
+        if (data.size() < 18) {
+            return false;
+        }
+        uint8_t idLength = data[0];
+        uint8_t colorMapType = data[1];
+        uint8_t imageType = data[2];
+        uint32_t width = data[12] | (data[13] << 8);
+        uint32_t height = data[14] | (data[15] << 8);
+        uint8_t bitsPerPixel = data[16];
+        bool bTopLeft = (data[17] & 0x20) != 0;
+        bool bRle = imageType == 10 || imageType == 11;
+        bool bGray = imageType == 3 || imageType == 11;
+
+        // 只支持真彩色和灰度图, 不支持调色板
+        if (colorMapType != 0 || (imageType != 2 && imageType != 3 && imageType != 10 && imageType != 11)) {
+            LOG_E("Unsupported tga image type: {0}", imageType);
+            return false;
+        }
+        uint32_t bytesPerPixel = bitsPerPixel / 8;
+        if ((bGray && bytesPerPixel != 1) || (!bGray && bytesPerPixel != 3 && bytesPerPixel != 4)
+            || width == 0 || height == 0) {
+            LOG_E("Unsupported tga format: {0} bits per pixel, {1}x{2}", bitsPerPixel, width, height);
+            return false;
+        }
+
+        outImage.width = width;
+        outImage.height = height;
+        outImage.pixels.resize(static_cast<size_t>(width) * height * 4);
+        size_t pixelCount = static_cast<size_t>(width) * height;
+        size_t cursor = 18 + idLength;
+        auto writePixel = [&](size_t index, const uint8_t *src) {
+            uint32_t x = index % width;
+            uint32_t y = index / width;
+            uint8_t *dst = &outImage.pixels[(static_cast<size_t>(bTopLeft ? y : height - 1 - y) * width + x) * 4];
+            if (bGray) {
+                dst[0] = dst[1] = dst[2] = src[0];
+                dst[3] = 255;
+            } else {
+                dst[0] = src[2];
+                dst[1] = src[1];
+                dst[2] = src[0];
+                dst[3] = bytesPerPixel == 4 ? src[3] : 255;
+            }
+        };
+
+        size_t index = 0;
+        while (index < pixelCount) {
+            uint32_t runLength = 1;
+            bool bRepeat = false;
+            if (bRle) {
+                if (cursor >= data.size()) {
+                    return false;
+                }
+                uint8_t packet = data[cursor++];
+                runLength = (packet & 0x7f) + 1;
+                bRepeat = (packet & 0x80) != 0;
+            }
+            if (runLength > pixelCount - index) {
+                return false;
+            }
+            for (uint32_t i = 0; i < runLength; i++) {
+                if (!bRepeat || i == 0) {
+                    if (cursor + bytesPerPixel > data.size()) {
+                        return false;
+                    }
+                    cursor += bytesPerPixel;
+                }
+                writePixel(index++, &data[cursor - bytesPerPixel]);
+            }
+        }
+        return true;
+    }
+
+    static bool LoadPPM(const std::vector<uint8_t> &data, AdImage &outImage) {
+        size_t cursor = 2;
+        auto readNumber = [&](uint32_t &outValue) {
+            while (cursor < data.size()) {
+                if (data[cursor] == '#') {
+                    while (cursor < data.size() && data[cursor] != '\n') cursor++;
+                } else if (isspace(data[cursor])) {
+                    cursor++;
+                } else {
+                    break;
+                }
+            }
+            if (cursor >= data.size() || !isdigit(data[cursor])) {
+                return false;
+            }
+            outValue = 0;
+            while (cursor < data.size() && isdigit(data[cursor])) {
+                outValue = outValue * 10 + (data[cursor++] - '0');
+            }
+            return true;
+        };
+
+        uint32_t width, height, maxValue;
+        if (data.size() < 2 || data[0] != 'P' || data[1] != '6'
+            || !readNumber(width) || !readNumber(height) || !readNumber(maxValue)) {
+            LOG_E("Only binary ppm (P6) is supported.");
+            return false;
+        }
+        cursor++;   // 数据前的单个空白字符
+        size_t pixelCount = static_cast<size_t>(width) * height;
+        if (maxValue == 0 || maxValue > 255 || width == 0 || height == 0 || cursor + pixelCount * 3 > data.size()) {
+            LOG_E("Unsupported ppm: {0}x{1}, max value {2}", width, height, maxValue);
+            return false;
+        }
+
+        outImage.width = width;
+        outImage.height = height;
+        outImage.pixels.resize(pixelCount * 4);
+        for (size_t i = 0; i < pixelCount; i++) {
+            for (int c = 0; c < 3; c++) {
+                outImage.pixels[i * 4 + c] = static_cast<uint8_t>(data[cursor + i * 3 + c] * 255 / maxValue);
+            }
+            outImage.pixels[i * 4 + 3] = 255;
+        }
+        return true;
+    }
+
+    static float SrgbToLinear(float value) {
+        return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+    }
+
+    static float LinearToSrgb(float value) {
+        return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    }
+
+    // 2x2 盒式滤波, sRGB 纹理在线性空间中平均, 否则 mip 会逐级变暗
+    static AdImage DownSample(const AdImage &src, bool bSrgb) {
+        static const auto sDecodeTable = []() {
+            std::array<float, 256> table{};
+            for (int i = 0; i < 256; i++) {
+                table[i] = SrgbToLinear(i / 255.0f);
+            }
+            return table;
+        }();
+
+        AdImage dst;
+        dst.width = std::max(1u, src.width / 2);
+        dst.height = std::max(1u, src.height / 2);
+        dst.pixels.resize(static_cast<size_t>(dst.width) * dst.height * 4);
+        for (uint32_t y = 0; y < dst.height; y++) {
+            uint32_t y0 = std::min(y * 2, src.height - 1);
+            uint32_t y1 = std::min(y * 2 + 1, src.height - 1);
+            for (uint32_t x = 0; x < dst.width; x++) {
+                uint32_t x0 = std::min(x * 2, src.width - 1);
+                uint32_t x1 = std::min(x * 2 + 1, src.width - 1);
+                const uint8_t *samples[4] = {
+                        &src.pixels[(static_cast<size_t>(y0) * src.width + x0) * 4],
+                        &src.pixels[(static_cast<size_t>(y0) * src.width + x1) * 4],
+                        &src.pixels[(static_cast<size_t>(y1) * src.width + x0) * 4],
+                        &src.pixels[(static_cast<size_t>(y1) * src.width + x1) * 4],
+                };
+                uint8_t *out = &dst.pixels[(static_cast<size_t>(y) * dst.width + x) * 4];
+                for (int c = 0; c < 4; c++) {
+                    float sum = 0;
+                    for (const uint8_t *sample: samples) {
+                        sum += (bSrgb && c < 3) ? sDecodeTable[sample[c]] : sample[c] / 255.0f;
+                    }
+                    float value = sum * 0.25f;
+                    if (bSrgb && c < 3) {
+                        value = LinearToSrgb(value);
+                    }
+                    out[c] = static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+                }
+            }
+        }
+        return dst;
+    }
+
+    bool AdTextureCooker::Cook(const AdCookJob &job, AdCookResult &outResult) const {
+        std::vector<uint8_t> data;
+        if (!ReadFileBytes(job.GetSourceFullPath(), data)) {
+            return false;
+        }
+        AdImage image;
+        std::string extension = GetFileExtension(job.sourcePath);
+        if (!(extension == ".tga" ? LoadTGA(data, image) : LoadPPM(data, image))) {
+            LOG_E("Could not decode image: {0}", job.sourcePath);
+            return false;
+        }
+
+        std::string stem = ReplaceFileExtension(job.sourcePath, "");
+        std::transform(stem.begin(), stem.end(), stem.begin(), ::tolower);
+        auto endsWith = [&stem](const std::string &suffix) {
+            return stem.size() >= suffix.size() && stem.compare(stem.size() - suffix.size(), suffix.size(), suffix) == 0;
+        };
+        bool bSrgb = !endsWith("_n") && !endsWith("_normal");
+
+        AdTextureHeader header{};
+        header.magic = AD_TEXTURE_MAGIC;
+        header.version = AD_TEXTURE_VERSION;
+        header.format = bSrgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+
+        std::vector<AdImage> mips;
+        mips.push_back(std::move(image));
+        while ((mips.back().width > 1 || mips.back().height > 1) && mips.size() < AD_TEXTURE_MAX_MIP_COUNT) {
+            mips.push_back(DownSample(mips.back(), bSrgb));
+        }
+        header.mipCount = static_cast<uint32_t>(mips.size());
+
+        uint64_t offset = sizeof(AdTextureHeader);
+        for (uint32_t i = 0; i < header.mipCount; i++) {
+            offset = (offset + AD_TEXTURE_MIP_ALIGNMENT - 1) & ~(AD_TEXTURE_MIP_ALIGNMENT - 1);
+            header.mips[i] = {mips[i].width, mips[i].height, offset, mips[i].pixels.size()};
+            offset += mips[i].pixels.size();
+        }
+
+        outResult.data.assign(offset, 0);
+        memcpy(outResult.data.data(), &header, sizeof(header));
+        for (uint32_t i = 0; i < header.mipCount; i++) {
+            memcpy(outResult.data.data() + header.mips[i].offset, mips[i].pixels.data(), mips[i].pixels.size());
+        }
+        return true;
+    }
+}
@@ -0,0 +1,65 @@
+#include "AdLog.h"
+#include "AdCooker.h"
+#include "Cooker/AdShaderCooker.h"
+#include "Cooker/AdTextureCooker.h"
+#include "Cooker/AdMeshCooker.h"
+
+static void PrintUsage() {
+    std::cout << "Usage: adiosy_cooker --source <dir> --output <dir> [options]\n"
+                 "  --threads <n>               worker thread count, 0 = hardware concurrency\n"
+                 "  --force                     ignore the cook database and cook everything\n"
+                 "  --no-pack                   do not build Resource.adpak\n"
+                 "  --compress <none|lz4|zstd>  compression of packed files\n"
+                 "  --mesh-no-overdraw          keep the vertex cache order, skip overdraw optimization\n";
+}
+
+int main(int argc, char **argv) {
+    ade::AdLog::Init();
+
+    ade::AdCookerSettings settings;
+    ade::AdMeshCookSettings meshSettings;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool bHasValue = i + 1 < argc;
+        if (arg == "--source" && bHasValue) {
+            settings.sourceDir = argv[++i];
+        } else if (arg == "--output" && bHasValue) {
+            settings.outputDir = argv[++i];
+        } else if (arg == "--threads" && bHasValue) {
+            settings.threadCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--force") {
+            settings.bForce = true;
+        } else if (arg == "--no-pack") {
+            settings.bPack = false;
+        } else if (arg == "--mesh-no-overdraw") {
+            meshSettings.bOptimizeOverdraw = false;
+        } else if (arg == "--compress" && bHasValue) {
+            std::string value = argv[++i];
+            if (value == "lz4") {
+                settings.compression = ade::AdCompression::LZ4;
+            } else if (value == "zstd") {
+                settings.compression = ade::AdCompression::Zstd;
+            } else if (value != "none") {
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+        } else {
+            PrintUsage();
+            return EXIT_FAILURE;
+        }
+    }
+    if (settings.sourceDir.empty() || settings.outputDir.empty()) {
+        PrintUsage();
+        return EXIT_FAILURE;
+    }
+    if (!ade::IsCompressionSupported(settings.compression)) {
+        LOG_W("Compression is not available in this build, pack without compression.");
+        settings.compression = ade::AdCompression::None;
+    }
+
+    ade::AdCooker cooker(settings);
+    cooker.RegisterCooker(std::make_unique<ade::AdShaderCooker>());
+    cooker.RegisterCooker(std::make_unique<ade::AdTextureCooker>());
+    cooker.RegisterCooker(std::make_unique<ade::AdMeshCooker>(meshSettings));
+    return cooker.Run() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
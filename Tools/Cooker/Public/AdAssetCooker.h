@@ -0,0 +1,48 @@
+#ifndef AD_ASSET_COOKER_H
+#define AD_ASSET_COOKER_H
+
+#include "AdEngine.h"
+
+namespace ade {
+    class AdAssetCooker;
+
+    struct AdCookJob {
+        std::string sourcePath;         // 相对源目录, 例如 Mesh/cube.obj
+        std::string outputPath;         // 相对输出目录, 例如 Mesh/cube.mesh
+        std::string sourceDir;
+        std::string tempDir;            // 烘焙过程中的临时文件目录
+        const AdAssetCooker *cooker = nullptr;
+
+        std::string GetSourceFullPath() const { return sourceDir + sourcePath; }
+    };
+
+    struct AdCookResult {
+        std::vector<uint8_t> data;
+        std::vector<std::string> dependencies;  // 除源文件以外的依赖, 相对源目录
+    };
+
+    // 资源烘焙器: 把一种源文件转换成运行时格式
+    class AdAssetCooker {
+    public:
+        virtual ~AdAssetCooker() = default;
+
+        virtual const char *GetName() const = 0;
+
+        // 输出格式或转换逻辑变化时递增, 所有对应资源会重新烘焙
+        virtual uint32_t GetVersion() const = 0;
+
+        virtual bool CanCook(const std::string &extension) const = 0;
+
+        virtual std::string GetOutputPath(const std::string &sourcePath) const = 0;
+
+        virtual bool Cook(const AdCookJob &job, AdCookResult &outResult) const = 0;
+    };
+
+    bool ReadFileBytes(const std::string &path, std::vector<uint8_t> &outData);
+
+    std::string GetFileExtension(const std::string &path);
+
+    std::string ReplaceFileExtension(const std::string &path, const std::string &extension);
+}
+
+#endif
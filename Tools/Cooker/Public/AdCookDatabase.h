@@ -0,0 +1,52 @@
+#ifndef AD_COOK_DATABASE_H
+#define AD_COOK_DATABASE_H
+
+#include "AdAssetCooker.h"
+#include <mutex>
+
+namespace ade {
+    struct AdCookInput {
+        std::string path;               // 相对源目录
+        uint64_t hash;
+    };
+
+    struct AdCookRecord {
+        std::string cooker;
+        uint32_t version = 0;
+        std::vector<AdCookInput> inputs; // 第一个是源文件, 其余是依赖
+    };
+
+    /**
+     * 烘焙数据库: 记录每个输出对应的烘焙器版本和所有输入的内容哈希
+     * 文件大小和修改时间没变时复用上次的哈希, 避免每次都读全部源文件
+     */
+    class AdCookDatabase {
+    public:
+        bool Load(const std::string &path);
+
+        bool Save(const std::string &path);
+
+        // 线程安全, 文件不存在时返回 false
+        bool GetFileHash(const std::string &sourceDir, const std::string &path, uint64_t &outHash);
+
+        bool IsUpToDate(const AdCookJob &job, const std::string &outputFullPath);
+
+        void UpdateRecord(const std::string &outputPath, AdCookRecord record);
+
+        // 删除不在 outputPaths 中的记录(源文件已被删除), 返回被删除的输出路径
+        std::vector<std::string> RemoveStaleRecords(const std::unordered_set<std::string> &outputPaths);
+
+    private:
+        struct FileStamp {
+            uint64_t size;
+            int64_t modifyTime;
+            uint64_t hash;
+        };
+
+        std::mutex mMutex;
+        std::unordered_map<std::string, FileStamp> mFileStamps;
+        std::unordered_map<std::string, AdCookRecord> mRecords;
+    };
+}
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef AD_COOKER_H
+#define AD_COOKER_H
+
+#include "AdCookDatabase.h"
+#include "FileSystem/AdArchive.h"
+
+namespace ade {
+    struct AdCookerSettings {
+        std::string sourceDir;
+        std::string outputDir;
+        uint32_t threadCount = 0;       // 0 表示硬件线程数
+        bool bForce = false;            // 忽略数据库中的记录, 全部重新烘焙
+        bool bPack = true;              // 烘焙完成后把输出目录打包成 Resource.adpak
+        AdCompression compression = AdCompression::None;
+    };
+
+    class AdCooker {
+    public:
+        explicit AdCooker(const AdCookerSettings &settings);
+
+        void RegisterCooker(std::unique_ptr<AdAssetCooker> cooker);
+
+        // 返回是否全部成功
+        bool Run();
+
+    private:
+        void CollectJobs(std::vector<AdCookJob> &outJobs) const;
+
+        // 删除数据库中源文件已不存在的输出和记录, 使它们不会被打包; 返回删除的数量
+        uint32_t PruneStaleOutputs(const std::vector<AdCookJob> &jobs);
+
+        // 返回 -1 失败, 0 跳过, 1 烘焙
+        int RunJob(const AdCookJob &job);
+
+        bool Pack() const;
+
+    private:
+        AdCookerSettings mSettings;
+        std::vector<std::unique_ptr<AdAssetCooker>> mCookers;
+        AdCookDatabase mDatabase;
+    };
+}
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef AD_MESH_COOKER_H
+#define AD_MESH_COOKER_H
+
+#include "AdAssetCooker.h"
+#include "Asset/AdMeshFormat.h"
+
+namespace ade {
+    // 烘焙过程中的未量化网格
+    struct AdCookMesh {
+        std::vector<float> positions;   // float3
+        std::vector<float> normals;     // float3
+        std::vector<float> uvs;         // float2
+        std::vector<uint32_t> indices;  // 所有 LOD 的索引依次存放
+        std::vector<AdMeshLod> lods;    // 为空表示只有一级
+        std::vector<AdMeshlet> meshlets;
+        std::vector<uint32_t> meshletVertices;
+        std::vector<uint32_t> meshletTriangles;
+
+        uint32_t GetVertexCount() const { return static_cast<uint32_t>(positions.size() / 3); }
+    };
+
+    struct AdMeshCookSettings {
+        bool bOptimizeVertexCache = true;
+        bool bOptimizeOverdraw = true;
+        float overdrawThreshold = 1.05f;    // 减少过度绘制时允许的 ACMR 劣化比例
+        uint32_t maxLodCount = 6;           // 包括原始网格, 1 表示不生成 LOD
+        float lodReduction = 0.5f;          // 每一级相对上一级保留的三角形比例
+        uint32_t minLodTriangleCount = 64;  // 三角形少于这个数量时不再继续简化
+    };
+
+    /**
+     * OBJ -> .mesh, 三角化并按 (位置, 纹理坐标, 法线) 去重顶点, 输出量化后的顶点流
+     * 用二次误差简化生成 LOD 链, 每一级记录几何误差供运行时按屏幕投影大小选择
+     * 离线重排索引和顶点以提高顶点缓存命中率和读取局部性, 并可选地减少过度绘制
+     * 最后把每一级 LOD 切成 meshlet, 供 mesh shader 按簇剔除
+     */
+    class AdMeshCooker : public AdAssetCooker {
+    public:
+        explicit AdMeshCooker(const AdMeshCookSettings &settings = {}) : mSettings(settings) {}
+
+        const char *GetName() const override { return "Mesh"; }
+        // 所有影响输出的设置都编进版本号, 修改后对应资源重新烘焙
+        uint32_t GetVersion() const override;
+        bool CanCook(const std::string &extension) const override;
+        std::string GetOutputPath(const std::string &sourcePath) const override;
+        bool Cook(const AdCookJob &job, AdCookResult &outResult) const override;
+
+    private:
+        AdMeshCookSettings mSettings;
+    };
+}
+
+#endif
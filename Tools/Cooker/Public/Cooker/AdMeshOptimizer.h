@@ -0,0 +1,33 @@
+#ifndef AD_MESH_OPTIMIZER_H
+#define AD_MESH_OPTIMIZER_H
+
+#include "AdEngine.h"
+
+namespace ade {
+    struct AdCookMesh;
+
+    struct AdVertexCacheStats {
+        uint32_t vertexTransforms;
+        float acmr;                 // 平均每个三角形的顶点变换次数, 最优约 0.5
+        float atvr;                 // 顶点变换次数 / 顶点数, 最优为 1.0
+    };
+
+    // 模拟 FIFO 顶点缓存统计变换次数
+    AdVertexCacheStats AnalyzeVertexCache(const std::vector<uint32_t> &indices, uint32_t vertexCount,
+                                          uint32_t cacheSize = 16);
+
+    // 按 Forsyth 的线性时间算法重排三角形, 提高变换后顶点缓存命中率
+    void OptimizeVertexCache(std::vector<uint32_t> &indices, uint32_t vertexCount);
+
+    /**
+     * 在保持顶点缓存效率的前提下减少过度绘制(Sander et al. 2007):
+     * 把三角形序列切成簇, 朝外的簇先绘制
+     * @param threshold     允许的 ACMR 劣化比例, 越大簇越小, 排序越充分
+     */
+    void OptimizeOverdraw(std::vector<uint32_t> &indices, const std::vector<float> &positions, float threshold = 1.05f);
+
+    // 按首次使用顺序重排顶点, 提高顶点读取的局部性, 同时去掉未使用的顶点
+    void OptimizeVertexFetch(AdCookMesh &mesh);
+}
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef AD_MESH_SIMPLIFIER_H
+#define AD_MESH_SIMPLIFIER_H
+
+#include "AdEngine.h"
+
+namespace ade {
+    struct AdCookMesh;
+
+    /**
+     * 基于二次误差度量(Garland & Heckbert 1997)的网格简化
+     * 只做半边折叠, 顶点折叠到已有顶点上, 因此所有 LOD 可以共用同一份顶点流
+     * 属性接缝上的顶点保持不动, 开放边界上的顶点只能沿边界折叠, 法线和 uv 的变化计入折叠代价
+     *
+     * @param indices           输入三角形, 引用 mesh 的顶点
+     * @param targetIndexCount  目标索引数, 无法继续简化时会提前停止
+     * @param targetError       允许的最大几何误差(物体空间距离)
+     * @param outError          实际产生的最大几何误差
+     */
+    void SimplifyMesh(const AdCookMesh &mesh, const std::vector<uint32_t> &indices, size_t targetIndexCount,
+                      float targetError, std::vector<uint32_t> &outIndices, float &outError);
+}
+
+#endif
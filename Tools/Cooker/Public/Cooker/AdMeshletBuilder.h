@@ -0,0 +1,23 @@
+#ifndef AD_MESHLET_BUILDER_H
+#define AD_MESHLET_BUILDER_H
+
+#include "AdEngine.h"
+#include "Asset/AdMeshFormat.h"
+
+namespace ade {
+    struct AdCookMesh;
+
+    /**
+     * 按三角形顺序贪心地把索引切成 meshlet, 顶点或三角形达到上限时开始新的 meshlet
+     * 输入应当已经按顶点缓存优化过, 相邻三角形共享顶点多, 切出来的簇更紧凑
+     * 每个 meshlet 计算包围球和法线锥, 供运行时做视锥和背面剔除
+     *
+     * 结果追加到 mesh 的 meshlets / meshletVertices / meshletTriangles 后面
+     * @return 新增的 meshlet 数量
+     */
+    uint32_t BuildMeshlets(AdCookMesh &mesh, const uint32_t *indices, size_t indexCount,
+                           uint32_t maxVertices = AD_MESHLET_MAX_VERTICES,
+                           uint32_t maxTriangles = AD_MESHLET_MAX_TRIANGLES);
+}
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef AD_SHADER_COOKER_H
+#define AD_SHADER_COOKER_H
+
+#include "AdAssetCooker.h"
+
+namespace ade {
+    // GLSL -> SPIR-V, 调用 glslc 编译并记录 #include 依赖; 已编译的 .spv 直接拷贝
+    class AdShaderCooker : public AdAssetCooker {
+    public:
+        const char *GetName() const override { return "Shader"; }
+        uint32_t GetVersion() const override { return 1; }
+        bool CanCook(const std::string &extension) const override;
+        std::string GetOutputPath(const std::string &sourcePath) const override;
+        bool Cook(const AdCookJob &job, AdCookResult &outResult) const override;
+    };
+}
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef AD_TEXTURE_COOKER_H
+#define AD_TEXTURE_COOKER_H
+
+#include "AdAssetCooker.h"
+
+namespace ade {
+    /**
+     * TGA/PPM -> .tex, 输出 RGBA8 和完整的 mip 链
+     * 文件名以 _n 或 _normal 结尾的按线性空间(UNORM)处理, 其余按 sRGB 处理
+     */
+    class AdTextureCooker : public AdAssetCooker {
+    public:
+        const char *GetName() const override { return "Texture"; }
+        uint32_t GetVersion() const override { return 1; }
+        bool CanCook(const std::string &extension) const override;
+        std::string GetOutputPath(const std::string &sourcePath) const override;
+        bool Cook(const AdCookJob &job, AdCookResult &outResult) const override;
+    };
+}
+
+#endif